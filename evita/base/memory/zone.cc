@@ -2,11 +2,12 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <new>
 #include <utility>
 
 #include "evita/base/memory/zone.h"
 
-#include "evita/base/memory/zone_allocated.h"
+#include "base/logging.h"
 
 namespace evita {
 
@@ -24,74 +25,107 @@ size_t RoundUp(size_t num, size_t unit) {
 //
 // Zone::Segment
 //
+// A segment is allocated in one block of memory, header followed by
+// |max_offset_| bytes of memory for objects.
 class Zone::Segment final {
  public:
-  Segment(size_t size, Segment* next);
-  ~Segment();
-
   Segment* next() const { return next_; }
 
   void* Allocate(size_t size);
 
+  static Segment* New(size_t size, Segment* next);
+  static void Delete(Segment* segment);
+
  private:
+  Segment(size_t size, Segment* next);
+  ~Segment() = default;
+
+  char* memory() {
+    return reinterpret_cast<char*>(this) + RoundUp(sizeof(*this),
+                                                   kAllocateUnit);
+  }
+
   Segment* const next_;
   size_t const max_offset_;
   size_t offset_;
-  char* memory_;
 
   DISALLOW_COPY_AND_ASSIGN(Segment);
 };
 
 Zone::Segment::Segment(size_t size, Segment* next)
-    : next_(next),
-      max_offset_(RoundUp(size, kMinSegmentSize)),
-      offset_(0u),
-      memory_(new char[max_offset_]) {}
-
-Zone::Segment::~Segment() {
-  delete[] memory_;
-}
+    : next_(next), max_offset_(size), offset_(0u) {}
 
 void* Zone::Segment::Allocate(size_t size) {
   const auto allocate_size = RoundUp(size, kAllocateUnit);
   const auto next_offset = offset_ + allocate_size;
   if (next_offset > max_offset_)
     return nullptr;
-  auto* const result = &memory_[offset_];
+  auto* const result = &memory()[offset_];
   offset_ = next_offset;
   return result;
 }
 
+// static
+void Zone::Segment::Delete(Segment* segment) {
+  segment->~Segment();
+  ::operator delete(segment);
+}
+
+// static
+Zone::Segment* Zone::Segment::New(size_t size, Segment* next) {
+  auto* const block =
+      ::operator new(RoundUp(sizeof(Segment), kAllocateUnit) + size);
+  return new (block) Segment(size, next);
+}
+
 //////////////////////////////////////////////////////////////////////
 //
 // Zone
 //
-Zone::Zone(Zone&& other) : name_(other.name_), segment_(other.segment_) {
+Zone::Zone(Zone&& other)
+    : name_(other.name_),
+      segment_(other.segment_),
+      segment_size_(other.segment_size_) {
   other.segment_ = nullptr;
+  other.segment_size_ = 0;
 }
 
-Zone::Zone(const char* name) : name_(name), segment_(new Segment(0, nullptr)) {}
+Zone::Zone(const char* name) : Zone(name, kMinSegmentSize) {}
+
+// The first segment is allocated by the first |Allocate()|, so a zone costs
+// one allocation of |segment_size_| bytes, for small objects.
+Zone::Zone(const char* name, size_t segment_size)
+    : name_(name),
+      segment_(nullptr),
+      segment_size_(RoundUp(segment_size, kAllocateUnit)) {
+  DCHECK_GT(segment_size_, 0u);
+}
 
 Zone::~Zone() {
   auto* segment = segment_;
   while (segment) {
     auto* const next_segment = segment->next();
-    delete segment;
+    Segment::Delete(segment);
     segment = next_segment;
   }
 }
 
 Zone& Zone::operator=(Zone&& other) {
   segment_ = other.segment_;
+  segment_size_ = other.segment_size_;
   other.segment_ = nullptr;
+  other.segment_size_ = 0;
   return *this;
 }
 
 void* Zone::Allocate(size_t size) {
+  DCHECK_GT(segment_size_, 0u) << name_ << " was moved.";
   for (;;) {
-    if (auto* const pointer = segment_->Allocate(size))
-      return pointer;
-    segment_ = new Segment(size, segment_);
+    if (segment_) {
+      if (auto* const pointer = segment_->Allocate(size))
+        return pointer;
+    }
+    segment_ = Segment::New(RoundUp(size, segment_size_), segment_);
   }
 }
 
@@ -19,6 +19,10 @@ class EVITA_BASE_EXPORT Zone final {
   Zone(const Zone& other) = delete;
   Zone(Zone&& other);
   explicit Zone(const char* name);
+  // Allocates memory in segments of multiple of |segment_size| bytes. Small
+  // short-lived zones, e.g. one per line of text, should use a small
+  // |segment_size| to keep memory footprint low.
+  Zone(const char* name, size_t segment_size);
   ~Zone();
 
   Zone& operator=(const Zone& other) = delete;
@@ -37,6 +41,7 @@ class EVITA_BASE_EXPORT Zone final {
 
   const char* name_;
   Segment* segment_;
+  size_t segment_size_;
 };
 
 }  // namespace evita
@@ -23,13 +23,17 @@ class ZoneVector : public std::vector<T, ZoneAllocator<T>> {
   explicit ZoneVector(Zone* zone)
       : std::vector<T, ZoneAllocator<T>>(ZoneAllocator<T>(zone)) {}
 
-  ZoneVector(Zone* zone, size_t size, const value_type& val = value_type())
+  ZoneVector(Zone* zone, size_t size, const T& val = T())
       : std::vector<T, ZoneAllocator<T>>(size, val, ZoneAllocator<T>(zone)) {}
 
   ZoneVector(Zone* zone, const std::vector<T>& other)
       : std::vector<T, ZoneAllocator<T>>(other.begin(),
                                          other.end(),
                                          ZoneAllocator<T>(zone)) {}
+
+  template <typename Iterator>
+  ZoneVector(Zone* zone, Iterator first, Iterator last)
+      : std::vector<T, ZoneAllocator<T>>(first, last, ZoneAllocator<T>(zone)) {}
 };
 
 }  // namespace evita
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <array>
+#include <map>
 #include <vector>
 
 #include "evita/css/property.h"
@@ -28,6 +29,11 @@ class PropertyNames final {
     return names_[static_cast<size_t>(id)];
   }
 
+  PropertyId GetId(base::StringPiece16 name) const {
+    const auto& it = ids_.find(name);
+    return it == ids_.end() ? PropertyId::Invalid : it->second;
+  }
+
   const char* GetAscii(PropertyId id) const {
     const auto index = static_cast<size_t>(id);
     if (index >= ascii_names_.size())
@@ -41,6 +47,8 @@ class PropertyNames final {
 
  private:
   std::array<const char*, kMaxPropertyId + 1> ascii_names_;
+  // Keys of |ids_| refer strings in |names_|.
+  std::map<base::StringPiece16, PropertyId> ids_;
   std::vector<base::string16> names_;
 
   DISALLOW_COPY_AND_ASSIGN(PropertyNames);
@@ -52,6 +60,10 @@ PropertyNames::PropertyNames() : names_(kMaxPropertyId + 1) {
   ascii_names_[static_cast<size_t>(PropertyId::Name)] = text;
   FOR_EACH_VISUAL_CSS_PROPERTY(V)
 #undef V
+#define V(Name, name, type, text) \
+  ids_.emplace(Get(PropertyId::Name), PropertyId::Name);
+  FOR_EACH_VISUAL_CSS_PROPERTY(V)
+#undef V
 }
 
 }  // namespace
@@ -94,10 +106,18 @@ bool Property::operator!=(const Property& other) const {
   return !operator==(other);
 }
 
+size_t Property::hash_value() const {
+  return (value_.hash_value() << 5) ^ static_cast<size_t>(id_);
+}
+
 const char* Property::AsciiNameOf(PropertyId id) {
   return PropertyNames::GetInstance()->GetAscii(id);
 }
 
+PropertyId Property::IdOf(base::StringPiece16 name) {
+  return PropertyNames::GetInstance()->GetId(name);
+}
+
 const base::string16& Property::NameOf(PropertyId id) {
   return PropertyNames::GetInstance()->Get(id);
 }
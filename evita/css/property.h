@@ -9,6 +9,7 @@
 #include <string>
 
 #include "base/strings/string16.h"
+#include "base/strings/string_piece.h"
 #include "evita/css/values/value.h"
 
 namespace css {
@@ -37,6 +38,7 @@ class Property final {
   bool operator==(const Property& other) const;
   bool operator!=(const Property& other) const;
 
+  size_t hash_value() const;
   PropertyId id() const { return id_; }
   const base::string16& name() const { return NameOf(id_); }
   const char* ascii_name() const { return AsciiNameOf(id_); }
@@ -45,6 +47,10 @@ class Property final {
   static const base::string16& NameOf(PropertyId id);
   static const char* AsciiNameOf(PropertyId id);
 
+  // Returns property id of |name|, e.g. "color", or |PropertyId::Invalid|
+  // if |name| isn't a property name.
+  static PropertyId IdOf(base::StringPiece16 name);
+
  private:
   PropertyId id_;
   Value value_;
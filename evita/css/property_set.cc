@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <bitset>
 #include <ostream>
 #include <utility>
 
@@ -19,60 +20,154 @@
 
 namespace css {
 
+namespace {
+
+size_t CountBits(uint64_t word) {
+  return std::bitset<64>(word).count();
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// PropertySet::Iterator
+//
+PropertySet::Iterator::Iterator(const PropertySet& property_set,
+                                size_t id,
+                                size_t index)
+    : id_(id), index_(index), property_set_(&property_set) {}
+
+PropertySet::Iterator::Iterator(const Iterator& other)
+    : id_(other.id_),
+      index_(other.index_),
+      property_set_(other.property_set_) {}
+
+PropertySet::Iterator::~Iterator() {}
+
+PropertySet::Iterator& PropertySet::Iterator::operator=(
+    const Iterator& other) {
+  id_ = other.id_;
+  index_ = other.index_;
+  property_set_ = other.property_set_;
+  return *this;
+}
+
+Property PropertySet::Iterator::operator*() const {
+  DCHECK_LT(index_, property_set_->values_.size());
+  return Property(static_cast<PropertyId>(id_),
+                  property_set_->values_[index_]);
+}
+
+PropertySet::Iterator& PropertySet::Iterator::operator++() {
+  DCHECK_LT(index_, property_set_->values_.size());
+  id_ = property_set_->NextPresent(id_ + 1);
+  ++index_;
+  return *this;
+}
+
+bool PropertySet::Iterator::operator==(const Iterator& other) const {
+  DCHECK_EQ(property_set_, other.property_set_);
+  return index_ == other.index_;
+}
+
+bool PropertySet::Iterator::operator!=(const Iterator& other) const {
+  return !operator==(other);
+}
+
 //////////////////////////////////////////////////////////////////////
 //
 // PropertySet
 //
 PropertySet::PropertySet(const PropertySet& other)
-    : properties_(other.properties_) {}
+    : bits_(other.bits_), values_(other.values_) {}
 
 PropertySet::PropertySet(PropertySet&& other)
-    : properties_(std::move(other.properties_)) {}
+    : bits_(other.bits_), values_(std::move(other.values_)) {
+  other.bits_.fill(0);
+}
+
+PropertySet::PropertySet() {
+  bits_.fill(0);
+}
 
-PropertySet::PropertySet() {}
 PropertySet::~PropertySet() {}
 
 PropertySet& PropertySet::operator=(const PropertySet& other) {
-  properties_ = other.properties_;
+  bits_ = other.bits_;
+  values_ = other.values_;
   return *this;
 }
 
 PropertySet& PropertySet::operator=(PropertySet&& other) {
-  properties_ = std::move(other.properties_);
+  bits_ = other.bits_;
+  values_ = std::move(other.values_);
+  other.bits_.fill(0);
   return *this;
 }
 
+// Since values are stored in order of property id, we can compare them
+// element-wise.
 bool PropertySet::operator==(const PropertySet& other) const {
   if (this == &other)
     return true;
-  if (properties_.size() != other.properties_.size())
-    return false;
-  for (const auto& property : *this) {
-    const auto& it = std::find(other.begin(), other.end(), property);
-    if (it == other.end())
-      return false;
-  }
-  return true;
+  return bits_ == other.bits_ && values_ == other.values_;
 }
 
 bool PropertySet::operator!=(const PropertySet& other) const {
   return !operator==(other);
 }
 
+PropertySet::Iterator PropertySet::begin() const {
+  return Iterator(*this, NextPresent(0), 0);
+}
+
+PropertySet::Iterator PropertySet::end() const {
+  return Iterator(*this, kMaxPropertyId + 1, values_.size());
+}
+
 bool PropertySet::Contains(PropertyId property_id) const {
-  for (const auto& property : *this) {
-    if (property.id() == property_id)
-      return true;
+  return IsPresent(static_cast<size_t>(property_id));
+}
+
+size_t PropertySet::hash_value() const {
+  size_t hash_code = values_.size();
+  for (const auto& property : *this)
+    hash_code += property.hash_value();
+  return hash_code;
+}
+
+size_t PropertySet::IndexOf(size_t property_id) const {
+  DCHECK_LE(property_id, kMaxPropertyId);
+  const auto word_index = property_id / kBitsPerWord;
+  const auto bit_index = property_id % kBitsPerWord;
+  size_t index = 0;
+  for (size_t runner = 0; runner < word_index; ++runner)
+    index += CountBits(bits_[runner]);
+  const auto mask = (uint64_t{1} << bit_index) - 1;
+  return index + CountBits(bits_[word_index] & mask);
+}
+
+bool PropertySet::IsPresent(size_t property_id) const {
+  DCHECK_LE(property_id, kMaxPropertyId);
+  return (bits_[property_id / kBitsPerWord] >>
+          (property_id % kBitsPerWord)) & 1;
+}
+
+// Returns property id of present property at or after |property_id|, or
+// |kMaxPropertyId + 1| if there is no such property.
+size_t PropertySet::NextPresent(size_t property_id) const {
+  for (auto runner = property_id; runner <= kMaxPropertyId; ++runner) {
+    if (IsPresent(runner))
+      return runner;
   }
-  return false;
+  return kMaxPropertyId + 1;
 }
 
 Value PropertySet::ValueOf(PropertyId property_id) const {
-  for (const auto& property : *this) {
-    if (property.id() == property_id)
-      return std::move(property.value());
-  }
-  return Value();
+  const auto id = static_cast<size_t>(property_id);
+  if (!IsPresent(id))
+    return Value();
+  return values_[IndexOf(id)];
 }
 
 std::ostream& operator<<(std::ostream& ostream,
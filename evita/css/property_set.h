@@ -7,11 +7,13 @@
 
 #include <stdint.h>
 
+#include <array>
 #include <iosfwd>
 #include <iterator>
 #include <vector>
 
 #include "base/strings/string_piece.h"
+#include "evita/css/properties_forward.h"
 #include "evita/css/property.h"
 
 namespace css {
@@ -29,6 +31,9 @@ class Value;
 //////////////////////////////////////////////////////////////////////
 //
 // PropertySet
+// Property set is represented by a bit set indexed by property id and
+// an array of values of present properties in ascending order of property
+// id. Index of value is number of bits set before property id in bit set.
 //
 class PropertySet final {
  public:
@@ -37,6 +42,36 @@ class PropertySet final {
   // See "evita/css/property_set_editor.h" for implementation.
   class Editor;
 
+  //////////////////////////////////////////////////////////////////////
+  //
+  // Iterator yields |Property| in ascending order of property id.
+  //
+  // |Iterator| is an input iterator, since |Property| is made from bits and
+  // values when dereferenced rather than stored in |PropertySet|.
+  class Iterator final : public std::iterator<std::input_iterator_tag,
+                                              Property,
+                                              ptrdiff_t,
+                                              const Property*,
+                                              Property> {
+   public:
+    Iterator(const PropertySet& property_set, size_t id, size_t index);
+    Iterator(const Iterator& other);
+    ~Iterator();
+
+    Iterator& operator=(const Iterator& other);
+
+    Property operator*() const;
+    Iterator& operator++();
+
+    bool operator==(const Iterator& other) const;
+    bool operator!=(const Iterator& other) const;
+
+   private:
+    size_t id_;
+    size_t index_;
+    const PropertySet* property_set_;
+  };
+
   PropertySet(const PropertySet& other);
   PropertySet(PropertySet&& other);
   PropertySet();
@@ -48,22 +83,31 @@ class PropertySet final {
   bool operator==(const PropertySet& other) const;
   bool operator!=(const PropertySet& other) const;
 
-  std::vector<Property>::const_iterator begin() const {
-    return properties_.begin();
-  }
-  std::vector<Property>::iterator begin() { return properties_.begin(); }
-  std::vector<Property>::iterator end() { return properties_.end(); }
-  std::vector<Property>::const_iterator end() const {
-    return properties_.end();
-  }
+  Iterator begin() const;
+  Iterator end() const;
 
   bool Contains(PropertyId property_id) const;
+  // Returns hash code which doesn't depend on order of properties as
+  // |operator==()|.
+  size_t hash_value() const;
   Value ValueOf(PropertyId property_id) const;
 
  private:
   friend class PropertySetTest;
 
-  std::vector<Property> properties_;
+  static const size_t kBitsPerWord = 64;
+  static const size_t kNumberOfWords = kMaxPropertyId / kBitsPerWord + 1;
+  using Bits = std::array<uint64_t, kNumberOfWords>;
+
+  // Returns index in |values_| of |property_id| whether it is present or not.
+  size_t IndexOf(size_t property_id) const;
+  bool IsPresent(size_t property_id) const;
+  size_t NextPresent(size_t property_id) const;
+
+  // |bits_| has a bit for each property id present in this set.
+  Bits bits_;
+  // |values_| holds values in ascending order of property id.
+  std::vector<Value> values_;
 };
 
 std::ostream& operator<<(std::ostream& ostream,
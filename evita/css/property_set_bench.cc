@@ -0,0 +1,179 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Compares |PropertySet| with a vector of |Property| which was previous
+// representation of |PropertySet|.
+//
+// Usage: property_set_bench [--iterations=N]
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <unordered_set>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "evita/css/properties.h"
+#include "evita/css/property.h"
+#include "evita/css/property_set.h"
+#include "evita/css/property_set_editor.h"
+#include "evita/css/values/value.h"
+
+namespace css {
+
+namespace {
+
+const auto kDefaultIterations = 100000;
+
+//////////////////////////////////////////////////////////////////////
+//
+// VectorPropertySet
+// A property set searching properties linearly.
+//
+class VectorPropertySet final {
+ public:
+  VectorPropertySet() = default;
+  ~VectorPropertySet() = default;
+
+  void Add(PropertyId property_id, const Value& value) {
+    properties_.emplace_back(Property(property_id, value));
+  }
+
+  bool Contains(PropertyId property_id) const {
+    for (const auto& property : properties_) {
+      if (property.id() == property_id)
+        return true;
+    }
+    return false;
+  }
+
+  void Merge(const VectorPropertySet& other) {
+    std::unordered_set<PropertyId> present;
+    for (const auto& property : properties_)
+      present.insert(property.id());
+    for (const auto& property : other.properties_) {
+      if (present.count(property.id()))
+        continue;
+      Add(property.id(), property.value());
+    }
+  }
+
+  Value ValueOf(PropertyId property_id) const {
+    for (const auto& property : properties_) {
+      if (property.id() == property_id)
+        return property.value();
+    }
+    return Value();
+  }
+
+ private:
+  std::vector<Property> properties_;
+};
+
+// Returns property ids from last to first, as ids of computed style of
+// element are mostly at end of |PropertyId|.
+std::vector<PropertyId> PropertyIds(size_t count, size_t step) {
+  std::vector<PropertyId> ids;
+  for (auto id = kMaxPropertyId; ids.size() < count; id -= step) {
+    ids.push_back(static_cast<PropertyId>(id));
+    if (id <= step)
+      break;
+  }
+  return ids;
+}
+
+void Fill(VectorPropertySet* set, const std::vector<PropertyId>& ids) {
+  for (const auto id : ids)
+    set->Add(id, Value(static_cast<int>(id)));
+}
+
+void Fill(PropertySet* set, const std::vector<PropertyId>& ids) {
+  for (const auto id : ids)
+    PropertySet::Editor().Add(set, id, Value(static_cast<int>(id)));
+}
+
+void Merge(VectorPropertySet* left, const VectorPropertySet& right) {
+  left->Merge(right);
+}
+
+void Merge(PropertySet* left, const PropertySet& right) {
+  PropertySet::Editor().Merge(left, right);
+}
+
+void Report(const char* name,
+            const char* representation,
+            base::TimeDelta elapsed,
+            int iterations) {
+  std::cout << std::left << std::setw(16) << name << std::setw(8)
+            << representation << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10)
+            << elapsed.InMicrosecondsF() * 1000 / iterations << " ns/op"
+            << std::endl;
+}
+
+// Reads all properties as |Style| accessors do.
+template <typename SetType>
+void BenchLookup(const char* representation, size_t size, int iterations) {
+  SetType set;
+  Fill(&set, PropertyIds(size, 2));
+  auto found = 0;
+  const auto& start = base::TimeTicks::Now();
+  for (auto count = 0; count < iterations; ++count) {
+    for (size_t id = 1; id <= kMaxPropertyId; ++id) {
+      const auto property_id = static_cast<PropertyId>(id);
+      if (!set.Contains(property_id))
+        continue;
+      if (!set.ValueOf(property_id).is_unspecified())
+        ++found;
+    }
+  }
+  const auto& elapsed = base::TimeTicks::Now() - start;
+  CHECK_EQ(static_cast<int>(PropertyIds(size, 2).size()) * iterations, found);
+  Report(size > 8 ? "lookup/large" : "lookup/small", representation, elapsed,
+         iterations);
+}
+
+// Merges matched style into computed style as cascading does.
+template <typename SetType>
+void BenchMerge(const char* representation, size_t size, int iterations) {
+  SetType right;
+  Fill(&right, PropertyIds(size, 1));
+  SetType initial;
+  Fill(&initial, PropertyIds(size / 2, 3));
+  const auto& start = base::TimeTicks::Now();
+  for (auto count = 0; count < iterations; ++count) {
+    auto left = initial;
+    Merge(&left, right);
+  }
+  const auto& elapsed = base::TimeTicks::Now() - start;
+  Report(size > 8 ? "merge/large" : "merge/small", representation, elapsed,
+         iterations);
+}
+
+}  // namespace
+
+}  // namespace css
+
+int main(int argc, char** argv) {
+  base::AtExitManager at_exit;
+  base::CommandLine::Init(argc, argv);
+  const auto& command_line = *base::CommandLine::ForCurrentProcess();
+  auto iterations = css::kDefaultIterations;
+  if (command_line.HasSwitch("iterations")) {
+    base::StringToInt(command_line.GetSwitchValueASCII("iterations"),
+                      &iterations);
+  }
+  for (const auto size : {4, 16}) {
+    css::BenchLookup<css::VectorPropertySet>("vector", size, iterations);
+    css::BenchLookup<css::PropertySet>("packed", size, iterations);
+    css::BenchMerge<css::VectorPropertySet>("vector", size, iterations);
+    css::BenchMerge<css::PropertySet>("packed", size, iterations);
+  }
+  return 0;
+}
@@ -2,16 +2,13 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-#include <algorithm>
-#include <cmath>
-#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "evita/css/property_set_editor.h"
 
 #include "base/logging.h"
 #include "evita/css/properties.h"
-#include "evita/css/property_editor.h"
 #include "evita/css/property_set.h"
 #include "evita/css/values/color_value.h"
 #include "evita/css/values/dimension.h"
@@ -36,45 +33,59 @@ void Editor::Add(PropertySet* property_set,
                  const Value& value) {
   DCHECK(!property_set->Contains(property_id))
       << "Property '" << property_id << "' is already in " << *property_set;
-  property_set->properties_.emplace_back(Property(property_id, value));
+  const auto id = static_cast<size_t>(property_id);
+  auto& values = property_set->values_;
+  values.insert(values.begin() + property_set->IndexOf(id), value);
+  property_set->bits_[id / PropertySet::kBitsPerWord] |=
+      uint64_t{1} << (id % PropertySet::kBitsPerWord);
 }
 
+// Since both |left| and |right| hold values in order of property id, we
+// merge them in one pass.
 void Editor::Merge(PropertySet* left, const PropertySet& right) {
-  std::unordered_set<PropertyId> left_set;
-  for (const auto& left_property : *left)
-    left_set.insert(left_property.id());
-  for (const auto& right_property : right) {
-    if (left_set.count(right_property.id()))
-      continue;
-    Add(left, right_property.id(), right_property.value());
+  auto has_new_property = false;
+  PropertySet::Bits bits;
+  for (size_t index = 0; index < bits.size(); ++index) {
+    bits[index] = left->bits_[index] | right.bits_[index];
+    has_new_property |= bits[index] != left->bits_[index];
   }
+  if (!has_new_property)
+    return;
+  std::vector<Value> values;
+  values.reserve(left->values_.size() + right.values_.size());
+  auto left_index = size_t{0};
+  auto right_index = size_t{0};
+  for (size_t id = 0; id <= kMaxPropertyId; ++id) {
+    const auto in_left = left->IsPresent(id);
+    const auto in_right = right.IsPresent(id);
+    if (in_left)
+      values.push_back(std::move(left->values_[left_index++]));
+    else if (in_right)
+      values.push_back(right.values_[right_index]);
+    if (in_right)
+      ++right_index;
+  }
+  left->bits_ = bits;
+  left->values_ = std::move(values);
 }
 
 void Editor::Remove(PropertySet* property_set, PropertyId property_id) {
-  auto& properties = property_set->properties_;
-  const auto& it = std::find_if(properties.begin(), properties.end(),
-                                [property_id](const Property& property) {
-                                  return property.id() == property_id;
-                                });
-  DCHECK(it != properties.end()) << "Property '" << property_id << "' isn't in "
-                                 << *property_set;
-  std::move(std::next(it), properties.end(), it);
-  properties.resize(properties.size() - 1);
+  DCHECK(property_set->Contains(property_id))
+      << "Property '" << property_id << "' isn't in " << *property_set;
+  const auto id = static_cast<size_t>(property_id);
+  auto& values = property_set->values_;
+  values.erase(values.begin() + property_set->IndexOf(id));
+  property_set->bits_[id / PropertySet::kBitsPerWord] &=
+      ~(uint64_t{1} << (id % PropertySet::kBitsPerWord));
 }
 
 void Editor::Set(PropertySet* property_set,
                  PropertyId property_id,
                  const Value& new_value) {
-  auto& properties = property_set->properties_;
-  const auto& it = std::find_if(properties.begin(), properties.end(),
-                                [property_id](const Property& property) {
-                                  return property.id() == property_id;
-                                });
-  if (it == properties.end()) {
-    properties.emplace_back(Property(property_id, new_value));
-    return;
-  }
-  Property::Editor().SetValue(&*it, new_value);
+  if (!property_set->Contains(property_id))
+    return Add(property_set, property_id, new_value);
+  const auto id = static_cast<size_t>(property_id);
+  property_set->values_[property_set->IndexOf(id)] = new_value;
 }
 
 #define V(Name, name, type, text)                                         \
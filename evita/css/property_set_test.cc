@@ -2,6 +2,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <vector>
+
 #include "evita/css/property_set.h"
 
 #include "evita/css/properties.h"
@@ -19,7 +22,7 @@ class PropertySetTest : public ::testing::Test {
   ~PropertySetTest() override = default;
 
   size_t NumberOfProperties(const PropertySet& property_set) const {
-    return property_set.properties_.size();
+    return property_set.values_.size();
   }
 };
 
@@ -127,6 +130,22 @@ TEST_F(PropertySetTest, Equals) {
       << "Order of properties doesn't matter for equality.";
 }
 
+TEST_F(PropertySetTest, Iterator) {
+  PropertySet set1 = PropertySet::Builder()
+                         .AddInteger(PropertyId::Width, 456)
+                         .AddInteger(PropertyId::Height, 123)
+                         .AddKeyword(PropertyId::Display, Keyword::None)
+                         .Build();
+  std::vector<PropertyId> ids;
+  for (const auto& property : set1)
+    ids.push_back(property.id());
+  std::vector<PropertyId> expected{PropertyId::Display, PropertyId::Height,
+                                   PropertyId::Width};
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(expected, ids) << "Properties are in order of property id.";
+  EXPECT_EQ(PropertySet().begin(), PropertySet().end());
+}
+
 TEST_F(PropertySetTest, Integer) {
   PropertySet set1 = PropertySet::Builder()
                          .AddInteger(PropertyId::Height, 100)
@@ -147,6 +166,31 @@ TEST_F(PropertySetTest, Keyword) {
   EXPECT_TRUE(set1.ValueOf(PropertyId::Width).is_inherit());
 }
 
+TEST_F(PropertySetTest, Merge) {
+  PropertySet set1 = PropertySet::Builder()
+                         .AddInteger(PropertyId::Height, 123)
+                         .AddKeyword(PropertyId::Display, Keyword::None)
+                         .Build();
+  PropertySet set2 = PropertySet::Builder()
+                         .AddInteger(PropertyId::Height, 789)
+                         .AddInteger(PropertyId::Width, 456)
+                         .AddColor(PropertyId::Color,
+                                   ColorValue::Rgba(128, 192, 128))
+                         .Build();
+
+  PropertySet::Editor().Merge(&set1, set2);
+  EXPECT_EQ(4u, NumberOfProperties(set1));
+  EXPECT_EQ(Value(123), set1.ValueOf(PropertyId::Height))
+      << "Merge doesn't override existing property.";
+  EXPECT_EQ(Value(456), set1.ValueOf(PropertyId::Width));
+  EXPECT_EQ(Value(Keyword::None), set1.ValueOf(PropertyId::Display));
+  EXPECT_EQ(Value(ColorValue::Rgba(128, 192, 128)),
+            set1.ValueOf(PropertyId::Color));
+
+  PropertySet::Editor().Merge(&set1, set2);
+  EXPECT_EQ(4u, NumberOfProperties(set1));
+}
+
 TEST_F(PropertySetTest, Number) {
   PropertySet set1 = PropertySet::Builder()
                          .AddNumber(PropertyId::Height, 1.5f)
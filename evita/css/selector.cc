@@ -95,6 +95,14 @@ bool Selector::operator<(const Selector& other) const {
   return false;
 }
 
+size_t Selector::hash_value() const {
+  auto hash_code = tag_name_.hash_value();
+  hash_code ^= id_.hash_value() >> 3;
+  for (const auto& class_name : classes_)
+    hash_code = (hash_code << 5) ^ (hash_code >> 3) ^ class_name.hash_value();
+  return hash_code;
+}
+
 bool Selector::IsMoreSpecific(const Selector& other) const {
   if (id_ != other.id_)
     return !other.has_id();
@@ -5,6 +5,7 @@
 #ifndef EVITA_CSS_SELECTOR_H_
 #define EVITA_CSS_SELECTOR_H_
 
+#include <functional>
 #include <iosfwd>
 #include <set>
 
@@ -42,6 +43,10 @@ class Selector final {
   base::AtomicString tag_name() const { return tag_name_; }
   const std::set<base::AtomicString>& classes() const { return classes_; }
 
+  // Returns hash code computed from atomic strings of tag name, id and
+  // classes.
+  size_t hash_value() const;
+
   bool IsMoreSpecific(const Selector& other) const;
 
   // Returns true if set of elements selected by |this| selector is subset of
@@ -60,4 +65,19 @@ std::ostream& operator<<(std::ostream& ostream, const Selector& selector);
 
 }  // namespace css
 
+namespace std {
+
+//////////////////////////////////////////////////////////////////////
+//
+// std::hash<css::Selector>
+//
+template <>
+struct hash<css::Selector> {
+  size_t operator()(const css::Selector& selector) const {
+    return selector.hash_value();
+  }
+};
+
+}  // namespace std
+
 #endif  // EVITA_CSS_SELECTOR_H_
@@ -254,6 +254,15 @@ TEST(CssSelctorTest, ParseError) {
   EXPECT_EQ(L"Bad class", AsParseError(L".ab#"));
 }
 
+TEST(CssSelctorTest, hash_value) {
+  EXPECT_EQ(Parse("*").hash_value(), Selector().hash_value());
+  EXPECT_EQ(Parse("foo#bar.c1.c2").hash_value(),
+            Parse("foo#bar.c2.c1").hash_value());
+  EXPECT_NE(Parse("foo").hash_value(), Parse("bar").hash_value());
+  EXPECT_NE(Parse("foo.c1").hash_value(), Parse("foo.c2").hash_value());
+  EXPECT_NE(Parse("foo.c1").hash_value(), Parse("foo.c1.c2").hash_value());
+}
+
 TEST(CssSelctorTest, is_universal) {
   EXPECT_TRUE(Parse("*").is_universal());
   EXPECT_TRUE(Parse("*#bar").is_universal());
@@ -35,6 +35,8 @@ class Style final {
 
   const PropertySet& properties() const { return properties_; }
 
+  size_t hash_value() const { return properties_.hash_value(); }
+
 #define V(Name, name, type, text) \
   type name() const;              \
   bool has_##name() const;
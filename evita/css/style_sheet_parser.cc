@@ -0,0 +1,249 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <utility>
+
+#include "evita/css/style_sheet_parser.h"
+
+#include "base/logging.h"
+#include "base/strings/string16.h"
+#include "evita/css/properties.h"
+#include "evita/css/property.h"
+#include "evita/css/property_set.h"
+#include "evita/css/selector_parser.h"
+#include "evita/css/style.h"
+#include "evita/css/style_editor.h"
+#include "evita/css/style_sheet.h"
+#include "evita/css/values/value.h"
+
+namespace css {
+
+namespace {
+
+const base::StringPiece16 kSides[] = {L"-bottom", L"-left", L"-right",
+                                      L"-top"};
+
+// Reads tokens until right brace matching with already read left brace
+// into |tokens| except for whitespace and the last right brace.
+void ReadBlock(Tokenizer* tokenizer, std::vector<Token>* tokens) {
+  auto depth = 0;
+  for (;;) {
+    const auto& token = tokenizer->NextToken();
+    switch (token.type()) {
+      case Token::Type::End:
+        return;
+      case Token::Type::LeftBrace:
+        ++depth;
+        break;
+      case Token::Type::RightBrace:
+        if (depth == 0)
+          return;
+        --depth;
+        break;
+      case Token::Type::Whitespace:
+        continue;
+      default:
+        break;
+    }
+    tokens->push_back(token);
+  }
+}
+
+// Skips at-rule, e.g. "@import ...;", "@media ... { ... }", since we don't
+// support them yet.
+void SkipAtRule(Tokenizer* tokenizer) {
+  std::vector<Token> block;
+  for (;;) {
+    const auto& token = tokenizer->NextToken();
+    if (token.is(Token::Type::End) || token.is(Token::Type::Semicolon))
+      return;
+    if (token.is(Token::Type::LeftBrace))
+      return ReadBlock(tokenizer, &block);
+  }
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// StyleSheetParser::ValueParser
+//
+StyleSheetParser::ValueParser::ValueParser() = default;
+StyleSheetParser::ValueParser::~ValueParser() = default;
+
+//////////////////////////////////////////////////////////////////////
+//
+// StyleSheetParser
+//
+StyleSheetParser::StyleSheetParser(StyleSheet* style_sheet,
+                                   const ValueParser& value_parser)
+    : style_sheet_(style_sheet), value_parser_(value_parser) {}
+
+StyleSheetParser::~StyleSheetParser() = default;
+
+void StyleSheetParser::AppendRule(base::StringPiece16 selector_text,
+                                  const std::vector<Token>& block) {
+  Selector::Parser selector_parser;
+  const auto& selector = selector_parser.Parse(selector_text);
+  if (!selector_parser.error().empty())
+    return;
+  auto style = std::make_unique<Style>();
+  auto it = block.begin();
+  while (it != block.end()) {
+    auto end = it;
+    while (end != block.end() && !end->is(Token::Type::Semicolon))
+      ++end;
+    // Declaration is "name ':' value+ ['!' important]".
+    std::vector<Token> values(it, end);
+    if (values.size() >= 2 && values[values.size() - 2].text() == L"!" &&
+        values.back().text() == L"important") {
+      values.resize(values.size() - 2);
+    }
+    if (values.size() >= 3 && values[0].is(Token::Type::Ident) &&
+        values[1].is(Token::Type::Colon)) {
+      const auto name = values[0].text();
+      values.erase(values.begin(), values.begin() + 2);
+      ParseDeclaration(style.get(), name, values);
+    }
+    it = end == block.end() ? end : end + 1;
+  }
+  if (style->properties().begin() == style->properties().end())
+    return;
+  style_sheet_->AppendRule(selector, std::move(style));
+  ++num_rules_;
+}
+
+size_t StyleSheetParser::Parse(base::StringPiece16 source) {
+  const auto num_rules_start = num_rules_;
+  Tokenizer tokenizer(source);
+  base::string16 selector_text;
+  std::vector<Token> block;
+  for (;;) {
+    const auto& token = tokenizer.NextToken();
+    switch (token.type()) {
+      case Token::Type::AtKeyword:
+        SkipAtRule(&tokenizer);
+        selector_text.clear();
+        continue;
+      case Token::Type::End:
+        return num_rules_ - num_rules_start;
+      case Token::Type::LeftBrace:
+        block.clear();
+        ReadBlock(&tokenizer, &block);
+        AppendRule(selector_text, block);
+        selector_text.clear();
+        continue;
+      case Token::Type::RightBrace:
+        selector_text.clear();
+        continue;
+      case Token::Type::Whitespace:
+        // Since |Selector| has no combinator, we join compound selectors as
+        // "css.Parser", e.g. "div ::first-letter" to "div::first-letter".
+        continue;
+      default:
+        token.text().AppendToString(&selector_text);
+        continue;
+    }
+  }
+}
+
+void StyleSheetParser::ParseDeclaration(Style* style,
+                                        base::StringPiece16 name,
+                                        const std::vector<Token>& values) {
+  DCHECK(!values.empty());
+  if (name == L"border") {
+    for (const auto& side : kSides) {
+      ParseShorthand(style, name.as_string() + side.as_string(), values,
+                     {L"color", L"style", L"width"});
+    }
+    return;
+  }
+  if (name == L"border-color")
+    return ParseRepeat1To4(style, L"border", L"-color", values);
+  if (name == L"border-style")
+    return ParseRepeat1To4(style, L"border", L"-style", values);
+  if (name == L"border-width")
+    return ParseRepeat1To4(style, L"border", L"-width", values);
+  if (name == L"margin" || name == L"padding")
+    return ParseRepeat1To4(style, name, L"", values);
+  if (name == L"border-bottom" || name == L"border-left" ||
+      name == L"border-right" || name == L"border-top") {
+    return ParseShorthand(style, name, values, {L"color", L"style", L"width"});
+  }
+  if (name == L"text-decoration")
+    return ParseShorthand(style, name, values, {L"color", L"line", L"style"});
+  if (name == L"font-family") {
+    base::string16 text;
+    for (const auto& value : values)
+      value.text().AppendToString(&text);
+    SetValue(style, name, text);
+    return;
+  }
+  SetValue(style, name, values.front().text());
+}
+
+// Parses "prefix-{top,right,bottom,left}suffix" from 1, 2 or 4 values, e.g.
+// "margin: 1px 2px" to "margin-top: 1px; margin-right: 2px;
+// margin-bottom: 1px; margin-left: 2px". As "css.Parser" in JavaScript, we
+// ignore declaration with 3 values.
+void StyleSheetParser::ParseRepeat1To4(Style* style,
+                                       base::StringPiece16 prefix,
+                                       base::StringPiece16 suffix,
+                                       const std::vector<Token>& values) {
+  static const size_t kIndexes[4][4] = {
+      {0, 0, 0, 0}, {0, 1, 0, 1}, {0, 0, 0, 0}, {0, 1, 2, 3}};
+  static const base::StringPiece16 kClockwiseSides[] = {L"-top", L"-right",
+                                                        L"-bottom", L"-left"};
+  if (values.size() == 3 || values.size() > 4)
+    return;
+  const auto& indexes = kIndexes[values.size() - 1];
+  for (auto side = 0; side < 4; ++side) {
+    SetValue(style, prefix.as_string() + kClockwiseSides[side].as_string() +
+                        suffix.as_string(),
+             values[indexes[side]].text());
+  }
+}
+
+// Assigns each value to the first longhand "name-type" accepting it, e.g.
+// "border-top: solid 1px red" to "border-top-style: solid;
+// border-top-width: 1px; border-top-color: red".
+void StyleSheetParser::ParseShorthand(
+    Style* style,
+    base::StringPiece16 name,
+    const std::vector<Token>& values,
+    const std::vector<base::StringPiece16>& types) {
+  std::vector<bool> used(types.size());
+  for (const auto& value : values) {
+    for (size_t index = 0; index < types.size(); ++index) {
+      if (used[index])
+        continue;
+      const auto& property_name =
+          name.as_string() + L"-" + types[index].as_string();
+      if (!SetValue(style, property_name, value.text()))
+        continue;
+      used[index] = true;
+      break;
+    }
+  }
+}
+
+// Returns true if |text| is valid for property |name|. Property is set if
+// |style| doesn't have it yet.
+bool StyleSheetParser::SetValue(Style* style,
+                                base::StringPiece16 name,
+                                base::StringPiece16 text) {
+  const auto property_id = Property::IdOf(name);
+  if (property_id == PropertyId::Invalid)
+    return false;
+  const auto& value = value_parser_.Parse(property_id, text);
+  if (value.is_unspecified())
+    return false;
+  if (style->properties().Contains(property_id))
+    return true;
+  StyleEditor().Set(style, property_id, value);
+  return true;
+}
+
+}  // namespace css
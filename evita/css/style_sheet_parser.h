@@ -0,0 +1,87 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_CSS_STYLE_SHEET_PARSER_H_
+#define EVITA_CSS_STYLE_SHEET_PARSER_H_
+
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+#include "evita/css/tokenizer.h"
+
+namespace css {
+
+enum class PropertyId : uint32_t;
+class Style;
+class StyleSheet;
+class Value;
+
+//////////////////////////////////////////////////////////////////////
+//
+// StyleSheetParser
+// Parses CSS source and appends style rules to |StyleSheet| without going
+// through script. Rules having no valid property are dropped, and the first
+// declaration of a property in a rule wins, as "css.Parser" in script.
+//
+// Parsing property value depends on property type, which is implemented by
+// embedder, e.g. "dom", via |ValueParser|.
+//
+class StyleSheetParser final {
+ public:
+  //////////////////////////////////////////////////////////////////////
+  //
+  // StyleSheetParser::ValueParser
+  //
+  class ValueParser {
+   public:
+    virtual ~ValueParser();
+
+    // Returns value of property |property_id| represented by |text|, or
+    // unspecified value if |text| isn't valid for |property_id|.
+    virtual Value Parse(PropertyId property_id,
+                        base::StringPiece16 text) const = 0;
+
+   protected:
+    ValueParser();
+
+   private:
+    DISALLOW_COPY_AND_ASSIGN(ValueParser);
+  };
+
+  StyleSheetParser(StyleSheet* style_sheet, const ValueParser& value_parser);
+  ~StyleSheetParser();
+
+  // Appends style rules in |source| to style sheet and returns number of
+  // appended rules.
+  size_t Parse(base::StringPiece16 source);
+
+ private:
+  void AppendRule(base::StringPiece16 selector_text,
+                  const std::vector<Token>& block);
+  void ParseDeclaration(Style* style,
+                        base::StringPiece16 name,
+                        const std::vector<Token>& values);
+  void ParseRepeat1To4(Style* style,
+                       base::StringPiece16 prefix,
+                       base::StringPiece16 suffix,
+                       const std::vector<Token>& values);
+  void ParseShorthand(Style* style,
+                      base::StringPiece16 name,
+                      const std::vector<Token>& values,
+                      const std::vector<base::StringPiece16>& types);
+  bool SetValue(Style* style,
+                base::StringPiece16 name,
+                base::StringPiece16 text);
+
+  size_t num_rules_ = 0;
+  StyleSheet* const style_sheet_;
+  const ValueParser& value_parser_;
+
+  DISALLOW_COPY_AND_ASSIGN(StyleSheetParser);
+};
+
+}  // namespace css
+
+#endif  // EVITA_CSS_STYLE_SHEET_PARSER_H_
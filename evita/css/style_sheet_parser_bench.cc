@@ -0,0 +1,149 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures |StyleSheetParser| on generated style sheet like highlight theme.
+//
+// Usage: style_sheet_parser_bench [--rules=N] [--iterations=N] [file]
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#include "evita/css/style_sheet.h"
+#include "evita/css/style_sheet_parser.h"
+#include "evita/css/tokenizer.h"
+#include "evita/css/values/value.h"
+
+namespace css {
+
+namespace {
+
+const auto kDefaultIterations = 100;
+const auto kDefaultNumberOfRules = 1000;
+
+//////////////////////////////////////////////////////////////////////
+//
+// StringValueParser
+// Accepts any text as string value, since value parsers are implemented
+// in "dom".
+//
+class StringValueParser final : public StyleSheetParser::ValueParser {
+ public:
+  StringValueParser() = default;
+  ~StringValueParser() final = default;
+
+ private:
+  // StyleSheetParser::ValueParser
+  Value Parse(PropertyId property_id, base::StringPiece16 text) const final {
+    return Value(text);
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(StringValueParser);
+};
+
+base::string16 GenerateStyleSheet(int num_rules) {
+  static const char* const kDeclarations[] = {
+      "color: #A31515;",
+      "background-color: #FFF;",
+      "font-family: Consolas, Meiryo;",
+      "font-weight: bold;",
+      "border: 1px solid #CCC;",
+      "margin: 1px 2px;",
+      "text-decoration: underline wavy red;",
+  };
+  std::string source;
+  for (auto index = 0; index < num_rules; ++index) {
+    source += "/* rule " + base::IntToString(index) + " */\n";
+    source += "syntax_" + base::IntToString(index) + ".c" +
+              base::IntToString(index % 7) + " {";
+    for (auto count = 0; count <= index % 4; ++count) {
+      source += ' ';
+      source += kDeclarations[(index + count) % arraysize(kDeclarations)];
+    }
+    source += " }\n";
+  }
+  return base::UTF8ToUTF16(source);
+}
+
+base::string16 LoadStyleSheet(const base::CommandLine& command_line) {
+  const auto& args = command_line.GetArgs();
+  if (args.empty()) {
+    auto num_rules = kDefaultNumberOfRules;
+    if (command_line.HasSwitch("rules"))
+      base::StringToInt(command_line.GetSwitchValueASCII("rules"), &num_rules);
+    return GenerateStyleSheet(num_rules);
+  }
+  std::string contents;
+  const auto& file_path = base::FilePath(args[0]);
+  if (!base::ReadFileToString(file_path, &contents)) {
+    LOG(ERROR) << "Failed to read " << file_path.value();
+    return base::string16();
+  }
+  return base::UTF8ToUTF16(contents);
+}
+
+void Report(const char* name,
+            const base::TimeDelta& elapsed,
+            int iterations,
+            size_t num_items,
+            const char* unit) {
+  std::cout << std::left << std::setw(10) << name << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10)
+            << elapsed.InMillisecondsF() / iterations << " ms "
+            << std::setw(10) << num_items << ' ' << unit << ' '
+            << std::setw(10)
+            << elapsed.InMicrosecondsF() / iterations / (num_items ? num_items
+                                                                   : 1)
+            << " us/" << unit << std::endl;
+}
+
+void Run(const base::string16& source, int iterations) {
+  size_t num_tokens = 0;
+  const auto& tokenize_start = base::TimeTicks::Now();
+  for (auto count = 0; count < iterations; ++count) {
+    Tokenizer tokenizer(source);
+    num_tokens = 0;
+    while (!tokenizer.NextToken().is(Token::Type::End))
+      ++num_tokens;
+  }
+  Report("tokenize", base::TimeTicks::Now() - tokenize_start, iterations,
+         num_tokens, "token");
+
+  StringValueParser value_parser;
+  size_t num_rules = 0;
+  const auto& parse_start = base::TimeTicks::Now();
+  for (auto count = 0; count < iterations; ++count) {
+    const auto& style_sheet = std::make_unique<StyleSheet>();
+    num_rules = StyleSheetParser(style_sheet.get(), value_parser).Parse(source);
+  }
+  Report("parse", base::TimeTicks::Now() - parse_start, iterations, num_rules,
+         "rule");
+}
+
+}  // namespace
+
+}  // namespace css
+
+int main(int argc, char** argv) {
+  base::AtExitManager at_exit;
+  base::CommandLine::Init(argc, argv);
+  const auto& command_line = *base::CommandLine::ForCurrentProcess();
+  auto iterations = css::kDefaultIterations;
+  if (command_line.HasSwitch("iterations")) {
+    base::StringToInt(command_line.GetSwitchValueASCII("iterations"),
+                      &iterations);
+  }
+  css::Run(css::LoadStyleSheet(command_line), iterations);
+  return 0;
+}
@@ -0,0 +1,202 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+
+#include "base/macros.h"
+#include "base/strings/string16.h"
+#include "base/strings/string_util.h"
+#include "base/strings/utf_string_conversions.h"
+#include "evita/css/properties.h"
+#include "evita/css/property.h"
+#include "evita/css/property_set.h"
+#include "evita/css/rule.h"
+#include "evita/css/selector.h"
+#include "evita/css/style.h"
+#include "evita/css/style_sheet.h"
+#include "evita/css/style_sheet_parser.h"
+#include "evita/css/values/value.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace css {
+
+namespace {
+
+//////////////////////////////////////////////////////////////////////
+//
+// FakeValueParser
+// Accepts "#..." and "red" for color, "solid" for style, "<n>px" for width
+// and any text for other properties, as string value.
+//
+class FakeValueParser final : public StyleSheetParser::ValueParser {
+ public:
+  FakeValueParser() = default;
+  ~FakeValueParser() final = default;
+
+ private:
+  // StyleSheetParser::ValueParser
+  Value Parse(PropertyId property_id, base::StringPiece16 text) const final;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeValueParser);
+};
+
+Value FakeValueParser::Parse(PropertyId property_id,
+                             base::StringPiece16 text) const {
+  const auto& name = Property::NameOf(property_id);
+  const auto& is_valid = [&]() {
+    if (base::EndsWith(name, L"color", base::CompareCase::SENSITIVE))
+      return text.starts_with(L"#") || text == L"red";
+    if (base::EndsWith(name, L"-style", base::CompareCase::SENSITIVE))
+      return text == L"solid";
+    if (base::EndsWith(name, L"-width", base::CompareCase::SENSITIVE))
+      return text.ends_with(L"px");
+    return true;
+  };
+  return is_valid() ? Value(text) : Value();
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// StyleSheetParserTest
+//
+class StyleSheetParserTest : public ::testing::Test {
+ protected:
+  StyleSheetParserTest() : style_sheet_(new StyleSheet()) {}
+  ~StyleSheetParserTest() override = default;
+
+  // Returns "top right bottom left" margins of |index|-th rule.
+  std::string MarginOf(size_t index) const;
+  size_t Parse(base::StringPiece16 source);
+
+  // Returns "selector { name: value; ... }" of |index|-th rule.
+  std::string RuleAt(size_t index) const;
+
+  // Returns value of property |name| of |index|-th rule, or "-" if rule
+  // doesn't have it.
+  std::string ValueOf(size_t index, base::StringPiece16 name) const;
+
+ private:
+  const std::unique_ptr<StyleSheet> style_sheet_;
+  FakeValueParser value_parser_;
+
+  DISALLOW_COPY_AND_ASSIGN(StyleSheetParserTest);
+};
+
+std::string StyleSheetParserTest::MarginOf(size_t index) const {
+  return ValueOf(index, L"margin-top") + " " +
+         ValueOf(index, L"margin-right") + " " +
+         ValueOf(index, L"margin-bottom") + " " +
+         ValueOf(index, L"margin-left");
+}
+
+size_t StyleSheetParserTest::Parse(base::StringPiece16 source) {
+  return StyleSheetParser(style_sheet_.get(), value_parser_).Parse(source);
+}
+
+std::string StyleSheetParserTest::RuleAt(size_t index) const {
+  const auto& rule = *style_sheet_->rules()[index];
+  auto result = base::UTF16ToUTF8(rule.selector().ToString()) + " {";
+  for (const auto& property : rule.style().properties()) {
+    result += " " + base::UTF16ToUTF8(property.name()) + ": " +
+              base::UTF16ToUTF8(property.value().string_value()) + ";";
+  }
+  return result + " }";
+}
+
+std::string StyleSheetParserTest::ValueOf(size_t index,
+                                          base::StringPiece16 name) const {
+  const auto& properties = style_sheet_->rules()[index]->style().properties();
+  const auto property_id = Property::IdOf(name);
+  if (!properties.Contains(property_id))
+    return "-";
+  return base::UTF16ToUTF8(properties.ValueOf(property_id).string_value());
+}
+
+TEST_F(StyleSheetParserTest, AtRule) {
+  EXPECT_EQ(1u, Parse(L"@import 'foo.css'; @media print { a { color: red } }"
+                      L" b { color: red }"));
+  EXPECT_EQ("b { color: red; }", RuleAt(0));
+}
+
+TEST_F(StyleSheetParserTest, Basic) {
+  EXPECT_EQ(2u, Parse(L"foo {color: red} bar {color: #00F}"
+                      L" /* baz {color: #0F0} */"));
+  EXPECT_EQ("foo { color: red; }", RuleAt(0));
+  EXPECT_EQ("bar { color: #00F; }", RuleAt(1));
+}
+
+TEST_F(StyleSheetParserTest, Border) {
+  EXPECT_EQ(1u, Parse(L"a { border: 1px solid red }"));
+  EXPECT_EQ("1px", ValueOf(0, L"border-top-width"));
+  EXPECT_EQ("solid", ValueOf(0, L"border-left-style"));
+  EXPECT_EQ("red", ValueOf(0, L"border-bottom-color"));
+  EXPECT_EQ("1px", ValueOf(0, L"border-right-width"));
+}
+
+TEST_F(StyleSheetParserTest, Empty) {
+  EXPECT_EQ(1u, Parse(L"foo {} foo {color: red;} bar { unknown: 1 }"));
+  EXPECT_EQ("foo { color: red; }", RuleAt(0));
+}
+
+TEST_F(StyleSheetParserTest, FirstWins) {
+  EXPECT_EQ(1u, Parse(L"foo { color: red; color: #00F !important }"));
+  EXPECT_EQ("foo { color: red; }", RuleAt(0));
+}
+
+TEST_F(StyleSheetParserTest, InvalidDeclaration) {
+  EXPECT_EQ(1u, Parse(L"foo { color; color: blue; : red; color: red }"));
+  EXPECT_EQ("foo { color: red; }", RuleAt(0));
+}
+
+TEST_F(StyleSheetParserTest, InvalidSelector) {
+  EXPECT_EQ(1u, Parse(L"a..b { color: red } b { color: red }"));
+  EXPECT_EQ("b { color: red; }", RuleAt(0));
+}
+
+TEST_F(StyleSheetParserTest, Margin) {
+  EXPECT_EQ(4u, Parse(L"a { margin: 1px } b { margin: 1px 2px }"
+                      L" c { margin: 1px 2px 3px }"
+                      L" d { margin: 1px 2px 3px 4px }"));
+  EXPECT_EQ("1px 1px 1px 1px", MarginOf(0));
+  EXPECT_EQ("1px 2px 1px 2px", MarginOf(1));
+  EXPECT_EQ("- - - -", MarginOf(2)) << "3 values aren't allowed.";
+  EXPECT_EQ("1px 2px 3px 4px", MarginOf(3));
+}
+
+TEST_F(StyleSheetParserTest, Margin3Values) {
+  EXPECT_EQ(1u, Parse(L"a { margin: 1px 2px 3px; padding: 1px 2px 3px;"
+                      L" border-width: 1px 2px 3px; color: red }"));
+  EXPECT_EQ("a { color: red; }", RuleAt(0));
+}
+
+TEST_F(StyleSheetParserTest, NotMerge) {
+  EXPECT_EQ(2u, Parse(L"foo {color: red} foo {color: #00F}"));
+  EXPECT_EQ("foo { color: red; }", RuleAt(0));
+  EXPECT_EQ("foo { color: #00F; }", RuleAt(1));
+}
+
+TEST_F(StyleSheetParserTest, Selector) {
+  EXPECT_EQ(3u, Parse(L"* { color: red } .hover { color: red }"
+                      L" :hover { color: red }"));
+  EXPECT_EQ("* { color: red; }", RuleAt(0));
+  EXPECT_EQ(".hover { color: red; }", RuleAt(1));
+  EXPECT_EQ(":hover { color: red; }", RuleAt(2));
+}
+
+TEST_F(StyleSheetParserTest, Shorthand) {
+  EXPECT_EQ(1u, Parse(L"a { border-top: red 2px }"));
+  EXPECT_EQ("red", ValueOf(0, L"border-top-color"));
+  EXPECT_EQ("-", ValueOf(0, L"border-top-style"));
+  EXPECT_EQ("2px", ValueOf(0, L"border-top-width"));
+}
+
+TEST_F(StyleSheetParserTest, Whitespace) {
+  EXPECT_EQ(1u, Parse(L"div .foo { color: red }"));
+  EXPECT_EQ("div.foo { color: red; }", RuleAt(0));
+}
+
+}  // namespace css
@@ -20,6 +20,21 @@ TEST(StyleTest, has) {
   EXPECT_FALSE(style1->has_color());
 }
 
+TEST(StyleTest, hash_value) {
+  const auto& style1 = StyleBuilder()
+                           .SetColor(ColorValue(1, 0, 0))
+                           .SetFontFamily(FontFamily(String(L"Arial")))
+                           .Build();
+  const auto& style2 = StyleBuilder()
+                           .SetFontFamily(FontFamily(String(L"Arial")))
+                           .SetColor(ColorValue(1, 0, 0))
+                           .Build();
+  const auto& style3 = StyleBuilder().SetColor(ColorValue(0, 1, 0)).Build();
+
+  EXPECT_EQ(style1->hash_value(), style2->hash_value());
+  EXPECT_NE(style1->hash_value(), style3->hash_value());
+}
+
 TEST(StyleTest, Equals) {
   const auto& style1 = StyleBuilder().Build();
   const auto& style2 = StyleBuilder().SetColor(ColorValue(1, 0, 0)).Build();
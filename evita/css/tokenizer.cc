@@ -0,0 +1,248 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <ostream>
+
+#include "evita/css/tokenizer.h"
+
+#include "base/logging.h"
+#include "base/strings/utf_string_conversions.h"
+
+namespace css {
+
+namespace {
+
+bool IsDigitChar(base::char16 ch) {
+  return ch >= '0' && ch <= '9';
+}
+
+bool IsNameStartChar(base::char16 ch) {
+  if (ch >= 'A' && ch <= 'Z')
+    return true;
+  if (ch >= 'a' && ch <= 'z')
+    return true;
+  if (ch == '_')
+    return true;
+  return ch >= 0x80;
+}
+
+bool IsNameChar(base::char16 ch) {
+  return IsNameStartChar(ch) || IsDigitChar(ch) || ch == '-';
+}
+
+bool IsWhitespaceChar(base::char16 ch) {
+  return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\f';
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// Token
+//
+Token::Token(Type type, base::StringPiece16 text, size_t offset)
+    : offset_(offset), text_(text), type_(type) {}
+
+Token::Token(const Token& other) = default;
+Token::~Token() = default;
+
+Token& Token::operator=(const Token& other) = default;
+
+bool Token::operator==(const Token& other) const {
+  return type_ == other.type_ && offset_ == other.offset_ &&
+         text_ == other.text_;
+}
+
+bool Token::operator!=(const Token& other) const {
+  return !operator==(other);
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// Tokenizer
+//
+Tokenizer::Tokenizer(base::StringPiece16 source) : source_(source) {}
+Tokenizer::~Tokenizer() = default;
+
+base::char16 Tokenizer::CharAt(size_t offset) const {
+  return offset < source_.size() ? source_[offset] : 0;
+}
+
+// Returns true if an identifier starts at |offset|, e.g. "foo", "-foo",
+// "--foo".
+bool Tokenizer::IsNameStartAt(size_t offset) const {
+  const auto ch = CharAt(offset);
+  if (ch != '-')
+    return IsNameStartChar(ch);
+  const auto next = CharAt(offset + 1);
+  return next == '-' || IsNameStartChar(next);
+}
+
+// Returns true if a number starts at |offset|, e.g. "1", ".5", "-1", "+.5".
+bool Tokenizer::IsNumberStartAt(size_t offset) const {
+  auto ch = CharAt(offset);
+  if (ch == '+' || ch == '-')
+    ch = CharAt(++offset);
+  if (IsDigitChar(ch))
+    return true;
+  return ch == '.' && IsDigitChar(CharAt(offset + 1));
+}
+
+Token Tokenizer::MakeToken(Token::Type type, size_t start) {
+  DCHECK_LE(start, position_);
+  return Token(type, source_.substr(start, position_ - start), start);
+}
+
+Token Tokenizer::NextToken() {
+  for (;;) {
+    const auto start = position_;
+    if (start >= source_.size())
+      return MakeToken(Token::Type::End, start);
+    const auto ch = source_[start];
+    if (ch == '/' && CharAt(start + 1) == '*') {
+      position_ = SkipComment(start + 2);
+      continue;
+    }
+    if (IsWhitespaceChar(ch)) {
+      position_ = start + 1;
+      while (IsWhitespaceChar(CharAt(position_)))
+        ++position_;
+      return MakeToken(Token::Type::Whitespace, start);
+    }
+    if (IsNumberStartAt(start)) {
+      position_ = SkipNumber(start);
+      if (CharAt(position_) == '%') {
+        ++position_;
+        return MakeToken(Token::Type::Percentage, start);
+      }
+      if (IsNameStartAt(position_)) {
+        position_ = SkipName(position_);
+        return MakeToken(Token::Type::Dimension, start);
+      }
+      return MakeToken(Token::Type::Number, start);
+    }
+    if (IsNameStartAt(start)) {
+      position_ = SkipName(start);
+      if (CharAt(position_) != '(')
+        return MakeToken(Token::Type::Ident, start);
+      ++position_;
+      return MakeToken(Token::Type::Function, start);
+    }
+    position_ = start + 1;
+    switch (ch) {
+      case '"':
+      case '\'':
+        position_ = SkipString(start);
+        return MakeToken(Token::Type::String, start);
+      case '#':
+        if (!IsNameChar(CharAt(position_)))
+          break;
+        position_ = SkipName(position_);
+        return MakeToken(Token::Type::Hash, start);
+      case '(':
+        return MakeToken(Token::Type::LeftParenthesis, start);
+      case ')':
+        return MakeToken(Token::Type::RightParenthesis, start);
+      case '*':
+        return MakeToken(Token::Type::Asterisk, start);
+      case ',':
+        return MakeToken(Token::Type::Comma, start);
+      case '.':
+        return MakeToken(Token::Type::Dot, start);
+      case ':':
+        if (CharAt(position_) != ':')
+          return MakeToken(Token::Type::Colon, start);
+        ++position_;
+        return MakeToken(Token::Type::DoubleColon, start);
+      case ';':
+        return MakeToken(Token::Type::Semicolon, start);
+      case '@':
+        if (!IsNameStartAt(position_))
+          break;
+        position_ = SkipName(position_);
+        return MakeToken(Token::Type::AtKeyword, start);
+      case '[':
+        return MakeToken(Token::Type::LeftBracket, start);
+      case ']':
+        return MakeToken(Token::Type::RightBracket, start);
+      case '{':
+        return MakeToken(Token::Type::LeftBrace, start);
+      case '}':
+        return MakeToken(Token::Type::RightBrace, start);
+    }
+    return MakeToken(Token::Type::Delim, start);
+  }
+}
+
+// Returns offset after "*/" or end of source for unterminated comment.
+size_t Tokenizer::SkipComment(size_t offset) const {
+  const auto end = source_.find(base::StringPiece16(L"*/"), offset);
+  return end == base::StringPiece16::npos ? source_.size() : end + 2;
+}
+
+size_t Tokenizer::SkipName(size_t offset) const {
+  while (IsNameChar(CharAt(offset)))
+    ++offset;
+  return offset;
+}
+
+size_t Tokenizer::SkipNumber(size_t offset) const {
+  DCHECK(IsNumberStartAt(offset));
+  if (CharAt(offset) == '+' || CharAt(offset) == '-')
+    ++offset;
+  while (IsDigitChar(CharAt(offset)))
+    ++offset;
+  if (CharAt(offset) == '.' && IsDigitChar(CharAt(offset + 1))) {
+    offset += 2;
+    while (IsDigitChar(CharAt(offset)))
+      ++offset;
+  }
+  const auto exponent = CharAt(offset);
+  if (exponent != 'e' && exponent != 'E')
+    return offset;
+  // Exponent, e.g. "1e3", "1e-3", but not "1em".
+  auto digits = offset + 1;
+  if (CharAt(digits) == '+' || CharAt(digits) == '-')
+    ++digits;
+  if (!IsDigitChar(CharAt(digits)))
+    return offset;
+  while (IsDigitChar(CharAt(digits)))
+    ++digits;
+  return digits;
+}
+
+// Returns offset after closing quote. Unterminated string ends before
+// newline or at end of source.
+size_t Tokenizer::SkipString(size_t offset) const {
+  const auto quote = source_[offset];
+  ++offset;
+  while (offset < source_.size()) {
+    const auto ch = source_[offset];
+    if (ch == quote)
+      return offset + 1;
+    if (ch == '\n')
+      return offset;
+    offset += ch == '\\' ? 2 : 1;
+  }
+  return source_.size();
+}
+
+std::ostream& operator<<(std::ostream& ostream, Token::Type type) {
+  static const char* const kTypeNames[] = {
+#define V(Name) #Name,
+      FOR_EACH_CSS_TOKEN_TYPE(V)
+#undef V
+  };
+  const auto index = static_cast<size_t>(type);
+  if (index >= arraysize(kTypeNames))
+    return ostream << "Token::Type(" << index << ')';
+  return ostream << kTypeNames[index];
+}
+
+std::ostream& operator<<(std::ostream& ostream, const Token& token) {
+  return ostream << token.type() << '('
+                 << base::UTF16ToUTF8(token.text().as_string()) << ')';
+}
+
+}  // namespace css
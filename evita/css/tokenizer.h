@@ -0,0 +1,110 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_CSS_TOKENIZER_H_
+#define EVITA_CSS_TOKENIZER_H_
+
+#include <iosfwd>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace css {
+
+#define FOR_EACH_CSS_TOKEN_TYPE(V) \
+  V(Asterisk)                      \
+  V(AtKeyword)                     \
+  V(Colon)                         \
+  V(Comma)                         \
+  V(Delim)                         \
+  V(Dimension)                     \
+  V(Dot)                           \
+  V(DoubleColon)                   \
+  V(End)                           \
+  V(Function)                      \
+  V(Hash)                          \
+  V(Ident)                         \
+  V(LeftBrace)                     \
+  V(LeftBracket)                   \
+  V(LeftParenthesis)               \
+  V(Number)                        \
+  V(Percentage)                    \
+  V(RightBrace)                    \
+  V(RightBracket)                  \
+  V(RightParenthesis)              \
+  V(Semicolon)                     \
+  V(String)                        \
+  V(Whitespace)
+
+//////////////////////////////////////////////////////////////////////
+//
+// Token
+// Represents a token of CSS source. |text| refers source text passed to
+// |Tokenizer|, e.g. "#F00" for hash, "'foo'" for string, "rgb(" for function.
+//
+class Token final {
+ public:
+  enum class Type {
+#define V(Name) Name,
+    FOR_EACH_CSS_TOKEN_TYPE(V)
+#undef V
+  };
+
+  Token(Type type, base::StringPiece16 text, size_t offset);
+  Token(const Token& other);
+  ~Token();
+
+  Token& operator=(const Token& other);
+
+  bool operator==(const Token& other) const;
+  bool operator!=(const Token& other) const;
+
+  bool is(Type type) const { return type_ == type; }
+  size_t offset() const { return offset_; }
+  base::StringPiece16 text() const { return text_; }
+  Type type() const { return type_; }
+
+ private:
+  size_t offset_;
+  base::StringPiece16 text_;
+  Type type_;
+};
+
+std::ostream& operator<<(std::ostream& ostream, Token::Type type);
+std::ostream& operator<<(std::ostream& ostream, const Token& token);
+
+//////////////////////////////////////////////////////////////////////
+//
+// Tokenizer
+// Splits CSS source into tokens without copying source. Comments are
+// skipped, and a run of whitespace characters is a |Whitespace| token.
+//
+class Tokenizer final {
+ public:
+  explicit Tokenizer(base::StringPiece16 source);
+  ~Tokenizer();
+
+  // Returns next token, or |End| token at end of source. Unterminated
+  // comment extends to end of source.
+  Token NextToken();
+
+ private:
+  base::char16 CharAt(size_t offset) const;
+  bool IsNameStartAt(size_t offset) const;
+  bool IsNumberStartAt(size_t offset) const;
+  Token MakeToken(Token::Type type, size_t start);
+  size_t SkipComment(size_t offset) const;
+  size_t SkipName(size_t offset) const;
+  size_t SkipNumber(size_t offset) const;
+  size_t SkipString(size_t offset) const;
+
+  size_t position_ = 0;
+  const base::StringPiece16 source_;
+
+  DISALLOW_COPY_AND_ASSIGN(Tokenizer);
+};
+
+}  // namespace css
+
+#endif  // EVITA_CSS_TOKENIZER_H_
@@ -0,0 +1,70 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <sstream>
+#include <string>
+
+#include "base/strings/string16.h"
+#include "evita/css/tokenizer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace css {
+
+namespace {
+
+// Returns space separated tokens in |source|.
+std::string Tokenize(base::StringPiece16 source) {
+  Tokenizer tokenizer(source);
+  std::ostringstream ostream;
+  auto delimiter = "";
+  for (;;) {
+    const auto& token = tokenizer.NextToken();
+    if (token.is(Token::Type::End))
+      return ostream.str();
+    ostream << delimiter << token;
+    delimiter = " ";
+  }
+}
+
+}  // namespace
+
+TEST(TokenizerTest, Comment) {
+  EXPECT_EQ("Ident(a) Whitespace( ) Ident(b)", Tokenize(L"a /* x */ b"));
+  EXPECT_EQ("Ident(a)", Tokenize(L"a/* unterminated"));
+}
+
+TEST(TokenizerTest, Hash) {
+  EXPECT_EQ("Hash(#F00) Hash(#foo)", Tokenize(L"#F00 #foo"));
+  EXPECT_EQ("Delim(#) Whitespace( )", Tokenize(L"# "));
+}
+
+TEST(TokenizerTest, Ident) {
+  EXPECT_EQ("Ident(foo) Ident(-bar) Ident(--baz) Ident(x_1)",
+            Tokenize(L"foo -bar --baz x_1"));
+  EXPECT_EQ("Function(rgb() Number(1) RightParenthesis())",
+            Tokenize(L"rgb(1)"));
+  EXPECT_EQ("AtKeyword(@media)", Tokenize(L"@media"));
+}
+
+TEST(TokenizerTest, Number) {
+  EXPECT_EQ("Number(1) Number(-2) Number(+.5) Number(1e3)",
+            Tokenize(L"1 -2 +.5 1e3"));
+  EXPECT_EQ("Dimension(10px) Dimension(1em) Percentage(50%)",
+            Tokenize(L"10px 1em 50%"));
+}
+
+TEST(TokenizerTest, Punctuation) {
+  EXPECT_EQ(
+      "Asterisk(*) Dot(.) DoubleColon(::) Colon(:) Comma(,) Semicolon(;) "
+      "LeftBrace({) RightBrace(}) LeftBracket([) RightBracket(]) Delim(!)",
+      Tokenize(L"*.:::,;{}[]!"));
+}
+
+TEST(TokenizerTest, String) {
+  EXPECT_EQ("String(\"a b\") String('c\\'d')",
+            Tokenize(L"\"a b\"'c\\'d'"));
+  EXPECT_EQ("String(\"ab) Whitespace(\n) Ident(c)", Tokenize(L"\"ab\nc"));
+}
+
+}  // namespace css
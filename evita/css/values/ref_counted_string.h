@@ -18,8 +18,11 @@ namespace css {
 //////////////////////////////////////////////////////////////////////
 //
 // RefCountedString
+// Reference count is thread safe since computed styles holding strings are
+// copied on style recalc worker threads.
 //
-class RefCountedString final : public base::RefCounted<RefCountedString> {
+class RefCountedString final
+    : public base::RefCountedThreadSafe<RefCountedString> {
  public:
   explicit RefCountedString(base::StringPiece16 data);
   RefCountedString();
@@ -30,7 +33,7 @@ class RefCountedString final : public base::RefCounted<RefCountedString> {
   const base::string16& data() const { return data_; }
 
  private:
-  friend class base::RefCounted<RefCountedString>;
+  friend class base::RefCountedThreadSafe<RefCountedString>;
 
   ~RefCountedString();
 
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <functional>
 #include <ostream>
 
 #include "evita/css/values/value.h"
@@ -134,6 +135,12 @@ bool Value::operator!=(const Value& other) const {
   return !operator==(other);
 }
 
+size_t Value::hash_value() const {
+  if (is_string())
+    return std::hash<base::string16>()(string_value());
+  return std::hash<uint64_t>()(data_.immediate.u64);
+}
+
 ColorValue Value::as_color() const {
   DCHECK(is_color()) << *this;
   const auto rgba = data_.immediate.packed.data.u32;
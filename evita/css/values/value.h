@@ -72,6 +72,8 @@ class Value final {
   bool is_string() const;
   bool is_unspecified() const;
 
+  // Returns hash code which is same for equal values.
+  size_t hash_value() const;
   const base::string16& string_value() const;
   ValueType type() const;
 
@@ -0,0 +1,373 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+goog.provide('file_index');
+
+goog.scope(function() {
+
+/** @const @type {number} */
+const kFormatVersion = 1;
+
+/** @const @type {number} */
+const kMaxLookupResults = 100;
+
+/** @const @type {number} */
+const kReadSize = 1000;
+
+/**
+ * Bonus of a matched character at start of path component or word.
+ * @const @type {number}
+ */
+const kStartBonus = 8;
+
+/**
+ * Bonus of a matched character following the previous matched character.
+ * @const @type {number}
+ */
+const kConsecutiveBonus = 4;
+
+/**
+ * Bonus of a matched character in base name.
+ * @const @type {number}
+ */
+const kBaseNameBonus = 2;
+
+/**
+ * @typedef {{
+ *    isDir: boolean,
+ *    lastWriteTime: number,
+ *    size: number
+ * }}
+ */
+var Entry;
+
+/**
+ * @param {number} charCode
+ * @return {boolean}
+ */
+function isWordSeparator(charCode) {
+  return charCode === Unicode.SOLIDUS || charCode === Unicode.REVERSE_SOLIDUS ||
+      charCode === Unicode.FULL_STOP || charCode === Unicode.LOW_LINE ||
+      charCode === Unicode.HYPHEN_MINUS || charCode === Unicode.SPACE;
+}
+
+/**
+ * Returns score of matching characters of |pattern| to |lowerName| from
+ * |start| in order, or -1 if some characters aren't matched.
+ * @param {string} pattern
+ * @param {string} lowerName
+ * @param {number} start
+ * @param {number} baseNameStart
+ * @return {number}
+ */
+function scoreFrom(pattern, lowerName, start, baseNameStart) {
+  /** @type {number} */
+  let score = 0;
+  /** @type {number} */
+  let previous = start - 1;
+  for (/** @type {number} */ let k = 0; k < pattern.length; ++k) {
+    /** @const @type {number} */
+    const index = lowerName.indexOf(pattern[k], previous + 1);
+    if (index < 0)
+      return -1;
+    ++score;
+    if (index === 0 || isWordSeparator(lowerName.charCodeAt(index - 1)))
+      score += kStartBonus;
+    if (index === previous + 1 && k > 0)
+      score += kConsecutiveBonus;
+    if (index >= baseNameStart)
+      score += kBaseNameBonus;
+    previous = index;
+  }
+  return score;
+}
+
+/**
+ * Returns score of |name| for |pattern| in lower case, or -1 if |name|
+ * doesn't contain characters of |pattern| in order. We match in base name
+ * first, then in whole name. Matches at start of path components and
+ * words, consecutive matches and matches in base name score higher, and
+ * shorter names score higher for same matches.
+ * @param {string} pattern
+ * @param {string} name
+ * @return {number}
+ */
+function scoreOf(pattern, name) {
+  /** @const @type {string} */
+  const lowerName = name.toLowerCase();
+  /** @const @type {number} */
+  const baseNameStart =
+      Math.max(name.lastIndexOf('/'), name.lastIndexOf('\\')) + 1;
+  /** @type {number} */
+  let score = scoreFrom(pattern, lowerName, baseNameStart, baseNameStart);
+  if (score < 0)
+    score = scoreFrom(pattern, lowerName, 0, baseNameStart);
+  if (score < 0)
+    return -1;
+  return score * 1000 - Math.min(name.length, 999);
+}
+
+/**
+ * |FileIndex| holds files in directory tree of |rootName| for fuzzy lookup
+ * by relative path. The index is built from batches of entries returned by
+ * |Os.Directory.scan()|, so it is usable while scanning. Rescanning updates
+ * only changed entries, and |update()| updates entries of changed files,
+ * e.g. reported by |Os.Directory.readChanges()|. The index can be saved to
+ * and loaded from a file, so lookup doesn't need to wait for the first
+ * scan.
+ *
+ * Note: |FileIndex| is a library for a file lookup UI, e.g. quick open,
+ * which doesn't exist yet. Such UI owns the index; it calls |load()| then
+ * |scan()| on open, passes names from |Os.Directory.readChanges()| to
+ * |update()|, and calls |save()| on close. Launchpad lists open documents
+ * only, so it doesn't use the index.
+ */
+class FileIndex {
+  /** @param {string} rootName */
+  constructor(rootName) {
+    /** @const @type {!Map<string, !Entry>} */
+    this.entries_ = new Map();
+    /** @const @type {string} */
+    this.rootName_ = rootName;
+    /** @type {Promise<number>} */
+    this.scanPromise_ = null;
+  }
+
+  /** @return {boolean} */
+  get isScanning() { return this.scanPromise_ !== null; }
+
+  /** @return {string} */
+  get rootName() { return this.rootName_; }
+
+  /** @return {number} */
+  get size() { return this.entries_.size; }
+
+  /**
+   * @param {string} name
+   * @return {Entry}
+   */
+  get(name) { return this.entries_.get(name) || null; }
+
+  /**
+   * Returns relative paths of files matching |pattern| in descending order
+   * of score. Characters of |pattern| are matched in order ignoring case.
+   * @param {string} pattern
+   * @param {number=} opt_maxCount
+   * @return {!Array<string>}
+   */
+  lookup(pattern, opt_maxCount) {
+    /** @const @type {number} */
+    const maxCount = opt_maxCount === undefined ? kMaxLookupResults :
+                                                  opt_maxCount;
+    /** @const @type {string} */
+    const lowerPattern = pattern.toLowerCase();
+    /** @const @type {!Array<{name: string, score: number}>} */
+    const matches = [];
+    for (const [name, entry] of this.entries_) {
+      if (entry.isDir)
+        continue;
+      /** @const @type {number} */
+      const score = scoreOf(lowerPattern, name);
+      if (score < 0)
+        continue;
+      matches.push({name: name, score: score});
+    }
+    matches.sort((a, b) => b.score - a.score || a.name.localeCompare(b.name));
+    return matches.slice(0, maxCount).map(match => match.name);
+  }
+
+  /**
+   * Loads index saved by |save()|.
+   * @param {string} fileName
+   * @return {!Promise<number>} Number of loaded entries
+   */
+  async load(fileName) {
+    /** @const @type {Os.File} */
+    const file = await Os.File.open(fileName);
+    try {
+      /** @const @type {!Array<string>} */
+      const texts = [];
+      /** @const @type {!Uint8Array} */
+      const buffer = new Uint8Array(64 * 1024);
+      /** @const @type {!TextDecoder} */
+      const decoder = new TextDecoder('utf-8', {fatal: true});
+      for (;;) {
+        /** @const @type {number} */
+        const numRead = await file.read(buffer);
+        if (numRead === 0)
+          break;
+        texts.push(decoder.decode(buffer.subarray(0, numRead), {stream: true}));
+      }
+      texts.push(decoder.decode());
+      return this.restore(JSON.parse(texts.join('')));
+    } finally {
+      file.close();
+    }
+  }
+
+  /**
+   * Restores entries from |data| returned by |toJSON()|, e.g. parsed from
+   * a file. Returns number of restored entries, or -1 if |data| isn't for
+   * this index.
+   * @param {*} data
+   * @return {number}
+   */
+  restore(data) {
+    if (!data || data['version'] !== kFormatVersion ||
+        data['rootName'] !== this.rootName_) {
+      return -1;
+    }
+    this.entries_.clear();
+    for (const [name, size, lastWriteTime, isDir] of data['entries']) {
+      this.entries_.set(
+          name, {isDir: isDir === 1, lastWriteTime: lastWriteTime, size: size});
+    }
+    return this.entries_.size;
+  }
+
+  /**
+   * @param {string} fileName
+   * @return {!Promise<number>} Number of saved entries
+   */
+  async save(fileName) {
+    /** @const @type {!TextEncoder} */
+    const encoder = new TextEncoder('utf-8');
+    /** @const @type {!Uint8Array} */
+    const bytes = encoder.encode(JSON.stringify(this));
+    /** @const @type {Os.File} */
+    const file = await Os.File.open(fileName, 'w');
+    try {
+      /** @type {number} */
+      let offset = 0;
+      while (offset < bytes.length)
+        offset += await file.write(bytes.subarray(offset));
+      return this.entries_.size;
+    } finally {
+      file.close();
+    }
+  }
+
+  /**
+   * Scans directory tree and updates entries. Returns number of added,
+   * changed and removed entries. Entries are updated while scanning.
+   * @return {!Promise<number>}
+   */
+  scan() {
+    if (this.scanPromise_)
+      return this.scanPromise_;
+    this.scanPromise_ = this.scanInternal_().then(
+        numChanges => {
+          this.scanPromise_ = null;
+          return numChanges;
+        },
+        reason => {
+          this.scanPromise_ = null;
+          throw reason;
+        });
+    return this.scanPromise_;
+  }
+
+  /**
+   * Sets entry of |name| from |info|. Returns true if entry is changed.
+   * @param {string} name
+   * @param {!Os.File.Info} info
+   * @return {boolean}
+   */
+  set(name, info) {
+    /** @const @type {!Entry} */
+    const newEntry = {
+      isDir: info.isDir,
+      lastWriteTime: info.lastModificationDate.valueOf(),
+      size: info.size,
+    };
+    /** @const @type {Entry} */
+    const entry = this.entries_.get(name) || null;
+    if (entry && entry.isDir === newEntry.isDir &&
+        entry.lastWriteTime === newEntry.lastWriteTime &&
+        entry.size === newEntry.size) {
+      return false;
+    }
+    this.entries_.set(name, newEntry);
+    return true;
+  }
+
+  /** @return {!Object} */
+  toJSON() {
+    /** @const @type {!Array<!Array<*>>} */
+    const entries = [];
+    for (const [name, entry] of this.entries_) {
+      entries.push(
+          [name, entry.size, entry.lastWriteTime, entry.isDir ? 1 : 0]);
+    }
+    return {
+      entries: entries,
+      rootName: this.rootName_,
+      version: kFormatVersion,
+    };
+  }
+
+  /**
+   * Updates entries of |names|, relative path from root directory, by
+   * querying file status. Entries of missing files are removed. Returns
+   * number of changed entries.
+   * @param {!Array<string>} names
+   * @return {!Promise<number>}
+   */
+  async update(names) {
+    /** @type {number} */
+    let numChanges = 0;
+    await Promise.all(names.map(async(name) => {
+      try {
+        /** @const @type {!Os.File.Info} */
+        const info =
+            await Os.File.stat(FilePath.join(this.rootName_, name));
+        if (this.set(name, info))
+          ++numChanges;
+      } catch (reason) {
+        if (this.entries_.delete(name))
+          ++numChanges;
+      }
+    }));
+    return numChanges;
+  }
+
+  /**
+   * @private
+   * @return {!Promise<number>}
+   */
+  async scanInternal_() {
+    /** @const @type {!Set<string>} */
+    const seenNames = new Set();
+    /** @type {number} */
+    let numChanges = 0;
+    /** @const @type {!Os.Directory} */
+    const directory = await Os.Directory.scan(this.rootName_);
+    try {
+      for (;;) {
+        /** @const @type {!Array<!Os.File.Info>} */
+        const infos = await directory.read(kReadSize);
+        if (infos.length === 0)
+          break;
+        for (const info of infos) {
+          seenNames.add(info.name);
+          if (this.set(info.name, info))
+            ++numChanges;
+        }
+      }
+    } finally {
+      directory.close();
+    }
+    for (const name of Array.from(this.entries_.keys())) {
+      if (seenNames.has(name))
+        continue;
+      this.entries_.delete(name);
+      ++numChanges;
+    }
+    return numChanges;
+  }
+}
+
+/** @constructor */
+file_index.FileIndex = FileIndex;
+});
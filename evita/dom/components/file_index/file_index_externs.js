@@ -0,0 +1,48 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+var file_index;
+
+/**
+ * @constructor
+ * @param {string} rootName
+ */
+file_index.FileIndex = function(rootName) {};
+
+/** @type {boolean} */
+file_index.FileIndex.prototype.isScanning;
+
+/** @type {string} */
+file_index.FileIndex.prototype.rootName;
+
+/** @type {number} */
+file_index.FileIndex.prototype.size;
+
+/**
+ * @param {string} fileName
+ * @return {!Promise<number>}
+ */
+file_index.FileIndex.prototype.load = function(fileName) {};
+
+/**
+ * @param {string} pattern
+ * @param {number=} opt_maxCount
+ * @return {!Array<string>}
+ */
+file_index.FileIndex.prototype.lookup = function(pattern, opt_maxCount) {};
+
+/**
+ * @param {string} fileName
+ * @return {!Promise<number>}
+ */
+file_index.FileIndex.prototype.save = function(fileName) {};
+
+/** @return {!Promise<number>} */
+file_index.FileIndex.prototype.scan = function() {};
+
+/**
+ * @param {!Array<string>} names
+ * @return {!Promise<number>}
+ */
+file_index.FileIndex.prototype.update = function(names) {};
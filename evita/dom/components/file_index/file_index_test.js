@@ -0,0 +1,69 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+goog.require('file_index');
+goog.require('testing');
+
+goog.scope(function() {
+
+const FileIndex = file_index.FileIndex;
+
+/**
+ * @param {!Array<string>} names
+ * @return {!FileIndex}
+ */
+function newFileIndex(names) {
+  const index = new FileIndex('/root');
+  index.restore({
+    entries: names.map(
+        name => [name, name.length, 0, name.endsWith('/') ? 1 : 0]),
+    rootName: '/root',
+    version: 1,
+  });
+  return index;
+}
+
+testing.test('FileIndex.lookup', function(t) {
+  const index = newFileIndex([
+    'src/text/text_document.cc',
+    'src/text/text_document.h',
+    'src/dom/document.cc',
+    'src/io/directory_scanner.cc',
+    'README',
+    'src/',
+  ]);
+  t.expect(index.lookup('tdcc').join(' '))
+      .toEqual('src/text/text_document.cc');
+  t.expect(index.lookup('document.cc').join(' '))
+      .toEqual('src/dom/document.cc src/text/text_document.cc');
+  t.expect(index.lookup('scanner').join(' '))
+      .toEqual('src/io/directory_scanner.cc');
+  t.expect(index.lookup('README').join(' ')).toEqual('README');
+  t.expect(index.lookup('xyz').length).toEqual(0);
+  t.expect(index.lookup('src/').length).toEqual(4);
+  t.expect(index.lookup('doc', 2).length).toEqual(2);
+});
+
+testing.test('FileIndex.restore', function(t) {
+  const index = newFileIndex(['foo.cc', 'bar.cc']);
+  const data = JSON.parse(JSON.stringify(index));
+  const index2 = new FileIndex('/root');
+  t.expect(index2.restore(data)).toEqual(2);
+  t.expect(index2.get('foo.cc').size).toEqual(6);
+  t.expect(new FileIndex('/other').restore(data)).toEqual(-1);
+});
+
+testing.test('FileIndex.set', function(t) {
+  const index = newFileIndex(['foo.cc']);
+  const info = new Os.File.Info();
+  info.isDir = false;
+  info.lastModificationDate = new Date(1000);
+  info.name = 'foo.cc';
+  info.size = 6;
+  t.expect(index.set('foo.cc', info)).toEqual(true);
+  t.expect(index.set('foo.cc', info)).toEqual(false);
+  t.expect(index.get('foo.cc').lastWriteTime).toEqual(1000);
+});
+
+});
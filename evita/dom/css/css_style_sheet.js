@@ -9,6 +9,12 @@ goog.scope(function() {
 /** @constructor */
 const CSSRule = css.CSSRule;
 
+/** @constructor */
+const CSSStyleDeclaration = css.CSSStyleDeclaration;
+
+/** @constructor */
+const CSSStyleRule = css.CSSStyleRule;
+
 //////////////////////////////////////////////////////////////////////
 //
 // CSSStyleSheet
@@ -18,7 +24,11 @@ class CSSStyleSheet {
     /** @private @type {Array<!CSSRule>} */
     this.cachedCssRules_ = null;
 
-    /** @private @const @type {!Array<!CSSRule>} */
+    /**
+     * |cssRules_| can be shorter than rules in |handle_| for rules appended
+     * by |appendRules()|, see |syncCssRules_()|.
+     * @private @const @type {!Array<!CSSRule>}
+     */
     this.cssRules_ = [];
 
     /** @const @type {!CSSStyleSheetHandle} */
@@ -27,6 +37,7 @@ class CSSStyleSheet {
 
   /** @return {!Array<!CSSRule>} */
   get cssRules() {
+    this.syncCssRules_();
     if (!this.cachedCssRules_) {
       // TODO(eval17490: Once |Array.from()| has right type definition, we
       // should get rid of type case for |this.cssRules_|.
@@ -47,6 +58,7 @@ class CSSStyleSheet {
   appendRule(rule) {
     if (rule.parentStyleSheet)
       throw new Error(`${rule} is already in ${rule.parentStyleSheet}`);
+    this.syncCssRules_();
     CSSStyleSheetHandle.appendStyleRule(
         this.handle_, rule.selectorText, rule.style.rawStyle_);
     rule.parentStyleSheet_ = this;
@@ -54,6 +66,19 @@ class CSSStyleSheet {
     this.clearCssRulesCache_();
   }
 
+  /**
+   * Appends style rules in |cssText| parsed by native parser in one call.
+   * @param {string} cssText
+   * @return {number} number of appended rules
+   */
+  appendRules(cssText) {
+    /** @const @type {number} */
+    const count = CSSStyleSheetHandle.parseStyleSheet(this.handle_, cssText);
+    if (count > 0)
+      this.clearCssRulesCache_();
+    return count;
+  }
+
   /** @private */
   clearCssRulesCache_() { this.cachedCssRules_ = null; }
 
@@ -61,6 +86,7 @@ class CSSStyleSheet {
    * @param {number} index
    */
   deleteRule(index) {
+    this.syncCssRules_();
     CSSStyleSheetHandle.deleteRule(this.handle_, index);
     this.cssRules_.splice(index, 1);
     this.clearCssRulesCache_();
@@ -70,6 +96,7 @@ class CSSStyleSheet {
    * @param {number} index
    */
   didChangeCSSRule(index) {
+    this.syncCssRules_();
     const rule = /** @type {!CSSStyleRule} */ (this.cssRules_[index]);
     this.deleteRule(index);
     this.insertRule(rule, index);
@@ -84,12 +111,36 @@ class CSSStyleSheet {
   insertRule(rule, index) {
     if (rule.parentStyleSheet)
       throw new Error(`${rule} is already in ${rule.parentStyleSheet}`);
+    this.syncCssRules_();
     CSSStyleSheetHandle.insertStyleRule(
         this.handle_, rule.selectorText, rule.style.rawStyle_, index);
     rule.parentStyleSheet_ = this;
     this.cssRules_.splice(index, 0, rule);
     this.clearCssRulesCache_();
   }
+
+  /**
+   * Makes |CSSStyleRule| for rules appended by |appendRules()|. Since they
+   * are always appended, they are at end of rules in |handle_|.
+   * @private
+   */
+  syncCssRules_() {
+    /** @const @type {number} */
+    const count = CSSStyleSheetHandle.countRules(this.handle_);
+    while (this.cssRules_.length < count) {
+      /** @const @type {!Map<number, string>} */
+      const rawStyle =
+          CSSStyleSheetHandle.ruleAt(this.handle_, this.cssRules_.length);
+      /** @const @type {string} */
+      const selectorText = rawStyle.get(-1) || '';
+      rawStyle.delete(-1);
+      /** @const @type {!CSSStyleRule} */
+      const rule =
+          new CSSStyleRule(selectorText, new CSSStyleDeclaration(rawStyle));
+      rule.parentStyleSheet_ = this;
+      this.cssRules_.push(rule);
+    }
+  }
 }
 
 /** @constructor */
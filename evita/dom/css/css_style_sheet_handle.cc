@@ -7,18 +7,63 @@
 #include "evita/dom/css/css_style_sheet_handle.h"
 
 #include "base/logging.h"
+#include "evita/base/maybe.h"
+#include "evita/css/properties.h"
 #include "evita/css/rule.h"
 #include "evita/css/selector_parser.h"
 #include "evita/css/style.h"
 #include "evita/css/style_sheet.h"
+#include "evita/css/style_sheet_parser.h"
+#include "evita/css/values.h"
 #include "evita/dom/bindings/exception_state.h"
 #include "evita/dom/converter.h"
 #include "evita/dom/css/css_style.h"
+#include "evita/dom/css/css_value_parsers.h"
 #include "evita/dom/script_host.h"
 #include "evita/ginx/runner.h"
 
 namespace dom {
 
+namespace {
+
+//////////////////////////////////////////////////////////////////////
+//
+// CSSValueParser
+// Parses CSS property value as |CSSStyle::ConvertFromV8()|.
+//
+class CSSValueParser final : public css::StyleSheetParser::ValueParser {
+ public:
+  CSSValueParser() = default;
+  ~CSSValueParser() final = default;
+
+ private:
+  // css::StyleSheetParser::ValueParser
+  css::Value Parse(css::PropertyId property_id,
+                   base::StringPiece16 text) const final;
+
+  DISALLOW_COPY_AND_ASSIGN(CSSValueParser);
+};
+
+css::Value CSSValueParser::Parse(css::PropertyId property_id,
+                                 base::StringPiece16 text) const {
+  switch (property_id) {
+#define V(Name, name, type, ...)                  \
+  case css::PropertyId::Name: {                   \
+    const auto& maybe_##name = Parse##type(text); \
+    if (maybe_##name.IsJust())                    \
+      return maybe_##name.FromJust().value();     \
+    return css::Value();                          \
+  }
+    FOR_EACH_VISUAL_CSS_PROPERTY(V)
+#undef V
+    default:
+      break;
+  }
+  return css::Value();
+}
+
+}  // namespace
+
 //////////////////////////////////////////////////////////////////////
 //
 // CSSStyleSheetHandle
@@ -65,6 +110,13 @@ void CSSStyleSheetHandle::InsertStyleRule(ScriptHost* script_host,
   handle->object_->InsertRule(selector, std::move(style), index);
 }
 
+int CSSStyleSheetHandle::ParseStyleSheet(CSSStyleSheetHandle* handle,
+                                         const base::string16& css_text) {
+  CSSValueParser value_parser;
+  css::StyleSheetParser parser(handle->object_.get(), value_parser);
+  return static_cast<int>(parser.Parse(css_text));
+}
+
 v8::Local<v8::Map> CSSStyleSheetHandle::RuleAt(
     CSSStyleSheetHandle* handle,
     int index,
@@ -51,6 +51,8 @@ class CSSStyleSheetHandle final : public ginx::Scriptable<CSSStyleSheetHandle> {
                               const base::string16& selector,
                               v8::Local<v8::Map> raw_style,
                               int index);
+  static int ParseStyleSheet(CSSStyleSheetHandle* handle,
+                             const base::string16& css_text);
   static v8::Local<v8::Map> RuleAt(CSSStyleSheetHandle* handle,
                                    int index,
                                    ExceptionState* exception_state);
@@ -50,3 +50,35 @@ testing.test('CSSStyleSheet', function(t) {
   t.expect(toString(styleSheet))
       .toEqual('div { color: #00f; } body { color: #080; }');
 });
+
+testing.test('CSSStyleSheet.appendRules', function(t) {
+  /** @constructor */
+  const CSSStyleDeclaration = css.CSSStyleDeclaration;
+
+  /** @constructor */
+  const CSSStyleRule = css.CSSStyleRule;
+
+  /** @constructor */
+  const CSSStyleSheet = css.CSSStyleSheet;
+
+  const styleSheet = new CSSStyleSheet();
+  function toString(styleSheet) {
+    return styleSheet.cssRules.map(rule => rule.cssText).join(' ');
+  }
+
+  t.expect(styleSheet.appendRules(
+               'body { color: #008800 } /* div { color: #0000FF } */' +
+               ' bad..selector { color: #0000FF } div {}'))
+      .toEqual(1);
+  t.expect(toString(styleSheet)).toEqual('body { color: #008800; }');
+  t.expect(styleSheet.cssRules[0].parentStyleSheet).toEqual(styleSheet);
+
+  t.expect(styleSheet.appendRules('span { color: #00FF00 }')).toEqual(1);
+  const divStyle = new CSSStyleDeclaration();
+  divStyle.color = '#0000FF';
+  styleSheet.insertRule(new CSSStyleRule('div', divStyle), 1);
+  t.expect(toString(styleSheet))
+      .toEqual(
+          'body { color: #008800; } div { color: #0000FF; } ' +
+          'span { color: #00FF00; }');
+});
@@ -251,11 +251,18 @@ class Parser extends base.Logger {
   warn(message) { this.log(0, 'WARN:', message); }
 
   /**
+   * Parses |source| by native parser in one call. Use
+   * |Parser.prototype.parse()| with |verbose| for tracing parser.
    * @public
    * @param {string} source
    * @return {!css.CSSStyleSheet}
    */
-  static parse(source) { return (new Parser()).parse(source); }
+  static parse(source) {
+    /** @const @type {!css.CSSStyleSheet} */
+    const styleSheet = new css.CSSStyleSheet();
+    styleSheet.appendRules(source);
+    return styleSheet;
+  }
 }
 
 /** @constructor */
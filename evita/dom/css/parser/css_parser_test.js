@@ -11,6 +11,16 @@ goog.scope(function() {
 const CSSStyleSheet = css.CSSStyleSheet;
 const Parser = css.Parser;
 
+/**
+ * Parses |source| by script parser, since |Parser.parse()| uses native
+ * parser.
+ * @param {string} source
+ * @return {!CSSStyleSheet}
+ */
+function parse(source) {
+  return (new Parser()).parse(source);
+}
+
 /**
  * @param {!CSSStyleSheet} styleSheet
  * @param {string} selectorText
@@ -26,7 +36,7 @@ function querySelector(styleSheet, selectorText) {
 
 testing.test('css.Parser.basic', function(t) {
   /** @const @type {!CSSStyleSheet} */
-  const styleSheet = Parser.parse(
+  const styleSheet = parse(
       'foo {color: red} bar {color: blue} /* baz {color: green} */');
   t.expect(styleSheet.cssRules.length, "comment doesn't affect").toEqual(2);
   t.expect(querySelector(styleSheet, 'foo')).toEqual('foo { color: red; }');
@@ -35,7 +45,7 @@ testing.test('css.Parser.basic', function(t) {
 
 testing.test('css.Parser.classSelector', function(t) {
   /** @const @type {!CSSStyleSheet} */
-  const styleSheet = Parser.parse('.hover { color: blue}');
+  const styleSheet = parse('.hover { color: blue}');
   t.expect(styleSheet.cssRules.length).toEqual(1);
   t.expect(querySelector(styleSheet, '.hover'))
       .toEqual('.hover { color: blue; }');
@@ -43,7 +53,7 @@ testing.test('css.Parser.classSelector', function(t) {
 
 testing.test('css.Parser.empty', function(t) {
   /** @const @type {!CSSStyleSheet} */
-  const styleSheet = Parser.parse(
+  const styleSheet = parse(
       'foo {} ' +
       'foo {color: red;}');
   t.expect(styleSheet.cssRules.length, "Empty style doesn't in style sheet")
@@ -53,7 +63,7 @@ testing.test('css.Parser.empty', function(t) {
 
 testing.test('css.Parser.notMerge', function(t) {
   /** @const @type {!CSSStyleSheet} */
-  const styleSheet = Parser.parse(
+  const styleSheet = parse(
       'foo {color: red} ' +
       'foo {color: blue; background-color: green}');
   t.expect(styleSheet.cssRules.length, "Selectors aren't merged").toEqual(2);
@@ -62,7 +72,7 @@ testing.test('css.Parser.notMerge', function(t) {
 
 testing.test('css.Parser.pseudoClass', function(t) {
   /** @const @type {!CSSStyleSheet} */
-  const styleSheet = Parser.parse(':hover { color: blue}');
+  const styleSheet = parse(':hover { color: blue}');
   t.expect(styleSheet.cssRules.length).toEqual(1);
   t.expect(querySelector(styleSheet, ':hover'))
       .toEqual(':hover { color: blue; }');
@@ -70,7 +80,7 @@ testing.test('css.Parser.pseudoClass', function(t) {
 
 testing.test('css.Parser.pseudoElement', function(t) {
   /** @const @type {!CSSStyleSheet} */
-  const styleSheet = Parser.parse('div ::first-letter { color: blue}');
+  const styleSheet = parse('div ::first-letter { color: blue}');
   t.expect(styleSheet.cssRules.length).toEqual(1);
   t.expect(querySelector(styleSheet, 'div::first-letter'))
       .toEqual('div::first-letter { color: blue; }');
@@ -78,7 +88,7 @@ testing.test('css.Parser.pseudoElement', function(t) {
 
 testing.test('css.Parser.universalTypeSelector', function(t) {
   /** @const @type {!CSSStyleSheet} */
-  const styleSheet = Parser.parse('* { color: red }');
+  const styleSheet = parse('* { color: red }');
   t.expect(styleSheet.cssRules.length).toEqual(1);
   t.expect(querySelector(styleSheet, '*')).toEqual('* { color: red; }');
 });
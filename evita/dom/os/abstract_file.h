@@ -26,6 +26,8 @@ class AbstractFile : public ginx::Scriptable<AbstractFile> {
   explicit AbstractFile(domapi::IoContextId context_id);
   ~AbstractFile() override;
 
+  domapi::IoContextId context_id() const { return context_id_; }
+
  private:
   friend class bindings::AbstractFileClass;
 
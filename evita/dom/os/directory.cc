@@ -57,4 +57,28 @@ v8::Local<v8::Promise> Directory::Read(int num_read) {
                      context_id_, num_read));
 }
 
+v8::Local<v8::Promise> Directory::ReadChanges() {
+  return PromiseResolver::Call(
+      FROM_HERE,
+      base::BindOnce(&domapi::IoDelegate::ReadDirectoryChanges,
+                     base::Unretained(ScriptHost::instance()->io_delegate()),
+                     context_id_));
+}
+
+v8::Local<v8::Promise> Directory::Scan(const base::string16& dir_name) {
+  return PromiseResolver::Call(
+      FROM_HERE,
+      base::BindOnce(&domapi::IoDelegate::ScanDirectory,
+                     base::Unretained(ScriptHost::instance()->io_delegate()),
+                     dir_name));
+}
+
+v8::Local<v8::Promise> Directory::Watch(const base::string16& dir_name) {
+  return PromiseResolver::Call(
+      FROM_HERE,
+      base::BindOnce(&domapi::IoDelegate::WatchDirectory,
+                     base::Unretained(ScriptHost::instance()->io_delegate()),
+                     dir_name));
+}
+
 }  // namespace dom
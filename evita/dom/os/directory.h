@@ -32,6 +32,9 @@ class Directory final : public ginx::Scriptable<Directory> {
   v8::Local<v8::Promise> Close();
   static v8::Local<v8::Promise> Open(const base::string16& dir_name);
   v8::Local<v8::Promise> Read(int num_read);
+  v8::Local<v8::Promise> ReadChanges();
+  static v8::Local<v8::Promise> Scan(const base::string16& dir_name);
+  static v8::Local<v8::Promise> Watch(const base::string16& dir_name);
 
   domapi::IoContextId context_id_;
 
@@ -87,4 +87,59 @@ TEST_F(OsDirectoryTest, ReadSucceeded) {
   EXPECT_SCRIPT_EQ("22", "entries[1].size");
 }
 
+TEST_F(OsDirectoryTest, ReadChanges) {
+  mock_io_delegate()->SetWatchDirectoryResult(domapi::IoContextId::New(), 0);
+  EXPECT_SCRIPT_VALID(
+      "var directory;"
+      "Os.Directory.watch('my_dir').then(x => directory = x);");
+  EXPECT_SCRIPT_TRUE("directory instanceof Os.Directory");
+
+  mock_io_delegate()->SetStrings("ReadDirectoryChanges", 0, {L"foo", L"bar"});
+  EXPECT_SCRIPT_VALID(
+      "var names;"
+      "directory.readChanges().then(x => names = x);");
+  EXPECT_SCRIPT_EQ("foo,bar", "names.join(',')");
+}
+
+TEST_F(OsDirectoryTest, ScanFailed) {
+  mock_io_delegate()->SetOpenDirectoryResult(domapi::IoContextId(), 123);
+  EXPECT_SCRIPT_VALID(
+      "var reason;"
+      "Os.Directory.scan('my_dir').catch(x => reason = x);");
+  EXPECT_SCRIPT_TRUE("reason instanceof Os.File.Error");
+  EXPECT_SCRIPT_EQ("123", "reason.winLastError");
+}
+
+TEST_F(OsDirectoryTest, ScanSucceeded) {
+  mock_io_delegate()->SetOpenDirectoryResult(domapi::IoContextId::New(), 0);
+  EXPECT_SCRIPT_VALID(
+      "var directory;"
+      "Os.Directory.scan('my_dir').then(x => directory = x);");
+  EXPECT_SCRIPT_TRUE("directory instanceof Os.Directory");
+
+  domapi::FileStatus entry;
+  entry.file_size = 11;
+  entry.is_directory = false;
+  entry.is_symlink = false;
+  entry.last_write_time = base::Time::FromJsTime(123456.0);
+  entry.name = L"src\\foo.cc";
+  entry.readonly = false;
+  mock_io_delegate()->SetReadDirectoryResult({entry});
+
+  EXPECT_SCRIPT_VALID(
+      "var entries;"
+      "directory.read(100).then(x => entries = x);");
+  EXPECT_SCRIPT_EQ("1", "entries.length");
+  EXPECT_SCRIPT_EQ("src\\foo.cc", "entries[0].name");
+}
+
+TEST_F(OsDirectoryTest, WatchFailed) {
+  mock_io_delegate()->SetWatchDirectoryResult(domapi::IoContextId(), 123);
+  EXPECT_SCRIPT_VALID(
+      "var reason;"
+      "Os.Directory.watch('my_dir').catch(x => reason = x);");
+  EXPECT_SCRIPT_TRUE("reason instanceof Os.File.Error");
+  EXPECT_SCRIPT_EQ("123", "reason.winLastError");
+}
+
 }  // namespace dom
@@ -14,6 +14,7 @@ Os.File.Error = function(winLastError) {};
  *    isDir: boolean,
  *    isSymLink: boolean,
  *    lastModificationDate: !Date,
+ *    name: string,
  *    readonly: boolean,
  *    size: number
  * }}
@@ -5,6 +5,7 @@
 #include "evita/dom/os/process.h"
 
 #include "evita/dom/os/io_error.h"
+#include "evita/dom/os/process_output_writer.h"
 #include "evita/dom/promise_resolver.h"
 #include "evita/dom/public/io_delegate.h"
 #include "evita/dom/script_host.h"
@@ -29,6 +30,14 @@ Process::Process(domapi::IoContextId context_id) : ScriptableBase(context_id) {}
 
 Process::~Process() {}
 
+v8::Local<v8::Promise> Process::AppendOutputTo(TextDocument* document,
+                                               const base::string16& encoding) {
+  const auto& writer = base::WrapRefCounted(
+      new ProcessOutputWriter(context_id(), document, encoding));
+  return PromiseResolver::Call(
+      FROM_HERE, base::BindOnce(&ProcessOutputWriter::Start, writer));
+}
+
 v8::Local<v8::Promise> Process::Open(const base::string16& command_line) {
   return PromiseResolver::Call(
       FROM_HERE,
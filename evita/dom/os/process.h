@@ -13,6 +13,8 @@ namespace bindings {
 class ProcessClass;
 }
 
+class TextDocument;
+
 class Process final : public ginx::Scriptable<Process, AbstractFile> {
   DECLARE_SCRIPTABLE_OBJECT(Process);
 
@@ -23,6 +25,11 @@ class Process final : public ginx::Scriptable<Process, AbstractFile> {
  private:
   friend class bindings::ProcessClass;
 
+  // Appends output of this process to |document| until end of output.
+  // Returned promise is resolved with throughput counters.
+  v8::Local<v8::Promise> AppendOutputTo(TextDocument* document,
+                                        const base::string16& encoding);
+
   static v8::Local<v8::Promise> Open(const base::string16& command_line);
 
   DISALLOW_COPY_AND_ASSIGN(Process);
@@ -0,0 +1,132 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/dom/os/process_output_writer.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/trace_event/trace_event.h"
+#include "evita/dom/public/io_delegate.h"
+#include "evita/dom/public/io_error.h"
+#include "evita/dom/script_host.h"
+#include "evita/dom/text/text_document.h"
+#include "evita/text/encodings/decoder.h"
+#include "evita/text/encodings/encodings.h"
+#include "evita/text/models/buffer.h"
+
+namespace dom {
+
+namespace {
+
+// Maximum number of bytes inserted at once.
+const size_t kBufferSize = 64 * 1024;
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// ProcessOutputWriter
+//
+ProcessOutputWriter::ProcessOutputWriter(domapi::IoContextId process_id,
+                                         TextDocument* document,
+                                         const base::string16& encoding)
+    : bytes_(kBufferSize),
+      chars_(encodings::Decoder::MaxCharsOf(kBufferSize)),
+      decoder_(encodings::Encodings::instance()->GetDecoder(encoding)),
+      document_(document),
+      process_id_(process_id) {}
+
+ProcessOutputWriter::~ProcessOutputWriter() {}
+
+// Appends |chars| to document replacing CRLF to LF. Note: CR at end of
+// read is kept in |has_pending_cr_| until we see next character.
+void ProcessOutputWriter::Append(const base::char16* chars, size_t length) {
+  text_.clear();
+  for (auto runner = chars; runner < chars + length; ++runner) {
+    auto const char_code = *runner;
+    if (has_pending_cr_) {
+      has_pending_cr_ = false;
+      if (char_code == '\n') {
+        text_.push_back('\n');
+        continue;
+      }
+      text_.push_back('\r');
+    }
+    if (char_code == '\r') {
+      has_pending_cr_ = true;
+      continue;
+    }
+    text_.push_back(char_code);
+  }
+  if (text_.empty())
+    return;
+  auto* const buffer = document_->buffer();
+  buffer->InsertBefore(buffer->GetEnd(), text_);
+  ++result_.num_inserts;
+}
+
+void ProcessOutputWriter::DidFail(domapi::IoError error) {
+  std::move(promise_.reject).Run(error);
+}
+
+void ProcessOutputWriter::DidRead(int num_read) {
+  TRACE_EVENT1("io", "ProcessOutputWriter::DidRead", "num_read", num_read);
+  if (document_->buffer()->IsReadOnly())
+    return DidFail(domapi::IoError(domapi::IoError::kWriteProtect));
+  if (num_read == 0) {
+    if (has_pending_cr_) {
+      has_pending_cr_ = false;
+      const base::char16 kCr = '\r';
+      Append(&kCr, 1);
+    }
+    result_.elapsed = base::TimeTicks::Now() - start_time_;
+    return std::move(promise_.resolve).Run(result_);
+  }
+  result_.num_bytes += num_read;
+  const auto& result =
+      decoder_->DecodeTo(bytes_.data(), static_cast<size_t>(num_read), true,
+                         chars_.data());
+  Append(chars_.data(), result.right);
+  if (!result.left)
+    return DidFail(domapi::IoError(domapi::IoError::kNoUnicodeTranslation));
+  Read();
+}
+
+void ProcessOutputWriter::Read() {
+  domapi::IoIntPromise promise;
+  promise.reject =
+      base::BindOnce(&ProcessOutputWriter::DidFail, base::WrapRefCounted(this));
+  promise.resolve =
+      base::BindOnce(&ProcessOutputWriter::DidRead, base::WrapRefCounted(this));
+  ScriptHost::instance()->io_delegate()->ReadFile(
+      process_id_, bytes_.data(), bytes_.size(), std::move(promise));
+}
+
+void ProcessOutputWriter::Start(WritePromise promise) {
+  promise_ = std::move(promise);
+  if (!decoder_)
+    return DidFail(domapi::IoError(domapi::IoError::kInvalidParameter));
+  start_time_ = base::TimeTicks::Now();
+  Read();
+}
+
+}  // namespace dom
+
+namespace gin {
+v8::Local<v8::Value> Converter<dom::ProcessOutputResult>::ToV8(
+    v8::Isolate* isolate,
+    const dom::ProcessOutputResult& result) {
+  auto const js_result = v8::Object::New(isolate);
+  js_result->Set(gin::StringToV8(isolate, "elapsed"),
+                 v8::Number::New(isolate, result.elapsed.InMillisecondsF()));
+  js_result->Set(gin::StringToV8(isolate, "numBytes"),
+                 v8::Number::New(isolate, static_cast<double>(
+                                              result.num_bytes)));
+  js_result->Set(gin::StringToV8(isolate, "numInserts"),
+                 v8::Integer::New(isolate, result.num_inserts));
+  return js_result;
+}
+}  // namespace gin
@@ -0,0 +1,99 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_DOM_OS_PROCESS_OUTPUT_WRITER_H_
+#define EVITA_DOM_OS_PROCESS_OUTPUT_WRITER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string16.h"
+#include "base/time/time.h"
+#include "evita/dom/public/io_context_id.h"
+#include "evita/dom/public/io_error.h"
+#include "evita/dom/public/promise.h"
+#include "evita/gc/member.h"
+#include "evita/ginx/converter.h"
+
+namespace encodings {
+class Decoder;
+}
+
+namespace dom {
+
+class TextDocument;
+
+//////////////////////////////////////////////////////////////////////
+//
+// ProcessOutputResult
+// Throughput counters of |ProcessOutputWriter|.
+//
+struct ProcessOutputResult final {
+  base::TimeDelta elapsed;
+  int64_t num_bytes = 0;
+  int num_inserts = 0;
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// ProcessOutputWriter
+// Appends output of a process to |TextDocument| until end of output. Each
+// read takes all output buffered by the I/O thread, up to |kBufferSize|
+// bytes, so we insert output in batches instead of a script round trip per
+// read of pipe. We issue the next read after inserting output, so when the
+// document can't keep up, the I/O thread stops reading the pipe and the
+// process waits.
+//
+class ProcessOutputWriter final
+    : public base::RefCounted<ProcessOutputWriter> {
+ public:
+  using WritePromise =
+      domapi::Promise<ProcessOutputResult, domapi::IoError>;
+
+  ProcessOutputWriter(domapi::IoContextId process_id,
+                      TextDocument* document,
+                      const base::string16& encoding);
+
+  void Start(WritePromise promise);
+
+ private:
+  friend class base::RefCounted<ProcessOutputWriter>;
+
+  ~ProcessOutputWriter();
+
+  void Append(const base::char16* chars, size_t length);
+  void DidFail(domapi::IoError error);
+  void DidRead(int num_read);
+  void Read();
+
+  std::vector<uint8_t> bytes_;
+  std::vector<base::char16> chars_;
+  std::unique_ptr<encodings::Decoder> decoder_;
+  gc::Member<TextDocument> document_;
+  bool has_pending_cr_ = false;
+  const domapi::IoContextId process_id_;
+  WritePromise promise_;
+  ProcessOutputResult result_;
+  base::TimeTicks start_time_;
+  // |text_| holds newline normalized text of a read to reuse its storage.
+  base::string16 text_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProcessOutputWriter);
+};
+
+}  // namespace dom
+
+namespace gin {
+template <>
+struct Converter<dom::ProcessOutputResult> {
+  static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
+                                   const dom::ProcessOutputResult& result);
+};
+}  // namespace gin
+
+#endif  // EVITA_DOM_OS_PROCESS_OUTPUT_WRITER_H_
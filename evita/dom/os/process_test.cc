@@ -2,6 +2,7 @@
 // Written by Yoshifumi "VOGUE" INOUE. (yosi@msn.com)
 
 #include <string>
+#include <vector>
 
 #include "base/macros.h"
 #include "evita/dom/testing/abstract_dom_test.h"
@@ -21,6 +22,47 @@ class OsProcessTest : public AbstractDomTest {
   DISALLOW_COPY_AND_ASSIGN(OsProcessTest);
 };
 
+TEST_F(OsProcessTest, OsProcess_appendOutputTo) {
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId::New(), 0);
+  EXPECT_SCRIPT_VALID(
+      "var process;"
+      "Os.Process.open('foo.js').then(function(x) { process = x });");
+  EXPECT_SCRIPT_TRUE("process instanceof Os.Process");
+
+  std::vector<uint8_t> bytes{
+      102, 111, 111, 13, 10,  // foo\r\n
+      98,  97,  114, 10,      // bar\n
+  };
+  mock_io_delegate()->set_bytes(bytes);
+  mock_io_delegate()->SetCallResult("ReadFile", 0,
+                                    static_cast<int>(bytes.size()));
+  mock_io_delegate()->SetCallResult("ReadFile", 0, 0);
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('output');"
+      "var result;"
+      "process.appendOutputTo(doc, 'utf-8').then(x => result = x);");
+  EXPECT_SCRIPT_TRUE("doc.slice(0) === 'foo\\nbar\\n'")
+      << "CRLF is replaced to LF.";
+  EXPECT_SCRIPT_EQ("9", "result.numBytes");
+  EXPECT_SCRIPT_EQ("1", "result.numInserts");
+}
+
+TEST_F(OsProcessTest, OsProcess_appendOutputTo_failed) {
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId::New(), 0);
+  EXPECT_SCRIPT_VALID(
+      "var process;"
+      "Os.Process.open('foo.js').then(function(x) { process = x });");
+  EXPECT_SCRIPT_TRUE("process instanceof Os.Process");
+
+  mock_io_delegate()->SetCallResult("ReadFile", 123);
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('output');"
+      "var reason;"
+      "process.appendOutputTo(doc, 'utf-8').catch(x => reason = x);");
+  EXPECT_SCRIPT_TRUE("reason instanceof Os.File.Error");
+  EXPECT_SCRIPT_EQ("123", "reason.winLastError");
+}
+
 TEST_F(OsProcessTest, OsProcess_open_failed) {
   mock_io_delegate()->SetOpenFileResult(domapi::IoContextId(), 123);
   EXPECT_SCRIPT_VALID(
@@ -43,6 +43,8 @@ using OpenFilePromise = Promise<FileId, IoError>;
 using OpenProcessPromise = Promise<ProcessId, IoError>;
 using OpenWinResourcePromise = Promise<WinResourceId, IoError>;
 using QueryFileStatusPromise = Promise<FileStatus, IoError>;
+using ReadDirectoryChangesPromise =
+    Promise<const std::vector<base::string16>&, IoError>;
 using ReadDirectoryPromise = Promise<const std::vector<FileStatus>&, IoError>;
 
 }  // namespace domapi
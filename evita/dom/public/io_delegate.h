@@ -75,7 +75,7 @@ class IoDelegate {
                         const MoveFileOptions& options,
                         IoBoolPromise resolver) = 0;
 
-  // Open directory for reading entries
+  // Open directory for reading entries of |dir_name|.
   virtual void OpenDirectory(const base::string16& dir_name,
                              OpenDirectoryPromise promise) = 0;
 
@@ -94,6 +94,11 @@ class IoDelegate {
                              size_t num_read,
                              ReadDirectoryPromise promise) = 0;
 
+  // Returns names of files changed in directory watched by |context_id|
+  // since the last call. An empty list means the system dropped changes.
+  virtual void ReadDirectoryChanges(IoContextId context_id,
+                                    ReadDirectoryChangesPromise promise) = 0;
+
   virtual void ReadFile(IoContextId context_id,
                         void* buffer,
                         size_t num_read,
@@ -102,11 +107,22 @@ class IoDelegate {
   virtual void RemoveFile(const base::string16& file_name,
                           IoBoolPromise resolver) = 0;
 
+  // Open directory for reading entries of directory tree of |dir_name|,
+  // named by relative path from |dir_name|, except for entries ignored by
+  // ".gitignore" files.
+  virtual void ScanDirectory(const base::string16& dir_name,
+                             OpenDirectoryPromise promise) = 0;
+
   virtual void WriteFile(IoContextId context_id,
                          void* buffer,
                          size_t num_write,
                          IoIntPromise promise) = 0;
 
+  // Starts watching changes of files in |dir_name|. Use |CloseContext()| to
+  // stop watching.
+  virtual void WatchDirectory(const base::string16& dir_name,
+                              OpenDirectoryPromise promise) = 0;
+
  protected:
   IoDelegate();
 
@@ -8,6 +8,14 @@
 namespace domapi {
 
 struct IoError final {
+  // Error codes detected by evita itself rather than the platform. They have
+  // same values as Windows' error codes, e.g. |ERROR_NO_UNICODE_TRANSLATION|,
+  // since scripts see them as platform error code.
+  static const int kWriteProtect = 19;
+  static const int kInvalidParameter = 87;
+  // Contents can't be decoded or encoded in requested encoding.
+  static const int kNoUnicodeTranslation = 1113;
+
   int error_code;
 
   explicit IoError(int error_code);
@@ -94,6 +94,13 @@ void MockIoDelegate::SetReadDirectoryResult(
   directory_entries_ = entries;
 }
 
+void MockIoDelegate::SetWatchDirectoryResult(domapi::IoContextId context_id,
+                                             int error_code) {
+  SetCallResult("WatchDirectory", error_code);
+  context_id_.Reset();
+  context_id_ = context_id;
+}
+
 void MockIoDelegate::SetResourceResult(base::StringPiece operation,
                                        int error_code,
                                        base::StringPiece16 type,
@@ -259,6 +266,17 @@ void MockIoDelegate::ReadDirectory(domapi::IoContextId,
   std::move(promise.resolve).Run(directory_entries_);
 }
 
+void MockIoDelegate::ReadDirectoryChanges(
+    domapi::IoContextId,
+    domapi::ReadDirectoryChangesPromise promise) {
+  auto const result = PopCallResult("ReadDirectoryChanges");
+  if (auto const error_code = result.error_code) {
+    std::move(promise.reject).Run(domapi::IoError(error_code));
+    return;
+  }
+  std::move(promise.resolve).Run(strings_);
+}
+
 void MockIoDelegate::ReadFile(domapi::IoContextId,
                               void* bytes,
                               size_t num_bytes,
@@ -268,8 +286,8 @@ void MockIoDelegate::ReadFile(domapi::IoContextId,
     std::move(promise.reject).Run(domapi::IoError(error_code));
     return;
   }
-  std::move(promise.resolve).Run(result.num_transferred);
   ::memcpy(bytes, bytes_.data(), std::min(bytes_.size(), num_bytes));
+  std::move(promise.resolve).Run(result.num_transferred);
 }
 
 void MockIoDelegate::RemoveFile(const base::string16&,
@@ -282,6 +300,12 @@ void MockIoDelegate::RemoveFile(const base::string16&,
     std::move(resolver.resolve).Run(true);
 }
 
+// Note: |ScanDirectory()| uses result of "OpenDirectory".
+void MockIoDelegate::ScanDirectory(const base::string16& dir_name,
+                                   domapi::OpenDirectoryPromise promise) {
+  OpenDirectory(dir_name, std::move(promise));
+}
+
 void MockIoDelegate::WriteFile(domapi::IoContextId,
                                void* bytes,
                                size_t num_bytes,
@@ -296,4 +320,18 @@ void MockIoDelegate::WriteFile(domapi::IoContextId,
   std::move(promise.resolve).Run(result.num_transferred);
 }
 
+// Note: Unless a test sets result of "WatchDirectory", we reject the call
+// as not supported, since loading and saving documents start watching.
+void MockIoDelegate::WatchDirectory(const base::string16&,
+                                    domapi::OpenDirectoryPromise promise) {
+  if (call_results_.empty() || call_results_.front().name != "WatchDirectory")
+    return std::move(promise.reject).Run(domapi::IoError(ERROR_NOT_SUPPORTED));
+  auto const result = PopCallResult("WatchDirectory");
+  if (auto const error_code = result.error_code) {
+    std::move(promise.reject).Run(domapi::IoError(error_code));
+    return;
+  }
+  std::move(promise.resolve).Run(domapi::DirectoryId(context_id_));
+}
+
 }  // namespace dom
@@ -49,6 +49,8 @@ class MockIoDelegate final : public domapi::IoDelegate {
   void SetStrings(base::StringPiece name,
                   int error_code,
                   const std::vector<base::string16>& strings);
+  void SetWatchDirectoryResult(domapi::IoContextId context_id,
+                               int error_code);
 
   // domapi::IoDelegate
   void CheckSpelling(const base::string16& word_to_check,
@@ -87,16 +89,22 @@ class MockIoDelegate final : public domapi::IoDelegate {
   void ReadDirectory(domapi::IoContextId context_id,
                      size_t num_read,
                      domapi::ReadDirectoryPromise promise) final;
+  void ReadDirectoryChanges(domapi::IoContextId context_id,
+                            domapi::ReadDirectoryChangesPromise promise) final;
   void ReadFile(domapi::IoContextId context_id,
                 void* buffer,
                 size_t num_read,
                 domapi::IoIntPromise promise) final;
   void RemoveFile(const base::string16& file_name,
                   domapi::IoBoolPromise resolver) final;
+  void ScanDirectory(const base::string16& dir_name,
+                     domapi::OpenDirectoryPromise promise) final;
   void WriteFile(domapi::IoContextId context_id,
                  void* buffer,
                  size_t num_write,
                  domapi::IoIntPromise promise) final;
+  void WatchDirectory(const base::string16& dir_name,
+                      domapi::OpenDirectoryPromise promise) final;
 
  private:
   struct CallResult final {
@@ -7,12 +7,17 @@
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/logging.h"
 #include "base/strings/stringprintf.h"
 #include "evita/dom/bindings/exception_state.h"
+#include "evita/dom/os/file_status.h"
+#include "evita/dom/promise_resolver.h"
 #include "evita/dom/public/view_delegate.h"
 #include "evita/dom/script_host.h"
 #include "evita/dom/text/regular_expression.h"
+#include "evita/dom/text/text_document_loader.h"
+#include "evita/dom/text/text_document_saver.h"
 #include "evita/dom/v8_strings.h"
 #include "evita/ginx/runner.h"
 #include "evita/metrics/time_scope.h"
@@ -139,6 +144,15 @@ bool TextDocument::IsValidRange(text::Offset start,
   return false;
 }
 
+v8::Local<v8::Promise> TextDocument::Load(const base::string16& file_name,
+                                          v8::Local<v8::Function> progress) {
+  const auto& loader = base::WrapRefCounted(new TextDocumentLoader(
+      this, file_name, TextDocumentLoader::Mode::Load));
+  loader->SetProgressCallback(progress);
+  return PromiseResolver::Call(
+      FROM_HERE, base::BindOnce(&TextDocumentLoader::Start, loader));
+}
+
 v8::Local<v8::Value> TextDocument::Match(RegularExpression* regexp,
                                          text::Offset start,
                                          text::Offset end) {
@@ -153,6 +167,13 @@ text::Offset TextDocument::Redo(text::Offset position) {
   return buffer_->Redo(position);
 }
 
+v8::Local<v8::Promise> TextDocument::Reload(const base::string16& file_name) {
+  const auto& loader = base::WrapRefCounted(new TextDocumentLoader(
+      this, file_name, TextDocumentLoader::Mode::Reload));
+  return PromiseResolver::Call(
+      FROM_HERE, base::BindOnce(&TextDocumentLoader::Start, loader));
+}
+
 void TextDocument::Replace(text::Offset start,
                            text::Offset end,
                            const base::string16& replacement,
@@ -162,6 +183,15 @@ void TextDocument::Replace(text::Offset start,
   buffer_->Replace(start, end, replacement);
 }
 
+v8::Local<v8::Promise> TextDocument::Save(const base::string16& file_name,
+                                          const base::string16& encoding,
+                                          int newline) {
+  const auto& saver = base::WrapRefCounted(
+      new TextDocumentSaver(this, file_name, encoding, newline));
+  return PromiseResolver::Call(
+      FROM_HERE, base::BindOnce(&TextDocumentSaver::Start, saver));
+}
+
 void TextDocument::SetSpelling(text::Offset start,
                                text::Offset end,
                                const base::string16& spelling,
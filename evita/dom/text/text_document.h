@@ -69,10 +69,23 @@ class TextDocument final : public ginx::Scriptable<TextDocument, EventTarget> {
   bool IsValidRange(text::Offset start,
                     text::Offset end,
                     ExceptionState* exception_state) const;
+  // Loads contents of |file_name| into this document. |progress| is called
+  // with number of bytes loaded so far after each chunk is inserted. Returned
+  // promise is resolved with encoding, newline and file status.
+  v8::Local<v8::Promise> Load(const base::string16& file_name,
+                              v8::Local<v8::Function> progress);
   v8::Local<v8::Value> Match(RegularExpression* regexp,
                              text::Offset start,
                              text::Offset end);
   text::Offset Redo(text::Offset position);
+  // Reloads contents of |file_name| by applying line differences to this
+  // document. Returned promise is resolved same as |Load()|.
+  v8::Local<v8::Promise> Reload(const base::string16& file_name);
+  // Saves contents of this document into |file_name|. Returned promise is
+  // resolved with file status of saved file.
+  v8::Local<v8::Promise> Save(const base::string16& file_name,
+                              const base::string16& encoding,
+                              int newline);
   void SetSpelling(text::Offset start,
                    text::Offset end,
                    const base::string16& spelling,
@@ -3,73 +3,6 @@
 // found in the LICENSE file.
 
 goog.scope(function() {
-/** @const @type {number} */
-const kBufferSize = 1024 * 64;
-
-/** @const @type {!RegExp} */
-const RE_CR = new RegExp('\r', 'g');
-
-/**
- * @class A wrapper class of |TextDecoder| to keep decoded strings.
- */
-class Decoder {
-  /**
-   * @param {string} encoding
-   */
-  constructor(encoding) {
-    /** @type {?TextDecoder} */
-    this.decoder_ = new TextDecoder(encoding, {fatal: true});
-    /** @type {!Array<string>} */
-    this.strings = [];
-  }
-
-  /** @return {string} */
-  get encoding() { return this.decoder_.encoding; }
-
-  /**
-   * @param {!Uint8Array} data
-   * @return {boolean}
-   */
-  decode(data) {
-    if (!this.decoder_)
-      return false;
-    try {
-      this.strings.push(this.decoder_.decode(data, {stream: data.length > 0}));
-      return true;
-    } catch (e) {
-      this.decoder_ = null;
-      return false;
-    }
-  }
-}
-
-/**
- * @class A text encoding detector.
- */
-class EncodingDetector {
-  constructor() {
-    /**
-     * @type {!Array<!Decoder>}
-     * A list of text encoding decoder in order of preference. The most
-     * preferred * encoding is at zero.
-     */
-    this.decoders_ =
-        [new Decoder('utf-8'), new Decoder('shift_jis'), new Decoder('euc-jp')];
-  }
-
-  /** @return {!Array<!Decoder>} */
-  get decoders() { return this.decoders_; }
-
-  /**
-   * @param {!Uint8Array} data
-   * @return {boolean}
-   */
-  detect(data) {
-    this.decoders_ = this.decoders_.filter(decoder => decoder.decode(data));
-    return this.decoders.length > 0;
-  }
-}
-
 /**
  * @param {!TextDocument} document
  */
@@ -79,128 +12,33 @@ function resetSelections(document) {
       .forEach((window) => { window.selection.range.collapseTo(0); });
 }
 
-/*
- * Load contents of |fileName| into |document|. The |document| is readonly
- * during reading file contents.
- *
- * |load| function updates following properties when loading succeeded:
- *    * |encoding|
- *    * |lastWriteTime|
- *    * |newline|
- *    * |readonly|
+/**
+ * @param {!TextDocument} document
+ * @param {!Object} result
+ * Reading file contents is finished. Update document properties based on
+ * file.
  */
-class FileLoader {
-  constructor(document) {
-    /** @const @type {!TextDocument} */
-    this.document_ = document;
-    /** @const @type {!EncodingDetector} */
-    this.detector_ = new EncodingDetector();
-    /** @type {string} */
-    this.encoding_ = '';
-    /** @type {?Os.File} */
-    this.file_ = null;
-    /** @type {boolean} */
-    this.firstRead_ = true;
-    /** @type {boolean} */
-    this.readonly_ = document.readonly;
-  }
-
-  close() {
-    this.document_.readonly = this.readonly_;
-    if (!this.file_)
-      return;
-    this.file_.close();
-    this.file_ = null;
-  }
-
-  didRead(readData, numRead) {
-    const detector = this.detector_;
-    if (!detector.detect(readData.subarray(0, numRead)))
-      throw new Error('Bad encoding');
-
-    // Display loading result
-    // Note: We may display text in wrong encoding.
-    /** @const @type {!TextDocument} */
-    const document = this.document_;
-    document.readonly = false;
-    /** @const @type {!Decoder} */
-    const decoder = detector.decoders[0];
-    /** @const @type {string} */
-    const string =
-        decoder.strings[decoder.strings.length - 1].replace(RE_CR, '');
-    document.replace(document.length, document.length, string);
-    document.readonly = true;
-
-    // TDOO(eval1749): We should have loading progress UI feedback since we
-    // shows top of document during loading.
-    if (this.firstRead_) {
-      this.firstRead_ = false;
-      resetSelections(document);
-    }
-  }
-
-  load(fileName) {
-    return (async(function * (loader, fileName) {
-      loader.file_ = yield Os.File.open(fileName);
-      /** @const @type {!Os.File} */
-      const file = loader.file_;
-      /** @const @type {!Uint8Array} */
-      const readData = new Uint8Array(kBufferSize);
-      for (;;) {
-        /** @const @type {number} */
-        const numRead = yield file.read(readData);
-        if (numRead === 0)
-          break;
-        loader.didRead(readData, numRead);
-      }
-      /** @const @type {!Os.File.Info} */
-      const fileInfo = yield Os.File.stat(fileName);
-      loader.finish(fileInfo);
-    }))(this, fileName);
-  }
-
-  /**
-   * @param {!Os.File.Info} fileInfo
-   * Reading file contents is finished. Record file last write time.
-   */
-  finish(fileInfo) {
-    /** @const @type {!EncodingDetector} */
-    const detector = this.detector_;
-    /** @const @type {?Decoder} */
-    const decoder = detector.decoders[0];
-    if (!decoder)
-      throw new Error('Bad encoding');
-
-    this.readonly_ = fileInfo.readonly;
-
-    /** @const @type {!TextDocument} */
-    const document = this.document_;
-
-    // Adjust newline character
-    document.readonly = false;
-    document.replace(0, document.length, '');
-    /** @type {!Newline} */
-    let newline = Newline.UNKNOWN;
-    decoder.strings.forEach(function(string) {
-      if (newline === Newline.UNKNOWN) {
-        if (string.indexOf('\r\n') >= 0)
-          newline = Newline.CRLF;
-        else if (string.indexOf('\n') >= 0)
-          newline = Newline.LF;
-      }
-      if (newline === Newline.CRLF)
-        string = string.replace(RE_CR, '');
-      document.replace(document.length, document.length, string);
-    });
-    resetSelections(document);
+function didLoad(document, result) {
+  resetSelections(document);
+  document.encoding = result['encoding'];
+  document.lastWriteTime = result['lastWriteTime'];
+  document.modified = false;
+  document.newline = /** @type {!Newline} */ (result['newline']);
+  document.readonly = result['readonly'];
+  document.clearUndo();
+}
 
-    // Update document properties based on file.
-    document.encoding = decoder.encoding;
-    document.lastWriteTime = fileInfo.lastModificationDate;
-    document.modified = false;
-    document.newline = newline;
-    document.clearUndo();
-  }
+/**
+ * @param {!TextDocument} document
+ * @param {number} numBytesRead
+ * Shows number of bytes loaded so far in windows of |document|, since we
+ * show top of document during loading.
+ */
+function didLoadChunk(document, numBytesRead) {
+  /** @const @type {string} */
+  const status = `Loading ${document.fileName} ` +
+      `(${Math.ceil(numBytesRead / 1024)}KB)`;
+  document.listWindows().forEach(window => window.status = status);
 }
 
 /**
@@ -241,23 +79,57 @@ function load(opt_fileName) {
       null, 'Loading ' + document.fileName, MessageBox.ICONINFORMATION);
   document.dispatchEvent(new TextDocumentEvent(Event.Names.BEFORELOAD));
 
-  // Start loading
-  /** @const @type {!FileLoader} */
-  const loader = new FileLoader(document);
-  return loader.load(document.fileName)
-      .then(function(length) {
-        loader.close();
+  // Contents of file are read, decoded and inserted into |document| chunk by
+  // chunk in native code. |document| is readonly during loading.
+  return document
+      .load_(
+          document.fileName,
+          numBytesRead => didLoadChunk(document, numBytesRead))
+      .then(function(result) {
+        didLoad(document, result);
         Editor.messageBox(
             null, 'Loaded ' + document.fileName, MessageBox.ICONINFORMATION);
         finishLoad(document, TextDocument.Obsolete.NO);
-        return length;
+        return document.length;
       })
       .catch(function(exception) {
-        loader.close();
         finishLoad(document, TextDocument.Obsolete.UNKNOWN);
         throw exception;
       });
 }
 
+/**
+ * @this {!TextDocument}
+ * @return {!Promise<number>}
+ *
+ * Reloads contents of file bound to this document by applying line
+ * differences, so unchanged lines keep markers and selections, and reload
+ * can be undone. Since native code edits |document| as usual mutations, we
+ * don't dispatch "beforeload" and "load" events.
+ */
+function reload() {
+  /** @const  @type {!TextDocument} */
+  const document = this;
+  if (document.fileName === '')
+    throw 'TextDocument isn\'t bound to file.';
+  document.obsolete = TextDocument.Obsolete.CHECKING;
+  return document.reload_(document.fileName)
+      .then(function(result) {
+        document.encoding = result['encoding'];
+        document.lastWriteTime = result['lastWriteTime'];
+        document.modified = false;
+        document.newline = /** @type {!Newline} */ (result['newline']);
+        document.readonly = result['readonly'];
+        document.obsolete = TextDocument.Obsolete.NO;
+        document.lastStatTime_ = new Date();
+        return document.length;
+      })
+      .catch(function(exception) {
+        document.obsolete = TextDocument.Obsolete.UNKNOWN;
+        throw exception;
+      });
+}
+
 Object.defineProperty(TextDocument.prototype, 'load', {value: load});
+Object.defineProperty(TextDocument.prototype, 'reload', {value: reload});
 });
@@ -0,0 +1,420 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/dom/text/text_document_loader.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/auto_reset.h"
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/trace_event/trace_event.h"
+#include "evita/dom/converter.h"
+#include "evita/dom/public/io_delegate.h"
+#include "evita/dom/script_host.h"
+#include "evita/dom/text/text_document.h"
+#include "evita/ginx/runner.h"
+#include "evita/text/encodings/decoder.h"
+#include "evita/text/encodings/encodings.h"
+#include "evita/text/models/buffer.h"
+#include "evita/text/models/scoped_undo_group.h"
+#include "evita/text/models/text_diff.h"
+
+namespace dom {
+
+namespace {
+
+const size_t kChunkSize = 64 * 1024;
+
+// Number of reads in flight.
+const size_t kNumReadAheads = 4;
+
+// Candidate encodings in order of preference, used until we see non-ASCII
+// bytes.
+const base::char16* const kEncodings[] = {L"utf-8", L"shift_jis", L"euc-jp"};
+
+// See |Newline| in "evita/dom/enums.js".
+const int kNewlineUnknown = 0;
+const int kNewlineLf = 1;
+const int kNewlineCrLf = 3;
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// TextDocumentLoader
+//
+TextDocumentLoader::TextDocumentLoader(TextDocument* document,
+                                       const base::string16& file_name,
+                                       Mode mode)
+    : chars_(encodings::Decoder::MaxCharsOf(kChunkSize)),
+      chunks_(kNumReadAheads),
+      document_(document),
+      encodings_(std::begin(kEncodings), std::end(kEncodings)),
+      file_name_(file_name),
+      mode_(mode) {
+  for (auto& chunk : chunks_)
+    chunk.bytes.resize(kChunkSize);
+}
+
+TextDocumentLoader::~TextDocumentLoader() {
+  DCHECK(!is_open_);
+  DCHECK(!num_pending_reads_);
+}
+
+// Appends |chars| to document with newline normalization. When the first
+// newline of file is CRLF, we replace CRLF to LF, otherwise we keep file
+// contents as is. Note: CR at end of chunk is kept in |has_pending_cr_|
+// until we see next character.
+void TextDocumentLoader::Append(const base::char16* chars, size_t length) {
+  text_.clear();
+  for (auto runner = chars; runner < chars + length; ++runner) {
+    auto const char_code = *runner;
+    if (has_pending_cr_) {
+      has_pending_cr_ = false;
+      if (char_code == '\n') {
+        if (result_.newline == kNewlineUnknown)
+          result_.newline = kNewlineCrLf;
+        if (result_.newline == kNewlineCrLf) {
+          text_.push_back('\n');
+          continue;
+        }
+      }
+      text_.push_back('\r');
+    }
+    if (char_code == '\r') {
+      has_pending_cr_ = true;
+      continue;
+    }
+    if (char_code == '\n' && result_.newline == kNewlineUnknown)
+      result_.newline = kNewlineLf;
+    text_.push_back(char_code);
+  }
+  if (text_.empty())
+    return;
+  if (mode_ == Mode::Reload) {
+    new_text_.append(text_);
+    return;
+  }
+  auto* const buffer = document_->buffer();
+  buffer->SetReadOnly(false);
+  buffer->InsertBefore(buffer->GetEnd(), text_);
+  buffer->SetReadOnly(true);
+}
+
+// Replaces document contents with |new_text_| by line edits in one undo
+// group, so "undo" restores contents before reload.
+void TextDocumentLoader::ApplyNewText() {
+  TRACE_EVENT1("io", "TextDocumentLoader::ApplyNewText", "length",
+               new_text_.size());
+  auto* const buffer = document_->buffer();
+  buffer->SetReadOnly(false);
+  {
+    text::ScopedUndoGroup undo_group(buffer, L"Reload");
+    text::ReplaceTextByLineEdits(buffer, new_text_);
+  }
+  buffer->SetReadOnly(true);
+  base::string16().swap(new_text_);
+}
+
+TextDocumentLoader::Chunk& TextDocumentLoader::ChunkOf(size_t sequence_num) {
+  return chunks_[sequence_num % chunks_.size()];
+}
+
+void TextDocumentLoader::Close(base::OnceClosure callback) {
+  DCHECK(is_open_);
+  is_open_ = false;
+  close_callback_ = std::move(callback);
+  domapi::IoIntPromise promise;
+  promise.reject = base::BindOnce(&TextDocumentLoader::DidFailToClose,
+                                  base::WrapRefCounted(this));
+  promise.resolve =
+      base::BindOnce(&TextDocumentLoader::DidClose, base::WrapRefCounted(this));
+  ScriptHost::instance()->io_delegate()->CloseContext(context_id_,
+                                                      std::move(promise));
+}
+
+bool TextDocumentLoader::DecodeChunk(const Chunk& chunk) {
+  TRACE_EVENT1("io", "TextDocumentLoader::DecodeChunk", "num_read",
+               chunk.num_read);
+  if (!is_encoding_fixed_) {
+    detector_.Feed(chunk.bytes.data(), chunk.num_read);
+    if (!detector_.is_ascii())
+      FixEncoding();
+  }
+  const auto& result = decoder_->DecodeTo(chunk.bytes.data(), chunk.num_read,
+                                          true, chars_.data());
+  if (!result.left)
+    return false;
+  Append(chars_.data(), result.right);
+  num_bytes_decoded_ += chunk.num_read;
+  ReportProgress();
+  return true;
+}
+
+// Decodes chunks read so far in file order, then issues reads into decoded
+// chunks.
+void TextDocumentLoader::DecodeChunks() {
+  while (num_decoded_ < num_issued_) {
+    const auto& chunk = ChunkOf(num_decoded_);
+    if (!chunk.is_done)
+      break;
+    if (chunk.error) {
+      return WaitForReads(base::BindOnce(&TextDocumentLoader::DidFail,
+                                         base::WrapRefCounted(this),
+                                         domapi::IoError(chunk.error)));
+    }
+    if (chunk.num_read == 0) {
+      // Reads after end of file are still in flight.
+      if (num_pending_reads_)
+        return;
+      return DidReadAll();
+    }
+    ++num_decoded_;
+    if (!DecodeChunk(chunk)) {
+      return WaitForReads(base::BindOnce(&TextDocumentLoader::Restart,
+                                         base::WrapRefCounted(this)));
+    }
+  }
+  Read();
+}
+
+void TextDocumentLoader::DidClose(int) {
+  std::move(close_callback_).Run();
+}
+
+void TextDocumentLoader::DidFail(domapi::IoError error) {
+  if (!is_open_)
+    return Reject(error);
+  Close(base::BindOnce(&TextDocumentLoader::Reject, base::WrapRefCounted(this),
+                       error));
+}
+
+void TextDocumentLoader::DidFailToClose(domapi::IoError error) {
+  DVLOG(0) << "CloseContext failed error_code=" << error.error_code;
+  std::move(close_callback_).Run();
+}
+
+void TextDocumentLoader::DidFailToRead(size_t sequence_num,
+                                       domapi::IoError error) {
+  DCHECK_GT(num_pending_reads_, 0);
+  --num_pending_reads_;
+  if (wait_for_reads_callback_) {
+    if (!num_pending_reads_)
+      std::move(wait_for_reads_callback_).Run();
+    return;
+  }
+  auto& chunk = ChunkOf(sequence_num);
+  chunk.error = error.error_code;
+  chunk.is_done = true;
+  is_eof_ = true;
+  DecodeChunks();
+}
+
+void TextDocumentLoader::DidOpen(domapi::FileId context_id) {
+  context_id_ = context_id;
+  is_eof_ = false;
+  is_open_ = true;
+  num_decoded_ = 0;
+  num_issued_ = 0;
+  Read();
+}
+
+void TextDocumentLoader::DidQueryFileStatus(domapi::FileStatus file_status) {
+  result_.file_status = file_status;
+  Close(base::BindOnce(&TextDocumentLoader::Resolve,
+                       base::WrapRefCounted(this)));
+}
+
+void TextDocumentLoader::DidRead(size_t sequence_num, int num_read) {
+  TRACE_EVENT1("io", "TextDocumentLoader::DidRead", "num_read", num_read);
+  DCHECK_GT(num_pending_reads_, 0);
+  --num_pending_reads_;
+  if (wait_for_reads_callback_) {
+    if (!num_pending_reads_)
+      std::move(wait_for_reads_callback_).Run();
+    return;
+  }
+  auto& chunk = ChunkOf(sequence_num);
+  chunk.is_done = true;
+  chunk.num_read = num_read;
+  if (num_read == 0)
+    is_eof_ = true;
+  DecodeChunks();
+}
+
+void TextDocumentLoader::DidReadAll() {
+  if (has_pending_cr_) {
+    has_pending_cr_ = false;
+    const base::char16 kCr = '\r';
+    Append(&kCr, 1);
+  }
+  domapi::QueryFileStatusPromise promise;
+  promise.reject =
+      base::BindOnce(&TextDocumentLoader::DidFail, base::WrapRefCounted(this));
+  promise.resolve = base::BindOnce(&TextDocumentLoader::DidQueryFileStatus,
+                                   base::WrapRefCounted(this));
+  ScriptHost::instance()->io_delegate()->QueryFileStatus(file_name_,
+                                                         std::move(promise));
+}
+
+// Orders |encodings_| by likelihood from |detector_|. Candidates eliminated
+// by |detector_| are kept at end of |encodings_|, since detector is
+// stricter than decoders, e.g. Shift_JIS decoder accepts 0x80.
+void TextDocumentLoader::FixEncoding() {
+  DCHECK(!is_encoding_fixed_);
+  TRACE_EVENT2("io", "TextDocumentLoader::FixEncoding", "encoding",
+               base::UTF16ToUTF8(detector_.encoding()), "confidence",
+               detector_.confidence());
+  is_encoding_fixed_ = true;
+  auto encodings = detector_.Candidates();
+  for (const auto& encoding : encodings_) {
+    if (std::find(encodings.begin(), encodings.end(), encoding) ==
+        encodings.end()) {
+      encodings.push_back(encoding);
+    }
+  }
+  encodings_.swap(encodings);
+  encoding_index_ = 0;
+  if (decoder_->name() == encodings_.front())
+    return;
+  // Bytes decoded so far are ASCII, so a new decoder can continue.
+  decoder_.reset(encodings::Encodings::instance()->GetDecoder(
+      encodings_[encoding_index_]));
+  DCHECK(decoder_) << encodings_[encoding_index_];
+  result_.encoding = decoder_->name();
+}
+
+void TextDocumentLoader::Open() {
+  domapi::OpenFilePromise promise;
+  promise.reject =
+      base::BindOnce(&TextDocumentLoader::DidFail, base::WrapRefCounted(this));
+  promise.resolve =
+      base::BindOnce(&TextDocumentLoader::DidOpen, base::WrapRefCounted(this));
+  ScriptHost::instance()->io_delegate()->OpenFile(file_name_, base::string16(),
+                                                  std::move(promise));
+}
+
+// Issues reads until all chunks are in flight or wait for decoding. Note:
+// |io_delegate()| may call back synchronously, e.g. in tests, so we don't
+// issue reads recursively.
+void TextDocumentLoader::Read() {
+  if (is_in_read_)
+    return;
+  base::AutoReset<bool> in_read_scope(&is_in_read_, true);
+  while (is_open_ && !is_eof_ && !wait_for_reads_callback_ &&
+         num_issued_ - num_decoded_ < chunks_.size()) {
+    auto& chunk = ChunkOf(num_issued_);
+    chunk.error = 0;
+    chunk.is_done = false;
+    chunk.num_read = 0;
+    domapi::IoIntPromise promise;
+    promise.reject = base::BindOnce(&TextDocumentLoader::DidFailToRead,
+                                    base::WrapRefCounted(this), num_issued_);
+    promise.resolve = base::BindOnce(&TextDocumentLoader::DidRead,
+                                     base::WrapRefCounted(this), num_issued_);
+    ++num_issued_;
+    ++num_pending_reads_;
+    ScriptHost::instance()->io_delegate()->ReadFile(
+        context_id_, chunk.bytes.data(), chunk.bytes.size(),
+        std::move(promise));
+  }
+}
+
+void TextDocumentLoader::Reject(domapi::IoError error) {
+  document_->buffer()->SetReadOnly(read_only_);
+  std::move(promise_.reject).Run(error);
+}
+
+void TextDocumentLoader::ReportProgress() {
+  if (progress_callback_.IsEmpty())
+    return;
+  auto* const runner = ScriptHost::instance()->runner();
+  ginx::Runner::Scope runner_scope(runner);
+  auto* const isolate = runner->isolate();
+  runner->CallAsFunction(
+      progress_callback_.NewLocal(isolate), v8::Undefined(isolate),
+      gin::ConvertToV8(isolate, static_cast<double>(num_bytes_decoded_)));
+}
+
+void TextDocumentLoader::ResetContents() {
+  if (mode_ == Mode::Reload) {
+    new_text_.clear();
+  } else {
+    auto* const buffer = document_->buffer();
+    buffer->SetReadOnly(false);
+    buffer->Delete(text::Offset(), buffer->GetEnd());
+    buffer->SetReadOnly(true);
+  }
+  decoder_.reset(encodings::Encodings::instance()->GetDecoder(
+      encodings_[encoding_index_]));
+  DCHECK(decoder_) << encodings_[encoding_index_];
+  has_pending_cr_ = false;
+  num_bytes_decoded_ = 0;
+  result_.encoding = decoder_->name();
+  result_.newline = kNewlineUnknown;
+}
+
+// In |Mode::Reload|, we change document only after we get file status, so
+// document is unchanged when reload fails.
+void TextDocumentLoader::Resolve() {
+  if (mode_ == Mode::Reload)
+    ApplyNewText();
+  document_->buffer()->SetReadOnly(read_only_);
+  std::move(promise_.resolve).Run(result_);
+}
+
+// Loads file again with next candidate encoding, since |decoder_| can't
+// decode file contents.
+void TextDocumentLoader::Restart() {
+  is_encoding_fixed_ = true;
+  ++encoding_index_;
+  if (encoding_index_ == encodings_.size())
+    return DidFail(domapi::IoError(domapi::IoError::kNoUnicodeTranslation));
+  ResetContents();
+  Close(base::BindOnce(&TextDocumentLoader::Open, base::WrapRefCounted(this)));
+}
+
+void TextDocumentLoader::SetProgressCallback(
+    v8::Local<v8::Function> callback) {
+  progress_callback_.Reset(ScriptHost::instance()->isolate(), callback);
+}
+
+void TextDocumentLoader::Start(LoadPromise promise) {
+  promise_ = std::move(promise);
+  read_only_ = document_->buffer()->IsReadOnly();
+  // Since |Mode::Reload| applies differences between contents at start and
+  // file contents, we don't allow changing document while loading.
+  document_->buffer()->SetReadOnly(true);
+  ResetContents();
+  Open();
+}
+
+void TextDocumentLoader::WaitForReads(base::OnceClosure callback) {
+  DCHECK(!wait_for_reads_callback_);
+  if (!num_pending_reads_)
+    return std::move(callback).Run();
+  wait_for_reads_callback_ = std::move(callback);
+}
+
+}  // namespace dom
+
+namespace gin {
+v8::Local<v8::Value> Converter<dom::TextDocumentLoadResult>::ToV8(
+    v8::Isolate* isolate,
+    const dom::TextDocumentLoadResult& result) {
+  auto const js_result = v8::Object::New(isolate);
+  js_result->Set(gin::StringToV8(isolate, "encoding"),
+                 gin::ConvertToV8(isolate, result.encoding));
+  js_result->Set(gin::StringToV8(isolate, "lastWriteTime"),
+                 gin::ConvertToV8(isolate, result.file_status.last_write_time));
+  js_result->Set(gin::StringToV8(isolate, "newline"),
+                 v8::Integer::New(isolate, result.newline));
+  js_result->Set(gin::StringToV8(isolate, "readonly"),
+                 gin::ConvertToV8(isolate, result.file_status.readonly));
+  return js_result;
+}
+}  // namespace gin
@@ -0,0 +1,182 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_DOM_TEXT_TEXT_DOCUMENT_LOADER_H_
+#define EVITA_DOM_TEXT_TEXT_DOCUMENT_LOADER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string16.h"
+#include "evita/dom/public/io_callback.h"
+#include "evita/dom/public/io_context_id.h"
+#include "evita/dom/public/io_error.h"
+#include "evita/dom/public/promise.h"
+#include "evita/gc/member.h"
+#include "evita/ginx/converter.h"
+#include "evita/ginx/scoped_persistent.h"
+#include "evita/text/encodings/encoding_detector.h"
+
+namespace encodings {
+class Decoder;
+}
+
+namespace dom {
+
+class TextDocument;
+
+//////////////////////////////////////////////////////////////////////
+//
+// TextDocumentLoadResult
+//
+struct TextDocumentLoadResult final {
+  base::string16 encoding;
+  domapi::FileStatus file_status;
+  // See |Newline| in "evita/dom/enums.js".
+  int newline = 0;
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// TextDocumentLoader
+// Loads contents of a file into |TextDocument| chunk by chunk: reads a
+// chunk, decodes it, normalizes newlines and appends it to the document,
+// reusing buffers for each chunk.
+//
+// The loader keeps several reads in flight into a ring of chunk buffers and
+// decodes chunks in file order, so reading a file overlaps with decoding
+// and inserting chunks read before.
+//
+// Encoding is decided by |encodings::EncodingDetector| on the first chunk
+// containing non-ASCII bytes; chunks before it are ASCII and decoded same
+// by all candidates. When the chosen encoding fails to decode a chunk, the
+// loader discards loaded contents and loads the file again with the next
+// candidate.
+//
+// In |Mode::Reload|, the loader accumulates decoded text instead of
+// appending to the document, then applies minimal line edits between
+// current contents and file contents to the document at end of file, so
+// markers and selections in unchanged lines survive reload, and reload can
+// be undone. The document is read-only while loading, and is unchanged
+// when reload fails.
+//
+// Since a promise is settled once, progress is reported to the callback set
+// by |SetProgressCallback()| after each chunk is inserted, and the promise
+// is settled when the whole file is loaded.
+//
+class TextDocumentLoader final
+    : public base::RefCounted<TextDocumentLoader> {
+ public:
+  using LoadPromise = domapi::Promise<TextDocumentLoadResult, domapi::IoError>;
+
+  enum class Mode {
+    Load,
+    Reload,
+  };
+
+  TextDocumentLoader(TextDocument* document,
+                     const base::string16& file_name,
+                     Mode mode);
+
+  // Sets |callback| to be called with number of bytes loaded so far.
+  void SetProgressCallback(v8::Local<v8::Function> callback);
+  void Start(LoadPromise promise);
+
+ private:
+  friend class base::RefCounted<TextDocumentLoader>;
+
+  ~TextDocumentLoader();
+
+  // |Chunk| holds bytes of a read in flight, or read but not yet decoded.
+  struct Chunk {
+    std::vector<uint8_t> bytes;
+    int error = 0;
+    bool is_done = false;
+    int num_read = 0;
+  };
+
+  void Append(const base::char16* chars, size_t length);
+  void ApplyNewText();
+  Chunk& ChunkOf(size_t sequence_num);
+  void Close(base::OnceClosure callback);
+  // Returns false if |decoder_| can't decode |chunk|.
+  bool DecodeChunk(const Chunk& chunk);
+  void DecodeChunks();
+  void DidClose(int dummy);
+  void DidFail(domapi::IoError error);
+  void DidFailToClose(domapi::IoError error);
+  void DidFailToRead(size_t sequence_num, domapi::IoError error);
+  void DidOpen(domapi::FileId context_id);
+  void DidQueryFileStatus(domapi::FileStatus file_status);
+  void DidRead(size_t sequence_num, int num_read);
+  void DidReadAll();
+  void FixEncoding();
+  void Open();
+  void Read();
+  void Reject(domapi::IoError error);
+  void ReportProgress();
+  void Resolve();
+  void ResetContents();
+  void Restart();
+  // Runs |callback| after all reads in flight are finished. Results of
+  // these reads are discarded.
+  void WaitForReads(base::OnceClosure callback);
+
+  // |chars_| holds decoded characters of a chunk.
+  std::vector<base::char16> chars_;
+  // Ring of chunk buffers indexed by sequence number of read.
+  std::vector<Chunk> chunks_;
+  base::OnceClosure close_callback_;
+  domapi::IoContextId context_id_;
+  std::unique_ptr<encodings::Decoder> decoder_;
+  encodings::EncodingDetector detector_;
+  gc::Member<TextDocument> document_;
+  size_t encoding_index_ = 0;
+  // Candidate encodings in order of likelihood.
+  std::vector<base::string16> encodings_;
+  const base::string16 file_name_;
+  bool has_pending_cr_ = false;
+  bool is_encoding_fixed_ = false;
+  // True if we saw end of file or read error, so we don't issue more reads.
+  bool is_eof_ = false;
+  bool is_in_read_ = false;
+  bool is_open_ = false;
+  const Mode mode_;
+  // |new_text_| holds decoded contents of file in |Mode::Reload|.
+  base::string16 new_text_;
+  // Number of bytes decoded, reported to |progress_callback_|.
+  size_t num_bytes_decoded_ = 0;
+  // Sequence number of the next chunk to decode.
+  size_t num_decoded_ = 0;
+  // Sequence number of the next read.
+  size_t num_issued_ = 0;
+  int num_pending_reads_ = 0;
+  ginx::ScopedPersistent<v8::Function> progress_callback_;
+  LoadPromise promise_;
+  bool read_only_ = false;
+  TextDocumentLoadResult result_;
+  // |text_| holds newline normalized text of a chunk to reuse its storage
+  // for each chunk.
+  base::string16 text_;
+  base::OnceClosure wait_for_reads_callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(TextDocumentLoader);
+};
+
+}  // namespace dom
+
+namespace gin {
+template <>
+struct Converter<dom::TextDocumentLoadResult> {
+  static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
+                                   const dom::TextDocumentLoadResult& result);
+};
+}  // namespace gin
+
+#endif  // EVITA_DOM_TEXT_TEXT_DOCUMENT_LOADER_H_
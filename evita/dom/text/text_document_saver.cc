@@ -0,0 +1,265 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/dom/text/text_document_saver.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/trace_event/trace_event.h"
+#include "evita/dom/public/io_delegate.h"
+#include "evita/dom/script_host.h"
+#include "evita/dom/text/text_document.h"
+#include "evita/text/encodings/encoder.h"
+#include "evita/text/encodings/encodings.h"
+#include "evita/text/models/buffer.h"
+
+namespace dom {
+
+namespace {
+
+// Number of characters of a block.
+const int kBlockSize = 64 * 1024;
+
+// See |Newline| in "evita/dom/enums.js".
+const int kNewlineLf = 1;
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// TextDocumentSaver
+//
+TextDocumentSaver::TextDocumentSaver(TextDocument* document,
+                                     const base::string16& file_name,
+                                     const base::string16& encoding,
+                                     int newline)
+    : chars_(kBlockSize),
+      document_(document),
+      encoder_(encodings::Encodings::instance()->GetEncoder(encoding)),
+      error_(0),
+      file_name_(file_name),
+      is_crlf_(newline != kNewlineLf) {}
+
+TextDocumentSaver::~TextDocumentSaver() {
+  DCHECK(!is_open_);
+  DCHECK(!is_writing_);
+}
+
+void TextDocumentSaver::Close(base::OnceClosure callback) {
+  DCHECK(is_open_);
+  is_open_ = false;
+  close_callback_ = std::move(callback);
+  domapi::IoIntPromise promise;
+  promise.reject = base::BindOnce(&TextDocumentSaver::DidFailToClose,
+                                  base::WrapRefCounted(this));
+  promise.resolve =
+      base::BindOnce(&TextDocumentSaver::DidClose, base::WrapRefCounted(this));
+  ScriptHost::instance()->io_delegate()->CloseContext(context_id_,
+                                                      std::move(promise));
+}
+
+void TextDocumentSaver::DidClose(int) {
+  std::move(close_callback_).Run();
+}
+
+void TextDocumentSaver::DidFail(domapi::IoError error) {
+  error_ = error;
+  if (!is_open_)
+    return RemoveTempFile();
+  Close(base::BindOnce(&TextDocumentSaver::RemoveTempFile,
+                       base::WrapRefCounted(this)));
+}
+
+// Unlike loading, we should not treat temporary file as saved, since
+// contents may not be flushed.
+void TextDocumentSaver::DidFailToClose(domapi::IoError error) {
+  DVLOG(0) << "CloseContext failed error_code=" << error.error_code;
+  close_callback_.Reset();
+  if (error_.error_code)
+    return RemoveTempFile();
+  DidFail(error);
+}
+
+// We don't remove temporary file which we can't open.
+void TextDocumentSaver::DidFailToOpen(domapi::IoError error) {
+  temp_file_name_.clear();
+  DidFail(error);
+}
+
+void TextDocumentSaver::DidFailToRemoveFile(domapi::IoError error) {
+  DVLOG(0) << "RemoveFile failed error_code=" << error.error_code;
+  Reject();
+}
+
+void TextDocumentSaver::DidFailToWrite(domapi::IoError error) {
+  DCHECK(is_writing_);
+  is_writing_ = false;
+  DidFail(error);
+}
+
+void TextDocumentSaver::DidMakeTempFileName(base::string16 temp_file_name) {
+  temp_file_name_ = temp_file_name;
+  domapi::OpenFilePromise promise;
+  promise.reject = base::BindOnce(&TextDocumentSaver::DidFailToOpen,
+                                  base::WrapRefCounted(this));
+  promise.resolve =
+      base::BindOnce(&TextDocumentSaver::DidOpen, base::WrapRefCounted(this));
+  ScriptHost::instance()->io_delegate()->OpenFile(temp_file_name_, L"w",
+                                                  std::move(promise));
+}
+
+// Note: We encode the first block before the first write, so an encoding
+// error doesn't produce partially written temporary file.
+void TextDocumentSaver::DidOpen(domapi::FileId context_id) {
+  context_id_ = context_id;
+  is_open_ = true;
+  if (!EncodeNext())
+    return DidFail(domapi::IoError(domapi::IoError::kNoUnicodeTranslation));
+  WriteNext();
+}
+
+void TextDocumentSaver::DidQueryFileStatus(domapi::FileStatus file_status) {
+  std::move(promise_.resolve).Run(file_status);
+}
+
+void TextDocumentSaver::DidRemoveFile(bool) {
+  Reject();
+}
+
+void TextDocumentSaver::DidRename(bool) {
+  temp_file_name_.clear();
+  domapi::QueryFileStatusPromise promise;
+  promise.reject =
+      base::BindOnce(&TextDocumentSaver::DidFail, base::WrapRefCounted(this));
+  promise.resolve = base::BindOnce(&TextDocumentSaver::DidQueryFileStatus,
+                                   base::WrapRefCounted(this));
+  ScriptHost::instance()->io_delegate()->QueryFileStatus(file_name_,
+                                                         std::move(promise));
+}
+
+void TextDocumentSaver::DidWrite(int num_written) {
+  DCHECK(is_writing_);
+  DCHECK_EQ(writing_.size(), static_cast<size_t>(num_written));
+  is_writing_ = false;
+  if (is_in_write_next_)
+    return;
+  WriteNext();
+}
+
+// We always terminate the last line with newline, since some tools don't
+// work well without it. An empty document is saved as a newline.
+bool TextDocumentSaver::EncodeNext() {
+  TRACE_EVENT0("io", "TextDocumentSaver::EncodeNext");
+  encoded_.clear();
+  if (is_done_)
+    return true;
+  auto* const buffer = document_->buffer();
+  auto end = std::min(end_, offset_ + text::OffsetDelta(kBlockSize));
+  // Don't split surrogate pair into blocks.
+  if (end < end_) {
+    const auto last = end - text::OffsetDelta(1);
+    if (IS_HIGH_SURROGATE(buffer->GetCharAt(last)))
+      end = last;
+  }
+  const auto length = buffer->GetText(chars_.data(), offset_, end);
+  offset_ = end;
+  text_.clear();
+  for (auto runner = chars_.data(); runner < chars_.data() + length;
+       ++runner) {
+    if (*runner == '\n' && is_crlf_)
+      text_.push_back('\r');
+    text_.push_back(*runner);
+  }
+  is_done_ = offset_ == end_;
+  if (is_done_ && (text_.empty() || text_.back() != '\n')) {
+    if (is_crlf_)
+      text_.push_back('\r');
+    text_.push_back('\n');
+  }
+  auto result = encoder_->Encode(text_, !is_done_);
+  if (result.left)
+    return false;
+  encoded_ = std::move(result.right);
+  return true;
+}
+
+void TextDocumentSaver::Reject() {
+  std::move(promise_.reject).Run(error_);
+}
+
+void TextDocumentSaver::RemoveTempFile() {
+  if (temp_file_name_.empty())
+    return Reject();
+  domapi::IoBoolPromise promise;
+  promise.reject = base::BindOnce(&TextDocumentSaver::DidFailToRemoveFile,
+                                  base::WrapRefCounted(this));
+  promise.resolve = base::BindOnce(&TextDocumentSaver::DidRemoveFile,
+                                   base::WrapRefCounted(this));
+  ScriptHost::instance()->io_delegate()->RemoveFile(temp_file_name_,
+                                                    std::move(promise));
+}
+
+void TextDocumentSaver::Rename() {
+  domapi::IoBoolPromise promise;
+  promise.reject =
+      base::BindOnce(&TextDocumentSaver::DidFail, base::WrapRefCounted(this));
+  promise.resolve =
+      base::BindOnce(&TextDocumentSaver::DidRename, base::WrapRefCounted(this));
+  domapi::MoveFileOptions options;
+  options.no_overwrite = false;
+  ScriptHost::instance()->io_delegate()->MoveFile(temp_file_name_, file_name_,
+                                                  options, std::move(promise));
+}
+
+void TextDocumentSaver::Start(SavePromise promise) {
+  promise_ = std::move(promise);
+  if (!encoder_) {
+    error_ = domapi::IoError(domapi::IoError::kNoUnicodeTranslation);
+    return Reject();
+  }
+  end_ = document_->buffer()->GetEnd();
+  domapi::MakeTempFileNamePromise temp_promise;
+  temp_promise.reject =
+      base::BindOnce(&TextDocumentSaver::DidFail, base::WrapRefCounted(this));
+  temp_promise.resolve = base::BindOnce(
+      &TextDocumentSaver::DidMakeTempFileName, base::WrapRefCounted(this));
+  ScriptHost::instance()->io_delegate()->MakeTempFileName(
+      base::FilePath(file_name_).DirName().value(), L"ed",
+      std::move(temp_promise));
+}
+
+// Writes |encoded_| and encodes the next block while writing. When write
+// is finished during encoding, e.g. synchronous write, we continue writing
+// in loop rather than in |DidWrite()|.
+void TextDocumentSaver::WriteNext() {
+  DCHECK(!is_writing_);
+  while (is_open_) {
+    if (is_encode_failed_)
+      return DidFail(domapi::IoError(domapi::IoError::kNoUnicodeTranslation));
+    if (encoded_.empty()) {
+      return Close(base::BindOnce(&TextDocumentSaver::Rename,
+                                  base::WrapRefCounted(this)));
+    }
+    writing_.swap(encoded_);
+    is_writing_ = true;
+    is_in_write_next_ = true;
+    domapi::IoIntPromise promise;
+    promise.reject = base::BindOnce(&TextDocumentSaver::DidFailToWrite,
+                                    base::WrapRefCounted(this));
+    promise.resolve = base::BindOnce(&TextDocumentSaver::DidWrite,
+                                     base::WrapRefCounted(this));
+    ScriptHost::instance()->io_delegate()->WriteFile(
+        context_id_, writing_.data(), writing_.size(), std::move(promise));
+    is_encode_failed_ = !EncodeNext();
+    is_in_write_next_ = false;
+    if (is_writing_)
+      return;
+  }
+}
+
+}  // namespace dom
@@ -0,0 +1,113 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_DOM_TEXT_TEXT_DOCUMENT_SAVER_H_
+#define EVITA_DOM_TEXT_TEXT_DOCUMENT_SAVER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string16.h"
+#include "evita/dom/public/io_callback.h"
+#include "evita/dom/public/io_context_id.h"
+#include "evita/dom/public/io_error.h"
+#include "evita/dom/public/promise.h"
+#include "evita/gc/member.h"
+#include "evita/text/models/offset.h"
+
+namespace encodings {
+class Encoder;
+}
+
+namespace dom {
+
+class TextDocument;
+
+//////////////////////////////////////////////////////////////////////
+//
+// TextDocumentSaver
+// Saves contents of |TextDocument| into a temporary file in the same
+// directory, then renames it to the file name. Contents are read from
+// buffer in blocks; each block is newline translated and encoded into a
+// byte block. While a byte block is being written, the saver encodes the
+// next block.
+//
+// On failure, the saver closes and removes the temporary file, and the
+// file keeps its original contents.
+//
+class TextDocumentSaver final : public base::RefCounted<TextDocumentSaver> {
+ public:
+  using SavePromise = domapi::Promise<domapi::FileStatus, domapi::IoError>;
+
+  // |newline| is |Newline| in "evita/dom/enums.js".
+  TextDocumentSaver(TextDocument* document,
+                    const base::string16& file_name,
+                    const base::string16& encoding,
+                    int newline);
+
+  void Start(SavePromise promise);
+
+ private:
+  friend class base::RefCounted<TextDocumentSaver>;
+
+  ~TextDocumentSaver();
+
+  void Close(base::OnceClosure callback);
+  void DidClose(int dummy);
+  void DidFail(domapi::IoError error);
+  void DidFailToClose(domapi::IoError error);
+  void DidFailToOpen(domapi::IoError error);
+  void DidFailToRemoveFile(domapi::IoError error);
+  void DidFailToWrite(domapi::IoError error);
+  void DidMakeTempFileName(base::string16 temp_file_name);
+  void DidOpen(domapi::FileId context_id);
+  void DidQueryFileStatus(domapi::FileStatus file_status);
+  void DidRemoveFile(bool dummy);
+  void DidRename(bool dummy);
+  void DidWrite(int num_written);
+  // Encodes next block of document into |encoded_|. Returns false if
+  // document contains a character which encoder can't encode.
+  bool EncodeNext();
+  void Reject();
+  void RemoveTempFile();
+  // Renames temporary file to |file_name_|.
+  void Rename();
+  void WriteNext();
+
+  // |chars_| and |text_| are reused for each block.
+  std::vector<base::char16> chars_;
+  base::OnceClosure close_callback_;
+  domapi::IoContextId context_id_;
+  gc::Member<TextDocument> document_;
+  // |encoded_| holds encoded bytes of the next block to write.
+  std::vector<uint8_t> encoded_;
+  std::unique_ptr<encodings::Encoder> encoder_;
+  text::Offset end_;
+  domapi::IoError error_;
+  const base::string16 file_name_;
+  bool is_crlf_;
+  // True after encoding the last block.
+  bool is_done_ = false;
+  bool is_encode_failed_ = false;
+  bool is_in_write_next_ = false;
+  bool is_open_ = false;
+  bool is_writing_ = false;
+  text::Offset offset_;
+  SavePromise promise_;
+  base::string16 temp_file_name_;
+  base::string16 text_;
+  // |writing_| holds bytes being written.
+  std::vector<uint8_t> writing_;
+
+  DISALLOW_COPY_AND_ASSIGN(TextDocumentSaver);
+};
+
+}  // namespace dom
+
+#endif  // EVITA_DOM_TEXT_TEXT_DOCUMENT_SAVER_H_
@@ -260,6 +260,118 @@ TEST_F(TextDocumentTest, load_succeeded) {
   EXPECT_SCRIPT_TRUE("doc.readonly") << "set readonly from file attribute";
 }
 
+// Loader keeps several reads in flight and decodes chunks in order.
+TEST_F(TextDocumentTest, load_succeeded_chunks) {
+  std::vector<uint8_t> bytes{102, 111, 111, 10};  // foo\n
+  mock_io_delegate()->set_bytes(bytes);
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId::New(), 0);
+  for (auto count = 0; count < 5; ++count) {
+    mock_io_delegate()->SetCallResult("ReadFile", 0,
+                                      static_cast<int>(bytes.size()));
+  }
+  mock_io_delegate()->SetCallResult("ReadFile", 0, 0);
+  domapi::FileStatus file_status;
+  file_status.file_size = static_cast<int>(bytes.size() * 5);
+  file_status.is_directory = false;
+  file_status.is_symlink = false;
+  file_status.last_write_time = base::Time::FromJsTime(123456.0);
+  file_status.readonly = false;
+  mock_io_delegate()->SetFileStatus(file_status, 0);
+  mock_io_delegate()->SetCallResult("CloseContext", 0, 0);
+
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('foo');"
+      "var promise = doc.load('foo.cc');");
+  EXPECT_EQ(1, mock_io_delegate()->num_close_called());
+  EXPECT_SCRIPT_EQ("20", "doc.length");
+  EXPECT_SCRIPT_TRUE("doc.slice(0) === 'foo\\n'.repeat(5)");
+  EXPECT_SCRIPT_EQ("1", "doc.newline");
+}
+
+// Loader reports number of bytes loaded so far after each chunk.
+TEST_F(TextDocumentTest, load_progress) {
+  std::vector<uint8_t> bytes{102, 111, 111, 10};  // foo\n
+  mock_io_delegate()->set_bytes(bytes);
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId::New(), 0);
+  for (auto count = 0; count < 3; ++count) {
+    mock_io_delegate()->SetCallResult("ReadFile", 0,
+                                      static_cast<int>(bytes.size()));
+  }
+  mock_io_delegate()->SetCallResult("ReadFile", 0, 0);
+  domapi::FileStatus file_status;
+  file_status.file_size = static_cast<int>(bytes.size() * 3);
+  file_status.is_directory = false;
+  file_status.is_symlink = false;
+  file_status.last_write_time = base::Time::FromJsTime(123456.0);
+  file_status.readonly = false;
+  mock_io_delegate()->SetFileStatus(file_status, 0);
+  mock_io_delegate()->SetCallResult("CloseContext", 0, 0);
+
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('foo');"
+      "var progress = [];"
+      "var promise = doc.load_('foo.cc', n => progress.push(n));");
+  EXPECT_EQ(1, mock_io_delegate()->num_close_called());
+  EXPECT_SCRIPT_EQ("4 8 12", "progress.join(' ')");
+  EXPECT_SCRIPT_EQ("12", "doc.length");
+}
+
+TEST_F(TextDocumentTest, load_succeeded_lf) {
+  std::vector<uint8_t> bytes{
+      102, 111, 111, 10,      // foo\n
+      98,  97,  114, 13, 10,  // bar\r\n
+  };
+  mock_io_delegate()->set_bytes(bytes);
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId::New(), 0);
+  mock_io_delegate()->SetCallResult("ReadFile", 0,
+                                    static_cast<int>(bytes.size()));
+  mock_io_delegate()->SetCallResult("ReadFile", 0, 0);
+  domapi::FileStatus file_status;
+  file_status.file_size = static_cast<int>(bytes.size());
+  file_status.is_directory = false;
+  file_status.is_symlink = false;
+  file_status.last_write_time = base::Time::FromJsTime(123456.0);
+  file_status.readonly = false;
+  mock_io_delegate()->SetFileStatus(file_status, 0);
+  mock_io_delegate()->SetCallResult("CloseContext", 0, 0);
+
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('foo');"
+      "var promise = doc.load('foo.cc');");
+  EXPECT_EQ(1, mock_io_delegate()->num_close_called());
+  EXPECT_SCRIPT_EQ("9", "doc.length") << "CR in LF file is kept.";
+  EXPECT_SCRIPT_EQ("1", "doc.newline");
+  EXPECT_SCRIPT_FALSE("doc.readonly");
+}
+
+TEST_F(TextDocumentTest, load_succeeded_shift_jis) {
+  // "\u3042\r\n" in Shift_JIS, which is invalid in UTF-8.
+  std::vector<uint8_t> bytes{0x82, 0xA0, 13, 10};
+  mock_io_delegate()->set_bytes(bytes);
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId::New(), 0);
+  mock_io_delegate()->SetCallResult("ReadFile", 0,
+                                    static_cast<int>(bytes.size()));
+  mock_io_delegate()->SetCallResult("ReadFile", 0, 0);
+  domapi::FileStatus file_status;
+  file_status.file_size = static_cast<int>(bytes.size());
+  file_status.is_directory = false;
+  file_status.is_symlink = false;
+  file_status.last_write_time = base::Time::FromJsTime(123456.0);
+  file_status.readonly = false;
+  mock_io_delegate()->SetFileStatus(file_status, 0);
+  mock_io_delegate()->SetCallResult("CloseContext", 0, 0);
+
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('foo');"
+      "var promise = doc.load('foo.cc');");
+  EXPECT_EQ(1, mock_io_delegate()->num_close_called())
+      << "Loader reads file once with detected encoding.";
+  EXPECT_SCRIPT_EQ("shift_jis", "doc.encoding");
+  EXPECT_SCRIPT_EQ("12354,10", "[doc.charCodeAt(0), doc.charCodeAt(1)]");
+  EXPECT_SCRIPT_EQ("2", "doc.length");
+  EXPECT_SCRIPT_EQ("3", "doc.newline");
+}
+
 TEST_F(TextDocumentTest, modified) {
   EXPECT_SCRIPT_VALID(
       "var doc = TextDocument.new('foo');"
@@ -327,6 +439,68 @@ TEST_F(TextDocumentTest, redo) {
   EXPECT_SCRIPT_EQ("foo", "range.text");
 }
 
+// Reload doesn't change document when it fails to get file status.
+TEST_F(TextDocumentTest, reload_failed_status) {
+  std::vector<uint8_t> bytes{113, 117, 117, 120, 10};  // quux\n
+  mock_io_delegate()->set_bytes(bytes);
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId::New(), 0);
+  mock_io_delegate()->SetCallResult("ReadFile", 0,
+                                    static_cast<int>(bytes.size()));
+  mock_io_delegate()->SetCallResult("ReadFile", 0, 0);
+  mock_io_delegate()->SetFileStatus(domapi::FileStatus(), 123);
+  mock_io_delegate()->SetCallResult("CloseContext", 0, 0);
+
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('foo');"
+      "var range = new TextRange(doc);"
+      "range.text = 'foo\\nbar\\n';"
+      "doc.fileName = 'foo.cc';"
+      "var promise = doc.reload();");
+  EXPECT_EQ(1, mock_io_delegate()->num_close_called());
+  EXPECT_SCRIPT_TRUE("doc.slice(0) === 'foo\\nbar\\n'");
+  EXPECT_SCRIPT_FALSE("doc.readonly");
+}
+
+// Reload applies line differences, so ranges in unchanged lines are kept.
+TEST_F(TextDocumentTest, reload_succeeded) {
+  std::vector<uint8_t> bytes{
+      102, 111, 111, 10,       // foo\n
+      113, 117, 117, 120, 10,  // quux\n
+      98,  97,  122, 10,       // baz\n
+  };
+  mock_io_delegate()->set_bytes(bytes);
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId::New(), 0);
+  mock_io_delegate()->SetCallResult("ReadFile", 0,
+                                    static_cast<int>(bytes.size()));
+  mock_io_delegate()->SetCallResult("ReadFile", 0, 0);
+  domapi::FileStatus file_status;
+  file_status.file_size = static_cast<int>(bytes.size());
+  file_status.is_directory = false;
+  file_status.is_symlink = false;
+  file_status.last_write_time = base::Time::FromJsTime(123456.0);
+  file_status.readonly = false;
+  mock_io_delegate()->SetFileStatus(file_status, 0);
+  mock_io_delegate()->SetCallResult("CloseContext", 0, 0);
+
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('foo');"
+      "var range = new TextRange(doc);"
+      "range.text = 'foo\\nbar\\nbaz\\n';"
+      "range.start = 8;"
+      "range.end = 11;"
+      "doc.fileName = 'foo.cc';"
+      "var beforeLoad = false;"
+      "doc.addEventListener('beforeload', function() { beforeLoad = true; });"
+      "var promise = doc.reload();");
+  EXPECT_EQ(1, mock_io_delegate()->num_close_called());
+  EXPECT_SCRIPT_FALSE("beforeLoad");
+  EXPECT_SCRIPT_TRUE("doc.slice(0) === 'foo\\nquux\\nbaz\\n'");
+  EXPECT_SCRIPT_EQ("9 12", "range.start + ' ' + range.end");
+  EXPECT_SCRIPT_EQ("123456", "doc.lastWriteTime.valueOf()");
+  EXPECT_SCRIPT_TRUE("TextDocument.Obsolete.NO === doc.obsolete");
+  EXPECT_SCRIPT_FALSE("doc.modified");
+}
+
 TEST_F(TextDocumentTest, renameTo) {
   EXPECT_SCRIPT_VALID("var doc = TextDocument.new('foo'); doc.renameTo('bar')");
   EXPECT_SCRIPT_EQ("bar", "doc.name");
@@ -415,6 +589,61 @@ TEST_F(TextDocumentTest, save_succeeded) {
   EXPECT_SCRIPT_TRUE("doc.lastStatusCheckTime_ != new Date(0)");
 }
 
+TEST_F(TextDocumentTest, save_succeeded_crlf) {
+  std::vector<uint8_t> expected_bytes{
+      102, 111, 111, 13, 10,  // foo\r\n
+      98,  97,  114, 13, 10,  // bar\r\n
+  };
+  mock_io_delegate()->SetMakeTempFileName(L"foo.tmp", 0);
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId::New(), 0);
+  mock_io_delegate()->SetCallResult("WriteFile", 0,
+                                    static_cast<int>(expected_bytes.size()));
+  mock_io_delegate()->SetCallResult("CloseContext", 0);
+  mock_io_delegate()->SetCallResult("MoveFile", 0);
+  domapi::FileStatus file_status;
+  file_status.file_size = static_cast<int>(expected_bytes.size());
+  file_status.is_directory = false;
+  file_status.is_symlink = false;
+  file_status.last_write_time = base::Time::FromJsTime(123456.0);
+  file_status.readonly = false;
+  mock_io_delegate()->SetFileStatus(file_status, 0);
+
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('foo');"
+      "new TextRange(doc).text = 'foo\\nbar';"
+      "doc.newline = 3;"
+      "doc.save('foo.cc');");
+  EXPECT_EQ(1, mock_io_delegate()->num_close_called());
+  EXPECT_EQ(expected_bytes, mock_io_delegate()->bytes())
+      << "Saver translates LF to CRLF and terminates the last line.";
+  EXPECT_SCRIPT_TRUE("TextDocument.Obsolete.NO === doc.obsolete");
+}
+
+// Like the last line, an empty document is terminated with newline.
+TEST_F(TextDocumentTest, save_succeeded_empty) {
+  std::vector<uint8_t> expected_bytes{10};
+  mock_io_delegate()->SetMakeTempFileName(L"foo.tmp", 0);
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId::New(), 0);
+  mock_io_delegate()->SetCallResult("WriteFile", 0,
+                                    static_cast<int>(expected_bytes.size()));
+  mock_io_delegate()->SetCallResult("CloseContext", 0);
+  mock_io_delegate()->SetCallResult("MoveFile", 0);
+  domapi::FileStatus file_status;
+  file_status.file_size = static_cast<int>(expected_bytes.size());
+  file_status.is_directory = false;
+  file_status.is_symlink = false;
+  file_status.last_write_time = base::Time::FromJsTime(123456.0);
+  file_status.readonly = false;
+  mock_io_delegate()->SetFileStatus(file_status, 0);
+
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('foo');"
+      "doc.save('foo.cc');");
+  EXPECT_EQ(1, mock_io_delegate()->num_close_called());
+  EXPECT_EQ(expected_bytes, mock_io_delegate()->bytes());
+  EXPECT_SCRIPT_TRUE("TextDocument.Obsolete.NO === doc.obsolete");
+}
+
 TEST_F(TextDocumentTest, setSyntax) {
   EXPECT_SCRIPT_VALID(
       "var doc = TextDocument.new('syntax');"
@@ -0,0 +1,183 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+goog.scope(function() {
+
+/**
+ * Watches a directory containing files of documents. When a file of
+ * document is changed, we record a pending change in |hasPendingChange_| of
+ * the document and mark the document as |Obsolete.UNKNOWN|, then
+ * |TextWindow| checks file status of the document. A change during checking
+ * file status, e.g. loading, saving, is kept in |hasPendingChange_|, so it
+ * is checked after the current check. Documents in a directory which can't
+ * be watched fall back to polling file status.
+ */
+class DirectoryWatcher {
+  /** @param {string} dirName */
+  constructor(dirName) {
+    /** @const @type {string} */
+    this.dirName_ = dirName;
+    /** @type {Os.Directory} */
+    this.directory_ = null;
+    /** @const @type {!Set<!TextDocument>} */
+    this.documents_ = new Set();
+    /** @type {boolean} */
+    this.isStopped_ = false;
+  }
+
+  /** @return {boolean} */
+  get isEmpty() { return this.documents_.size === 0; }
+
+  /** @param {!TextDocument} document */
+  add(document) {
+    this.documents_.add(document);
+    document.watched_ = this.directory_ !== null;
+  }
+
+  /**
+   * @param {!Array<string>} names
+   * An empty |names| means changes are dropped, so we check all documents.
+   */
+  didChange(names) {
+    /** @const @type {!Set<string>} */
+    const changedNames =
+        new Set(names.map(name => name.toLocaleLowerCase()));
+    for (const document of this.documents_) {
+      if (changedNames.size > 0 &&
+          !changedNames.has(
+              FilePath.basename(document.fileName).toLocaleLowerCase())) {
+        continue;
+      }
+      document.hasPendingChange_ = true;
+      if (document.obsolete === TextDocument.Obsolete.NO)
+        document.obsolete = TextDocument.Obsolete.UNKNOWN;
+    }
+  }
+
+  /** @param {!TextDocument} document */
+  remove(document) {
+    this.documents_.delete(document);
+    document.watched_ = false;
+  }
+
+  start() {
+    Os.Directory.watch(this.dirName_)
+        .then(directory => {
+          if (this.isStopped_) {
+            directory.close();
+            return;
+          }
+          this.directory_ = directory;
+          this.documents_.forEach(document => document.watched_ = true);
+          this.readChanges_(directory);
+        })
+        .catch(reason => this.stop());
+  }
+
+  stop() {
+    this.isStopped_ = true;
+    this.documents_.forEach(document => document.watched_ = false);
+    if (!this.directory_)
+      return;
+    this.directory_.close();
+    this.directory_ = null;
+  }
+
+  /** @param {!Os.Directory} directory */
+  readChanges_(directory) {
+    directory.readChanges()
+        .then(names => {
+          if (this.isStopped_)
+            return;
+          this.didChange(names);
+          this.readChanges_(directory);
+        })
+        .catch(reason => {
+          if (this.isStopped_)
+            return;
+          this.stop();
+        });
+  }
+}
+
+/**
+ * Keeps one |DirectoryWatcher| for each directory of documents bound to
+ * files.
+ */
+class TextDocumentWatcher extends SimpleTextDocumentSetObserver {
+  constructor() {
+    super();
+    /** @const @type {!Map<!TextDocument, !DirectoryWatcher>} */
+    this.documentMap_ = new Map();
+    /** @const @type {!Map<string, !DirectoryWatcher>} */
+    this.watcherMap_ = new Map();
+  }
+
+  /** @param {!TextDocument} document */
+  didAddTextDocument(document) {
+    /** @const @type {function(!Event)} */
+    const callback = event => this.watch(document);
+    document.addEventListener(Event.Names.LOAD, callback);
+    document.addEventListener(Event.Names.SAVE, callback);
+  }
+
+  /** @param {!TextDocument} document */
+  didRemoveTextDocument(document) { this.unwatch(document); }
+
+  /** @param {!TextDocument} document */
+  unwatch(document) {
+    /** @const @type {DirectoryWatcher} */
+    const watcher = this.documentMap_.get(document) || null;
+    if (!watcher)
+      return;
+    this.documentMap_.delete(document);
+    watcher.remove(document);
+    if (!watcher.isEmpty)
+      return;
+    watcher.stop();
+    for (const [key, value] of this.watcherMap_) {
+      if (value !== watcher)
+        continue;
+      this.watcherMap_.delete(key);
+      break;
+    }
+  }
+
+  /** @param {!TextDocument} document */
+  watch(document) {
+    /** @const @type {string} */
+    const dirName =
+        document.fileName === '' ? '' : FilePath.dirname(document.fileName);
+    /** @const @type {string} */
+    const key = dirName.toLocaleLowerCase();
+    /** @const @type {DirectoryWatcher} */
+    const present = this.documentMap_.get(document) || null;
+    if (present && present === this.watcherMap_.get(key))
+      return;
+    this.unwatch(document);
+    if (dirName === '')
+      return;
+    /** @type {DirectoryWatcher} */
+    let watcher = this.watcherMap_.get(key) || null;
+    if (!watcher) {
+      watcher = new DirectoryWatcher(dirName);
+      this.watcherMap_.set(key, watcher);
+      watcher.start();
+    }
+    watcher.add(document);
+    this.documentMap_.set(document, watcher);
+  }
+}
+
+Object.defineProperty(
+    TextDocument.prototype, 'hasPendingChange_',
+    {value: false, writable: true});
+Object.defineProperty(
+    TextDocument.prototype, 'watched_', {value: false, writable: true});
+
+/** @constructor */
+text.DirectoryWatcher = DirectoryWatcher;
+
+TextDocument.addObserver(new TextDocumentWatcher());
+});
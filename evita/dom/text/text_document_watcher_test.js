@@ -0,0 +1,55 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+goog.require('testing');
+
+goog.scope(function() {
+
+const DirectoryWatcher = text.DirectoryWatcher;
+
+/**
+ * @param {!DirectoryWatcher} watcher
+ * @param {string} fileName
+ * @return {!TextDocument}
+ */
+function newDocument(watcher, fileName) {
+  const document = new TextDocument();
+  document.fileName = fileName;
+  document.obsolete = TextDocument.Obsolete.NO;
+  watcher.add(document);
+  return document;
+}
+
+testing.test('DirectoryWatcher.didChange', function(t) {
+  const watcher = new DirectoryWatcher('/src');
+  const foo = newDocument(watcher, '/src/foo.cc');
+  const bar = newDocument(watcher, '/src/bar.cc');
+  watcher.didChange(['FOO.cc']);
+  t.expect(foo.hasPendingChange_).toEqual(true);
+  t.expect(foo.obsolete).toEqual(TextDocument.Obsolete.UNKNOWN);
+  t.expect(bar.hasPendingChange_).toEqual(false);
+  t.expect(bar.obsolete).toEqual(TextDocument.Obsolete.NO);
+});
+
+// Changes while checking file status should be kept for the next check.
+testing.test('DirectoryWatcher.didChange checking', function(t) {
+  const watcher = new DirectoryWatcher('/src');
+  const foo = newDocument(watcher, '/src/foo.cc');
+  foo.obsolete = TextDocument.Obsolete.CHECKING;
+  watcher.didChange(['foo.cc']);
+  t.expect(foo.hasPendingChange_).toEqual(true);
+  t.expect(foo.obsolete).toEqual(TextDocument.Obsolete.CHECKING);
+});
+
+// Empty names mean changes are dropped, so all documents are changed.
+testing.test('DirectoryWatcher.didChange empty', function(t) {
+  const watcher = new DirectoryWatcher('/src');
+  const foo = newDocument(watcher, '/src/foo.cc');
+  const bar = newDocument(watcher, '/src/bar.cc');
+  watcher.didChange([]);
+  t.expect(foo.hasPendingChange_).toEqual(true);
+  t.expect(bar.hasPendingChange_).toEqual(true);
+});
+
+});
@@ -206,6 +206,7 @@ TextWindow::TextWindow(ScriptHost* script_host,
       caret_(new Caret(this)),
       markers_(new text::MarkerSet(text::MarkerSet::Kind::Fragile,
                                    *selection_range->document()->buffer())),
+      paint_view_builder_(new PaintViewBuilder()),
       selection_(new TextSelection(this, selection_range)),
       text_view_(new layout::TextView(*selection_range->document()->buffer(),
                                       *markers_,
@@ -380,8 +381,8 @@ void TextWindow::DidBeginAnimationFrame(const base::TimeTicks& now) {
   const auto caret_bounds =
       ToFloatRect(text_view_->ComputeCaretBounds(selection));
   caret_->Update(caret_bounds, now);
-  const auto paint_view =
-      PaintViewBuilder().Build(text_view_->block(), selection, caret_->Paint());
+  const auto paint_view = paint_view_builder_->Build(
+      text_view_->block(), selection, caret_->Paint());
   UpdateScrollBar();
   auto display_item = std::make_unique<domapi::TextAreaDisplayItem>(
       paint_view, std::move(vertical_scroll_bar_->Paint()));
@@ -23,6 +23,7 @@ class StyleSheet;
 }
 
 namespace layout {
+class PaintViewBuilder;
 class TextView;
 }
 
@@ -152,6 +153,7 @@ class TextWindow final : public ginx::Scriptable<TextWindow, Window>,
   const std::unique_ptr<Caret> caret_;
   bool is_waiting_animation_frame_ = false;
   const std::unique_ptr<text::MarkerSet> markers_;
+  const std::unique_ptr<layout::PaintViewBuilder> paint_view_builder_;
   const gc::Member<TextSelection> selection_;
   const std::unique_ptr<layout::TextView> text_view_;
   const std::unique_ptr<ScrollBar> vertical_scroll_bar_;
@@ -487,46 +487,14 @@ function mapPointToOffset(event) {
   return textWindow.hitTestPoint(event.clientX, event.clientY);
 }
 
-/**
- * @param {!TextDocument} document
- * @return {!Map<!TextSelection, number>}
- */
-function rememberSelections(document) {
-  /** @const @type {!Map<!TextSelection, number>} */
-  const selectionMap = new Map();
-  for (/** @type {!TextWindow} */ let window of listTextWindows(document)) {
-    /** @const @type {!TextSelection} */
-    const selection = window.selection;
-    selectionMap.set(selection, selection.range.start);
-  }
-  return selectionMap;
-}
-
 /**
  * @param {!TextDocument} document
  * @return {!Promise<number>}
+ * Selections in unchanged lines are kept, since |TextDocument.reload()|
+ * applies line differences to |document|.
  */
 function reloadTextDocument(document) {
-  /** @const @type {!Map<!TextSelection, number>} */
-  const selectionMap = rememberSelections(document);
-  return document.load().then(zero => restorSelections(document, selectionMap));
-}
-
-/**
- * @param {!TextDocument} document
- * @param {!Map<!TextSelection, number>} selectionMap
- */
-function restorSelections(document, selectionMap) {
-  for (/** @const @type {!TextWindow} */ const window of listTextWindows(
-      document)) {
-    /** @const @type {!TextSelection} */
-    const selection = window.selection;
-    /** @const @type {number|undefined} */
-    const present = selectionMap.get(selection);
-    if (present === undefined)
-      continue;
-    selection.range.collapseTo(Math.min(present, document.length));
-  }
+  return document.reload();
 }
 
 /**
@@ -575,6 +543,14 @@ function updateObsolete() {
         window, 'This document has been stale.', MessageBox.ICONWARNING);
     return;
   }
+  // Directory watcher records pending change when its file is changed, so
+  // we check file status only for unwatched or changed documents. Changes
+  // after we start checking are recorded again.
+  if (document.watched_ && document.obsolete === TextDocument.Obsolete.NO &&
+      !document.hasPendingChange_) {
+    return;
+  }
+  document.hasPendingChange_ = false;
   document.obsolete = TextDocument.Obsolete.CHECKING;
   Os.File.stat(document.fileName)
       .then(info => {
@@ -0,0 +1,395 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <iterator>
+#include <ostream>
+#include <utility>
+
+#include "evita/gfx/base/geometry/int_region.h"
+
+#include "base/logging.h"
+
+namespace gfx {
+
+namespace {
+
+int64_t AreaOf(int top, int bottom, int left, int right) {
+  return static_cast<int64_t>(bottom - top) * (right - left);
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// IntRegion
+//
+IntRegion::IntRegion(const IntRect& rect) {
+  if (rect.IsEmpty())
+    return;
+  bands_.push_back(Band{rect.y(), rect.bottom(), {{rect.x(), rect.right()}}});
+}
+
+IntRegion::IntRegion(const IntRegion& other) : bands_(other.bands_) {}
+
+IntRegion::IntRegion(IntRegion&& other) : bands_(std::move(other.bands_)) {}
+
+IntRegion::IntRegion() {}
+IntRegion::~IntRegion() {}
+
+IntRegion& IntRegion::operator=(const IntRegion& other) {
+  bands_ = other.bands_;
+  return *this;
+}
+
+IntRegion& IntRegion::operator=(IntRegion&& other) {
+  bands_ = std::move(other.bands_);
+  return *this;
+}
+
+bool IntRegion::operator==(const IntRegion& other) const {
+  if (bands_.size() != other.bands_.size())
+    return false;
+  for (size_t index = 0; index < bands_.size(); ++index) {
+    const auto& band1 = bands_[index];
+    const auto& band2 = other.bands_[index];
+    if (band1.top != band2.top || band1.bottom != band2.bottom ||
+        band1.spans != band2.spans) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IntRegion::operator!=(const IntRegion& other) const {
+  return !operator==(other);
+}
+
+IntRect IntRegion::bounds() const {
+  if (bands_.empty())
+    return IntRect();
+  auto left = bands_.front().spans.front().left;
+  auto right = bands_.front().spans.back().right;
+  for (const auto& band : bands_) {
+    left = std::min(left, band.spans.front().left);
+    right = std::max(right, band.spans.back().right);
+  }
+  const auto top = bands_.front().top;
+  return IntRect(IntPoint(left, top),
+                 IntSize(right - left, bands_.back().bottom - top));
+}
+
+size_t IntRegion::num_rects() const {
+  size_t count = 0;
+  for (const auto& band : bands_)
+    count += band.spans.size();
+  return count;
+}
+
+std::vector<IntRect> IntRegion::rects() const {
+  std::vector<IntRect> rects;
+  rects.reserve(num_rects());
+  for (const auto& band : bands_) {
+    for (const auto& span : band.spans) {
+      rects.push_back(
+          IntRect(IntPoint(span.left, band.top),
+                  IntSize(span.right - span.left, band.bottom - band.top)));
+    }
+  }
+  return rects;
+}
+
+void IntRegion::AppendBand(int top, int bottom, Spans&& spans) {
+  DCHECK_LT(top, bottom);
+  if (spans.empty())
+    return;
+  if (!bands_.empty()) {
+    auto& last = bands_.back();
+    DCHECK_LE(last.bottom, top);
+    if (last.bottom == top && last.spans == spans) {
+      last.bottom = bottom;
+      return;
+    }
+  }
+  bands_.push_back(Band{top, bottom, std::move(spans)});
+}
+
+void IntRegion::Clear() {
+  bands_.clear();
+}
+
+// static
+IntRegion IntRegion::Combine(const IntRegion& region1,
+                             const IntRegion& region2,
+                             Operation operation) {
+  std::vector<int> ys;
+  ys.reserve((region1.bands_.size() + region2.bands_.size()) * 2);
+  for (const auto& band : region1.bands_) {
+    ys.push_back(band.top);
+    ys.push_back(band.bottom);
+  }
+  for (const auto& band : region2.bands_) {
+    ys.push_back(band.top);
+    ys.push_back(band.bottom);
+  }
+  std::sort(ys.begin(), ys.end());
+  ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+  const Spans empty_spans;
+  IntRegion result;
+  auto band1 = region1.bands_.begin();
+  auto band2 = region2.bands_.begin();
+  for (size_t index = 0; index + 1 < ys.size(); ++index) {
+    const auto top = ys[index];
+    const auto bottom = ys[index + 1];
+    while (band1 != region1.bands_.end() && band1->bottom <= top)
+      ++band1;
+    while (band2 != region2.bands_.end() && band2->bottom <= top)
+      ++band2;
+    const auto& spans1 = band1 != region1.bands_.end() && band1->top <= top
+                             ? band1->spans
+                             : empty_spans;
+    const auto& spans2 = band2 != region2.bands_.end() && band2->top <= top
+                             ? band2->spans
+                             : empty_spans;
+    result.AppendBand(top, bottom, CombineSpans(spans1, spans2, operation));
+  }
+  return std::move(result);
+}
+
+// static
+IntRegion::Spans IntRegion::CombineSpans(const Spans& spans1,
+                                         const Spans& spans2,
+                                         Operation operation) {
+  Spans spans;
+  switch (operation) {
+    case Operation::Intersect: {
+      auto span1 = spans1.begin();
+      auto span2 = spans2.begin();
+      while (span1 != spans1.end() && span2 != spans2.end()) {
+        const auto left = std::max(span1->left, span2->left);
+        const auto right = std::min(span1->right, span2->right);
+        if (left < right)
+          spans.push_back(Span{left, right});
+        if (span1->right < span2->right)
+          ++span1;
+        else
+          ++span2;
+      }
+      break;
+    }
+    case Operation::Subtract: {
+      auto span2 = spans2.begin();
+      for (const auto& span1 : spans1) {
+        while (span2 != spans2.end() && span2->right <= span1.left)
+          ++span2;
+        auto left = span1.left;
+        for (auto runner = span2;
+             runner != spans2.end() && runner->left < span1.right;
+             ++runner) {
+          if (runner->left > left)
+            spans.push_back(Span{left, runner->left});
+          left = std::max(left, runner->right);
+        }
+        if (left < span1.right)
+          spans.push_back(Span{left, span1.right});
+      }
+      break;
+    }
+    case Operation::Union: {
+      spans.reserve(spans1.size() + spans2.size());
+      std::merge(spans1.begin(), spans1.end(), spans2.begin(), spans2.end(),
+                 std::back_inserter(spans),
+                 [](const Span& span1, const Span& span2) {
+                   return span1.left < span2.left;
+                 });
+      auto last = spans.begin();
+      for (auto runner = spans.begin(); runner != spans.end(); ++runner) {
+        if (runner == last)
+          continue;
+        if (runner->left <= last->right) {
+          last->right = std::max(last->right, runner->right);
+          continue;
+        }
+        ++last;
+        *last = *runner;
+      }
+      if (!spans.empty())
+        spans.erase(last + 1, spans.end());
+      break;
+    }
+    default:
+      NOTREACHED();
+      break;
+  }
+  return spans;
+}
+
+bool IntRegion::Contains(const IntPoint& point) const {
+  const auto band = std::upper_bound(
+      bands_.begin(), bands_.end(), point.y(),
+      [](int y, const Band& band) { return y < band.bottom; });
+  if (band == bands_.end() || band->top > point.y())
+    return false;
+  for (const auto& span : band->spans) {
+    if (point.x() < span.left)
+      return false;
+    if (point.x() < span.right)
+      return true;
+  }
+  return false;
+}
+
+bool IntRegion::Contains(const IntRect& rect) const {
+  if (rect.IsEmpty())
+    return true;
+  return Combine(IntRegion(rect), *this, Operation::Subtract).IsEmpty();
+}
+
+void IntRegion::Intersect(const IntRect& rect) {
+  Intersect(IntRegion(rect));
+}
+
+void IntRegion::Intersect(const IntRegion& other) {
+  *this = Combine(*this, other, Operation::Intersect);
+}
+
+bool IntRegion::Intersects(const IntRect& rect) const {
+  if (rect.IsEmpty())
+    return false;
+  for (const auto& band : bands_) {
+    if (band.bottom <= rect.y())
+      continue;
+    if (band.top >= rect.bottom())
+      return false;
+    for (const auto& span : band.spans) {
+      if (span.right > rect.x() && span.left < rect.right())
+        return true;
+    }
+  }
+  return false;
+}
+
+void IntRegion::Simplify(size_t max_rects) {
+  DCHECK_GE(max_rects, 1u);
+  auto num_rects = this->num_rects();
+  while (num_rects > max_rects) {
+    // Candidate merge, which adds |cost| pixels and removes |gain|
+    // rectangles.
+    int64_t best_cost = 0;
+    size_t best_gain = 0;
+    size_t best_band = 0;
+    size_t best_span = 0;
+    Spans best_spans;
+    const auto is_better = [&](int64_t cost, size_t gain) {
+      return gain && (!best_gain || cost * static_cast<int64_t>(best_gain) <
+                                        best_cost * static_cast<int64_t>(gain));
+    };
+
+    for (size_t index = 0; index < bands_.size(); ++index) {
+      const auto& band = bands_[index];
+      // Fill gap between adjacent spans in |band|.
+      for (size_t span = 0; span + 1 < band.spans.size(); ++span) {
+        const auto cost = AreaOf(band.top, band.bottom, band.spans[span].right,
+                                 band.spans[span + 1].left);
+        if (!is_better(cost, 1))
+          continue;
+        best_cost = cost;
+        best_gain = 1;
+        best_band = index;
+        best_span = span;
+        best_spans.clear();
+      }
+      if (index + 1 == bands_.size())
+        continue;
+      // Merge |band| and the next band into one band, including rows between
+      // them.
+      const auto& next = bands_[index + 1];
+      int64_t area = 0;
+      for (const auto& span : band.spans)
+        area += AreaOf(band.top, band.bottom, span.left, span.right);
+      for (const auto& span : next.spans)
+        area += AreaOf(next.top, next.bottom, span.left, span.right);
+      const auto num_spans = band.spans.size() + next.spans.size();
+      const auto& union_spans =
+          CombineSpans(band.spans, next.spans, Operation::Union);
+      int64_t union_area = 0;
+      for (const auto& span : union_spans)
+        union_area += AreaOf(band.top, next.bottom, span.left, span.right);
+      const auto union_gain = num_spans - union_spans.size();
+      if (is_better(union_area - area, union_gain)) {
+        best_cost = union_area - area;
+        best_gain = union_gain;
+        best_band = index;
+        best_spans = union_spans;
+      }
+      const Span bounding_span = {union_spans.front().left,
+                                  union_spans.back().right};
+      const auto bounding_cost =
+          AreaOf(band.top, next.bottom, bounding_span.left,
+                 bounding_span.right) -
+          area;
+      if (is_better(bounding_cost, num_spans - 1)) {
+        best_cost = bounding_cost;
+        best_gain = num_spans - 1;
+        best_band = index;
+        best_spans = Spans{bounding_span};
+      }
+    }
+    DCHECK(best_gain);
+
+    std::vector<Band> bands;
+    bands.swap(bands_);
+    if (best_spans.empty()) {
+      auto& spans = bands[best_band].spans;
+      spans[best_span].right = spans[best_span + 1].right;
+      spans.erase(spans.begin() + best_span + 1);
+    } else {
+      bands[best_band].bottom = bands[best_band + 1].bottom;
+      bands[best_band].spans = std::move(best_spans);
+      bands.erase(bands.begin() + best_band + 1);
+    }
+    for (auto& band : bands)
+      AppendBand(band.top, band.bottom, std::move(band.spans));
+    num_rects = this->num_rects();
+  }
+}
+
+void IntRegion::Subtract(const IntRect& rect) {
+  if (bands_.empty() || rect.IsEmpty())
+    return;
+  Subtract(IntRegion(rect));
+}
+
+void IntRegion::Subtract(const IntRegion& other) {
+  *this = Combine(*this, other, Operation::Subtract);
+}
+
+void IntRegion::Union(const IntRect& rect) {
+  if (rect.IsEmpty())
+    return;
+  if (bands_.empty()) {
+    *this = IntRegion(rect);
+    return;
+  }
+  Union(IntRegion(rect));
+}
+
+void IntRegion::Union(const IntRegion& other) {
+  *this = Combine(*this, other, Operation::Union);
+}
+
+std::ostream& operator<<(std::ostream& ostream, const IntRegion& region) {
+  ostream << "IntRegion(";
+  auto delimiter = "";
+  for (const auto& rect : region.rects()) {
+    ostream << delimiter << rect;
+    delimiter = ", ";
+  }
+  return ostream << ')';
+}
+
+}  // namespace gfx
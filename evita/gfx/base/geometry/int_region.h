@@ -0,0 +1,105 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_GFX_BASE_GEOMETRY_INT_REGION_H_
+#define EVITA_GFX_BASE_GEOMETRY_INT_REGION_H_
+
+#include <iosfwd>
+#include <vector>
+
+#include "evita/gfx/base/geometry/int_rect.h"
+#include "evita/gfx/gfx_export.h"
+
+namespace gfx {
+
+//////////////////////////////////////////////////////////////////////
+//
+// IntRegion
+// A set of pixels represented by y-x banded rectangles as pixman and X11.
+// A region is a list of bands sorted by y, and each band is a list of
+// spans sorted by x. Bands don't overlap, spans in a band neither overlap
+// nor touch, and vertically adjacent bands have different spans, so every
+// region has unique representation.
+//
+class GFX_EXPORT IntRegion final {
+ public:
+  explicit IntRegion(const IntRect& rect);
+  IntRegion(const IntRegion& other);
+  IntRegion(IntRegion&& other);
+  IntRegion();
+  ~IntRegion();
+
+  IntRegion& operator=(const IntRegion& other);
+  IntRegion& operator=(IntRegion&& other);
+
+  bool operator==(const IntRegion& other) const;
+  bool operator!=(const IntRegion& other) const;
+
+  // Returns the smallest rectangle containing this region.
+  IntRect bounds() const;
+  bool IsEmpty() const { return bands_.empty(); }
+  size_t num_rects() const;
+
+  // Returns rectangles of this region in y-x order.
+  std::vector<IntRect> rects() const;
+
+  void Clear();
+  bool Contains(const IntPoint& point) const;
+  bool Contains(const IntRect& rect) const;
+  void Intersect(const IntRect& rect);
+  void Intersect(const IntRegion& other);
+  bool Intersects(const IntRect& rect) const;
+
+  // Reduces number of rectangles to |max_rects| or less by adding pixels to
+  // this region, e.g. filling gaps between rectangles. Each step chooses
+  // a merge which adds the smallest number of pixels per removed rectangle.
+  void Simplify(size_t max_rects);
+
+  void Subtract(const IntRect& rect);
+  void Subtract(const IntRegion& other);
+  void Union(const IntRect& rect);
+  void Union(const IntRegion& other);
+
+ private:
+  struct Span {
+    int left;
+    int right;
+
+    bool operator==(const Span& other) const {
+      return left == other.left && right == other.right;
+    }
+  };
+
+  using Spans = std::vector<Span>;
+
+  struct Band {
+    int top;
+    int bottom;
+    Spans spans;
+  };
+
+  enum class Operation {
+    Intersect,
+    Subtract,
+    Union,
+  };
+
+  static IntRegion Combine(const IntRegion& region1,
+                           const IntRegion& region2,
+                           Operation operation);
+  static Spans CombineSpans(const Spans& spans1,
+                            const Spans& spans2,
+                            Operation operation);
+
+  void AppendBand(int top, int bottom, Spans&& spans);
+
+  std::vector<Band> bands_;
+};
+
+GFX_EXPORT std::ostream& operator<<(std::ostream& ostream,
+                                    const IntRegion& region);
+
+}  // namespace gfx
+
+#endif  // EVITA_GFX_BASE_GEOMETRY_INT_REGION_H_
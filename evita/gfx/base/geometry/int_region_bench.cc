@@ -0,0 +1,159 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Compares |IntRegion| with a list of dirty rectangles pruned by containment,
+// which was previous representation of dirty rectangles in |SwapChain|, for
+// dirty rectangles produced by painting text lines.
+//
+// Usage: int_region_bench [--iterations=N] [--max-rects=N]
+
+#include <stdint.h>
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "evita/gfx/base/geometry/int_region.h"
+
+namespace gfx {
+
+namespace {
+
+const auto kDefaultIterations = 10000;
+const auto kDefaultMaxRects = 8;
+const auto kLineHeight = 16;
+const auto kNumberOfLines = 60;
+
+IntRect Rect(int left, int top, int right, int bottom) {
+  return IntRect(IntPoint(left, top), IntSize(right - left, bottom - top));
+}
+
+int64_t AreaOf(const IntRect& rect) {
+  return static_cast<int64_t>(rect.width()) * rect.height();
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// RectList
+//
+class RectList final {
+ public:
+  RectList() = default;
+  ~RectList() = default;
+
+  const std::vector<IntRect>& rects() const { return rects_; }
+
+  void Add(const IntRect& new_rect) {
+    std::vector<IntRect> rects;
+    for (const auto& rect : rects_) {
+      if (Contains(rect, new_rect))
+        return;
+      if (!Contains(new_rect, rect))
+        rects.push_back(rect);
+    }
+    rects.push_back(new_rect);
+    rects_.swap(rects);
+  }
+
+ private:
+  static bool Contains(const IntRect& rect1, const IntRect& rect2) {
+    return rect1.x() <= rect2.x() && rect1.y() <= rect2.y() &&
+           rect1.right() >= rect2.right() && rect1.bottom() >= rect2.bottom();
+  }
+
+  std::vector<IntRect> rects_;
+};
+
+// Returns dirty rectangles of a frame: caret, selection and text of lines
+// after an insertion, and a few changed lines at bottom of window.
+std::vector<IntRect> DirtyRectsOfFrame(int frame) {
+  std::vector<IntRect> rects;
+  const auto first_line = frame % (kNumberOfLines / 2);
+  for (auto line = first_line; line < kNumberOfLines; line += 2) {
+    const auto top = line * kLineHeight;
+    const auto width = 200 + (line * 37 + frame) % 600;
+    rects.push_back(Rect(0, top, width, top + kLineHeight));
+    rects.push_back(Rect(width - 2, top, width, top + kLineHeight));
+  }
+  rects.push_back(Rect(0, 1000, 800, 1020));
+  return rects;
+}
+
+void Report(const char* name,
+            base::TimeDelta elapsed,
+            int iterations,
+            size_t num_rects,
+            int64_t area) {
+  std::cout << std::left << std::setw(16) << name << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10)
+            << elapsed.InMicrosecondsF() / iterations << " us/frame"
+            << std::setw(6) << num_rects << " rects" << std::setw(10) << area
+            << " pixels" << std::endl;
+}
+
+void BenchRectList(int iterations) {
+  size_t num_rects = 0;
+  int64_t area = 0;
+  const auto& start = base::TimeTicks::Now();
+  for (auto frame = 0; frame < iterations; ++frame) {
+    RectList list;
+    for (const auto& rect : DirtyRectsOfFrame(frame))
+      list.Add(rect);
+    num_rects += list.rects().size();
+    for (const auto& rect : list.rects())
+      area += AreaOf(rect);
+  }
+  const auto& elapsed = base::TimeTicks::Now() - start;
+  Report("list", elapsed, iterations, num_rects / iterations,
+         area / iterations);
+}
+
+void BenchRegion(int iterations, size_t max_rects) {
+  size_t num_rects = 0;
+  int64_t area = 0;
+  const auto& start = base::TimeTicks::Now();
+  for (auto frame = 0; frame < iterations; ++frame) {
+    IntRegion region;
+    for (const auto& rect : DirtyRectsOfFrame(frame))
+      region.Union(rect);
+    region.Simplify(max_rects);
+    const auto& rects = region.rects();
+    num_rects += rects.size();
+    for (const auto& rect : rects)
+      area += AreaOf(rect);
+  }
+  const auto& elapsed = base::TimeTicks::Now() - start;
+  Report("region", elapsed, iterations, num_rects / iterations,
+         area / iterations);
+}
+
+}  // namespace
+
+}  // namespace gfx
+
+int main(int argc, char** argv) {
+  base::AtExitManager at_exit;
+  base::CommandLine::Init(argc, argv);
+  const auto& command_line = *base::CommandLine::ForCurrentProcess();
+  auto iterations = gfx::kDefaultIterations;
+  if (command_line.HasSwitch("iterations")) {
+    base::StringToInt(command_line.GetSwitchValueASCII("iterations"),
+                      &iterations);
+  }
+  auto max_rects = gfx::kDefaultMaxRects;
+  if (command_line.HasSwitch("max-rects")) {
+    base::StringToInt(command_line.GetSwitchValueASCII("max-rects"),
+                      &max_rects);
+  }
+  CHECK_GT(iterations, 0);
+  CHECK_GT(max_rects, 0);
+  gfx::BenchRectList(iterations);
+  gfx::BenchRegion(iterations, static_cast<size_t>(max_rects));
+  return 0;
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "evita/gfx/base/geometry/int_region.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace gfx {
+
+namespace {
+
+IntRect Rect(int left, int top, int right, int bottom) {
+  return IntRect(IntPoint(left, top), IntSize(right - left, bottom - top));
+}
+
+}  // namespace
+
+TEST(IntRegionTest, Contains) {
+  IntRegion region(Rect(0, 0, 10, 10));
+  region.Union(Rect(20, 0, 30, 10));
+
+  EXPECT_TRUE(region.Contains(IntPoint(0, 0)));
+  EXPECT_TRUE(region.Contains(IntPoint(9, 9)));
+  EXPECT_FALSE(region.Contains(IntPoint(10, 5)));
+  EXPECT_TRUE(region.Contains(IntPoint(25, 5)));
+  EXPECT_FALSE(region.Contains(IntPoint(25, 10)));
+
+  EXPECT_TRUE(region.Contains(Rect(2, 2, 8, 8)));
+  EXPECT_FALSE(region.Contains(Rect(5, 5, 25, 8)));
+  EXPECT_TRUE(region.Contains(IntRect())) << "Empty rect is always contained.";
+}
+
+TEST(IntRegionTest, Empty) {
+  IntRegion region;
+  EXPECT_TRUE(region.IsEmpty());
+  EXPECT_EQ(0u, region.num_rects());
+  EXPECT_EQ(IntRect(), region.bounds());
+
+  region.Union(IntRect());
+  EXPECT_TRUE(region.IsEmpty());
+
+  region.Union(Rect(0, 0, 10, 10));
+  region.Clear();
+  EXPECT_TRUE(region.IsEmpty());
+}
+
+TEST(IntRegionTest, Intersect) {
+  IntRegion region(Rect(0, 0, 10, 10));
+  region.Union(Rect(20, 0, 30, 10));
+  region.Intersect(Rect(5, 5, 25, 15));
+  EXPECT_EQ((std::vector<IntRect>{Rect(5, 5, 10, 10), Rect(20, 5, 25, 10)}),
+            region.rects());
+
+  region.Intersect(Rect(100, 100, 200, 200));
+  EXPECT_TRUE(region.IsEmpty());
+}
+
+TEST(IntRegionTest, Intersects) {
+  IntRegion region(Rect(0, 0, 10, 10));
+  region.Union(Rect(20, 20, 30, 30));
+
+  EXPECT_TRUE(region.Intersects(Rect(5, 5, 15, 15)));
+  EXPECT_FALSE(region.Intersects(Rect(10, 10, 20, 20)));
+  EXPECT_TRUE(region.Intersects(Rect(25, 0, 26, 21)));
+  EXPECT_FALSE(region.Intersects(IntRect()));
+}
+
+TEST(IntRegionTest, Simplify) {
+  // Text lines of height 10px with different width.
+  IntRegion region;
+  for (auto line = 0; line < 10; ++line)
+    region.Union(Rect(0, line * 10, 100 + line * 10, line * 10 + 5));
+  EXPECT_EQ(10u, region.num_rects());
+
+  auto region1 = region;
+  region1.Simplify(10);
+  EXPECT_EQ(region, region1) << "Simplify() doesn't change small region.";
+
+  auto region2 = region;
+  region2.Simplify(4);
+  EXPECT_LE(region2.num_rects(), 4u);
+  for (const auto& rect : region.rects())
+    EXPECT_TRUE(region2.Contains(rect));
+
+  auto region3 = region;
+  region3.Simplify(1);
+  EXPECT_EQ((std::vector<IntRect>{region.bounds()}), region3.rects());
+}
+
+TEST(IntRegionTest, SimplifyFillsSmallestGap) {
+  IntRegion region(Rect(0, 0, 10, 10));
+  region.Union(Rect(12, 0, 20, 10));
+  region.Union(Rect(100, 0, 110, 10));
+  region.Simplify(2);
+  EXPECT_EQ((std::vector<IntRect>{Rect(0, 0, 20, 10), Rect(100, 0, 110, 10)}),
+            region.rects());
+}
+
+TEST(IntRegionTest, Subtract) {
+  IntRegion region(Rect(0, 0, 30, 30));
+  region.Subtract(Rect(10, 10, 20, 20));
+  EXPECT_EQ((std::vector<IntRect>{Rect(0, 0, 30, 10), Rect(0, 10, 10, 20),
+                                  Rect(20, 10, 30, 20), Rect(0, 20, 30, 30)}),
+            region.rects());
+  EXPECT_EQ(Rect(0, 0, 30, 30), region.bounds());
+
+  region.Subtract(Rect(-10, -10, 40, 40));
+  EXPECT_TRUE(region.IsEmpty());
+}
+
+TEST(IntRegionTest, Union) {
+  IntRegion region(Rect(0, 0, 10, 10));
+  region.Union(Rect(10, 0, 20, 10));
+  EXPECT_EQ((std::vector<IntRect>{Rect(0, 0, 20, 10)}), region.rects())
+      << "Touching spans are merged.";
+
+  region.Union(Rect(0, 10, 20, 20));
+  EXPECT_EQ((std::vector<IntRect>{Rect(0, 0, 20, 20)}), region.rects())
+      << "Adjacent bands with same spans are merged.";
+
+  region.Union(Rect(5, 5, 30, 15));
+  EXPECT_EQ((std::vector<IntRect>{Rect(0, 0, 20, 5), Rect(0, 5, 30, 15),
+                                  Rect(0, 15, 20, 20)}),
+            region.rects());
+
+  region.Union(Rect(2, 2, 8, 8));
+  EXPECT_EQ(3u, region.num_rects()) << "Contained rect doesn't add rects.";
+}
+
+TEST(IntRegionTest, UniqueRepresentation) {
+  IntRegion region1(Rect(0, 0, 10, 20));
+  region1.Union(Rect(10, 0, 20, 20));
+
+  IntRegion region2(Rect(0, 0, 20, 10));
+  region2.Union(Rect(0, 10, 20, 20));
+
+  EXPECT_EQ(region1, region2);
+  EXPECT_EQ(IntRegion(Rect(0, 0, 20, 20)), region1);
+
+  region2.Subtract(Rect(5, 5, 6, 6));
+  EXPECT_NE(region1, region2);
+}
+
+}  // namespace gfx
@@ -160,6 +160,35 @@ void Canvas::CommitDraw() {
   DVLOG(0) << "ID2D1RenderTarget::Flush: hr=" << std::hex << hr;
 }
 
+std::unique_ptr<Bitmap> Canvas::CopyToBitmap(const RectF& bounds) {
+  DCHECK(!bounds_.empty());
+  DCHECK(!bounds.empty());
+  D2D1_MATRIX_3X2_F transform;
+  GetRenderTarget()->GetTransform(&transform);
+  const auto pixel_size = GetRenderTarget()->GetPixelSize();
+  auto const rect =
+      gfx::RectF(bounds.origin() + gfx::PointF(transform._31, transform._32),
+                 bounds.size())
+          .Intersect(gfx::RectF(gfx::SizeF(
+              static_cast<float>(pixel_size.width),
+              static_cast<float>(pixel_size.height))));
+  if (rect.empty())
+    return std::unique_ptr<Bitmap>();
+  auto const enclosing_rect = ToEnclosingRect(rect);
+  const RectU source_rect(static_cast<uint32_t>(enclosing_rect.left()),
+                          static_cast<uint32_t>(enclosing_rect.top()),
+                          static_cast<uint32_t>(enclosing_rect.right()),
+                          static_cast<uint32_t>(enclosing_rect.bottom()));
+  auto bitmap = std::make_unique<Bitmap>(this, source_rect.size());
+  const PointU dest_point(0, 0);
+  auto const hr = (*bitmap)->CopyFromRenderTarget(
+      &dest_point, GetRenderTarget(), &source_rect);
+  if (SUCCEEDED(hr))
+    return std::move(bitmap);
+  DVLOG(0) << "ID2D1Bitmap->CopyFromRenderTarget hr=" << std::hex << hr;
+  return std::unique_ptr<Bitmap>();
+}
+
 void Canvas::DidLostRenderTarget() {
   swap_chain_ = owner_->CreateSwapChain();
   bitmap_id_ = ++global_bitmap_id;
@@ -86,6 +86,10 @@ class Canvas final : public DpiHandler {
   void AddObserver(CanvasObserver* observer);
   void Clear(const ColorF& color);
   void Clear(D2D1::ColorF::Enum name);
+  // Returns a bitmap containing pixels in |bounds| of render target, or
+  // null if we can't copy pixels, e.g. lost render target, clip is pushed.
+  // |bounds| is mapped to render target by current transform.
+  std::unique_ptr<Bitmap> CopyToBitmap(const RectF& bounds);
   void DrawBitmap(const Bitmap& bitmap,
                   const RectF& dst_rect,
                   const RectF& src_rect,
@@ -0,0 +1,218 @@
+// Copyright (c) 1996-2014 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "evita/gfx/direct_write_font_backend_win.h"
+
+#include "base/logging.h"
+#include "evita/gfx/brush.h"
+#include "evita/gfx/canvas.h"
+#include "evita/gfx/direct2d_factory_win.h"
+#include "evita/gfx/font_face.h"
+
+namespace gfx {
+
+//////////////////////////////////////////////////////////////////////
+//
+// DirectWriteFontBackend::FaceImpl
+//
+class DirectWriteFontBackend::FaceImpl final : public FontBackend::Face {
+ public:
+  explicit FaceImpl(const gfx::FontProperties& properties);
+  ~FaceImpl() final = default;
+
+ private:
+  uint32_t CalculateFixedWidth() const;
+  float ConvertToDip(uint32_t design_unit) const;
+  float ConvertToDip(int design_unit) const;
+  std::vector<uint16_t> GetGlyphIndexes(const base::char16* chars,
+                                        size_t num_chars) const;
+  std::vector<DWRITE_GLYPH_METRICS> GetGlyphMetrics(const base::char16* chars,
+                                                    size_t num_chars) const;
+  std::vector<DWRITE_GLYPH_METRICS> GetGlyphMetrics(
+      const std::vector<uint16_t> glyph_indexes) const;
+  DWRITE_FONT_METRICS GetMetrics() const;
+
+  // FontBackend::Face
+  FontMetrics CalculateMetrics() const final;
+  void DrawText(gfx::Canvas* canvas,
+                const gfx::Brush& text_brush,
+                const gfx::PointF& baseline,
+                const base::char16* chars,
+                size_t num_chars) const final;
+  float GetTextWidth(const base::char16* chars, size_t num_chars) const final;
+  bool HasCharacter(base::char16 sample) const final;
+
+  const std::unique_ptr<gfx::FontFace> font_face_;
+  const float em_size_;  // the logical size of the font in DIP units.
+  const float pixels_per_dip_;
+  const DWRITE_FONT_METRICS metrics_;
+
+  DISALLOW_COPY_AND_ASSIGN(FaceImpl);
+};
+
+DirectWriteFontBackend::FaceImpl::FaceImpl(
+    const gfx::FontProperties& properties)
+    : font_face_(new gfx::FontFace(properties)),
+      em_size_(properties.font_size_pt * 96.0f / 72.0f),
+      pixels_per_dip_(
+          gfx::Direct2DFactory::GetInstance()->pixels_per_dip().height),
+      metrics_(GetMetrics()) {}
+
+FontMetrics DirectWriteFontBackend::FaceImpl::CalculateMetrics() const {
+  FontMetrics metrics;
+  metrics.ascent = ConvertToDip(metrics_.ascent);
+  metrics.descent = ConvertToDip(metrics_.descent);
+  metrics.height =
+      ConvertToDip(metrics_.ascent + metrics_.descent + metrics_.lineGap);
+  metrics.fixed_width = ConvertToDip(CalculateFixedWidth());
+  metrics.underline = ConvertToDip(-metrics_.underlinePosition);
+  metrics.underline_thickness = ConvertToDip(metrics_.underlineThickness);
+  return metrics;
+}
+
+uint32_t DirectWriteFontBackend::FaceImpl::CalculateFixedWidth() const {
+  static base::char16 cacheable_chars[0x7E - 0x20 + 1];
+  if (!cacheable_chars[0]) {
+    for (int ch = ' '; ch <= 0x7E; ++ch) {
+      cacheable_chars[ch - 0x20] = static_cast<base::char16>(ch);
+    }
+  }
+
+  const auto metrics =
+      GetGlyphMetrics(cacheable_chars, std::size(cacheable_chars));
+  const auto width = metrics[0].advanceWidth;
+  for (const auto metric : metrics) {
+    if (width != metric.advanceWidth)
+      return 0u;
+  }
+  return width;
+}
+
+float DirectWriteFontBackend::FaceImpl::ConvertToDip(
+    uint32_t design_unit) const {
+  return ::round(design_unit * em_size_ / metrics_.designUnitsPerEm);
+}
+
+float DirectWriteFontBackend::FaceImpl::ConvertToDip(int design_unit) const {
+  DCHECK_GE(design_unit, 0);
+  return ConvertToDip(static_cast<uint32_t>(design_unit));
+}
+
+void DirectWriteFontBackend::FaceImpl::DrawText(gfx::Canvas* canvas,
+                                                const gfx::Brush& text_brush,
+                                                const gfx::PointF& baseline,
+                                                const base::char16* chars,
+                                                size_t num_chars) const {
+  DCHECK_GE(num_chars, 1u);
+  const auto glyph_indexes = GetGlyphIndexes(chars, num_chars);
+
+  std::vector<float> glyph_advances(num_chars);
+  {
+    const auto& glyph_metrics = GetGlyphMetrics(glyph_indexes);
+    auto metrics_it = glyph_metrics.begin();
+    for (auto& it : glyph_advances) {
+      it = ConvertToDip(metrics_it->advanceWidth);
+      ++metrics_it;
+    }
+  }
+
+  DWRITE_GLYPH_RUN glyph_run;
+  glyph_run.fontFace = *font_face_;
+  glyph_run.fontEmSize = em_size_;
+  glyph_run.glyphCount = static_cast<uint32_t>(glyph_indexes.size());
+  glyph_run.glyphIndices = &glyph_indexes[0];
+  glyph_run.glyphAdvances = &glyph_advances[0];
+  glyph_run.glyphOffsets = nullptr;
+  glyph_run.isSideways = false;
+  glyph_run.bidiLevel = 0;
+
+  DCHECK(canvas->drawing());
+  (*canvas)->DrawGlyphRun(baseline, &glyph_run, text_brush,
+                          DWRITE_MEASURING_MODE_NATURAL);
+}
+
+std::vector<uint16_t> DirectWriteFontBackend::FaceImpl::GetGlyphIndexes(
+    const base::char16* chars,
+    size_t num_chars) const {
+  DCHECK_GE(num_chars, 1u);
+  std::vector<uint32_t> code_points(num_chars);
+  auto it = code_points.begin();
+  for (auto* s = chars; s < chars + num_chars; ++s) {
+    *it = *s;
+    ++it;
+  }
+  std::vector<uint16_t> glyph_indexes(num_chars);
+  COM_VERIFY((*font_face_)
+                 ->GetGlyphIndices(&code_points[0],
+                                   static_cast<DWORD>(code_points.size()),
+                                   &glyph_indexes[0]));
+  return std::move(glyph_indexes);
+}
+
+std::vector<DWRITE_GLYPH_METRICS>
+DirectWriteFontBackend::FaceImpl::GetGlyphMetrics(const base::char16* chars,
+                                                  size_t num_chars) const {
+  return GetGlyphMetrics(GetGlyphIndexes(chars, num_chars));
+}
+
+std::vector<DWRITE_GLYPH_METRICS>
+DirectWriteFontBackend::FaceImpl::GetGlyphMetrics(
+    const std::vector<uint16_t> glyph_indexes) const {
+  const auto is_side_ways = false;
+  std::vector<DWRITE_GLYPH_METRICS> metrics(glyph_indexes.size());
+  COM_VERIFY(
+      (*font_face_)
+          ->GetDesignGlyphMetrics(&glyph_indexes[0],
+                                  static_cast<DWORD>(glyph_indexes.size()),
+                                  &metrics[0], is_side_ways));
+  return std::move(metrics);
+}
+
+DWRITE_FONT_METRICS DirectWriteFontBackend::FaceImpl::GetMetrics() const {
+  DWRITE_FONT_METRICS metrics;
+  (*font_face_)->GetMetrics(&metrics);
+  return metrics;
+}
+
+float DirectWriteFontBackend::FaceImpl::GetTextWidth(
+    const base::char16* chars,
+    size_t num_chars) const {
+  const auto metrics = GetGlyphMetrics(chars, num_chars);
+  auto width = 0;
+  for (const auto metric : metrics) {
+    width += metric.advanceWidth;
+  }
+  return ConvertToDip(width);
+}
+
+bool DirectWriteFontBackend::FaceImpl::HasCharacter(base::char16 sample) const {
+  uint32_t code_point = sample;
+  uint16_t glyph_index;
+  COM_VERIFY((*font_face_)->GetGlyphIndices(&code_point, 1, &glyph_index));
+  return glyph_index != 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// DirectWriteFontBackend
+//
+DirectWriteFontBackend::DirectWriteFontBackend() {}
+DirectWriteFontBackend::~DirectWriteFontBackend() {}
+
+float DirectWriteFontBackend::AlignHeightToPixel(float height) const {
+  return Direct2DFactory::GetInstance()
+      ->AlignToPixel(gfx::SizeF(0.0f, height))
+      .height;
+}
+
+std::unique_ptr<FontBackend::Face> DirectWriteFontBackend::CreateFace(
+    const FontProperties& properties) const {
+  return std::make_unique<FaceImpl>(properties);
+}
+
+}  // namespace gfx
@@ -0,0 +1,37 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_GFX_DIRECT_WRITE_FONT_BACKEND_WIN_H_
+#define EVITA_GFX_DIRECT_WRITE_FONT_BACKEND_WIN_H_
+
+#include <memory>
+
+#include "base/macros.h"
+#include "evita/gfx/font_backend.h"
+
+namespace gfx {
+
+//////////////////////////////////////////////////////////////////////
+//
+// DirectWriteFontBackend
+//
+class DirectWriteFontBackend final : public FontBackend {
+ public:
+  DirectWriteFontBackend();
+  ~DirectWriteFontBackend() final;
+
+ private:
+  class FaceImpl;
+
+  // FontBackend
+  float AlignHeightToPixel(float height) const final;
+  std::unique_ptr<Face> CreateFace(
+      const FontProperties& properties) const final;
+
+  DISALLOW_COPY_AND_ASSIGN(DirectWriteFontBackend);
+};
+
+}  // namespace gfx
+
+#endif  // EVITA_GFX_DIRECT_WRITE_FONT_BACKEND_WIN_H_
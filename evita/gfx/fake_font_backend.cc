@@ -0,0 +1,104 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cmath>
+
+#include "evita/gfx/fake_font_backend.h"
+
+#include "base/logging.h"
+#include "evita/gfx/font_face.h"
+
+namespace gfx {
+
+namespace {
+
+bool IsWideCharacter(base::char16 char_code) {
+  return (char_code >= 0x1100 && char_code <= 0x115F) ||
+         (char_code >= 0x2E80 && char_code <= 0xA4CF) ||
+         (char_code >= 0xAC00 && char_code <= 0xD7A3) ||
+         (char_code >= 0xF900 && char_code <= 0xFAFF) ||
+         (char_code >= 0xFF00 && char_code <= 0xFF60) ||
+         (char_code >= 0xFFE0 && char_code <= 0xFFE6);
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// FakeFontBackend::FaceImpl
+//
+class FakeFontBackend::FaceImpl final : public FontBackend::Face {
+ public:
+  explicit FaceImpl(const FontProperties& properties);
+  ~FaceImpl() final = default;
+
+ private:
+  // FontBackend::Face
+  FontMetrics CalculateMetrics() const final;
+  void DrawText(Canvas* canvas,
+                const Brush& text_brush,
+                const PointF& baseline,
+                const base::char16* chars,
+                size_t num_chars) const final;
+  float GetTextWidth(const base::char16* chars, size_t num_chars) const final;
+  bool HasCharacter(base::char16 sample) const final;
+
+  // The logical size of the font in DIP units.
+  const float em_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(FaceImpl);
+};
+
+FakeFontBackend::FaceImpl::FaceImpl(const FontProperties& properties)
+    : em_size_(properties.font_size_pt * 96.0f / 72.0f) {}
+
+FontMetrics FakeFontBackend::FaceImpl::CalculateMetrics() const {
+  FontMetrics metrics;
+  metrics.ascent = ::round(em_size_ * 0.8f);
+  metrics.descent = ::round(em_size_ * 0.2f);
+  metrics.height = ::round(em_size_ * 1.2f);
+  metrics.fixed_width = ::round(em_size_ * 0.5f);
+  metrics.underline = ::round(em_size_ * 0.1f);
+  metrics.underline_thickness = 1.0f;
+  return metrics;
+}
+
+void FakeFontBackend::FaceImpl::DrawText(Canvas* canvas,
+                                         const Brush& text_brush,
+                                         const PointF& baseline,
+                                         const base::char16* chars,
+                                         size_t num_chars) const {
+  NOTREACHED() << "FakeFontBackend can't draw text.";
+}
+
+float FakeFontBackend::FaceImpl::GetTextWidth(const base::char16* chars,
+                                              size_t num_chars) const {
+  const auto half_width = ::round(em_size_ * 0.5f);
+  auto width = 0.0f;
+  for (auto* runner = chars; runner < chars + num_chars; ++runner)
+    width += IsWideCharacter(*runner) ? half_width * 2 : half_width;
+  return width;
+}
+
+bool FakeFontBackend::FaceImpl::HasCharacter(base::char16 sample) const {
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// FakeFontBackend
+//
+FakeFontBackend::FakeFontBackend() {}
+FakeFontBackend::~FakeFontBackend() {}
+
+float FakeFontBackend::AlignHeightToPixel(float height) const {
+  return ::ceil(height);
+}
+
+std::unique_ptr<FontBackend::Face> FakeFontBackend::CreateFace(
+    const FontProperties& properties) const {
+  return std::make_unique<FaceImpl>(properties);
+}
+
+}  // namespace gfx
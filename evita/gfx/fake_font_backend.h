@@ -0,0 +1,40 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_GFX_FAKE_FONT_BACKEND_H_
+#define EVITA_GFX_FAKE_FONT_BACKEND_H_
+
+#include <memory>
+
+#include "base/macros.h"
+#include "evita/gfx/font_backend.h"
+
+namespace gfx {
+
+//////////////////////////////////////////////////////////////////////
+//
+// FakeFontBackend
+// A deterministic font backend which doesn't use system fonts. All fonts are
+// monospace; ASCII characters are half of em wide and East Asian wide
+// characters are em wide. Fonts of this backend can't draw text.
+//
+class FakeFontBackend final : public FontBackend {
+ public:
+  FakeFontBackend();
+  ~FakeFontBackend() final;
+
+ private:
+  class FaceImpl;
+
+  // FontBackend
+  float AlignHeightToPixel(float height) const final;
+  std::unique_ptr<Face> CreateFace(
+      const FontProperties& properties) const final;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeFontBackend);
+};
+
+}  // namespace gfx
+
+#endif  // EVITA_GFX_FAKE_FONT_BACKEND_H_
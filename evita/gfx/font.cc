@@ -2,10 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-#include <iterator>
 #include <unordered_map>
 #include <utility>
-#include <vector>
 
 #include "evita/gfx/font.h"
 
@@ -13,7 +11,7 @@
 #include "common/memory/singleton.h"
 #include "evita/gfx/brush.h"
 #include "evita/gfx/canvas.h"
-#include "evita/gfx/direct2d_factory_win.h"
+#include "evita/gfx/font_backend.h"
 #include "evita/gfx/font_face.h"
 
 namespace {
@@ -62,182 +60,13 @@ const Font& Font::Cache::GetOrCreate(const gfx::FontProperties& font_props) {
   return *new_font;
 }
 
-//////////////////////////////////////////////////////////////////////
-//
-// Font
-//
-class Font::FontImpl {
- public:
-  explicit FontImpl(const gfx::FontProperties& properties);
-
-  // [C]
-  SimpleMetrics CalculateMetrics() const;
-  float ConvertToDip(uint32_t design_unit) const;
-  float ConvertToDip(int design_unit) const;
-
-  // [D]
-  void DrawText(gfx::Canvas* canvas,
-                const gfx::Brush& text_brush,
-                const gfx::PointF& baseline,
-                const base::char16* chars,
-                size_t num_chars) const;
-
-  // [G]
-  std::vector<uint16_t> GetGlyphIndexes(const base::char16* chars,
-                                        size_t num_chars) const;
-  std::vector<DWRITE_GLYPH_METRICS> GetGlyphMetrics(const base::char16* chars,
-                                                    size_t num_chars) const;
-  // [H]
-  bool HasCharacter(base::char16 sample) const;
-
- private:
-  uint32_t CalculateFixedWidth() const;
-  std::vector<DWRITE_GLYPH_METRICS> GetGlyphMetrics(
-      const std::vector<uint16_t> glyph_indexes) const;
-  DWRITE_FONT_METRICS GetMetrics() const;
-
-  const std::unique_ptr<gfx::FontFace> font_face_;
-  const float em_size_;  // the logical size of the font in DIP units.
-  const float pixels_per_dip_;
-  const DWRITE_FONT_METRICS metrics_;
-
-  DISALLOW_COPY_AND_ASSIGN(FontImpl);
-};
-
-Font::FontImpl::FontImpl(const gfx::FontProperties& properties)
-    : font_face_(new gfx::FontFace(properties)),
-      em_size_(properties.font_size_pt * 96.0f / 72.0f),
-      pixels_per_dip_(
-          gfx::Direct2DFactory::GetInstance()->pixels_per_dip().height),
-      metrics_(GetMetrics()) {}
-
-Font::SimpleMetrics Font::FontImpl::CalculateMetrics() const {
-  SimpleMetrics metrics;
-  metrics.ascent = ConvertToDip(metrics_.ascent);
-  metrics.descent = ConvertToDip(metrics_.descent);
-  metrics.height =
-      ConvertToDip(metrics_.ascent + metrics_.descent + metrics_.lineGap);
-  metrics.fixed_width = ConvertToDip(CalculateFixedWidth());
-  metrics.underline = ConvertToDip(-metrics_.underlinePosition);
-  metrics.underline_thickness = ConvertToDip(metrics_.underlineThickness);
-  return metrics;
-}
-
-uint32_t Font::FontImpl::CalculateFixedWidth() const {
-  static base::char16 cacheable_chars[0x7E - 0x20 + 1];
-  if (!cacheable_chars[0]) {
-    for (int ch = ' '; ch <= 0x7E; ++ch) {
-      cacheable_chars[ch - 0x20] = static_cast<base::char16>(ch);
-    }
-  }
-
-  const auto metrics =
-      GetGlyphMetrics(cacheable_chars, std::size(cacheable_chars));
-  const auto width = metrics[0].advanceWidth;
-  for (const auto metric : metrics) {
-    if (width != metric.advanceWidth)
-      return 0u;
-  }
-  return width;
-}
-
-float Font::FontImpl::ConvertToDip(uint32_t design_unit) const {
-  return ::round(design_unit * em_size_ / metrics_.designUnitsPerEm);
-}
-
-float Font::FontImpl::ConvertToDip(int design_unit) const {
-  DCHECK_GE(design_unit, 0);
-  return ConvertToDip(static_cast<uint32_t>(design_unit));
-}
-
-void Font::FontImpl::DrawText(gfx::Canvas* canvas,
-                              const gfx::Brush& text_brush,
-                              const gfx::PointF& baseline,
-                              const base::char16* chars,
-                              size_t num_chars) const {
-  DCHECK_GE(num_chars, 1u);
-  const auto glyph_indexes = GetGlyphIndexes(chars, num_chars);
-
-  std::vector<float> glyph_advances(num_chars);
-  {
-    const auto& glyph_metrics = GetGlyphMetrics(glyph_indexes);
-    auto metrics_it = glyph_metrics.begin();
-    for (auto& it : glyph_advances) {
-      it = ConvertToDip(metrics_it->advanceWidth);
-      ++metrics_it;
-    }
-  }
-
-  DWRITE_GLYPH_RUN glyph_run;
-  glyph_run.fontFace = *font_face_;
-  glyph_run.fontEmSize = em_size_;
-  glyph_run.glyphCount = static_cast<uint32_t>(glyph_indexes.size());
-  glyph_run.glyphIndices = &glyph_indexes[0];
-  glyph_run.glyphAdvances = &glyph_advances[0];
-  glyph_run.glyphOffsets = nullptr;
-  glyph_run.isSideways = false;
-  glyph_run.bidiLevel = 0;
-
-  DCHECK(canvas->drawing());
-  (*canvas)->DrawGlyphRun(baseline, &glyph_run, text_brush,
-                          DWRITE_MEASURING_MODE_NATURAL);
-}
-
-std::vector<uint16_t> Font::FontImpl::GetGlyphIndexes(const base::char16* chars,
-                                                      size_t num_chars) const {
-  DCHECK_GE(num_chars, 1u);
-  std::vector<uint32_t> code_points(num_chars);
-  auto it = code_points.begin();
-  for (auto* s = chars; s < chars + num_chars; ++s) {
-    *it = *s;
-    ++it;
-  }
-  std::vector<uint16_t> glyph_indexes(num_chars);
-  COM_VERIFY((*font_face_)
-                 ->GetGlyphIndices(&code_points[0],
-                                   static_cast<DWORD>(code_points.size()),
-                                   &glyph_indexes[0]));
-  return std::move(glyph_indexes);
-}
-
-std::vector<DWRITE_GLYPH_METRICS> Font::FontImpl::GetGlyphMetrics(
-    const base::char16* chars,
-    size_t num_chars) const {
-  return GetGlyphMetrics(GetGlyphIndexes(chars, num_chars));
-}
-
-std::vector<DWRITE_GLYPH_METRICS> Font::FontImpl::GetGlyphMetrics(
-    const std::vector<uint16_t> glyph_indexes) const {
-  const auto is_side_ways = false;
-  std::vector<DWRITE_GLYPH_METRICS> metrics(glyph_indexes.size());
-  COM_VERIFY(
-      (*font_face_)
-          ->GetDesignGlyphMetrics(&glyph_indexes[0],
-                                  static_cast<DWORD>(glyph_indexes.size()),
-                                  &metrics[0], is_side_ways));
-  return std::move(metrics);
-}
-
-DWRITE_FONT_METRICS Font::FontImpl::GetMetrics() const {
-  DWRITE_FONT_METRICS metrics;
-  (*font_face_)->GetMetrics(&metrics);
-  return metrics;
-}
-
-bool Font::FontImpl::HasCharacter(base::char16 sample) const {
-  uint32_t code_point = sample;
-  uint16_t glyph_index;
-  COM_VERIFY((*font_face_)->GetGlyphIndices(&code_point, 1, &glyph_index));
-  return glyph_index != 0;
-}
-
 //////////////////////////////////////////////////////////////////////
 //
 // Font
 //
 Font::Font(const gfx::FontProperties& properties)
-    : font_impl_(new FontImpl(properties)),
-      metrics_(font_impl_->CalculateMetrics()) {}
+    : face_(FontBackend::GetInstance()->CreateFace(properties)),
+      metrics_(face_->CalculateMetrics()) {}
 
 Font::~Font() {}
 
@@ -247,7 +76,7 @@ void Font::DrawText(gfx::Canvas* canvas,
                     const base::char16* chars,
                     size_t num_chars) const {
   const auto baseline = rect.origin() + gfx::SizeF(0.0f, metrics_.ascent);
-  font_impl_->DrawText(canvas, text_brush, baseline, chars, num_chars);
+  face_->DrawText(canvas, text_brush, baseline, chars, num_chars);
 }
 
 void Font::DrawText(gfx::Canvas* canvas,
@@ -272,12 +101,7 @@ float Font::GetTextWidth(const base::char16* chars, size_t num_chars) const {
   if (metrics_.fixed_width && IsCachableString(chars, num_chars))
     return metrics_.fixed_width * num_chars;
 
-  const auto metrics = font_impl_->GetGlyphMetrics(chars, num_chars);
-  auto width = 0;
-  for (const auto metric : metrics) {
-    width += metric.advanceWidth;
-  }
-  return font_impl_->ConvertToDip(width);
+  return face_->GetTextWidth(chars, num_chars);
 }
 
 float Font::GetTextWidth(const base::string16& string) const {
@@ -289,7 +113,7 @@ bool Font::HasCharacter(base::char16 sample) const {
   // TODO(yosi): We don't believe this assumption.l
   if (sample >= 0x20 && sample <= 0x7E)
     return true;
-  return font_impl_->HasCharacter(sample);
+  return face_->HasCharacter(sample);
 }
 
 }  // namespace gfx
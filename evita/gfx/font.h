@@ -11,6 +11,7 @@
 
 #include "base/macros.h"
 #include "base/strings/string16.h"
+#include "evita/gfx/font_backend.h"
 #include "evita/gfx/forward.h"
 
 namespace gfx {
@@ -46,24 +47,13 @@ class Font {
   bool HasCharacter(base::char16) const;
 
  private:
-  class FontImpl;
-
-  struct SimpleMetrics {
-    float ascent;
-    float descent;
-    float height;
-    float fixed_width;
-    float underline;
-    float underline_thickness;
-  };
-
   explicit Font(const gfx::FontProperties& properties);
   ~Font();
 
   float ascent() const { return metrics_.ascent; }
 
-  const std::unique_ptr<FontImpl> font_impl_;
-  const SimpleMetrics metrics_;
+  const std::unique_ptr<FontBackend::Face> face_;
+  const FontMetrics metrics_;
 
   DISALLOW_COPY_AND_ASSIGN(Font);
 };
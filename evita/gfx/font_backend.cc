@@ -0,0 +1,52 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <utility>
+
+#include "evita/gfx/font_backend.h"
+
+#include "base/logging.h"
+
+#if OS_WIN
+#include "evita/gfx/direct_write_font_backend_win.h"
+#endif
+
+namespace gfx {
+
+namespace {
+FontBackend* s_font_backend;
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// FontBackend::Face
+//
+FontBackend::Face::Face() {}
+FontBackend::Face::~Face() {}
+
+//////////////////////////////////////////////////////////////////////
+//
+// FontBackend
+//
+FontBackend::FontBackend() {}
+FontBackend::~FontBackend() {}
+
+// static
+FontBackend* FontBackend::GetInstance() {
+#if OS_WIN
+  if (!s_font_backend)
+    s_font_backend = new DirectWriteFontBackend();
+#endif
+  DCHECK(s_font_backend) << "No default font backend for this platform.";
+  return s_font_backend;
+}
+
+// static
+void FontBackend::SetInstance(std::unique_ptr<FontBackend> backend) {
+  DCHECK(backend);
+  delete s_font_backend;
+  s_font_backend = backend.release();
+}
+
+}  // namespace gfx
@@ -0,0 +1,91 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_GFX_FONT_BACKEND_H_
+#define EVITA_GFX_FONT_BACKEND_H_
+
+#include <memory>
+
+#include "base/macros.h"
+#include "base/strings/string16.h"
+#include "evita/gfx/forward.h"
+
+namespace gfx {
+
+struct FontProperties;
+
+//////////////////////////////////////////////////////////////////////
+//
+// FontMetrics
+//
+struct FontMetrics {
+  float ascent = 0;
+  float descent = 0;
+  float height = 0;
+  // |fixed_width| is zero if ASCII characters have different widths.
+  float fixed_width = 0;
+  float underline = 0;
+  float underline_thickness = 0;
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// FontBackend
+// Provides glyph metrics and glyph drawing to |Font|, and pixel alignment to
+// text layout. The default backend uses DirectWrite. Benchmarks and tests
+// install a deterministic backend to measure layout without system fonts.
+//
+class FontBackend {
+ public:
+  //////////////////////////////////////////////////////////////////////
+  //
+  // FontBackend::Face
+  //
+  class Face {
+   public:
+    virtual ~Face();
+
+    virtual FontMetrics CalculateMetrics() const = 0;
+    virtual void DrawText(Canvas* canvas,
+                          const Brush& text_brush,
+                          const PointF& baseline,
+                          const base::char16* chars,
+                          size_t num_chars) const = 0;
+    virtual float GetTextWidth(const base::char16* chars,
+                               size_t num_chars) const = 0;
+    virtual bool HasCharacter(base::char16 sample) const = 0;
+
+   protected:
+    Face();
+
+   private:
+    DISALLOW_COPY_AND_ASSIGN(Face);
+  };
+
+  virtual ~FontBackend();
+
+  virtual float AlignHeightToPixel(float height) const = 0;
+  virtual std::unique_ptr<Face> CreateFace(
+      const FontProperties& properties) const = 0;
+
+  // Returns current backend. On Windows, the DirectWrite backend is created
+  // on first call unless |SetInstance()| is called before. Other platforms
+  // have no default backend.
+  static FontBackend* GetInstance();
+
+  // Makes |backend| current backend. Since |Font| objects are cached forever,
+  // this function should be called before creating any font, e.g. at start
+  // of benchmark.
+  static void SetInstance(std::unique_ptr<FontBackend> backend);
+
+ protected:
+  FontBackend();
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(FontBackend);
+};
+
+}  // namespace gfx
+
+#endif  // EVITA_GFX_FONT_BACKEND_H_
@@ -14,6 +14,13 @@
 
 namespace gfx {
 
+namespace {
+
+// Maximum number of dirty rectangles passed to |IDXGISwapChain1::Present1()|.
+const size_t kMaxDirtyRects = 8;
+
+}  // namespace
+
 //////////////////////////////////////////////////////////////////////
 //
 // SwapChain
@@ -41,21 +48,9 @@ void SwapChain::AddDirtyRect(const RectF& new_dirty_rect_f) {
   DCHECK(bounds_.Contains(new_dirty_rect_f));
   auto const new_dirty_rect = ToEnclosingRect(new_dirty_rect_f);
   DCHECK(!new_dirty_rect.empty());
-  if (dirty_rects_.empty()) {
-    dirty_rects_.push_back(new_dirty_rect);
-    return;
-  }
-  for (const auto& dirty_rect : dirty_rects_) {
-    if (dirty_rect.Contains(new_dirty_rect))
-      return;
-  }
-  std::vector<Rect> new_dirty_rects;
-  for (const auto& dirty_rect : dirty_rects_) {
-    if (!new_dirty_rect.Contains(dirty_rect))
-      new_dirty_rects.push_back(dirty_rect);
-  }
-  new_dirty_rects.push_back(new_dirty_rect);
-  dirty_rects_ = new_dirty_rects;
+  dirty_region_.Union(
+      IntRect(IntPoint(new_dirty_rect.left(), new_dirty_rect.top()),
+              IntSize(new_dirty_rect.width(), new_dirty_rect.height())));
 }
 
 std::unique_ptr<SwapChain> SwapChain::CreateForComposition(
@@ -142,16 +137,19 @@ void SwapChain::DidChangeBounds(const RectF& new_bounds) {
 }
 
 void SwapChain::Present() {
-  if (dirty_rects_.empty())
+  if (dirty_region_.IsEmpty())
     return;
   DCHECK(is_ready_);
-  TRACE_EVENT1("gfx", "SwapChain::Present", "count", dirty_rects_.size());
+  TRACE_EVENT1("gfx", "SwapChain::Present", "count",
+               dirty_region_.num_rects());
   DXGI_PRESENT_PARAMETERS parameters = {0};
   std::vector<RECT> dirty_rects;
   if (!is_first_present_) {
-    for (auto const rect : dirty_rects_) {
-      dirty_rects.push_back(static_cast<RECT>(rect));
-    }
+    // Presenting many small rectangles costs more than presenting a few
+    // slightly larger rectangles, e.g. per line rectangles of text.
+    dirty_region_.Simplify(kMaxDirtyRects);
+    for (const auto& rect : dirty_region_.rects())
+      dirty_rects.push_back({rect.x(), rect.y(), rect.right(), rect.bottom()});
     parameters.DirtyRectsCount = static_cast<UINT>(dirty_rects.size());
     parameters.pDirtyRects = dirty_rects.data();
     parameters.pScrollRect = nullptr;
@@ -159,7 +157,7 @@ void SwapChain::Present() {
   }
   const auto kPresentFlags = DXGI_PRESENT_DO_NOT_WAIT;
   COM_VERIFY(swap_chain_->Present1(0, kPresentFlags, &parameters));
-  dirty_rects_.clear();
+  dirty_region_.Clear();
   is_ready_ = false;
   is_first_present_ = false;
 }
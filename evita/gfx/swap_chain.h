@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "common/win/scoped_comptr.h"
+#include "evita/gfx/base/geometry/int_region.h"
 #include "evita/gfx/rect_f.h"
 
 interface IDXGISwapChain2;
@@ -45,7 +46,7 @@ class SwapChain final {
 
   RectF bounds_;
   common::ComPtr<ID2D1DeviceContext> d2d_device_context_;
-  std::vector<Rect> dirty_rects_;
+  IntRegion dirty_region_;
   bool is_first_present_;
   // To avoid calling |WaitForSingleObject()|, |is_ready_| holds last checked
   // result.
@@ -0,0 +1,60 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/io/byte_ring_buffer.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace io {
+
+//////////////////////////////////////////////////////////////////////
+//
+// ByteRingBuffer
+//
+ByteRingBuffer::ByteRingBuffer(size_t capacity) : bytes_(capacity) {
+  DCHECK_GT(capacity, 0u);
+}
+
+ByteRingBuffer::~ByteRingBuffer() {}
+
+void ByteRingBuffer::Commit(size_t num_bytes) {
+  DCHECK_LE(num_bytes, capacity() - size_);
+  size_ += num_bytes;
+}
+
+uint8_t* ByteRingBuffer::GetWritableSpace(size_t* num_bytes) {
+  // Reset |start_| to make contiguous free space as large as possible. We
+  // don't do this in |Read()|, since a producer may be writing into space
+  // returned by the previous call, e.g. pending overlapped read.
+  if (empty())
+    start_ = 0;
+  const auto end = (start_ + size_) % capacity();
+  if (full())
+    *num_bytes = 0;
+  else if (end < start_)
+    *num_bytes = start_ - end;
+  else
+    *num_bytes = capacity() - end;
+  return bytes_.data() + end;
+}
+
+size_t ByteRingBuffer::Read(void* buffer, size_t num_bytes) {
+  auto* output = static_cast<uint8_t*>(buffer);
+  size_t num_read = 0;
+  while (num_read < num_bytes && size_ > 0) {
+    const auto count =
+        std::min({num_bytes - num_read, size_, capacity() - start_});
+    ::memcpy(output + num_read, bytes_.data() + start_, count);
+    num_read += count;
+    size_ -= count;
+    start_ = (start_ + count) % capacity();
+  }
+  return num_read;
+}
+
+}  // namespace io
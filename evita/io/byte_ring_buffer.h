@@ -0,0 +1,55 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_IO_BYTE_RING_BUFFER_H_
+#define EVITA_IO_BYTE_RING_BUFFER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/macros.h"
+
+namespace io {
+
+//////////////////////////////////////////////////////////////////////
+//
+// ByteRingBuffer
+// Fixed capacity FIFO of bytes. Producers write into |GetWritableSpace()|
+// directly, e.g. overlapped read, then |Commit()| number of bytes written.
+//
+class ByteRingBuffer final {
+ public:
+  explicit ByteRingBuffer(size_t capacity);
+  ~ByteRingBuffer();
+
+  size_t capacity() const { return bytes_.size(); }
+  bool empty() const { return size_ == 0; }
+  bool full() const { return size_ == capacity(); }
+  size_t size() const { return size_; }
+
+  // Adds |num_bytes| bytes written into |GetWritableSpace()|.
+  void Commit(size_t num_bytes);
+
+  // Returns start of contiguous free space and its size in |num_bytes|.
+  // Returned space is valid until |Commit()| even if |Read()| is called.
+  uint8_t* GetWritableSpace(size_t* num_bytes);
+
+  // Removes up to |num_bytes| bytes into |buffer| and returns number of
+  // bytes removed.
+  size_t Read(void* buffer, size_t num_bytes);
+
+ private:
+  std::vector<uint8_t> bytes_;
+  size_t size_ = 0;
+  // Index of the first byte.
+  size_t start_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ByteRingBuffer);
+};
+
+}  // namespace io
+
+#endif  // EVITA_IO_BYTE_RING_BUFFER_H_
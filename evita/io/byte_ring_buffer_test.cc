@@ -0,0 +1,88 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+#include "evita/io/byte_ring_buffer.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace io {
+
+namespace {
+
+void Write(ByteRingBuffer* ring, const std::string& text) {
+  size_t offset = 0;
+  while (offset < text.size()) {
+    size_t num_bytes = 0;
+    auto* const space = ring->GetWritableSpace(&num_bytes);
+    ASSERT_GT(num_bytes, 0u);
+    const auto count = std::min(num_bytes, text.size() - offset);
+    ::memcpy(space, text.data() + offset, count);
+    ring->Commit(count);
+    offset += count;
+  }
+}
+
+std::string Read(ByteRingBuffer* ring, size_t num_bytes) {
+  std::string result(num_bytes, 0);
+  result.resize(ring->Read(&result[0], num_bytes));
+  return result;
+}
+
+}  // namespace
+
+TEST(ByteRingBufferTest, Basic) {
+  ByteRingBuffer ring(8);
+  EXPECT_TRUE(ring.empty());
+  Write(&ring, "abcdef");
+  EXPECT_EQ(6u, ring.size());
+  EXPECT_EQ("abcd", Read(&ring, 4));
+  EXPECT_EQ(2u, ring.size());
+  EXPECT_EQ("ef", Read(&ring, 10));
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(ByteRingBufferTest, Full) {
+  ByteRingBuffer ring(8);
+  Write(&ring, "abcdefgh");
+  EXPECT_TRUE(ring.full());
+  size_t num_bytes = 1;
+  ring.GetWritableSpace(&num_bytes);
+  EXPECT_EQ(0u, num_bytes);
+}
+
+// Reading while producer writes into writable space, e.g. pending
+// overlapped read, should not move writable space.
+TEST(ByteRingBufferTest, ReadWhileWriting) {
+  ByteRingBuffer ring(8);
+  Write(&ring, "abcdef");
+  size_t num_bytes = 0;
+  auto* const space = ring.GetWritableSpace(&num_bytes);
+  ASSERT_EQ(2u, num_bytes);
+  EXPECT_EQ("abcdef", Read(&ring, 6));
+  EXPECT_TRUE(ring.empty());
+  ::memcpy(space, "gh", 2);
+  ring.Commit(2);
+  EXPECT_EQ("gh", Read(&ring, 8));
+  ring.GetWritableSpace(&num_bytes);
+  EXPECT_EQ(8u, num_bytes) << "Empty buffer should have whole space.";
+}
+
+TEST(ByteRingBufferTest, Wrap) {
+  ByteRingBuffer ring(8);
+  Write(&ring, "abcdef");
+  EXPECT_EQ("abcd", Read(&ring, 4));
+  size_t num_bytes = 0;
+  ring.GetWritableSpace(&num_bytes);
+  EXPECT_EQ(2u, num_bytes) << "Free space up to end of storage.";
+  Write(&ring, "ghijkl");
+  EXPECT_TRUE(ring.full());
+  EXPECT_EQ("efghijkl", Read(&ring, 8));
+}
+
+}  // namespace io
@@ -5,58 +5,49 @@
 #include "evita/io/directory_io_context.h"
 
 #include <utility>
-#include <vector>
 
 #include "base/bind.h"
-#include "base/callback.h"
-#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/task_runner.h"
 #include "evita/dom/public/promise.h"
-#include "evita/dom/public/view_event_handler.h"
-#include "evita/io/io_context_utils.h"
 
 namespace io {
 
-namespace {
-std::unique_ptr<base::FileEnumerator> CreateFileEnumerator(
-    const base::string16& dir_name) {
-  const auto recursive = false;
-  return std::make_unique<base::FileEnumerator>(
-      base::FilePath(dir_name), recursive,
-      base::FileEnumerator::FILES | base::FileEnumerator::DIRECTORIES);
-}
-}  // namespace
-
 //////////////////////////////////////////////////////////////////////
 //
 // DirectoryIoContext
 //
-DirectoryIoContext::DirectoryIoContext(const base::string16& dir_name)
-    : dir_name_(dir_name), file_enumerator_(CreateFileEnumerator(dir_name)) {}
+DirectoryIoContext::DirectoryIoContext(
+    const base::string16& dir_name,
+    bool recursive,
+    scoped_refptr<base::TaskRunner> task_runner,
+    const RunCallback& run_callback)
+    : run_callback_(run_callback),
+      scanner_(base::FilePath::FromUTF16Unsafe(dir_name),
+               recursive,
+               std::move(task_runner)) {}
 
 DirectoryIoContext::~DirectoryIoContext() {}
 
+void DirectoryIoContext::DidRead(
+    domapi::ReadDirectoryPromise promise,
+    const std::vector<domapi::FileStatus>& entries) {
+  run_callback_.Run(base::BindOnce(std::move(promise.resolve), entries));
+}
+
+// Read in flight is resolved with no entries before deleting |this|, since
+// its callback refers |this|. Results of scans in flight are discarded.
 void DirectoryIoContext::Close(domapi::IoIntPromise promise) {
-  Resolve(std::move(promise.resolve), 0);
+  scanner_.Cancel();
+  run_callback_.Run(base::BindOnce(std::move(promise.resolve), 0));
+  delete this;
 }
 
 void DirectoryIoContext::Read(size_t num_read,
                               domapi::ReadDirectoryPromise promise) {
-  std::vector<domapi::FileStatus> entries;
-  while (entries.size() < num_read) {
-    const auto& file_path = file_enumerator_->Next();
-    if (file_path.empty())
-      break;
-    const auto& file_info = file_enumerator_->GetInfo();
-    domapi::FileStatus entry;
-    entry.file_size = entry.is_directory = file_info.IsDirectory();
-    entry.is_symlink = false;
-    entry.last_write_time = file_info.GetLastModifiedTime();
-    entry.name = file_info.GetName().value();
-    entry.readonly =
-        !!(file_info.find_data().dwFileAttributes & FILE_ATTRIBUTE_READONLY);
-    entries.push_back(entry);
-  }
-  RunCallback(base::BindOnce(std::move(promise.resolve), entries));
+  scanner_.Read(num_read,
+                base::BindOnce(&DirectoryIoContext::DidRead,
+                               base::Unretained(this), std::move(promise)));
 }
 
 }  // namespace io
@@ -5,17 +5,18 @@
 #ifndef EVITA_IO_DIRECTORY_IO_CONTEXT_H_
 #define EVITA_IO_DIRECTORY_IO_CONTEXT_H_
 
-#include <memory>
-#include <string>
+#include <vector>
 
+#include "base/callback.h"
 #include "base/macros.h"
+#include "base/memory/ref_counted.h"
 #include "base/strings/string16.h"
 #include "evita/dom/public/io_callback.h"
-#include "evita/dom/public/io_context_id.h"
+#include "evita/io/directory_scanner.h"
 #include "evita/io/io_context.h"
 
 namespace base {
-class FileEnumerator;
+class TaskRunner;
 }
 
 namespace io {
@@ -23,18 +24,33 @@ namespace io {
 //////////////////////////////////////////////////////////////////////
 //
 // DirectoryIoContext
+// Returns entries of a directory, or of a directory tree if |recursive|, in
+// batches with their status. See |DirectoryScanner| for details.
 //
 class DirectoryIoContext final : public IoContext {
+  DECLARE_DEPRECATED_CASTABLE_CLASS(DirectoryIoContext, IoContext);
+
  public:
-  explicit DirectoryIoContext(const base::string16& dir_name);
+  // |run_callback| runs promise callbacks on the thread of caller.
+  using RunCallback = base::RepeatingCallback<void(base::OnceClosure)>;
+
+  DirectoryIoContext(const base::string16& dir_name,
+                     bool recursive,
+                     scoped_refptr<base::TaskRunner> task_runner,
+                     const RunCallback& run_callback);
   ~DirectoryIoContext() final;
 
-  void Close(domapi::IoIntPromise promise);
   void Read(size_t num_read, domapi::ReadDirectoryPromise promise);
 
  private:
-  const base::string16& dir_name_;
-  const std::unique_ptr<base::FileEnumerator> file_enumerator_;
+  void DidRead(domapi::ReadDirectoryPromise promise,
+               const std::vector<domapi::FileStatus>& entries);
+
+  // io::IoContext
+  void Close(domapi::IoIntPromise promise) final;
+
+  const RunCallback run_callback_;
+  DirectoryScanner scanner_;
 
   DISALLOW_COPY_AND_ASSIGN(DirectoryIoContext);
 };
@@ -0,0 +1,197 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/io/directory_scanner.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_enumerator.h"
+#include "base/logging.h"
+#include "base/task_runner.h"
+#include "base/task_runner_util.h"
+#include "base/trace_event/trace_event.h"
+#include "build/build_config.h"
+#include "evita/io/ignore_patterns.h"
+
+#if defined(OS_POSIX)
+#include <sys/stat.h>
+#endif
+
+namespace io {
+
+namespace {
+
+// Number of entries buffered before the scanner stops issuing scans.
+const size_t kMaxBufferedEntries = 64 * 1024;
+
+// Number of directories scanned in parallel.
+const int kMaxPendingScans = 8;
+
+const base::FilePath::CharType kGitDirName[] = FILE_PATH_LITERAL(".git");
+
+int FileTypesOf(bool recursive) {
+  auto const file_types =
+      base::FileEnumerator::FILES | base::FileEnumerator::DIRECTORIES;
+#if defined(OS_POSIX)
+  // Report symbolic links themselves, so we don't follow them into cycles.
+  if (recursive)
+    return file_types | base::FileEnumerator::SHOW_SYM_LINKS;
+#endif
+  return file_types;
+}
+
+domapi::FileStatus FileStatusOf(const base::FileEnumerator::FileInfo& info) {
+  domapi::FileStatus entry;
+  entry.file_size = static_cast<int>(std::min(
+      info.GetSize(), static_cast<int64_t>(std::numeric_limits<int>::max())));
+  entry.is_directory = info.IsDirectory();
+  entry.last_write_time = info.GetLastModifiedTime();
+#if defined(OS_WIN)
+  const auto attributes = info.find_data().dwFileAttributes;
+  entry.is_symlink = (attributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+  entry.readonly = (attributes & FILE_ATTRIBUTE_READONLY) != 0;
+#else
+  entry.is_symlink = S_ISLNK(info.stat().st_mode);
+  entry.readonly = (info.stat().st_mode & S_IWUSR) == 0;
+#endif
+  return entry;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// DirectoryScanner::ScanResult
+//
+struct DirectoryScanner::ScanResult {
+  std::vector<Directory> directories;
+  Entries entries;
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// DirectoryScanner
+//
+DirectoryScanner::DirectoryScanner(const base::FilePath& root_path,
+                                   bool recursive,
+                                   scoped_refptr<base::TaskRunner> task_runner)
+    : recursive_(recursive),
+      root_path_(root_path),
+      task_runner_(std::move(task_runner)),
+      weak_factory_(this) {
+  directories_.push_back(Directory());
+  ScanDirectories();
+}
+
+DirectoryScanner::~DirectoryScanner() {}
+
+bool DirectoryScanner::is_done() const {
+  return directories_.empty() && num_pending_scans_ == 0;
+}
+
+void DirectoryScanner::Cancel() {
+  weak_factory_.InvalidateWeakPtrs();
+  directories_.clear();
+  entries_.clear();
+  num_pending_scans_ = 0;
+  ServeRead();
+}
+
+void DirectoryScanner::DidScanDirectory(std::unique_ptr<ScanResult> result) {
+  DCHECK_GT(num_pending_scans_, 0);
+  --num_pending_scans_;
+  for (auto& directory : result->directories)
+    directories_.push_back(std::move(directory));
+  entries_.insert(entries_.end(),
+                  std::make_move_iterator(result->entries.begin()),
+                  std::make_move_iterator(result->entries.end()));
+  ServeRead();
+  ScanDirectories();
+}
+
+void DirectoryScanner::Read(size_t num_read, ReadCallback callback) {
+  DCHECK(!read_callback_) << "Only one read can be in flight.";
+  DCHECK_GT(num_read, 0u);
+  read_callback_ = std::move(callback);
+  read_size_ = num_read;
+  ServeRead();
+  ScanDirectories();
+}
+
+void DirectoryScanner::ScanDirectories() {
+  while (num_pending_scans_ < kMaxPendingScans && !directories_.empty() &&
+         entries_.size() < kMaxBufferedEntries) {
+    auto directory = std::move(directories_.front());
+    directories_.pop_front();
+    ++num_pending_scans_;
+    base::PostTaskAndReplyWithResult(
+        task_runner_.get(), FROM_HERE,
+        base::BindOnce(&DirectoryScanner::ScanDirectory, root_path_,
+                       recursive_, std::move(directory)),
+        base::BindOnce(&DirectoryScanner::DidScanDirectory,
+                       weak_factory_.GetWeakPtr()));
+  }
+}
+
+void DirectoryScanner::ServeRead() {
+  if (!read_callback_)
+    return;
+  if (entries_.empty() && !is_done())
+    return;
+  auto const count = std::min(read_size_, entries_.size());
+  Entries entries(std::make_move_iterator(entries_.begin()),
+                  std::make_move_iterator(entries_.begin() + count));
+  entries_.erase(entries_.begin(), entries_.begin() + count);
+  std::move(read_callback_).Run(entries);
+}
+
+// static
+std::unique_ptr<DirectoryScanner::ScanResult> DirectoryScanner::ScanDirectory(
+    const base::FilePath& root_path,
+    bool recursive,
+    const Directory& directory) {
+  TRACE_EVENT0("io", "DirectoryScanner::ScanDirectory");
+  const auto& dir_path = directory.dir_prefix.empty()
+                             ? root_path
+                             : root_path.Append(directory.dir_prefix);
+  scoped_refptr<IgnorePatterns> ignore_patterns;
+  if (recursive) {
+    ignore_patterns = IgnorePatterns::Load(directory.ignore_patterns, dir_path,
+                                           directory.dir_prefix);
+  }
+  auto result = std::make_unique<ScanResult>();
+  base::FileEnumerator enumerator(dir_path, false, FileTypesOf(recursive));
+  for (auto path = enumerator.Next(); !path.empty(); path = enumerator.Next()) {
+    const auto& info = enumerator.GetInfo();
+    const auto& name = info.GetName().value();
+    const auto& relative_name = directory.dir_prefix + name;
+    auto entry = FileStatusOf(info);
+    if (recursive) {
+      if (entry.is_directory && name == kGitDirName)
+        continue;
+      if (ignore_patterns &&
+          ignore_patterns->IsIgnored(relative_name, entry.is_directory)) {
+        continue;
+      }
+      if (entry.is_directory && !entry.is_symlink) {
+        Directory subdirectory;
+        subdirectory.dir_prefix = relative_name + FILE_PATH_LITERAL("/");
+        subdirectory.ignore_patterns = ignore_patterns;
+        result->directories.push_back(std::move(subdirectory));
+      }
+    }
+    entry.name = base::FilePath(relative_name)
+                     .NormalizePathSeparators()
+                     .AsUTF16Unsafe();
+    result->entries.push_back(std::move(entry));
+  }
+  return result;
+}
+
+}  // namespace io
@@ -0,0 +1,101 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_IO_DIRECTORY_SCANNER_H_
+#define EVITA_IO_DIRECTORY_SCANNER_H_
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "evita/dom/public/io_callback.h"
+
+namespace base {
+class TaskRunner;
+}
+
+namespace io {
+
+class IgnorePatterns;
+
+//////////////////////////////////////////////////////////////////////
+//
+// DirectoryScanner
+// Enumerates entries of a directory with their status, e.g. size and last
+// write time, taken from directory enumeration, so callers don't need to
+// query status of each entry.
+//
+// In recursive mode, the scanner scans each subdirectory by a task on
+// |task_runner|, so subdirectories are scanned in parallel when
+// |task_runner| runs tasks in parallel. Entries are named by relative path
+// from the root directory. ".git" directories and entries matched by
+// ".gitignore" files are skipped, and symbolic links aren't followed.
+//
+// Entries are buffered until |Read()| takes them. When the buffer is full,
+// the scanner stops issuing scans until the reader catches up.
+//
+class DirectoryScanner final {
+ public:
+  using Entries = std::vector<domapi::FileStatus>;
+  using ReadCallback = base::OnceCallback<void(const Entries& entries)>;
+
+  DirectoryScanner(const base::FilePath& root_path,
+                   bool recursive,
+                   scoped_refptr<base::TaskRunner> task_runner);
+  ~DirectoryScanner();
+
+  bool is_done() const;
+
+  // Stops scanning and runs the callback of read in flight, if any, with
+  // empty entries. Results of scans in flight are discarded.
+  void Cancel();
+
+  // Runs |callback| with at most |num_read| entries when entries are
+  // available. Empty |entries| means the end of scan. Only one read can be
+  // in flight.
+  void Read(size_t num_read, ReadCallback callback);
+
+ private:
+  struct Directory {
+    // Relative path from the root directory ending with "/", or empty for
+    // the root directory.
+    base::FilePath::StringType dir_prefix;
+    scoped_refptr<IgnorePatterns> ignore_patterns;
+  };
+
+  struct ScanResult;
+
+  void DidScanDirectory(std::unique_ptr<ScanResult> result);
+  void ScanDirectories();
+  void ServeRead();
+
+  // Runs on |task_runner_|.
+  static std::unique_ptr<ScanResult> ScanDirectory(
+      const base::FilePath& root_path,
+      bool recursive,
+      const Directory& directory);
+
+  // Directories waiting for scanning.
+  std::deque<Directory> directories_;
+  std::deque<domapi::FileStatus> entries_;
+  int num_pending_scans_ = 0;
+  ReadCallback read_callback_;
+  size_t read_size_ = 0;
+  const bool recursive_;
+  const base::FilePath root_path_;
+  const scoped_refptr<base::TaskRunner> task_runner_;
+
+  base::WeakPtrFactory<DirectoryScanner> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(DirectoryScanner);
+};
+
+}  // namespace io
+
+#endif  // EVITA_IO_DIRECTORY_SCANNER_H_
@@ -0,0 +1,178 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "evita/io/directory_scanner.h"
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/test/scoped_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace io {
+
+namespace {
+
+//////////////////////////////////////////////////////////////////////
+//
+// DirectoryScannerTest
+//
+class DirectoryScannerTest : public ::testing::Test {
+ protected:
+  DirectoryScannerTest() = default;
+  ~DirectoryScannerTest() override = default;
+
+  // Returns names of entries read before canceling read in flight.
+  std::vector<std::string> Cancel();
+  void MakeDirectory(const std::string& name);
+  void MakeFile(const std::string& name, const std::string& contents = "");
+  // Returns sorted names of entries, with "/" suffix for directories.
+  std::vector<std::string> Scan(bool recursive, size_t num_read);
+
+  base::FilePath PathOf(const std::string& name) const {
+    return temp_dir_.GetPath().Append(name);
+  }
+
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+ private:
+  void DidRead(std::vector<std::string>* names,
+               bool* is_end,
+               const DirectoryScanner::Entries& entries);
+
+  base::OnceClosure quit_closure_;
+  base::test::ScopedTaskEnvironment scoped_task_environment_;
+  base::ScopedTempDir temp_dir_;
+
+  DISALLOW_COPY_AND_ASSIGN(DirectoryScannerTest);
+};
+
+void DirectoryScannerTest::DidRead(std::vector<std::string>* names,
+                                   bool* is_end,
+                                   const DirectoryScanner::Entries& entries) {
+  *is_end = entries.empty();
+  for (const auto& entry : entries) {
+    names->push_back(base::UTF16ToUTF8(entry.name) +
+                     (entry.is_directory ? "/" : ""));
+  }
+  std::move(quit_closure_).Run();
+}
+
+std::vector<std::string> DirectoryScannerTest::Cancel() {
+  DirectoryScanner scanner(
+      temp_dir_.GetPath(), true,
+      base::CreateTaskRunnerWithTraits({base::MayBlock()}));
+  std::vector<std::string> names;
+  auto is_end = false;
+  base::RunLoop run_loop;
+  quit_closure_ = run_loop.QuitClosure();
+  scanner.Read(1, base::BindOnce(&DirectoryScannerTest::DidRead,
+                                 base::Unretained(this), &names, &is_end));
+  scanner.Cancel();
+  EXPECT_TRUE(is_end);
+  EXPECT_TRUE(scanner.is_done());
+  // Results of scans in flight should be discarded.
+  scoped_task_environment_.RunUntilIdle();
+  EXPECT_TRUE(scanner.is_done());
+  return names;
+}
+
+void DirectoryScannerTest::MakeDirectory(const std::string& name) {
+  ASSERT_TRUE(base::CreateDirectory(PathOf(name)));
+}
+
+void DirectoryScannerTest::MakeFile(const std::string& name,
+                                    const std::string& contents) {
+  ASSERT_EQ(static_cast<int>(contents.size()),
+            base::WriteFile(PathOf(name), contents.data(),
+                            static_cast<int>(contents.size())));
+}
+
+std::vector<std::string> DirectoryScannerTest::Scan(bool recursive,
+                                                    size_t num_read) {
+  DirectoryScanner scanner(
+      temp_dir_.GetPath(), recursive,
+      base::CreateTaskRunnerWithTraits({base::MayBlock()}));
+  std::vector<std::string> names;
+  for (;;) {
+    auto is_end = false;
+    base::RunLoop run_loop;
+    quit_closure_ = run_loop.QuitClosure();
+    scanner.Read(num_read,
+                 base::BindOnce(&DirectoryScannerTest::DidRead,
+                                base::Unretained(this), &names, &is_end));
+    run_loop.Run();
+    if (is_end)
+      break;
+  }
+  EXPECT_TRUE(scanner.is_done());
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+}  // namespace
+
+TEST_F(DirectoryScannerTest, Cancel) {
+  MakeDirectory("src");
+  MakeFile("src/foo.cc");
+
+  EXPECT_EQ(std::vector<std::string>(), Cancel());
+}
+
+TEST_F(DirectoryScannerTest, Ignore) {
+  MakeFile(".gitignore", "*.o\n/out/\n");
+  MakeDirectory(".git");
+  MakeFile(".git/HEAD");
+  MakeDirectory("out");
+  MakeFile("out/foo.txt");
+  MakeDirectory("src");
+  MakeFile("src/.gitignore", "!keep.o\ngen/\n");
+  MakeFile("src/foo.cc");
+  MakeFile("src/foo.o");
+  MakeFile("src/keep.o");
+  MakeDirectory("src/gen");
+  MakeFile("src/gen/bar.cc");
+  MakeDirectory("src/out");
+
+  EXPECT_EQ(std::vector<std::string>({".gitignore", "src/", "src/.gitignore",
+                                      "src/foo.cc", "src/keep.o",
+                                      "src/out/"}),
+            Scan(true, 2));
+}
+
+TEST_F(DirectoryScannerTest, NonRecursive) {
+  MakeFile(".gitignore", "*.o\n");
+  MakeFile("foo.o", "foo");
+  MakeDirectory("src");
+  MakeFile("src/bar.cc");
+
+  EXPECT_EQ(std::vector<std::string>({".gitignore", "foo.o", "src/"}),
+            Scan(false, 100));
+}
+
+TEST_F(DirectoryScannerTest, Recursive) {
+  MakeDirectory("a");
+  MakeDirectory("a/b");
+  MakeDirectory("a/b/c");
+  MakeFile("a/b/c/foo.txt", "foo");
+  MakeDirectory("d");
+  MakeFile("d/bar.txt", "bar");
+  ASSERT_EQ(0, ::symlink(PathOf("a").value().c_str(),
+                         PathOf("a/b/link").value().c_str()));
+
+  EXPECT_EQ(std::vector<std::string>({"a/", "a/b/", "a/b/c/", "a/b/c/foo.txt",
+                                      "a/b/link", "d/", "d/bar.txt"}),
+            Scan(true, 3));
+}
+
+}  // namespace io
@@ -0,0 +1,136 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/io/directory_watcher_io_context.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/trace_event/trace_event.h"
+#include "evita/editor/application.h"
+#include "evita/io/io_context_utils.h"
+#include "evita/io/io_manager.h"
+
+namespace io {
+
+namespace {
+
+// Size of buffer for change records. The system keeps changes up to this
+// size between reads.
+const size_t kBufferSize = 16 * 1024;
+
+const DWORD kNotifyFilter =
+    FILE_NOTIFY_CHANGE_ATTRIBUTES | FILE_NOTIFY_CHANGE_FILE_NAME |
+    FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// DirectoryWatcherIoContext
+//
+DirectoryWatcherIoContext::DirectoryWatcherIoContext(HANDLE handle)
+    : buffer_(kBufferSize / sizeof(DWORD)), dir_handle_(handle) {
+  editor::Application::instance()->io_manager()->RegisterIoHandler(
+      dir_handle_.get(), this);
+}
+
+DirectoryWatcherIoContext::~DirectoryWatcherIoContext() {
+  DCHECK(!IsRunning());
+}
+
+// static
+std::pair<HANDLE, int> DirectoryWatcherIoContext::Open(
+    const base::string16& dir_name) {
+  common::win::scoped_handle handle(::CreateFileW(
+      dir_name.c_str(), FILE_LIST_DIRECTORY,
+      FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+      OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+      nullptr));
+  if (!handle) {
+    const auto last_error = ::GetLastError();
+    PLOG(ERROR) << "CreateFileW " << dir_name << " failed.";
+    return std::make_pair(INVALID_HANDLE_VALUE, last_error);
+  }
+  return std::make_pair(handle.release(), 0);
+}
+
+void DirectoryWatcherIoContext::Read(
+    domapi::ReadDirectoryChangesPromise promise) {
+  TRACE_EVENT_WITH_FLOW0("promise", "DirectoryWatcherIoContext::Read",
+                         promise.sequence_num,
+                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT);
+  if (IsRunning())
+    return Reject(std::move(promise.reject), ERROR_BUSY);
+  if (!dir_handle_.is_valid())
+    return Reject(std::move(promise.reject), ERROR_INVALID_HANDLE);
+
+  const auto watch_subtree = false;
+  auto const succeeded = ::ReadDirectoryChangesW(
+      dir_handle_.get(), buffer_.data(),
+      static_cast<DWORD>(buffer_.size() * sizeof(DWORD)), watch_subtree,
+      kNotifyFilter, nullptr, &overlapped, nullptr);
+  if (!succeeded) {
+    const auto last_error = ::GetLastError();
+    PLOG(ERROR) << "ReadDirectoryChangesW failed";
+    return Reject(std::move(promise.reject), last_error);
+  }
+  is_running_ = true;
+  promise_ = std::move(promise);
+}
+
+// base::MessagePumpForIO::IOHandler
+void DirectoryWatcherIoContext::OnIOCompleted(IOContext*,
+                                              DWORD bytes_transferred,
+                                              DWORD error) {
+  DCHECK(IsRunning());
+  TRACE_EVENT_WITH_FLOW1("promise", "DirectoryWatcherIoContext::OnIOCompleted",
+                         promise_.sequence_num,
+                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT,
+                         "bytes_transferred", bytes_transferred);
+  is_running_ = false;
+  if (error) {
+    Reject(std::move(promise_.reject), error);
+  } else {
+    // Note: |bytes_transferred| is zero when the system drops changes.
+    std::vector<base::string16> names;
+    auto runner = reinterpret_cast<const uint8_t*>(buffer_.data());
+    auto const end = runner + bytes_transferred;
+    while (runner < end) {
+      auto const info =
+          reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(runner);
+      base::string16 name(info->FileName,
+                          info->FileNameLength / sizeof(base::char16));
+      if (std::find(names.begin(), names.end(), name) == names.end())
+        names.push_back(std::move(name));
+      if (!info->NextEntryOffset)
+        break;
+      runner += info->NextEntryOffset;
+    }
+    RunCallback(base::BindOnce(std::move(promise_.resolve), names));
+  }
+  if (!dir_handle_.is_valid())
+    delete this;
+}
+
+// io::IoContext
+// Note: Closing handle cancels read in flight, then |OnIOCompleted()|
+// deletes this context.
+void DirectoryWatcherIoContext::Close(domapi::IoIntPromise promise) {
+  if (dir_handle_.is_valid()) {
+    if (!::CloseHandle(dir_handle_.get())) {
+      const auto last_error = ::GetLastError();
+      PLOG(ERROR) << "CloseHandle failed.";
+      Reject(std::move(promise.reject), last_error);
+      return;
+    }
+    dir_handle_.release();
+  }
+  if (!IsRunning())
+    delete this;
+  Resolve(std::move(promise.resolve), 0u);
+}
+
+}  // namespace io
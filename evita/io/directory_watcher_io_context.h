@@ -0,0 +1,67 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_IO_DIRECTORY_WATCHER_IO_CONTEXT_H_
+#define EVITA_IO_DIRECTORY_WATCHER_IO_CONTEXT_H_
+
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/message_loop/message_pump_win.h"
+#include "base/strings/string16.h"
+#include "common/win/scoped_handle.h"
+#include "evita/dom/public/io_callback.h"
+#include "evita/dom/public/promise.h"
+#include "evita/io/io_context.h"
+
+namespace io {
+
+//////////////////////////////////////////////////////////////////////
+//
+// DirectoryWatcherIoContext
+// Watches changes of files in a directory by |ReadDirectoryChangesW()|.
+// Once the first read is issued, the system records changes until the
+// next read, so the caller doesn't miss changes between reads.
+//
+class DirectoryWatcherIoContext final
+    : private base::MessagePumpForIO::IOContext,
+      private base::MessagePumpForIO::IOHandler,
+      public IoContext {
+  DECLARE_DEPRECATED_CASTABLE_CLASS(DirectoryWatcherIoContext, IoContext);
+
+ public:
+  explicit DirectoryWatcherIoContext(HANDLE handle);
+  ~DirectoryWatcherIoContext() final;
+
+  static std::pair<HANDLE, int> Open(const base::string16& dir_name);
+
+  // Resolves |promise| with names of changed files relative to the watched
+  // directory, or an empty list if the system drops changes, e.g. buffer
+  // overflow, so the caller should check all files.
+  void Read(domapi::ReadDirectoryChangesPromise promise);
+
+ private:
+  bool IsRunning() const { return is_running_; }
+
+  // base::MessagePumpForIO::IOHandler
+  void OnIOCompleted(IOContext* context,
+                     DWORD bytes_transfered,
+                     DWORD error) final;
+
+  // io::IoContext
+  void Close(domapi::IoIntPromise promise) final;
+
+  // |ReadDirectoryChangesW()| requires DWORD aligned buffer.
+  std::vector<DWORD> buffer_;
+  common::win::scoped_handle dir_handle_;
+  bool is_running_ = false;
+  domapi::ReadDirectoryChangesPromise promise_;
+
+  DISALLOW_COPY_AND_ASSIGN(DirectoryWatcherIoContext);
+};
+
+}  // namespace io
+
+#endif  // EVITA_IO_DIRECTORY_WATCHER_IO_CONTEXT_H_
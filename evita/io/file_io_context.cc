@@ -4,6 +4,8 @@
 
 #include "evita/io/file_io_context.h"
 
+#include <memory>
+
 #include "base/bind.h"
 #include "base/logging.h"
 #include "base/trace_event/trace_event.h"
@@ -15,6 +17,10 @@
 namespace io {
 
 namespace {
+
+const char kReadFile[] = "ReadFile";
+const char kWriteFile[] = "WriteFile";
+
 //////////////////////////////////////////////////////////////////////
 //
 // CreateFileParams
@@ -44,53 +50,116 @@ void Resolve(base::OnceCallback<void(domapi::FileId)> resolve,
   RunCallback(base::BindOnce(std::move(resolve), context_id));
 }
 
+//////////////////////////////////////////////////////////////////////
+//
+// FileIoContext::Request
+// Holds |OVERLAPPED| of a request in flight.
+//
+struct FileIoContext::Request final : base::MessagePumpForIO::IOContext {
+  Request(const char* operation, domapi::IoIntPromise promise)
+      : operation(operation), promise(std::move(promise)) {}
+
+  const char* const operation;
+  domapi::IoIntPromise promise;
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// FileIoContext
+//
 FileIoContext::FileIoContext(HANDLE handle) : file_handle_(handle) {
   editor::Application::instance()->io_manager()->RegisterIoHandler(
       file_handle_.get(), this);
 }
 
 FileIoContext::~FileIoContext() {
+  DCHECK(!num_pending_);
   TRACE_EVENT_ASYNC_END0("io", "FileContext", this);
 }
 
-// base::MessagePumpForIO::FileIoContext
-void FileIoContext::OnIOCompleted(IOContext*,
+void FileIoContext::FinishClose() {
+  DCHECK(is_closing_);
+  if (::CloseHandle(file_handle_.get())) {
+    Resolve(std::move(close_promise_.resolve), 0u);
+  } else {
+    const auto last_error = ::GetLastError();
+    PLOG(ERROR) << "CloseHandle failed.";
+    Reject(std::move(close_promise_.reject), last_error);
+  }
+  file_handle_.release();
+  delete this;
+}
+
+void FileIoContext::StartRequest(const char* operation,
+                                 void* buffer,
+                                 size_t num_transfer,
+                                 domapi::IoIntPromise promise) {
+  if (is_closing_) {
+    Reject(std::move(promise.reject), ERROR_INVALID_HANDLE);
+    return;
+  }
+
+  TRACE_EVENT_ASYNC_BEGIN0("io", operation, promise.sequence_num);
+  auto const request = new Request(operation, std::move(promise));
+  request->overlapped.Offset = static_cast<DWORD>(offset_);
+  request->overlapped.OffsetHigh = static_cast<DWORD>(offset_ >> 32);
+  offset_ += num_transfer;
+  ++num_pending_;
+  auto const succeeded =
+      operation == kReadFile
+          ? ::ReadFile(file_handle_.get(), buffer,
+                       static_cast<DWORD>(num_transfer), nullptr,
+                       &request->overlapped)
+          : ::WriteFile(file_handle_.get(), buffer,
+                        static_cast<DWORD>(num_transfer), nullptr,
+                        &request->overlapped);
+  // Note: Completion port receives a packet for a request completed
+  // synchronously too.
+  if (succeeded)
+    return;
+  auto const error = ::GetLastError();
+  if (error == ERROR_IO_PENDING)
+    return;
+  PLOG(ERROR) << operation << " failed";
+  OnIOCompleted(request, 0, error);
+}
+
+// base::MessagePumpForIO::IOHandler
+void FileIoContext::OnIOCompleted(IOContext* context,
                                   DWORD bytes_transferred,
                                   DWORD error) {
-  DCHECK(IsRunning());
+  DCHECK_GT(num_pending_, 0);
+  std::unique_ptr<Request> request(static_cast<Request*>(context));
   TRACE_EVENT_WITH_FLOW1("promise", "FileIoContext::OnIOCompleted",
-                         promise_.sequence_num,
+                         request->promise.sequence_num,
                          TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT,
-                         "operation", operation_);
-  overlapped.Offset += bytes_transferred;
-  auto const operation = operation_;
-  operation_ = nullptr;
+                         "operation", request->operation);
+  --num_pending_;
   if (!error || error == ERROR_HANDLE_EOF)
-    Resolve(std::move(promise_.resolve), bytes_transferred);
+    Resolve(std::move(request->promise.resolve), bytes_transferred);
   else
-    Reject(std::move(promise_.reject), error);
-  if (!file_handle_.is_valid())
-    delete this;
-  TRACE_EVENT_ASYNC_END0("io", operation, promise_.sequence_num);
+    Reject(std::move(request->promise.reject), error);
+  TRACE_EVENT_ASYNC_END0("io", request->operation,
+                         request->promise.sequence_num);
+  if (is_closing_ && !num_pending_)
+    FinishClose();
 }
 
 // io::IoContext
+// Note: We close file handle after all requests in flight are finished.
 void FileIoContext::Close(domapi::IoIntPromise promise) {
   TRACE_EVENT_WITH_FLOW0("promise", "FileIoContext::Close",
                          promise.sequence_num,
                          TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT);
-  if (file_handle_.is_valid()) {
-    if (!::CloseHandle(file_handle_.get())) {
-      const auto last_error = ::GetLastError();
-      PLOG(ERROR) << "CloseHandle failed.";
-      Reject(std::move(promise.reject), last_error);
-      return;
-    }
-    file_handle_.release();
+  if (is_closing_) {
+    Reject(std::move(promise.reject), ERROR_INVALID_HANDLE);
+    return;
   }
-  if (!IsRunning())
-    delete this;
-  Resolve(std::move(promise.resolve), 0u);
+  is_closing_ = true;
+  close_promise_ = std::move(promise);
+  if (num_pending_)
+    return;
+  FinishClose();
 }
 
 // static
@@ -108,31 +177,13 @@ std::pair<HANDLE, int> FileIoContext::Open(const base::string16& file_name,
   return std::make_pair(handle.release(), 0);
 }
 
+// io::BlockIoContext
 void FileIoContext::Read(void* buffer,
                          size_t num_read,
                          domapi::IoIntPromise promise) {
   TRACE_EVENT_WITH_FLOW0("promise", "FileIoContext::Read", promise.sequence_num,
                          TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT);
-  if (IsRunning()) {
-    Reject(std::move(promise.reject), ERROR_BUSY);
-    return;
-  }
-
-  promise_ = std::move(promise);
-  operation_ = "ReadFile";
-  TRACE_EVENT_ASYNC_BEGIN0("io", operation_, promise.sequence_num);
-  DWORD read;
-  auto const succeeded =
-      ::ReadFile(file_handle_.get(), buffer, static_cast<DWORD>(num_read),
-                 &read, &overlapped);
-  DCHECK(!succeeded);
-  __assume(!succeeded);
-
-  auto const error = ::GetLastError();
-  if (error == ERROR_IO_PENDING)
-    return;
-  PLOG(ERROR) << "ReadFile failed";
-  OnIOCompleted(this, 0, error);
+  StartRequest(kReadFile, buffer, num_read, std::move(promise));
 }
 
 void FileIoContext::Write(void* buffer,
@@ -141,25 +192,7 @@ void FileIoContext::Write(void* buffer,
   TRACE_EVENT_WITH_FLOW0("promise", "FileIoContext::Write",
                          promise.sequence_num,
                          TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT);
-  if (IsRunning()) {
-    Reject(std::move(promise.reject), ERROR_BUSY);
-    return;
-  }
-
-  promise_ = std::move(promise);
-  operation_ = "WriteFile";
-  TRACE_EVENT_ASYNC_BEGIN0("io", operation_, promise.sequence_num);
-  DWORD written;
-  auto const succeeded =
-      ::WriteFile(file_handle_.get(), buffer, static_cast<DWORD>(num_write),
-                  &written, &overlapped);
-  DCHECK(!succeeded);
-  __assume(!succeeded);
-  auto const error = ::GetLastError();
-  if (error == ERROR_IO_PENDING)
-    return;
-  PLOG(ERROR) << "WriteFile failed";
-  OnIOCompleted(this, 0, error);
+  StartRequest(kWriteFile, buffer, num_write, std::move(promise));
 }
 
 }  // namespace io
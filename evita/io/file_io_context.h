@@ -5,6 +5,8 @@
 #ifndef EVITA_IO_FILE_IO_CONTEXT_H_
 #define EVITA_IO_FILE_IO_CONTEXT_H_
 
+#include <stdint.h>
+
 #include <utility>
 
 #include "base/callback.h"
@@ -17,8 +19,15 @@
 
 namespace io {
 
-class FileIoContext final : private base::MessagePumpForIO::IOContext,
-                            private base::MessagePumpForIO::IOHandler,
+//////////////////////////////////////////////////////////////////////
+//
+// FileIoContext
+// Reads and writes a file by overlapped I/O. Several requests can be in
+// flight, e.g. read-ahead of |TextDocumentLoader|. Each request transfers
+// at the file offset reserved when it is issued, so results are the same
+// as for sequential requests, although requests may complete out of order.
+//
+class FileIoContext final : private base::MessagePumpForIO::IOHandler,
                             public BlockIoContext {
   DECLARE_DEPRECATED_CASTABLE_CLASS(FileIoContext, BlockIoContext);
 
@@ -30,7 +39,13 @@ class FileIoContext final : private base::MessagePumpForIO::IOContext,
                                      const base::string16& mode);
 
  private:
-  bool IsRunning() const { return operation_ != nullptr; }
+  struct Request;
+
+  void FinishClose();
+  void StartRequest(const char* operation,
+                    void* buffer,
+                    size_t num_transfer,
+                    domapi::IoIntPromise promise);
 
   // base::MessagePumpForIO::IOHandler
   void OnIOCompleted(IOContext* context,
@@ -46,9 +61,12 @@ class FileIoContext final : private base::MessagePumpForIO::IOContext,
              size_t num_write,
              domapi::IoIntPromise promise) override;
 
-  domapi::IoIntPromise promise_;
+  domapi::IoIntPromise close_promise_;
   common::win::scoped_handle file_handle_;
-  const char* operation_ = nullptr;
+  bool is_closing_ = false;
+  int num_pending_ = 0;
+  // File offset for the next request.
+  uint64_t offset_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(FileIoContext);
 };
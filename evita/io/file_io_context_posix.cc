@@ -0,0 +1,169 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/io/file_io_context_posix.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/trace_event/trace_event.h"
+
+namespace io {
+
+namespace {
+
+using BlockingResult = IoDelegatePosix::BlockingResult;
+
+BlockingResult ReadAt(int file_descriptor,
+                      void* buffer,
+                      size_t num_read,
+                      off_t offset) {
+  BlockingResult result;
+  const auto num_transferred =
+      HANDLE_EINTR(::pread(file_descriptor, buffer, num_read, offset));
+  if (num_transferred < 0)
+    result.error = errno;
+  else
+    result.num_transferred = static_cast<int>(num_transferred);
+  return result;
+}
+
+// Unlike |pread(2)|, we write all bytes, since callers expect the same
+// behavior as |WriteFile()| on Windows.
+BlockingResult WriteAt(int file_descriptor,
+                       const void* buffer,
+                       size_t num_write,
+                       off_t offset) {
+  BlockingResult result;
+  auto const bytes = static_cast<const uint8_t*>(buffer);
+  size_t num_written = 0;
+  while (num_written < num_write) {
+    const auto num_transferred = HANDLE_EINTR(
+        ::pwrite(file_descriptor, bytes + num_written, num_write - num_written,
+                 offset + static_cast<off_t>(num_written)));
+    if (num_transferred < 0) {
+      result.error = errno;
+      return result;
+    }
+    num_written += static_cast<size_t>(num_transferred);
+  }
+  result.num_transferred = static_cast<int>(num_written);
+  return result;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// FileIoContextPosix
+//
+FileIoContextPosix::FileIoContextPosix(IoDelegatePosix* delegate,
+                                       int file_descriptor)
+    : delegate_(delegate), file_descriptor_(file_descriptor) {}
+
+FileIoContextPosix::~FileIoContextPosix() {
+  DCHECK(!num_pending_);
+}
+
+void FileIoContextPosix::DidTransfer(domapi::IoIntPromise promise,
+                                     BlockingResult result) {
+  TRACE_EVENT_WITH_FLOW1("promise", "FileIoContextPosix::DidTransfer",
+                         promise.sequence_num,
+                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT,
+                         "num_transferred", result.num_transferred);
+  DCHECK_GT(num_pending_, 0);
+  --num_pending_;
+  if (result.error)
+    delegate_->Reject(std::move(promise.reject), result.error);
+  else
+    delegate_->Resolve(std::move(promise.resolve), result.num_transferred);
+  if (is_closing_ && !num_pending_)
+    FinishClose();
+}
+
+void FileIoContextPosix::FinishClose() {
+  DCHECK(is_closing_);
+  if (IGNORE_EINTR(::close(file_descriptor_)) < 0) {
+    const auto error = errno;
+    PLOG(ERROR) << "close failed.";
+    delegate_->Reject(std::move(close_promise_.reject), error);
+  } else {
+    delegate_->Resolve(std::move(close_promise_.resolve), 0);
+  }
+  delete this;
+}
+
+// static
+std::pair<int, int> FileIoContextPosix::Open(const base::string16& file_name,
+                                             const base::string16& mode) {
+  const auto flags = mode.empty() || mode[0] != 'w'
+                         ? O_RDONLY
+                         : O_WRONLY | O_CREAT | O_TRUNC;
+  const auto file_descriptor = HANDLE_EINTR(
+      ::open(base::UTF16ToUTF8(file_name).c_str(), flags | O_CLOEXEC, 0666));
+  if (file_descriptor < 0) {
+    const auto error = errno;
+    PLOG(ERROR) << "open " << file_name << " failed.";
+    return std::make_pair(-1, error);
+  }
+  return std::make_pair(file_descriptor, 0);
+}
+
+// io::IoContext
+// Note: We close file descriptor after all requests in flight are finished.
+void FileIoContextPosix::Close(domapi::IoIntPromise promise) {
+  TRACE_EVENT_WITH_FLOW0("promise", "FileIoContextPosix::Close",
+                         promise.sequence_num,
+                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT);
+  if (is_closing_)
+    return delegate_->Reject(std::move(promise.reject), EBADF);
+  is_closing_ = true;
+  close_promise_ = std::move(promise);
+  if (num_pending_)
+    return;
+  FinishClose();
+}
+
+// io::BlockIoContext
+void FileIoContextPosix::Read(void* buffer,
+                              size_t num_read,
+                              domapi::IoIntPromise promise) {
+  TRACE_EVENT_WITH_FLOW0("promise", "FileIoContextPosix::Read",
+                         promise.sequence_num,
+                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT);
+  if (is_closing_)
+    return delegate_->Reject(std::move(promise.reject), EBADF);
+  const auto offset = offset_;
+  offset_ += static_cast<off_t>(num_read);
+  ++num_pending_;
+  delegate_->PostBlockingTask(
+      base::BindOnce(&ReadAt, file_descriptor_, buffer, num_read, offset),
+      base::BindOnce(&FileIoContextPosix::DidTransfer, base::Unretained(this),
+                     std::move(promise)));
+}
+
+void FileIoContextPosix::Write(void* buffer,
+                               size_t num_write,
+                               domapi::IoIntPromise promise) {
+  TRACE_EVENT_WITH_FLOW0("promise", "FileIoContextPosix::Write",
+                         promise.sequence_num,
+                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT);
+  if (is_closing_)
+    return delegate_->Reject(std::move(promise.reject), EBADF);
+  const auto offset = offset_;
+  offset_ += static_cast<off_t>(num_write);
+  ++num_pending_;
+  delegate_->PostBlockingTask(
+      base::BindOnce(&WriteAt, file_descriptor_, buffer, num_write, offset),
+      base::BindOnce(&FileIoContextPosix::DidTransfer, base::Unretained(this),
+                     std::move(promise)));
+}
+
+}  // namespace io
@@ -0,0 +1,69 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_IO_FILE_IO_CONTEXT_POSIX_H_
+#define EVITA_IO_FILE_IO_CONTEXT_POSIX_H_
+
+#include <sys/types.h>
+
+#include <utility>
+
+#include "base/macros.h"
+#include "base/strings/string16.h"
+#include "evita/dom/public/promise.h"
+#include "evita/io/block_io_context.h"
+#include "evita/io/io_delegate_posix.h"
+
+namespace io {
+
+//////////////////////////////////////////////////////////////////////
+//
+// FileIoContextPosix
+// Reads and writes a file by |pread(2)| and |pwrite(2)| on worker threads
+// of |IoDelegatePosix|. Unlike |FileIoContext| on Windows, several requests
+// can be in flight. Each request transfers at the file offset reserved when
+// it is issued, so results are the same as for sequential requests.
+//
+class FileIoContextPosix final : public BlockIoContext {
+  DECLARE_DEPRECATED_CASTABLE_CLASS(FileIoContextPosix, BlockIoContext);
+
+ public:
+  FileIoContextPosix(IoDelegatePosix* delegate, int file_descriptor);
+  ~FileIoContextPosix() final;
+
+  // Returns file descriptor and zero, or -1 and |errno|.
+  static std::pair<int, int> Open(const base::string16& file_name,
+                                  const base::string16& mode);
+
+ private:
+  using BlockingResult = IoDelegatePosix::BlockingResult;
+
+  void DidTransfer(domapi::IoIntPromise promise, BlockingResult result);
+  void FinishClose();
+
+  // io::IoContext
+  void Close(domapi::IoIntPromise promise) final;
+
+  // io::BlockIoContext
+  void Read(void* buffer,
+            size_t num_read,
+            domapi::IoIntPromise promise) final;
+  void Write(void* buffer,
+             size_t num_write,
+             domapi::IoIntPromise promise) final;
+
+  domapi::IoIntPromise close_promise_;
+  IoDelegatePosix* const delegate_;
+  const int file_descriptor_;
+  bool is_closing_ = false;
+  int num_pending_ = 0;
+  // File offset for the next request.
+  off_t offset_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(FileIoContextPosix);
+};
+
+}  // namespace io
+
+#endif  // EVITA_IO_FILE_IO_CONTEXT_POSIX_H_
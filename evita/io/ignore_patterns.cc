@@ -0,0 +1,213 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/io/ignore_patterns.h"
+
+#include <utility>
+
+#include "base/files/file_util.h"
+#include "base/logging.h"
+
+namespace io {
+
+namespace {
+
+using StringType = IgnorePatterns::StringType;
+using CharType = StringType::value_type;
+
+const char kIgnoreFileName[] = ".gitignore";
+
+// Matches |pattern| and a character class starts at |pattern[start]|, which
+// is "[". Returns position after "]", or |StringType::npos| if |pattern|
+// doesn't have "]".
+size_t MatchCharClass(const StringType& pattern,
+                      size_t start,
+                      CharType char_code,
+                      bool* matched) {
+  auto position = start + 1;
+  auto is_negated = false;
+  if (position < pattern.size() &&
+      (pattern[position] == '!' || pattern[position] == '^')) {
+    is_negated = true;
+    ++position;
+  }
+  auto is_matched = false;
+  auto is_first = true;
+  while (position < pattern.size()) {
+    auto const low = pattern[position];
+    if (low == ']' && !is_first) {
+      *matched = is_matched != is_negated;
+      return position + 1;
+    }
+    is_first = false;
+    ++position;
+    if (position + 1 < pattern.size() && pattern[position] == '-' &&
+        pattern[position + 1] != ']') {
+      auto const high = pattern[position + 1];
+      position += 2;
+      if (char_code >= low && char_code <= high)
+        is_matched = true;
+      continue;
+    }
+    if (char_code == low)
+      is_matched = true;
+  }
+  return StringType::npos;
+}
+
+// Returns true if |pattern| from |pattern_start| matches |text| from
+// |text_start|. "*" and "?" don't match "/", and "**" matches any
+// characters. "**/" matches zero or more directories.
+bool MatchGlob(const StringType& pattern,
+               size_t pattern_start,
+               const StringType& text,
+               size_t text_start) {
+  auto pattern_index = pattern_start;
+  auto text_index = text_start;
+  while (pattern_index < pattern.size()) {
+    auto char_code = pattern[pattern_index];
+    if (char_code == '*') {
+      ++pattern_index;
+      if (pattern_index < pattern.size() && pattern[pattern_index] == '*') {
+        ++pattern_index;
+        if (pattern_index < pattern.size() && pattern[pattern_index] == '/') {
+          ++pattern_index;
+          for (auto index = text_index; index <= text.size(); ++index) {
+            if (index != text_index && text[index - 1] != '/')
+              continue;
+            if (MatchGlob(pattern, pattern_index, text, index))
+              return true;
+          }
+          return false;
+        }
+        for (auto index = text_index; index <= text.size(); ++index) {
+          if (MatchGlob(pattern, pattern_index, text, index))
+            return true;
+        }
+        return false;
+      }
+      for (auto index = text_index;; ++index) {
+        if (MatchGlob(pattern, pattern_index, text, index))
+          return true;
+        if (index == text.size() || text[index] == '/')
+          return false;
+      }
+    }
+    if (text_index == text.size())
+      return false;
+    if (char_code == '?') {
+      if (text[text_index] == '/')
+        return false;
+      ++pattern_index;
+      ++text_index;
+      continue;
+    }
+    if (char_code == '[') {
+      auto matched = false;
+      auto const next =
+          MatchCharClass(pattern, pattern_index, text[text_index], &matched);
+      if (next != StringType::npos) {
+        if (!matched || text[text_index] == '/')
+          return false;
+        pattern_index = next;
+        ++text_index;
+        continue;
+      }
+    }
+    if (char_code == '\\' && pattern_index + 1 < pattern.size())
+      char_code = pattern[++pattern_index];
+    if (text[text_index] != char_code)
+      return false;
+    ++pattern_index;
+    ++text_index;
+  }
+  return text_index == text.size();
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// IgnorePatterns
+//
+IgnorePatterns::IgnorePatterns(scoped_refptr<IgnorePatterns> parent,
+                               const StringType& dir_prefix,
+                               const std::string& text)
+    : dir_prefix_(dir_prefix), parent_(std::move(parent)) {
+  DCHECK(dir_prefix_.empty() || dir_prefix_.back() == '/');
+  size_t line_start = 0;
+  while (line_start < text.size()) {
+    auto line_end = text.find('\n', line_start);
+    if (line_end == std::string::npos)
+      line_end = text.size();
+    auto line = text.substr(line_start, line_end - line_start);
+    line_start = line_end + 1;
+    while (!line.empty() && (line.back() == ' ' || line.back() == '\t' ||
+                             line.back() == '\r')) {
+      line.pop_back();
+    }
+    if (line.empty() || line[0] == '#')
+      continue;
+    Pattern pattern;
+    if (line[0] == '!') {
+      pattern.is_negated = true;
+      line.erase(0, 1);
+    } else if (line[0] == '\\') {
+      line.erase(0, 1);
+    }
+    if (!line.empty() && line.back() == '/') {
+      pattern.is_directory_only = true;
+      line.pop_back();
+    }
+    if (line.empty())
+      continue;
+    if (line.find('/') != std::string::npos) {
+      pattern.is_anchored = true;
+      if (line[0] == '/')
+        line.erase(0, 1);
+    }
+    pattern.glob = base::FilePath::FromUTF8Unsafe(line).value();
+    patterns_.push_back(pattern);
+  }
+}
+
+IgnorePatterns::~IgnorePatterns() {}
+
+bool IgnorePatterns::IsIgnored(const StringType& path,
+                               bool is_directory) const {
+  return MatchPath(path, is_directory) == Match::Ignored;
+}
+
+scoped_refptr<IgnorePatterns> IgnorePatterns::Load(
+    scoped_refptr<IgnorePatterns> parent,
+    const base::FilePath& dir_path,
+    const StringType& dir_prefix) {
+  std::string text;
+  if (!base::ReadFileToString(dir_path.AppendASCII(kIgnoreFileName), &text))
+    return parent;
+  return new IgnorePatterns(std::move(parent), dir_prefix, text);
+}
+
+IgnorePatterns::Match IgnorePatterns::MatchPath(const StringType& path,
+                                                bool is_directory) const {
+  auto result = parent_ ? parent_->MatchPath(path, is_directory) : Match::None;
+  if (path.compare(0, dir_prefix_.size(), dir_prefix_) != 0)
+    return result;
+  const auto& relative_path = path.substr(dir_prefix_.size());
+  auto const slash = relative_path.rfind('/');
+  const auto& base_name = slash == StringType::npos
+                              ? relative_path
+                              : relative_path.substr(slash + 1);
+  for (const auto& pattern : patterns_) {
+    if (pattern.is_directory_only && !is_directory)
+      continue;
+    const auto& subject = pattern.is_anchored ? relative_path : base_name;
+    if (!MatchGlob(pattern.glob, 0, subject, 0))
+      continue;
+    result = pattern.is_negated ? Match::Included : Match::Ignored;
+  }
+  return result;
+}
+
+}  // namespace io
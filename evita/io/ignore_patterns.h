@@ -0,0 +1,82 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_IO_IGNORE_PATTERNS_H_
+#define EVITA_IO_IGNORE_PATTERNS_H_
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+
+namespace io {
+
+//////////////////////////////////////////////////////////////////////
+//
+// IgnorePatterns
+// Holds patterns of a ".gitignore" file. Patterns of a directory extend
+// patterns of its parent directory, and the last matched pattern wins, as
+// git does.
+//
+// Supported syntax: "#" comment, "!" negation, trailing "/" for directories
+// only, leading or inner "/" for anchoring to the directory of the ignore
+// file, and wildcards "*", "?", "[...]" and "**".
+//
+// Paths are relative to the directory of the root patterns and separated
+// by "/". Instances are immutable, so they are shared by scanning tasks on
+// worker threads.
+//
+class IgnorePatterns final
+    : public base::RefCountedThreadSafe<IgnorePatterns> {
+ public:
+  using StringType = base::FilePath::StringType;
+
+  // |dir_prefix| is a path of directory containing ignore file, relative to
+  // the root directory, and ends with "/" unless it is empty.
+  IgnorePatterns(scoped_refptr<IgnorePatterns> parent,
+                 const StringType& dir_prefix,
+                 const std::string& text);
+
+  // Returns true if |path| relative to the root directory is ignored.
+  bool IsIgnored(const StringType& path, bool is_directory) const;
+
+  // Returns patterns in ".gitignore" in |dir_path| extending |parent|, or
+  // |parent| if |dir_path| doesn't have ".gitignore".
+  static scoped_refptr<IgnorePatterns> Load(
+      scoped_refptr<IgnorePatterns> parent,
+      const base::FilePath& dir_path,
+      const StringType& dir_prefix);
+
+ private:
+  friend class base::RefCountedThreadSafe<IgnorePatterns>;
+
+  struct Pattern {
+    bool is_anchored = false;
+    bool is_directory_only = false;
+    bool is_negated = false;
+    StringType glob;
+  };
+
+  enum class Match {
+    None,
+    Ignored,
+    Included,
+  };
+
+  ~IgnorePatterns();
+
+  Match MatchPath(const StringType& path, bool is_directory) const;
+
+  const StringType dir_prefix_;
+  const scoped_refptr<IgnorePatterns> parent_;
+  std::vector<Pattern> patterns_;
+
+  DISALLOW_COPY_AND_ASSIGN(IgnorePatterns);
+};
+
+}  // namespace io
+
+#endif  // EVITA_IO_IGNORE_PATTERNS_H_
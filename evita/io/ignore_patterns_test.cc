@@ -0,0 +1,81 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "evita/io/ignore_patterns.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace io {
+
+namespace {
+
+bool IsIgnored(const std::string& text,
+               const std::string& path,
+               bool is_directory = false) {
+  scoped_refptr<IgnorePatterns> patterns(new IgnorePatterns(nullptr, "", text));
+  return patterns->IsIgnored(path, is_directory);
+}
+
+}  // namespace
+
+TEST(IgnorePatternsTest, Anchored) {
+  EXPECT_TRUE(IsIgnored("/out", "out"));
+  EXPECT_FALSE(IsIgnored("/out", "src/out"));
+  EXPECT_TRUE(IsIgnored("src/gen", "src/gen"));
+  EXPECT_FALSE(IsIgnored("src/gen", "foo/src/gen"));
+}
+
+TEST(IgnorePatternsTest, Basic) {
+  EXPECT_TRUE(IsIgnored("*.o", "foo.o"));
+  EXPECT_TRUE(IsIgnored("*.o", "src/foo.o"));
+  EXPECT_FALSE(IsIgnored("*.o", "foo.obj"));
+  EXPECT_TRUE(IsIgnored("foo?.txt", "foo1.txt"));
+  EXPECT_FALSE(IsIgnored("foo?.txt", "foo.txt"));
+  EXPECT_TRUE(IsIgnored("foo[0-9].txt", "foo1.txt"));
+  EXPECT_FALSE(IsIgnored("foo[!0-9].txt", "foo1.txt"));
+  EXPECT_TRUE(IsIgnored("foo[!0-9].txt", "fooa.txt"));
+}
+
+TEST(IgnorePatternsTest, Comment) {
+  EXPECT_FALSE(IsIgnored("# foo\n\n", "# foo"));
+  EXPECT_TRUE(IsIgnored("\\#foo", "#foo"));
+  EXPECT_TRUE(IsIgnored("foo  \r\n", "foo"));
+}
+
+TEST(IgnorePatternsTest, DirectoryOnly) {
+  EXPECT_TRUE(IsIgnored("build/", "build", true));
+  EXPECT_FALSE(IsIgnored("build/", "build", false));
+  EXPECT_TRUE(IsIgnored("build/", "src/build", true));
+}
+
+TEST(IgnorePatternsTest, DoubleStar) {
+  EXPECT_TRUE(IsIgnored("**/gen", "gen"));
+  EXPECT_TRUE(IsIgnored("**/gen", "a/b/gen"));
+  EXPECT_TRUE(IsIgnored("a/**/b", "a/b"));
+  EXPECT_TRUE(IsIgnored("a/**/b", "a/x/y/b"));
+  EXPECT_FALSE(IsIgnored("a/**/b", "a/xb"));
+  EXPECT_TRUE(IsIgnored("a/**", "a/x/y"));
+  EXPECT_FALSE(IsIgnored("a/*", "a/x/y"));
+}
+
+TEST(IgnorePatternsTest, Negation) {
+  EXPECT_TRUE(IsIgnored("*.log\n!keep.log", "foo.log"));
+  EXPECT_FALSE(IsIgnored("*.log\n!keep.log", "keep.log"));
+  EXPECT_TRUE(IsIgnored("!keep.log\n*.log", "keep.log"));
+}
+
+TEST(IgnorePatternsTest, Parent) {
+  scoped_refptr<IgnorePatterns> root(new IgnorePatterns(nullptr, "", "*.o"));
+  scoped_refptr<IgnorePatterns> child(
+      new IgnorePatterns(root, "src/", "/gen\n!keep.o"));
+  EXPECT_TRUE(child->IsIgnored("src/foo.o", false));
+  EXPECT_FALSE(child->IsIgnored("src/keep.o", false));
+  EXPECT_TRUE(root->IsIgnored("keep.o", false));
+  EXPECT_TRUE(child->IsIgnored("src/gen", true));
+  EXPECT_FALSE(child->IsIgnored("src/foo/gen", true));
+}
+
+}  // namespace io
@@ -0,0 +1,216 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures read throughput of |IoDelegatePosix| with one request in flight
+// and with several requests in flight.
+//
+// Usage: io_bench [--iterations=N] [--size=MB] [--chunk-size=KB]
+
+#include <stdint.h>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#include "evita/dom/public/io_context_id.h"
+#include "evita/dom/public/io_error.h"
+#include "evita/dom/public/promise.h"
+#include "evita/io/io_delegate_posix.h"
+
+namespace io {
+
+namespace {
+
+const auto kDefaultChunkSize = 64;
+const auto kDefaultIterations = 10;
+const auto kDefaultSize = 64;
+const auto kNumWorkers = 4;
+
+//////////////////////////////////////////////////////////////////////
+//
+// FileReader
+// Reads a file until end of file, keeping |depth| requests in flight.
+//
+class FileReader final {
+ public:
+  FileReader(domapi::IoDelegate* io_delegate,
+             domapi::FileId file_id,
+             size_t chunk_size,
+             int depth);
+  ~FileReader() = default;
+
+  // Returns number of bytes read.
+  int64_t Run();
+
+ private:
+  void DidRead(size_t index, int num_read);
+  void DidReject(domapi::IoError error);
+  void Issue(size_t index);
+
+  std::vector<std::vector<uint8_t>> buffers_;
+  const size_t chunk_size_;
+  const domapi::FileId file_id_;
+  domapi::IoDelegate* const io_delegate_;
+  bool is_eof_ = false;
+  int num_pending_ = 0;
+  base::OnceClosure quit_closure_;
+  int64_t total_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(FileReader);
+};
+
+FileReader::FileReader(domapi::IoDelegate* io_delegate,
+                       domapi::FileId file_id,
+                       size_t chunk_size,
+                       int depth)
+    : buffers_(depth, std::vector<uint8_t>(chunk_size)),
+      chunk_size_(chunk_size),
+      file_id_(file_id),
+      io_delegate_(io_delegate) {}
+
+void FileReader::DidRead(size_t index, int num_read) {
+  --num_pending_;
+  total_ += num_read;
+  if (!num_read)
+    is_eof_ = true;
+  if (!is_eof_)
+    return Issue(index);
+  if (!num_pending_)
+    std::move(quit_closure_).Run();
+}
+
+void FileReader::DidReject(domapi::IoError error) {
+  LOG(FATAL) << "Read failed: " << error.error_code;
+}
+
+void FileReader::Issue(size_t index) {
+  ++num_pending_;
+  domapi::IoIntPromise promise;
+  promise.reject =
+      base::BindOnce(&FileReader::DidReject, base::Unretained(this));
+  promise.resolve =
+      base::BindOnce(&FileReader::DidRead, base::Unretained(this), index);
+  io_delegate_->ReadFile(file_id_, buffers_[index].data(), chunk_size_,
+                         std::move(promise));
+}
+
+int64_t FileReader::Run() {
+  base::RunLoop run_loop;
+  quit_closure_ = run_loop.QuitClosure();
+  for (size_t index = 0; index < buffers_.size(); ++index)
+    Issue(index);
+  run_loop.Run();
+  return total_;
+}
+
+domapi::FileId OpenFile(domapi::IoDelegate* io_delegate,
+                        const base::FilePath& path) {
+  domapi::FileId file_id((domapi::IoContextId()));
+  base::RunLoop run_loop;
+  domapi::OpenFilePromise promise;
+  promise.reject = base::BindOnce([](domapi::IoError error) {
+    LOG(FATAL) << "Open failed: " << error.error_code;
+  });
+  promise.resolve = base::BindOnce(
+      [](domapi::FileId* result, base::OnceClosure quit,
+         domapi::FileId file_id) {
+        *result = file_id;
+        std::move(quit).Run();
+      },
+      &file_id, run_loop.QuitClosure());
+  io_delegate->OpenFile(base::UTF8ToUTF16(path.value()), base::string16(),
+                        std::move(promise));
+  run_loop.Run();
+  return file_id;
+}
+
+void CloseFile(domapi::IoDelegate* io_delegate, domapi::FileId file_id) {
+  base::RunLoop run_loop;
+  domapi::IoIntPromise promise;
+  promise.reject = base::BindOnce([](domapi::IoError error) {
+    LOG(FATAL) << "Close failed: " << error.error_code;
+  });
+  promise.resolve = base::BindOnce(
+      [](base::OnceClosure quit, int) { std::move(quit).Run(); },
+      run_loop.QuitClosure());
+  io_delegate->CloseContext(file_id, std::move(promise));
+  run_loop.Run();
+}
+
+void Report(int depth, int64_t num_bytes, base::TimeDelta elapsed) {
+  std::cout << "depth=" << std::left << std::setw(4) << depth << std::right
+            << std::fixed << std::setprecision(3) << std::setw(10)
+            << num_bytes / elapsed.InSecondsF() / (1 << 20) << " MB/s"
+            << std::endl;
+}
+
+void BenchRead(domapi::IoDelegate* io_delegate,
+               const base::FilePath& path,
+               size_t chunk_size,
+               int depth,
+               int iterations) {
+  int64_t num_bytes = 0;
+  base::TimeDelta elapsed;
+  for (auto count = 0; count < iterations; ++count) {
+    const auto& file_id = OpenFile(io_delegate, path);
+    const auto& start = base::TimeTicks::Now();
+    num_bytes += FileReader(io_delegate, file_id, chunk_size, depth).Run();
+    elapsed += base::TimeTicks::Now() - start;
+    CloseFile(io_delegate, file_id);
+  }
+  Report(depth, num_bytes, elapsed);
+}
+
+int SwitchValue(const base::CommandLine& command_line,
+                const char* name,
+                int default_value) {
+  auto value = default_value;
+  if (command_line.HasSwitch(name))
+    base::StringToInt(command_line.GetSwitchValueASCII(name), &value);
+  return value;
+}
+
+}  // namespace
+
+}  // namespace io
+
+int main(int argc, char** argv) {
+  base::AtExitManager at_exit;
+  base::CommandLine::Init(argc, argv);
+  const auto& command_line = *base::CommandLine::ForCurrentProcess();
+  const auto iterations =
+      io::SwitchValue(command_line, "iterations", io::kDefaultIterations);
+  const auto size = io::SwitchValue(command_line, "size", io::kDefaultSize);
+  const auto chunk_size = static_cast<size_t>(
+      io::SwitchValue(command_line, "chunk-size", io::kDefaultChunkSize) *
+      1024);
+
+  base::ScopedTempDir temp_dir;
+  CHECK(temp_dir.CreateUniqueTempDir());
+  const auto& path = temp_dir.GetPath().Append("io_bench.dat");
+  const std::string contents(static_cast<size_t>(size) << 20, 'x');
+  CHECK_EQ(static_cast<int>(contents.size()),
+           base::WriteFile(path, contents.data(),
+                           static_cast<int>(contents.size())));
+
+  base::MessageLoop message_loop;
+  io::IoDelegatePosix io_delegate(message_loop.task_runner(),
+                                  io::kNumWorkers);
+  for (const auto depth : {1, 2, 4, 8})
+    io::BenchRead(&io_delegate, path, chunk_size, depth, iterations);
+  return 0;
+}
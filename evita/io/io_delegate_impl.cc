@@ -13,6 +13,7 @@
 #include "base/bind.h"
 #include "base/callback.h"
 #include "base/message_loop/message_pump_win.h"
+#include "base/task_scheduler/post_task.h"
 #include "base/time/time.h"
 #include "base/trace_event/trace_event.h"
 #include "common/win/scoped_handle.h"
@@ -21,6 +22,7 @@
 #include "evita/dom/public/promise.h"
 #include "evita/dom/public/view_event_handler.h"
 #include "evita/io/directory_io_context.h"
+#include "evita/io/directory_watcher_io_context.h"
 #include "evita/io/file_io_context.h"
 #include "evita/io/io_context_utils.h"
 #include "evita/io/process_io_context.h"
@@ -202,9 +204,30 @@ void IoDelegateImpl::MoveFile(const base::string16& src_path,
 
 void IoDelegateImpl::OpenDirectory(const base::string16& dir_name,
                                    domapi::OpenDirectoryPromise promise) {
-  auto directory = std::make_unique<DirectoryIoContext>(dir_name);
+  const auto recursive = false;
+  OpenDirectoryIoContext(dir_name, recursive, std::move(promise));
+}
+
+// Directories are scanned by tasks of |base::TaskScheduler|, so scanning
+// doesn't block the I/O thread and subdirectories are scanned in parallel.
+void IoDelegateImpl::OpenDirectoryIoContext(
+    const base::string16& dir_name,
+    bool recursive,
+    domapi::OpenDirectoryPromise promise) {
+  TRACE_EVENT1("io", "IoDelegateImpl::OpenDirectoryIoContext", "recursive",
+               recursive);
+  const auto attributes = ::GetFileAttributesW(dir_name.c_str());
+  if (attributes == INVALID_FILE_ATTRIBUTES)
+    return Reject(std::move(promise.reject), ::GetLastError());
+  if ((attributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+    return Reject(std::move(promise.reject), ERROR_DIRECTORY);
+  const auto directory = new DirectoryIoContext(
+      dir_name, recursive,
+      base::CreateTaskRunnerWithTraits(
+          {base::MayBlock(), base::TaskPriority::USER_VISIBLE}),
+      base::BindRepeating(&RunCallback));
   const auto directory_id = domapi::IoContextId::New();
-  context_map_.insert(std::make_pair(directory_id, directory.release()));
+  context_map_.emplace(directory_id, directory);
   RunCallback(base::BindOnce(std::move(promise.resolve),
                              domapi::DirectoryId(directory_id)));
 }
@@ -232,12 +255,15 @@ void IoDelegateImpl::OpenProcess(const base::string16& command_line,
   TRACE_EVENT_WITH_FLOW1("promise", "Promise", promise.sequence_num,
                          TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT,
                          "step", "IoDelegateImpl::OpenProcess");
+  const auto process = new ProcessIoContext();
+  if (const auto error = process->Start(command_line)) {
+    delete process;
+    return Reject(std::move(promise.reject), error);
+  }
   const auto process_id = domapi::IoContextId::New();
-  const auto process =
-      new ProcessIoContext(process_id, command_line, std::move(promise));
-  context_map_.insert(std::make_pair(process_id, process));
-  // Note: |ProcessIoContext| constructor delegate promise resolution to the
-  // gateway thread which spawns process with specified command line.
+  context_map_.emplace(process_id, process);
+  RunCallback(base::BindOnce(std::move(promise.resolve),
+                             domapi::ProcessId(process_id)));
 }
 
 void IoDelegateImpl::OpenWinResource(const base::string16& file_name,
@@ -288,10 +314,19 @@ void IoDelegateImpl::QueryFileStatus(const base::string16& file_name,
 void IoDelegateImpl::ReadDirectory(domapi::IoContextId context_id,
                                    size_t num_read,
                                    domapi::ReadDirectoryPromise promise) {
-  const auto context = IoContextOf(context_id)->as<DirectoryIoContext>();
-  if (!context)
+  const auto context = IoContextOf(context_id);
+  if (!context || !context->is<DirectoryIoContext>())
+    return Reject(std::move(promise.reject), ERROR_INVALID_HANDLE);
+  context->as<DirectoryIoContext>()->Read(num_read, std::move(promise));
+}
+
+void IoDelegateImpl::ReadDirectoryChanges(
+    domapi::IoContextId context_id,
+    domapi::ReadDirectoryChangesPromise promise) {
+  const auto context = IoContextOf(context_id);
+  if (!context || !context->is<DirectoryWatcherIoContext>())
     return Reject(std::move(promise.reject), ERROR_INVALID_HANDLE);
-  context->Read(num_read, std::move(promise));
+  context->as<DirectoryWatcherIoContext>()->Read(std::move(promise));
 }
 
 void IoDelegateImpl::ReadFile(domapi::IoContextId context_id,
@@ -318,6 +353,12 @@ void IoDelegateImpl::RemoveFile(const base::string16& file_name,
   RunCallback(base::BindOnce(std::move(resolver.resolve), true));
 }
 
+void IoDelegateImpl::ScanDirectory(const base::string16& dir_name,
+                                   domapi::OpenDirectoryPromise promise) {
+  const auto recursive = true;
+  OpenDirectoryIoContext(dir_name, recursive, std::move(promise));
+}
+
 void IoDelegateImpl::WriteFile(domapi::IoContextId context_id,
                                void* buffer,
                                size_t num_write,
@@ -329,4 +370,17 @@ void IoDelegateImpl::WriteFile(domapi::IoContextId context_id,
   context->Write(buffer, num_write, std::move(promise));
 }
 
+void IoDelegateImpl::WatchDirectory(const base::string16& dir_name,
+                                    domapi::OpenDirectoryPromise promise) {
+  TRACE_EVENT0("io", "IoDelegateImpl::WatchDirectory");
+  const auto& pair = DirectoryWatcherIoContext::Open(dir_name);
+  if (pair.second)
+    return Reject(std::move(promise.reject), pair.second);
+  const auto watcher = new DirectoryWatcherIoContext(pair.first);
+  const auto watcher_id = domapi::IoContextId::New();
+  context_map_.emplace(watcher_id, watcher);
+  RunCallback(base::BindOnce(std::move(promise.resolve),
+                             domapi::DirectoryId(watcher_id)));
+}
+
 }  // namespace io
@@ -22,6 +22,9 @@ class IoDelegateImpl final : public domapi::IoDelegate {
 
  private:
   IoContext* IoContextOf(domapi::IoContextId context_id) const;
+  void OpenDirectoryIoContext(const base::string16& dir_name,
+                              bool recursive,
+                              domapi::OpenDirectoryPromise promise);
 
   // domapi::IoDelegate
   void CheckSpelling(const base::string16& word_to_check,
@@ -62,16 +65,22 @@ class IoDelegateImpl final : public domapi::IoDelegate {
   void ReadDirectory(domapi::IoContextId context_id,
                      size_t num_read,
                      domapi::ReadDirectoryPromise promise) final;
+  void ReadDirectoryChanges(domapi::IoContextId context_id,
+                            domapi::ReadDirectoryChangesPromise promise) final;
   void ReadFile(domapi::IoContextId context_id,
                 void* buffer,
                 size_t num_read,
                 domapi::IoIntPromise promise) final;
   void RemoveFile(const base::string16& file_name,
                   domapi::IoBoolPromise resolver) final;
+  void ScanDirectory(const base::string16& dir_name,
+                     domapi::OpenDirectoryPromise promise) final;
   void WriteFile(domapi::IoContextId context_id,
                  void* buffer,
                  size_t num_write,
                  domapi::IoIntPromise promise) final;
+  void WatchDirectory(const base::string16& dir_name,
+                      domapi::OpenDirectoryPromise promise) final;
 
   std::unordered_map<domapi::IoContextId, IoContext*> context_map_;
 
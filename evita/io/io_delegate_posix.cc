@@ -0,0 +1,381 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/io/io_delegate_posix.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/rand_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/task_runner.h"
+#include "base/task_runner_util.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "base/trace_event/trace_event.h"
+#include "evita/dom/public/io_context_id.h"
+#include "evita/dom/public/io_error.h"
+#include "evita/dom/public/promise.h"
+#include "evita/io/directory_io_context.h"
+#include "evita/io/file_io_context_posix.h"
+
+namespace io {
+
+namespace {
+
+const off_t kHugeFileSize = 1 << 28;
+
+// Number of names |MakeTempFileName()| tries before giving up.
+const int kMaxTempFileNameTries = 100;
+
+// Copies owner, group and permission bits of |dst_path| to |src_path|, so
+// replacing |dst_path| by |src_path| keeps them. Changing owner fails
+// unless we are privileged, so we ignore errors of |chown(2)|.
+void CopyFileMode(const std::string& dst_path, const std::string& src_path) {
+  struct stat dst_stat;
+  if (::stat(dst_path.c_str(), &dst_stat) < 0)
+    return;
+  if (::chown(src_path.c_str(), dst_stat.st_uid, dst_stat.st_gid) < 0 &&
+      ::chown(src_path.c_str(), static_cast<uid_t>(-1), dst_stat.st_gid) < 0) {
+    DVLOG(1) << "Can't change owner of " << src_path;
+  }
+  // |chown(2)| may clear set-user-ID and set-group-ID bits, so we change
+  // mode after owner.
+  if (::chmod(src_path.c_str(), dst_stat.st_mode & 07777) < 0)
+    PLOG(ERROR) << "chmod failed";
+}
+
+std::string ToNativePath(const base::string16& file_name) {
+  return base::UTF16ToUTF8(file_name);
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// IoDelegatePosix
+//
+IoDelegatePosix::IoDelegatePosix(scoped_refptr<base::TaskRunner> reply_runner,
+                                 int num_workers)
+    : reply_runner_(std::move(reply_runner)) {
+  DCHECK_GT(num_workers, 0);
+  for (auto index = 0; index < num_workers; ++index) {
+    auto worker = std::make_unique<base::Thread>(
+        base::StringPrintf("IoWorker%d", index));
+    CHECK(worker->Start());
+    workers_.push_back(std::move(worker));
+  }
+}
+
+// Note: We stop workers before closing contexts, since workers may access
+// file descriptors of contexts.
+IoDelegatePosix::~IoDelegatePosix() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  workers_.clear();
+  DLOG_IF(ERROR, !context_map_.empty()) << context_map_.size()
+                                        << " contexts aren't closed.";
+}
+
+IoContext* IoDelegatePosix::IoContextOf(
+    domapi::IoContextId context_id) const {
+  const auto& it = context_map_.find(context_id);
+  if (it == context_map_.end())
+    return nullptr;
+  return it->second;
+}
+
+// Workers are chosen in round robin, so requests to a file can run in
+// parallel.
+void IoDelegatePosix::PostBlockingTask(BlockingTask task,
+                                       BlockingReply reply) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  const auto& worker = workers_[next_worker_];
+  next_worker_ = (next_worker_ + 1) % workers_.size();
+  base::PostTaskAndReplyWithResult(worker->task_runner().get(), FROM_HERE,
+                                   std::move(task), std::move(reply));
+}
+
+void IoDelegatePosix::Reject(base::OnceCallback<void(domapi::IoError)> reject,
+                             int error) {
+  RunCallback(base::BindOnce(std::move(reject), domapi::IoError(error)));
+}
+
+void IoDelegatePosix::Resolve(base::OnceCallback<void(int)> resolve,
+                              int num_transferred) {
+  RunCallback(base::BindOnce(std::move(resolve), num_transferred));
+}
+
+void IoDelegatePosix::RunCallback(base::OnceClosure callback) {
+  reply_runner_->PostTask(FROM_HERE, std::move(callback));
+}
+
+// domapi::IoDelegate
+void IoDelegatePosix::CheckSpelling(const base::string16& word_to_check,
+                                    CheckSpellingResolver promise) {
+  RunCallback(base::BindOnce(std::move(promise.reject), ENOSYS));
+}
+
+void IoDelegatePosix::CloseContext(const domapi::IoContextId& context_id,
+                                   domapi::IoIntPromise promise) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  const auto& it = context_map_.find(context_id);
+  if (it == context_map_.end())
+    return Reject(std::move(promise.reject), EBADF);
+  const auto context = it->second;
+  context_map_.erase(it);
+  context->Close(std::move(promise));
+}
+
+void IoDelegatePosix::ComputeFullPathName(const base::string16& path_name,
+                                          ComputeFullPathNamePromise promise) {
+  char full_path[PATH_MAX];
+  if (!::realpath(ToNativePath(path_name).c_str(), full_path))
+    return Reject(std::move(promise.reject), errno);
+  RunCallback(base::BindOnce(std::move(promise.resolve),
+                             base::UTF8ToUTF16(full_path)));
+}
+
+void IoDelegatePosix::GetWinResourceNames(
+    const domapi::WinResourceId& resource_id,
+    const base::string16& type,
+    GetWinResourceNamessPromise promise) {
+  Reject(std::move(promise.reject), ENOSYS);
+}
+
+void IoDelegatePosix::GetSpellingSuggestions(
+    const base::string16& wrong_word,
+    GetSpellingSuggestionsResolver promise) {
+  RunCallback(base::BindOnce(std::move(promise.reject), ENOSYS));
+}
+
+void IoDelegatePosix::LoadWinResource(const domapi::WinResourceId& resource_id,
+                                      const base::string16& type,
+                                      const base::string16& name,
+                                      uint8_t* buffer,
+                                      size_t buffer_size,
+                                      domapi::IoIntPromise promise) {
+  Reject(std::move(promise.reject), ENOSYS);
+}
+
+// Like |GetTempFileName()| on Windows, we create an empty file to reserve
+// the name. Unlike |mkstemp(3)|, which creates a file with mode 0600, we
+// create the file by |open(2)| with mode 0666 and let the kernel apply
+// umask, since it may become a new file by |MoveFile()|.
+void IoDelegatePosix::MakeTempFileName(
+    const base::string16& dir_name,
+    const base::string16& prefix,
+    domapi::MakeTempFileNamePromise resolver) {
+  TRACE_EVENT_WITH_FLOW1("promise", "Promise", resolver.sequence_num,
+                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT,
+                         "step", "IoDelegatePosix::MakeTempFileName");
+  const auto dir_path = base::FilePath(ToNativePath(dir_name));
+  for (auto num_tries = 1;; ++num_tries) {
+    const auto& file_name =
+        dir_path
+            .Append(ToNativePath(prefix) +
+                    base::StringPrintf(
+                        "%08X", static_cast<uint32_t>(base::RandUint64())))
+            .value();
+    const auto file_descriptor = HANDLE_EINTR(::open(
+        file_name.c_str(), O_CREAT | O_EXCL | O_WRONLY | O_CLOEXEC, 0666));
+    if (file_descriptor >= 0) {
+      IGNORE_EINTR(::close(file_descriptor));
+      return RunCallback(base::BindOnce(std::move(resolver.resolve),
+                                        base::UTF8ToUTF16(file_name)));
+    }
+    const auto error = errno;
+    if (error == EEXIST && num_tries < kMaxTempFileNameTries)
+      continue;
+    PLOG(ERROR) << "open failed";
+    return Reject(std::move(resolver.reject), error);
+  }
+}
+
+// Without |no_overwrite|, |rename(2)| replaces |dst_path| atomically, and
+// |src_path| takes owner and mode of |dst_path|, e.g. saving a document via
+// temporary file keeps them. With |no_overwrite|, |link(2)| fails with
+// |EEXIST| if |dst_path| exists.
+void IoDelegatePosix::MoveFile(const base::string16& src_path,
+                               const base::string16& dst_path,
+                               const domapi::MoveFileOptions& options,
+                               domapi::IoBoolPromise resolver) {
+  TRACE_EVENT0("io", "IoDelegatePosix::MoveFile");
+  const auto& src = ToNativePath(src_path);
+  const auto& dst = ToNativePath(dst_path);
+  if (options.no_overwrite) {
+    if (::link(src.c_str(), dst.c_str()) < 0 || ::unlink(src.c_str()) < 0) {
+      const auto error = errno;
+      PLOG(ERROR) << "link failed";
+      return Reject(std::move(resolver.reject), error);
+    }
+  } else {
+    CopyFileMode(dst, src);
+    if (::rename(src.c_str(), dst.c_str()) < 0) {
+      const auto error = errno;
+      PLOG(ERROR) << "rename failed";
+      return Reject(std::move(resolver.reject), error);
+    }
+  }
+  RunCallback(base::BindOnce(std::move(resolver.resolve), true));
+}
+
+void IoDelegatePosix::OpenDirectory(const base::string16& dir_name,
+                                    domapi::OpenDirectoryPromise promise) {
+  const auto recursive = false;
+  OpenDirectoryIoContext(dir_name, recursive, std::move(promise));
+}
+
+// Unlike file contexts, directories are scanned by tasks of
+// |base::TaskScheduler|, so subdirectories are scanned in parallel
+// regardless of number of workers.
+void IoDelegatePosix::OpenDirectoryIoContext(
+    const base::string16& dir_name,
+    bool recursive,
+    domapi::OpenDirectoryPromise promise) {
+  TRACE_EVENT1("io", "IoDelegatePosix::OpenDirectoryIoContext", "recursive",
+               recursive);
+  DCHECK(thread_checker_.CalledOnValidThread());
+  struct stat dir_stat;
+  if (::stat(ToNativePath(dir_name).c_str(), &dir_stat) < 0)
+    return Reject(std::move(promise.reject), errno);
+  if (!S_ISDIR(dir_stat.st_mode))
+    return Reject(std::move(promise.reject), ENOTDIR);
+  const auto directory = new DirectoryIoContext(
+      dir_name, recursive,
+      base::CreateTaskRunnerWithTraits(
+          {base::MayBlock(), base::TaskPriority::USER_VISIBLE}),
+      base::BindRepeating(&IoDelegatePosix::RunCallback,
+                          base::Unretained(this)));
+  const auto directory_id = domapi::IoContextId::New();
+  context_map_.emplace(directory_id, directory);
+  RunCallback(base::BindOnce(std::move(promise.resolve),
+                             domapi::DirectoryId(directory_id)));
+}
+
+void IoDelegatePosix::OpenFile(const base::string16& file_name,
+                               const base::string16& mode,
+                               domapi::OpenFilePromise promise) {
+  TRACE_EVENT0("io", "IoDelegatePosix::OpenFile");
+  DCHECK(thread_checker_.CalledOnValidThread());
+  const auto& pair = FileIoContextPosix::Open(file_name, mode);
+  if (pair.second)
+    return Reject(std::move(promise.reject), pair.second);
+  const auto file = new FileIoContextPosix(this, pair.first);
+  const auto file_id = domapi::IoContextId::New();
+  context_map_.emplace(file_id, file);
+  RunCallback(
+      base::BindOnce(std::move(promise.resolve), domapi::FileId(file_id)));
+}
+
+void IoDelegatePosix::OpenProcess(const base::string16& command_line,
+                                  domapi::OpenProcessPromise promise) {
+  Reject(std::move(promise.reject), ENOSYS);
+}
+
+void IoDelegatePosix::OpenWinResource(const base::string16& file_name,
+                                      domapi::OpenWinResourcePromise promise) {
+  Reject(std::move(promise.reject), ENOSYS);
+}
+
+void IoDelegatePosix::QueryFileStatus(const base::string16& file_name,
+                                      domapi::QueryFileStatusPromise promise) {
+  TRACE_EVENT0("io", "IoDelegatePosix::QueryFileStatus");
+  const auto& native_path = ToNativePath(file_name);
+  struct stat file_stat;
+  if (::lstat(native_path.c_str(), &file_stat) < 0) {
+    const auto error = errno;
+    PLOG(ERROR) << "lstat failed";
+    return Reject(std::move(promise.reject), error);
+  }
+  const auto is_symlink = S_ISLNK(file_stat.st_mode);
+  if (is_symlink && ::stat(native_path.c_str(), &file_stat) < 0)
+    return Reject(std::move(promise.reject), errno);
+  if (file_stat.st_size > kHugeFileSize)
+    return Reject(std::move(promise.reject), ENOMEM);
+
+  domapi::FileStatus data = {0};
+  data.file_size = static_cast<int>(file_stat.st_size);
+  data.is_directory = S_ISDIR(file_stat.st_mode);
+  data.is_symlink = is_symlink;
+  data.last_write_time = base::Time::FromTimeT(file_stat.st_mtime);
+  data.name = base::UTF8ToUTF16(base::FilePath(native_path).BaseName().value());
+  data.readonly = ::access(native_path.c_str(), W_OK) < 0;
+  RunCallback(base::BindOnce(std::move(promise.resolve), data));
+}
+
+void IoDelegatePosix::ReadDirectory(domapi::IoContextId context_id,
+                                    size_t num_read,
+                                    domapi::ReadDirectoryPromise promise) {
+  TRACE_EVENT0("io", "IoDelegatePosix::ReadDirectory");
+  const auto context = IoContextOf(context_id);
+  if (!context || !context->is<DirectoryIoContext>())
+    return Reject(std::move(promise.reject), EBADF);
+  context->as<DirectoryIoContext>()->Read(num_read, std::move(promise));
+}
+
+void IoDelegatePosix::ReadDirectoryChanges(
+    domapi::IoContextId context_id,
+    domapi::ReadDirectoryChangesPromise promise) {
+  Reject(std::move(promise.reject), ENOSYS);
+}
+
+void IoDelegatePosix::ReadFile(domapi::IoContextId context_id,
+                               void* buffer,
+                               size_t num_read,
+                               domapi::IoIntPromise promise) {
+  TRACE_EVENT0("io", "IoDelegatePosix::ReadFile");
+  const auto context = IoContextOf(context_id);
+  if (!context || !context->is<BlockIoContext>())
+    return Reject(std::move(promise.reject), EBADF);
+  context->as<BlockIoContext>()->Read(buffer, num_read, std::move(promise));
+}
+
+void IoDelegatePosix::RemoveFile(const base::string16& file_name,
+                                 domapi::IoBoolPromise resolver) {
+  TRACE_EVENT0("io", "IoDelegatePosix::RemoveFile");
+  if (::unlink(ToNativePath(file_name).c_str()) < 0) {
+    const auto error = errno;
+    PLOG(ERROR) << "unlink failed";
+    return Reject(std::move(resolver.reject), error);
+  }
+  RunCallback(base::BindOnce(std::move(resolver.resolve), true));
+}
+
+void IoDelegatePosix::ScanDirectory(const base::string16& dir_name,
+                                    domapi::OpenDirectoryPromise promise) {
+  const auto recursive = true;
+  OpenDirectoryIoContext(dir_name, recursive, std::move(promise));
+}
+
+void IoDelegatePosix::WriteFile(domapi::IoContextId context_id,
+                                void* buffer,
+                                size_t num_write,
+                                domapi::IoIntPromise promise) {
+  TRACE_EVENT0("io", "IoDelegatePosix::WriteFile");
+  const auto context = IoContextOf(context_id);
+  if (!context || !context->is<BlockIoContext>())
+    return Reject(std::move(promise.reject), EBADF);
+  context->as<BlockIoContext>()->Write(buffer, num_write, std::move(promise));
+}
+
+void IoDelegatePosix::WatchDirectory(const base::string16& dir_name,
+                                     domapi::OpenDirectoryPromise promise) {
+  Reject(std::move(promise.reject), ENOSYS);
+}
+
+}  // namespace io
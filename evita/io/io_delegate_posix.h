@@ -0,0 +1,138 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_IO_IO_DELEGATE_POSIX_H_
+#define EVITA_IO_IO_DELEGATE_POSIX_H_
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/threading/thread_checker.h"
+#include "evita/dom/public/io_delegate.h"
+
+namespace base {
+class TaskRunner;
+class Thread;
+}
+
+namespace io {
+
+class IoContext;
+
+//////////////////////////////////////////////////////////////////////
+//
+// IoDelegatePosix
+// Implements |domapi::IoDelegate| on POSIX file descriptors. Blocking
+// system calls of file contexts run on a pool of worker threads, and their
+// results come back to the thread which owns this delegate. Promise
+// callbacks run on |reply_runner|, e.g. the script thread.
+//
+// Directories are scanned by tasks of |base::TaskScheduler|, so it must be
+// running before opening directories.
+//
+// Note: Directory watchers, processes, Windows resources and spell checking
+// are not supported; they are rejected with |ENOSYS|.
+//
+class IoDelegatePosix final : public domapi::IoDelegate {
+ public:
+  // Result of a blocking operation: number of bytes transferred, or |errno|
+  // in |error|.
+  struct BlockingResult {
+    int error = 0;
+    int num_transferred = 0;
+  };
+
+  using BlockingTask = base::OnceCallback<BlockingResult()>;
+  using BlockingReply = base::OnceCallback<void(BlockingResult)>;
+
+  IoDelegatePosix(scoped_refptr<base::TaskRunner> reply_runner,
+                  int num_workers);
+  ~IoDelegatePosix() final;
+
+  // Runs |task| on a worker thread, then runs |reply| with result of |task|
+  // on the thread of this delegate.
+  void PostBlockingTask(BlockingTask task, BlockingReply reply);
+
+  void Reject(base::OnceCallback<void(domapi::IoError)> reject, int error);
+  void Resolve(base::OnceCallback<void(int)> resolve, int num_transferred);
+  void RunCallback(base::OnceClosure callback);
+
+ private:
+  IoContext* IoContextOf(domapi::IoContextId context_id) const;
+  void OpenDirectoryIoContext(const base::string16& dir_name,
+                              bool recursive,
+                              domapi::OpenDirectoryPromise promise);
+
+  // domapi::IoDelegate
+  void CheckSpelling(const base::string16& word_to_check,
+                     CheckSpellingResolver promise) final;
+  void CloseContext(const domapi::IoContextId& context_id,
+                    domapi::IoIntPromise promise) final;
+  void ComputeFullPathName(const base::string16& path_name,
+                           ComputeFullPathNamePromise promise) final;
+  void GetWinResourceNames(const domapi::WinResourceId& resource_id,
+                           const base::string16& type,
+                           GetWinResourceNamessPromise promise) final;
+  void GetSpellingSuggestions(const base::string16& wrong_word,
+                              GetSpellingSuggestionsResolver promise) final;
+  void LoadWinResource(const domapi::WinResourceId& resource_id,
+                       const base::string16& type,
+                       const base::string16& name,
+                       uint8_t* buffer,
+                       size_t buffer_size,
+                       domapi::IoIntPromise promise) final;
+  void MakeTempFileName(const base::string16& dir_name,
+                        const base::string16& prefix,
+                        domapi::MakeTempFileNamePromise resolver) final;
+  void MoveFile(const base::string16& src_path,
+                const base::string16& dst_path,
+                const domapi::MoveFileOptions& options,
+                domapi::IoBoolPromise resolver) final;
+  void OpenDirectory(const base::string16& dir_name,
+                     domapi::OpenDirectoryPromise promise) final;
+  void OpenFile(const base::string16& file_name,
+                const base::string16& mode,
+                domapi::OpenFilePromise promise) final;
+  void OpenProcess(const base::string16& command_line,
+                   domapi::OpenProcessPromise promise) final;
+  void OpenWinResource(const base::string16& file_name,
+                       domapi::OpenWinResourcePromise promise) final;
+  void QueryFileStatus(const base::string16& file_name,
+                       domapi::QueryFileStatusPromise promise) final;
+  void ReadDirectory(domapi::IoContextId context_id,
+                     size_t num_read,
+                     domapi::ReadDirectoryPromise promise) final;
+  void ReadDirectoryChanges(domapi::IoContextId context_id,
+                            domapi::ReadDirectoryChangesPromise promise) final;
+  void ReadFile(domapi::IoContextId context_id,
+                void* buffer,
+                size_t num_read,
+                domapi::IoIntPromise promise) final;
+  void RemoveFile(const base::string16& file_name,
+                  domapi::IoBoolPromise resolver) final;
+  void ScanDirectory(const base::string16& dir_name,
+                     domapi::OpenDirectoryPromise promise) final;
+  void WriteFile(domapi::IoContextId context_id,
+                 void* buffer,
+                 size_t num_write,
+                 domapi::IoIntPromise promise) final;
+  void WatchDirectory(const base::string16& dir_name,
+                      domapi::OpenDirectoryPromise promise) final;
+
+  std::unordered_map<domapi::IoContextId, IoContext*> context_map_;
+  size_t next_worker_ = 0;
+  const scoped_refptr<base::TaskRunner> reply_runner_;
+  base::ThreadChecker thread_checker_;
+  std::vector<std::unique_ptr<base::Thread>> workers_;
+
+  DISALLOW_COPY_AND_ASSIGN(IoDelegatePosix);
+};
+
+}  // namespace io
+
+#endif  // EVITA_IO_IO_DELEGATE_POSIX_H_
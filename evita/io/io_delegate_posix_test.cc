@@ -0,0 +1,284 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/strings/utf_string_conversions.h"
+#include "evita/dom/public/io_context_id.h"
+#include "evita/dom/public/io_error.h"
+#include "evita/dom/public/promise.h"
+#include "evita/io/io_delegate_posix.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace io {
+
+namespace {
+
+const int kNumWorkers = 4;
+
+//////////////////////////////////////////////////////////////////////
+//
+// IoDelegatePosixTest
+//
+class IoDelegatePosixTest : public ::testing::Test {
+ protected:
+  IoDelegatePosixTest()
+      : io_delegate_(message_loop_.task_runner(), kNumWorkers) {}
+  ~IoDelegatePosixTest() override = default;
+
+  domapi::IoDelegate* io_delegate() { return &io_delegate_; }
+
+  // Returns result of an operation, or negative error code.
+  domapi::IoIntPromise NewIntPromise(int* result);
+  domapi::IoBoolPromise NewBoolPromise(int* result);
+  domapi::FileId OpenFile(const std::string& name, const std::string& mode);
+  base::string16 PathOf(const std::string& name) const;
+  // Waits for all promises to be settled.
+  void WaitForAll();
+  void WriteBytes(const std::string& name, const std::vector<uint8_t>& bytes);
+
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+ private:
+  void DidReject(int* result, domapi::IoError error);
+  void DidResolveBool(int* result, bool value);
+  void DidResolveFile(domapi::FileId* result, domapi::FileId file_id);
+  void DidResolveInt(int* result, int value);
+  void DidSettle();
+
+  base::MessageLoop message_loop_;
+  IoDelegatePosix io_delegate_;
+  int num_pending_ = 0;
+  base::OnceClosure quit_closure_;
+  base::ScopedTempDir temp_dir_;
+
+  DISALLOW_COPY_AND_ASSIGN(IoDelegatePosixTest);
+};
+
+void IoDelegatePosixTest::DidReject(int* result, domapi::IoError error) {
+  *result = -error.error_code;
+  DidSettle();
+}
+
+void IoDelegatePosixTest::DidResolveBool(int* result, bool value) {
+  *result = value ? 1 : 0;
+  DidSettle();
+}
+
+void IoDelegatePosixTest::DidResolveFile(domapi::FileId* result,
+                                         domapi::FileId file_id) {
+  *result = file_id;
+  DidSettle();
+}
+
+void IoDelegatePosixTest::DidResolveInt(int* result, int value) {
+  *result = value;
+  DidSettle();
+}
+
+void IoDelegatePosixTest::DidSettle() {
+  DCHECK_GT(num_pending_, 0);
+  --num_pending_;
+  if (!num_pending_ && quit_closure_)
+    std::move(quit_closure_).Run();
+}
+
+domapi::IoBoolPromise IoDelegatePosixTest::NewBoolPromise(int* result) {
+  ++num_pending_;
+  domapi::IoBoolPromise promise;
+  promise.reject = base::BindOnce(&IoDelegatePosixTest::DidReject,
+                                  base::Unretained(this), result);
+  promise.resolve = base::BindOnce(&IoDelegatePosixTest::DidResolveBool,
+                                   base::Unretained(this), result);
+  return promise;
+}
+
+domapi::IoIntPromise IoDelegatePosixTest::NewIntPromise(int* result) {
+  ++num_pending_;
+  domapi::IoIntPromise promise;
+  promise.reject = base::BindOnce(&IoDelegatePosixTest::DidReject,
+                                  base::Unretained(this), result);
+  promise.resolve = base::BindOnce(&IoDelegatePosixTest::DidResolveInt,
+                                   base::Unretained(this), result);
+  return promise;
+}
+
+domapi::FileId IoDelegatePosixTest::OpenFile(const std::string& name,
+                                             const std::string& mode) {
+  ++num_pending_;
+  domapi::FileId file_id((domapi::IoContextId()));
+  int error = 0;
+  domapi::OpenFilePromise promise;
+  promise.reject = base::BindOnce(&IoDelegatePosixTest::DidReject,
+                                  base::Unretained(this), &error);
+  promise.resolve = base::BindOnce(&IoDelegatePosixTest::DidResolveFile,
+                                   base::Unretained(this), &file_id);
+  io_delegate()->OpenFile(PathOf(name), base::UTF8ToUTF16(mode),
+                          std::move(promise));
+  WaitForAll();
+  EXPECT_EQ(0, error);
+  return file_id;
+}
+
+base::string16 IoDelegatePosixTest::PathOf(const std::string& name) const {
+  return base::UTF8ToUTF16(temp_dir_.GetPath().Append(name).value());
+}
+
+void IoDelegatePosixTest::WaitForAll() {
+  if (!num_pending_)
+    return;
+  base::RunLoop run_loop;
+  quit_closure_ = run_loop.QuitClosure();
+  run_loop.Run();
+}
+
+void IoDelegatePosixTest::WriteBytes(const std::string& name,
+                                     const std::vector<uint8_t>& bytes) {
+  const auto size = static_cast<int>(bytes.size());
+  ASSERT_EQ(size, base::WriteFile(temp_dir_.GetPath().Append(name),
+                                  reinterpret_cast<const char*>(bytes.data()),
+                                  size));
+}
+
+}  // namespace
+
+TEST_F(IoDelegatePosixTest, CloseContext) {
+  int result = 0;
+  io_delegate()->CloseContext(domapi::IoContextId::New(),
+                              NewIntPromise(&result));
+  WaitForAll();
+  EXPECT_EQ(-EBADF, result);
+}
+
+TEST_F(IoDelegatePosixTest, MoveFile) {
+  WriteBytes("foo", std::vector<uint8_t>{1});
+  WriteBytes("bar", std::vector<uint8_t>{2});
+  domapi::MoveFileOptions options;
+  options.no_overwrite = true;
+  int result = 0;
+  io_delegate()->MoveFile(PathOf("foo"), PathOf("bar"), options,
+                          NewBoolPromise(&result));
+  WaitForAll();
+  EXPECT_EQ(-EEXIST, result);
+
+  options.no_overwrite = false;
+  io_delegate()->MoveFile(PathOf("foo"), PathOf("bar"), options,
+                          NewBoolPromise(&result));
+  WaitForAll();
+  EXPECT_EQ(1, result);
+}
+
+// Replacing a file by a temporary file keeps mode of the replaced file.
+TEST_F(IoDelegatePosixTest, MoveFileKeepsMode) {
+  WriteBytes("foo", std::vector<uint8_t>{1});
+  const auto& foo_path = base::UTF16ToUTF8(PathOf("foo"));
+  ASSERT_EQ(0, ::chmod(foo_path.c_str(), 0751));
+
+  base::string16 temp_name;
+  domapi::MakeTempFileNamePromise promise;
+  promise.resolve = base::BindOnce(
+      [](base::string16* result, base::string16 name) { *result = name; },
+      &temp_name);
+  io_delegate()->MakeTempFileName(PathOf("."), L"foo", std::move(promise));
+  base::RunLoop().RunUntilIdle();
+  ASSERT_FALSE(temp_name.empty());
+  const auto& temp_path = base::UTF16ToUTF8(temp_name);
+  const auto mask = ::umask(022);
+  ::umask(mask);
+  struct stat temp_stat;
+  ASSERT_EQ(0, ::stat(temp_path.c_str(), &temp_stat));
+  EXPECT_EQ(0666u & ~mask, temp_stat.st_mode & 07777u)
+      << "Temporary file has mode of new file rather than 0600.";
+
+  domapi::MoveFileOptions options;
+  int result = 0;
+  io_delegate()->MoveFile(temp_name, PathOf("foo"), options,
+                          NewBoolPromise(&result));
+  WaitForAll();
+  EXPECT_EQ(1, result);
+  struct stat foo_stat;
+  ASSERT_EQ(0, ::stat(foo_path.c_str(), &foo_stat));
+  EXPECT_EQ(0751u, foo_stat.st_mode & 07777u);
+  EXPECT_EQ(0u, foo_stat.st_size);
+}
+
+TEST_F(IoDelegatePosixTest, OpenFileNotFound) {
+  int error = 0;
+  domapi::OpenFilePromise promise;
+  promise.reject =
+      base::BindOnce([](int* error, domapi::IoError io_error) {
+        *error = io_error.error_code;
+      }, &error);
+  io_delegate()->OpenFile(PathOf("not_found"), base::string16(),
+                          std::move(promise));
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(ENOENT, error);
+}
+
+// Reads a file by several reads in flight.
+TEST_F(IoDelegatePosixTest, ReadFile) {
+  const size_t kChunkSize = 4096;
+  const size_t kNumChunks = 8;
+  std::vector<uint8_t> bytes(kChunkSize * kNumChunks - 1);
+  for (size_t index = 0; index < bytes.size(); ++index)
+    bytes[index] = static_cast<uint8_t>(index * 7);
+  WriteBytes("foo", bytes);
+
+  const auto& file_id = OpenFile("foo", "r");
+  std::vector<uint8_t> buffer(kChunkSize * (kNumChunks + 1));
+  std::vector<int> results(kNumChunks + 1);
+  for (size_t index = 0; index <= kNumChunks; ++index) {
+    io_delegate()->ReadFile(file_id, &buffer[index * kChunkSize], kChunkSize,
+                            NewIntPromise(&results[index]));
+  }
+  WaitForAll();
+
+  for (size_t index = 0; index < kNumChunks - 1; ++index)
+    EXPECT_EQ(static_cast<int>(kChunkSize), results[index]) << index;
+  EXPECT_EQ(static_cast<int>(kChunkSize - 1), results[kNumChunks - 1]);
+  EXPECT_EQ(0, results[kNumChunks]) << "End of file";
+  buffer.resize(bytes.size());
+  EXPECT_EQ(bytes, buffer);
+
+  int result = -1;
+  io_delegate()->CloseContext(file_id, NewIntPromise(&result));
+  WaitForAll();
+  EXPECT_EQ(0, result);
+}
+
+TEST_F(IoDelegatePosixTest, WriteFile) {
+  const auto& file_id = OpenFile("foo", "w");
+  std::vector<uint8_t> bytes1{'f', 'o', 'o'};
+  std::vector<uint8_t> bytes2{'b', 'a', 'r'};
+  int result1 = 0;
+  int result2 = 0;
+  int result3 = -1;
+  io_delegate()->WriteFile(file_id, bytes1.data(), bytes1.size(),
+                           NewIntPromise(&result1));
+  io_delegate()->WriteFile(file_id, bytes2.data(), bytes2.size(),
+                           NewIntPromise(&result2));
+  // |CloseContext()| waits for writes in flight.
+  io_delegate()->CloseContext(file_id, NewIntPromise(&result3));
+  WaitForAll();
+  EXPECT_EQ(3, result1);
+  EXPECT_EQ(3, result2);
+  EXPECT_EQ(0, result3);
+
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(
+      base::FilePath(base::UTF16ToUTF8(PathOf("foo"))), &contents));
+  EXPECT_EQ("foobar", contents);
+}
+
+}  // namespace io
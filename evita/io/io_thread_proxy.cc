@@ -127,16 +127,25 @@ DEFINE_DELEGATE_3(ReadDirectory,
                   domapi::IoContextId,
                   size_t,
                   domapi::ReadDirectoryPromise)
+DEFINE_DELEGATE_2(ReadDirectoryChanges,
+                  domapi::IoContextId,
+                  domapi::ReadDirectoryChangesPromise)
 DEFINE_DELEGATE_4(ReadFile,
                   domapi::IoContextId,
                   void*,
                   size_t,
                   domapi::IoIntPromise)
 DEFINE_DELEGATE_2(RemoveFile, const base::string16&, domapi::IoBoolPromise)
+DEFINE_DELEGATE_2(ScanDirectory,
+                  const base::string16&,
+                  domapi::OpenDirectoryPromise)
 DEFINE_DELEGATE_4(WriteFile,
                   domapi::IoContextId,
                   void*,
                   size_t,
                   domapi::IoIntPromise)
+DEFINE_DELEGATE_2(WatchDirectory,
+                  const base::string16&,
+                  domapi::OpenDirectoryPromise)
 
 }  // namespace io
@@ -59,16 +59,22 @@ class IoThreadProxy : public domapi::IoDelegate {
   void ReadDirectory(domapi::IoContextId context_id,
                      size_t num_read,
                      domapi::ReadDirectoryPromise promise) final;
+  void ReadDirectoryChanges(domapi::IoContextId context_id,
+                            domapi::ReadDirectoryChangesPromise promise) final;
   void ReadFile(domapi::IoContextId context_id,
                 void* buffer,
                 size_t num_read,
                 domapi::IoIntPromise promise) final;
   void RemoveFile(const base::string16& file_name,
                   domapi::IoBoolPromise resolver) final;
+  void ScanDirectory(const base::string16& dir_name,
+                     domapi::OpenDirectoryPromise promise) final;
   void WriteFile(domapi::IoContextId context_id,
                  void* buffer,
                  size_t num_write,
                  domapi::IoIntPromise promise) final;
+  void WatchDirectory(const base::string16& dir_name,
+                      domapi::OpenDirectoryPromise promise) final;
 
   domapi::IoDelegate* const delegate_;
   base::Thread* const thread_;
@@ -6,143 +6,164 @@
 
 #include <windows.h>
 
+#include <memory>
 #include <utility>
 #include <vector>
 
 #include "base/bind.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
-#include "base/threading/thread.h"
 #include "base/trace_event/trace_event.h"
 #include "evita/dom/public/io_error.h"
 #include "evita/dom/public/promise.h"
+#include "evita/editor/application.h"
 #include "evita/io/io_context_utils.h"
+#include "evita/io/io_manager.h"
 
 namespace io {
 
-ProcessIoContext::ProcessIoContext(domapi::IoContextId context_id,
-                                   const base::string16& command_line,
-                                   domapi::OpenProcessPromise promise)
-    : gateway_thread_(new base::Thread("process")) {
-  TRACE_EVENT_ASYNC_BEGIN1("io", "ProcessContext", this, "command_line",
-                           base::UTF16ToUTF8(command_line).c_str());
-  gateway_thread_->Start();
-  gateway_thread_->task_runner()->PostTask(
-      FROM_HERE,
-      base::BindOnce(&ProcessIoContext::StartProcess, base::Unretained(this),
-                     context_id, command_line, std::move(promise)));
+namespace {
+
+// Size of |ProcessIoContext::output_|, which holds output not yet taken by
+// |Read()|.
+const size_t kOutputBufferSize = 256 * 1024;
+
+// Size of pipe buffers in the system.
+const DWORD kPipeBufferSize = 64 * 1024;
+
+// Creates a pipe whose |server| end is opened for overlapped I/O and
+// |client| end is inherited by child process, since anonymous pipes don't
+// support overlapped I/O. |direction| is |PIPE_ACCESS_INBOUND| or
+// |PIPE_ACCESS_OUTBOUND| for the |server| end.
+uint32_t CreateOverlappedPipe(DWORD direction,
+                              common::win::scoped_handle* server,
+                              common::win::scoped_handle* client) {
+  static int serial_number;
+  ++serial_number;
+  const auto& pipe_name =
+      base::StringPrintf(L"\\\\.\\pipe\\evita.%lu.%d",
+                         ::GetCurrentProcessId(), serial_number);
+  server->reset(::CreateNamedPipeW(
+      pipe_name.c_str(),
+      direction | FILE_FLAG_FIRST_PIPE_INSTANCE | FILE_FLAG_OVERLAPPED,
+      PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, 1,
+      kPipeBufferSize, kPipeBufferSize, 0, nullptr));
+  if (!server->is_valid()) {
+    const auto last_error = ::GetLastError();
+    PLOG(ERROR) << "CreateNamedPipeW " << pipe_name << " failed";
+    return last_error;
+  }
+  SECURITY_ATTRIBUTES security_attributes = {0};
+  security_attributes.nLength = sizeof(security_attributes);
+  security_attributes.bInheritHandle = true;
+  client->reset(::CreateFileW(
+      pipe_name.c_str(),
+      direction == PIPE_ACCESS_INBOUND ? GENERIC_WRITE : GENERIC_READ, 0,
+      &security_attributes, OPEN_EXISTING, 0, nullptr));
+  if (!client->is_valid()) {
+    const auto last_error = ::GetLastError();
+    PLOG(ERROR) << "CreateFileW " << pipe_name << " failed";
+    return last_error;
+  }
+  return 0;
 }
 
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// ProcessIoContext::Request
+// Holds |OVERLAPPED| of a write in flight.
+//
+struct ProcessIoContext::Request final : base::MessagePumpForIO::IOContext {
+  explicit Request(domapi::IoIntPromise promise)
+      : promise(std::move(promise)) {}
+
+  domapi::IoIntPromise promise;
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// ProcessIoContext
+//
+ProcessIoContext::ProcessIoContext() : output_(kOutputBufferSize) {}
+
 ProcessIoContext::~ProcessIoContext() {
-  TRACE_EVENT_ASYNC_END0("io", "ProcessContext", this);
+  DCHECK(!num_pending_);
+  TRACE_EVENT_ASYNC_END2("io", "ProcessContext", this, "num_output_bytes",
+                         num_output_bytes_, "num_stalls", num_stalls_);
 }
 
-void ProcessIoContext::CloseAndWaitProcess(domapi::IoIntPromise promise) {
-  TRACE_EVENT0("io", "ProcessIoContext::CloseAndWaitProcess");
-  TRACE_EVENT_WITH_FLOW1("promise", "Promise", promise.sequence_num,
-                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT,
-                         "step", "ProcessIoContext::CloseAndWaitProcess");
-  if (auto const last_error = CloseProcess()) {
-    Reject(std::move(promise.reject), last_error);
+// Deletes this context after all requests in flight are finished and the
+// process is exited.
+void ProcessIoContext::FinishCloseIfDone() {
+  if (!is_closing_ || num_pending_ || process_.is_valid())
     return;
-  }
-
-  if (process_.is_valid()) {
-    auto const value = ::WaitForSingleObject(process_.get(), INFINITE);
-    if (value == WAIT_FAILED) {
-      const auto last_error = ::GetLastError();
-      PLOG(ERROR) << "WaitSingleObject failed";
-      Reject(std::move(promise.reject), last_error);
-      return;
-    }
-    process_.release();
-  }
-  Resolve(std::move(promise.resolve), 0u);
+  const auto elapsed = base::TimeTicks::Now() - start_time_;
+  DVLOG(1) << "Process output " << num_output_bytes_ << " bytes in "
+           << elapsed.InMillisecondsF() << "ms, stalled " << num_stalls_
+           << " times.";
+  Resolve(std::move(close_promise_.resolve), 0u);
+  delete this;
 }
 
-uint32_t ProcessIoContext::CloseProcess() {
-  TRACE_EVENT0("io", "ProcessIoContext::CloseProcess");
-  if (stdout_read_.is_valid()) {
-    if (!::CloseHandle(stdout_read_.get())) {
-      const auto last_error = ::GetLastError();
-      PLOG(ERROR) << "CloseHandle failed";
-      return last_error;
-    }
-    stdout_read_.release();
-  }
-  if (stdin_write_.is_valid()) {
-    if (!::CloseHandle(stdin_write_.get())) {
-      const auto last_error = ::GetLastError();
-      PLOG(ERROR) << "CloseHandle failed";
-      return last_error;
-    }
-    stdin_write_.release();
+// Reads stdout into free space of |output_|. When |output_| is full, we
+// resume reading after |Read()| takes output.
+void ProcessIoContext::ReadOutput() {
+  if (is_reading_ || output_error_ || !stdout_read_.is_valid())
+    return;
+  size_t num_bytes = 0;
+  auto* const space = output_.GetWritableSpace(&num_bytes);
+  if (!num_bytes) {
+    ++num_stalls_;
+    TRACE_EVENT_INSTANT1("io", "ProcessIoContext::Stall",
+                         TRACE_EVENT_SCOPE_THREAD, "num_stalls", num_stalls_);
+    return;
   }
-  if (gateway_thread_->IsRunning())
-    gateway_thread_->message_loop()->task_runner()->PostTask(
-        FROM_HERE, base::MessageLoop::QuitWhenIdleClosure());
-  return 0;
+  ::ZeroMemory(&read_context_.overlapped, sizeof(read_context_.overlapped));
+  is_reading_ = true;
+  ++num_pending_;
+  auto const succeeded =
+      ::ReadFile(stdout_read_.get(), space, static_cast<DWORD>(num_bytes),
+                 nullptr, &read_context_.overlapped);
+  // Note: Completion port receives a packet for a request completed
+  // synchronously too.
+  if (succeeded)
+    return;
+  auto const error = ::GetLastError();
+  if (error == ERROR_IO_PENDING)
+    return;
+  OnIOCompleted(&read_context_, 0, error);
 }
 
-void ProcessIoContext::ReadFromProcess(void* buffer,
-                                       size_t num_read,
-                                       domapi::IoIntPromise promise) {
-  TRACE_EVENT_WITH_FLOW1("promise", "ProcessIoContext::ReadFromProcess",
-                         promise.sequence_num,
-                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT,
-                         "step", "ProcessIoContext::ReadFromProcess");
-  DWORD read;
-  auto const succeeded = ::ReadFile(
-      stdout_read_.get(), buffer, static_cast<DWORD>(num_read), &read, nullptr);
-  if (!succeeded) {
-    const auto last_error = ::GetLastError();
-    PLOG(ERROR) << "ReadFile failed";
-    if (last_error == ERROR_BROKEN_PIPE)
-      CloseProcess();
-    Reject(std::move(promise.reject), last_error);
+void ProcessIoContext::ServeRead() {
+  if (!read_buffer_)
     return;
+  if (output_.empty()) {
+    if (!output_error_)
+      return;
+    read_buffer_ = nullptr;
+    if (output_error_ == ERROR_HANDLE_EOF)
+      return Resolve(std::move(read_promise_.resolve), 0u);
+    return Reject(std::move(read_promise_.reject), output_error_);
   }
-  Resolve(std::move(promise.resolve), read);
+  const auto num_read = output_.Read(read_buffer_, read_size_);
+  read_buffer_ = nullptr;
+  Resolve(std::move(read_promise_.resolve), static_cast<uint32_t>(num_read));
 }
 
-void ProcessIoContext::StartProcess(domapi::IoContextId context_id,
-                                    const base::string16& command_line,
-                                    domapi::OpenProcessPromise promise) {
-  TRACE_EVENT_WITH_FLOW1("promise", "ProcessIoContext::StartProcess",
-                         promise.sequence_num,
-                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT,
-                         "step", "ProcessIoContext::StartProcess");
-  SECURITY_ATTRIBUTES security_attributes = {0};
-  security_attributes.nLength = sizeof(security_attributes);
-  security_attributes.bInheritHandle = true;
+uint32_t ProcessIoContext::Start(const base::string16& command_line) {
+  TRACE_EVENT_ASYNC_BEGIN1("io", "ProcessContext", this, "command_line",
+                           base::UTF16ToUTF8(command_line));
   common::win::scoped_handle stdin_read;
-  common::win::scoped_handle stdin_write;
-  if (!::CreatePipe(stdin_read.location(), stdin_write.location(),
-                    &security_attributes, 0)) {
-    const auto last_error = ::GetLastError();
-    PLOG(ERROR) << "CreatePipe failed";
-    Reject(std::move(promise.reject), last_error);
-    return;
-  }
-  if (!::SetHandleInformation(stdin_write.get(), HANDLE_FLAG_INHERIT, 0)) {
-    const auto last_error = ::GetLastError();
-    PLOG(ERROR) << "SetHandleInformation failed";
-    Reject(std::move(promise.reject), last_error);
-    return;
+  if (auto const error = CreateOverlappedPipe(PIPE_ACCESS_OUTBOUND,
+                                              &stdin_write_, &stdin_read)) {
+    return error;
   }
-  common::win::scoped_handle stdout_read;
   common::win::scoped_handle stdout_write;
-  if (!::CreatePipe(stdout_read.location(), stdout_write.location(),
-                    &security_attributes, 0)) {
-    const auto last_error = ::GetLastError();
-    PLOG(ERROR) << "CreatePipe failed";
-    Reject(std::move(promise.reject), last_error);
-    return;
-  }
-  if (!::SetHandleInformation(stdout_read.get(), HANDLE_FLAG_INHERIT, 0)) {
-    const auto last_error = ::GetLastError();
-    PLOG(ERROR) << "SetHandleInformation failed";
-    Reject(std::move(promise.reject), last_error);
-    return;
+  if (auto const error = CreateOverlappedPipe(PIPE_ACCESS_INBOUND,
+                                              &stdout_read_, &stdout_write)) {
+    return error;
   }
 
   PROCESS_INFORMATION process_info;
@@ -164,97 +185,134 @@ void ProcessIoContext::StartProcess(domapi::IoContextId context_id,
   if (!succeeded) {
     const auto last_error = ::GetLastError();
     PLOG(ERROR) << "CreateProcessW failed";
-    Reject(std::move(promise.reject), last_error);
-    return;
+    return last_error;
   }
   ::ResumeThread(process_info.hThread);
   process_.reset(process_info.hProcess);
   ::CloseHandle(process_info.hThread);
-  RunCallback(base::BindOnce(std::move(promise.resolve),
-                             domapi::ProcessId(context_id)));
-  stdin_read.release();
-  stdin_write_.reset(stdin_write.release());
-  stdout_write.release();
-  stdout_read_.reset(stdout_read.release());
+
+  auto* const io_manager = editor::Application::instance()->io_manager();
+  io_manager->RegisterIoHandler(stdin_write_.get(), this);
+  io_manager->RegisterIoHandler(stdout_read_.get(), this);
+  start_time_ = base::TimeTicks::Now();
+  ReadOutput();
+  return 0;
 }
 
-void ProcessIoContext::WriteToProcess(void* buffer,
-                                      size_t num_write,
-                                      domapi::IoIntPromise promise) {
-  TRACE_EVENT_WITH_FLOW1("promise", "ProcessIoContext::WriteToProcess",
-                         promise.sequence_num,
-                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT,
-                         "step", "ProcessIoContext::WriteToProcess");
-  DWORD written;
-  auto const succeeded =
-      ::WriteFile(stdin_write_.get(), buffer, static_cast<DWORD>(num_write),
-                  &written, nullptr);
-  if (!succeeded) {
-    const auto last_error = ::GetLastError();
-    PLOG(ERROR) << "WriteFile failed";
-    if (last_error == ERROR_BROKEN_PIPE)
-      CloseProcess();
-    Reject(std::move(promise.reject), last_error);
+// base::MessagePumpForIO::IOHandler
+void ProcessIoContext::OnIOCompleted(IOContext* context,
+                                     DWORD bytes_transferred,
+                                     DWORD error) {
+  DCHECK_GT(num_pending_, 0);
+  --num_pending_;
+  if (context == &read_context_) {
+    TRACE_EVENT1("io", "ProcessIoContext::OnIOCompleted", "bytes_transferred",
+                 bytes_transferred);
+    is_reading_ = false;
+    if (error == ERROR_BROKEN_PIPE || error == ERROR_HANDLE_EOF ||
+        error == ERROR_OPERATION_ABORTED) {
+      output_error_ = ERROR_HANDLE_EOF;
+    } else if (error) {
+      PLOG(ERROR) << "ReadFile failed";
+      output_error_ = error;
+    } else {
+      output_.Commit(bytes_transferred);
+      num_output_bytes_ += bytes_transferred;
+      TRACE_COUNTER_ID1("io", "ProcessOutputBytes", this, num_output_bytes_);
+    }
+    if (is_closing_)
+      return FinishCloseIfDone();
+    ServeRead();
+    ReadOutput();
     return;
   }
-  Resolve(std::move(promise.resolve), written);
+
+  std::unique_ptr<Request> request(static_cast<Request*>(context));
+  TRACE_EVENT_WITH_FLOW1("promise", "ProcessIoContext::OnIOCompleted",
+                         request->promise.sequence_num,
+                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT,
+                         "bytes_transferred", bytes_transferred);
+  if (error)
+    Reject(std::move(request->promise.reject), error);
+  else
+    Resolve(std::move(request->promise.resolve), bytes_transferred);
+  FinishCloseIfDone();
+}
+
+// base::win::ObjectWatcher::Delegate
+void ProcessIoContext::OnObjectSignaled(HANDLE object) {
+  DCHECK_EQ(process_.get(), object);
+  TRACE_EVENT0("io", "ProcessIoContext::OnObjectSignaled");
+  ::CloseHandle(process_.release());
+  FinishCloseIfDone();
 }
 
 // io::IoContext
+// Closing pipes cancels requests in flight and lets the child process see
+// end of stdin, then we resolve |promise| after the process is exited.
 void ProcessIoContext::Close(domapi::IoIntPromise promise) {
-  TRACE_EVENT0("io", "ProcessIoContext::Close");
-  if (!gateway_thread_->IsRunning()) {
-    Reject(std::move(promise.reject), ERROR_INVALID_HANDLE);
-    return;
+  TRACE_EVENT_WITH_FLOW0("promise", "ProcessIoContext::Close",
+                         promise.sequence_num,
+                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT);
+  if (is_closing_)
+    return Reject(std::move(promise.reject), ERROR_INVALID_HANDLE);
+  is_closing_ = true;
+  close_promise_ = std::move(promise);
+  if (read_buffer_) {
+    read_buffer_ = nullptr;
+    Reject(std::move(read_promise_.reject), ERROR_OPERATION_ABORTED);
   }
-  gateway_thread_->task_runner()->PostTask(
-      FROM_HERE, base::BindOnce(&ProcessIoContext::CloseAndWaitProcess,
-                                base::Unretained(this), std::move(promise)));
+  if (stdin_write_.is_valid())
+    ::CloseHandle(stdin_write_.release());
+  if (stdout_read_.is_valid())
+    ::CloseHandle(stdout_read_.release());
+  if (process_.is_valid() &&
+      !process_watcher_.StartWatchingOnce(process_.get(), this)) {
+    PLOG(ERROR) << "StartWatchingOnce failed";
+    ::CloseHandle(process_.release());
+  }
+  FinishCloseIfDone();
 }
 
+// io::BlockIoContext
 void ProcessIoContext::Read(void* buffer,
                             size_t num_read,
                             domapi::IoIntPromise promise) {
-  if (!gateway_thread_->IsRunning() || !stdout_read_.is_valid()) {
-    Reject(std::move(promise.reject), ERROR_INVALID_HANDLE);
-    return;
-  }
-  gateway_thread_->task_runner()->PostTask(
-      FROM_HERE,
-      base::BindOnce(&ProcessIoContext::ReadFromProcess, base::Unretained(this),
-                     base::Unretained(buffer), num_read, std::move(promise)));
+  TRACE_EVENT_WITH_FLOW0("promise", "ProcessIoContext::Read",
+                         promise.sequence_num,
+                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT);
+  if (is_closing_)
+    return Reject(std::move(promise.reject), ERROR_INVALID_HANDLE);
+  if (read_buffer_)
+    return Reject(std::move(promise.reject), ERROR_BUSY);
+  read_buffer_ = buffer;
+  read_promise_ = std::move(promise);
+  read_size_ = num_read;
+  ServeRead();
+  // |output_| may have free space now.
+  ReadOutput();
 }
 
 void ProcessIoContext::Write(void* buffer,
                              size_t num_write,
                              domapi::IoIntPromise promise) {
-  if (!gateway_thread_->IsRunning() || !stdin_write_.is_valid()) {
-    Reject(std::move(promise.reject), ERROR_INVALID_HANDLE);
+  TRACE_EVENT_WITH_FLOW0("promise", "ProcessIoContext::Write",
+                         promise.sequence_num,
+                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT);
+  if (is_closing_ || !stdin_write_.is_valid())
+    return Reject(std::move(promise.reject), ERROR_INVALID_HANDLE);
+  auto const request = new Request(std::move(promise));
+  ++num_pending_;
+  auto const succeeded =
+      ::WriteFile(stdin_write_.get(), buffer, static_cast<DWORD>(num_write),
+                  nullptr, &request->overlapped);
+  if (succeeded)
     return;
-  }
-
-#if 0
-  // TODO(eval1749): Since http://crrev.com/406831,
-  // |base::Thread::thread_handle()| is no long avaialble, we should find the
-  // way to have thread handle.
-  // Abort blocked read pipe operation.
-  // We'll get ERROR_OPERATION_ABORTED(995).
-  auto const hThread = reinterpret_cast<HANDLE>(
-      gateway_thread_->thread_handle().platform_handle());
-  if (!::CancelSynchronousIo(hThread)) {
-    const auto last_error = ::GetLastError();
-    if (last_error != ERROR_NOT_FOUND) {
-      PLOG(ERROR) << "CancelSynchronousIo failed";
-      Reject(std::move(promise.reject), last_error);
-      return;
-    }
-  }
-#endif
-
-  gateway_thread_->task_runner()->PostTask(
-      FROM_HERE,
-      base::BindOnce(&ProcessIoContext::WriteToProcess, base::Unretained(this),
-                     base::Unretained(buffer), num_write, std::move(promise)));
+  auto const error = ::GetLastError();
+  if (error == ERROR_IO_PENDING)
+    return;
+  PLOG(ERROR) << "WriteFile failed";
+  OnIOCompleted(request, 0, error);
 }
 
 }  // namespace io
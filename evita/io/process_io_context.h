@@ -5,54 +5,90 @@
 #ifndef EVITA_IO_PROCESS_IO_CONTEXT_H_
 #define EVITA_IO_PROCESS_IO_CONTEXT_H_
 
-#include <memory>
+#include <stdint.h>
 
 #include "base/macros.h"
+#include "base/message_loop/message_pump_win.h"
 #include "base/strings/string16.h"
+#include "base/time/time.h"
+#include "base/win/object_watcher.h"
 #include "common/win/scoped_handle.h"
-#include "evita//io/block_io_context.h"
-#include "evita/dom/public/io_context_id.h"
-
-namespace base {
-class Thread;
-}
+#include "evita/dom/public/promise.h"
+#include "evita/io/block_io_context.h"
+#include "evita/io/byte_ring_buffer.h"
 
 namespace io {
 
-class ProcessIoContext final : public BlockIoContext {
+//////////////////////////////////////////////////////////////////////
+//
+// ProcessIoContext
+// Runs a child process whose stdin and stdout, also used for stderr, are
+// overlapped pipes served by the completion port of the I/O thread, so we
+// don't need a thread for each process.
+//
+// The context keeps reading stdout into |output_| while it has free space,
+// and |Read()| takes all output buffered so far. When the reader lags,
+// |output_| becomes full and we stop reading stdout, then the child process
+// blocks on writing to stdout until the reader catches up.
+//
+class ProcessIoContext final : private base::MessagePumpForIO::IOHandler,
+                               private base::win::ObjectWatcher::Delegate,
+                               public BlockIoContext {
   DECLARE_DEPRECATED_CASTABLE_CLASS(ProcessIoContext, BlockIoContext);
 
  public:
-  ProcessIoContext(domapi::IoContextId context_id,
-                   const base::string16& command_line,
-                   domapi::OpenProcessPromise promise);
-  ~ProcessIoContext();
+  ProcessIoContext();
+  ~ProcessIoContext() final;
+
+  // Starts |command_line| and returns zero, or error code on failure.
+  uint32_t Start(const base::string16& command_line);
 
  private:
-  void CloseAndWaitProcess(domapi::IoIntPromise promise);
-  uint32_t CloseProcess();
-  void ReadFromProcess(void* buffer,
-                       size_t num_read,
-                       domapi::IoIntPromise promise);
-  void StartProcess(domapi::IoContextId context_id,
-                    const base::string16& command_line,
-                    domapi::OpenProcessPromise promise);
-  void WriteToProcess(void* buffer,
-                      size_t num_read,
-                      domapi::IoIntPromise promise);
+  struct Request;
+
+  void FinishCloseIfDone();
+  void ReadOutput();
+  // Resolves pending |Read()| with buffered output.
+  void ServeRead();
+
+  // base::MessagePumpForIO::IOHandler
+  void OnIOCompleted(IOContext* context,
+                     DWORD bytes_transfered,
+                     DWORD error) final;
+
+  // base::win::ObjectWatcher::Delegate
+  void OnObjectSignaled(HANDLE object) final;
 
   // io::IoContext
-  void Close(domapi::IoIntPromise promise) override;
+  void Close(domapi::IoIntPromise promise) final;
+
+  // io::BlockIoContext
   void Read(void* buffer,
             size_t num_read,
-            domapi::IoIntPromise promise) override;
+            domapi::IoIntPromise promise) final;
   void Write(void* buffer,
              size_t num_write,
-             domapi::IoIntPromise promise) override;
+             domapi::IoIntPromise promise) final;
 
-  domapi::IoContextId context_id_;
-  std::unique_ptr<base::Thread> gateway_thread_;
+  domapi::IoIntPromise close_promise_;
+  bool is_closing_ = false;
+  bool is_reading_ = false;
+  // Number of overlapped requests in flight, including read of stdout.
+  int num_pending_ = 0;
+  // Number of times |output_| became full.
+  int num_stalls_ = 0;
+  int64_t num_output_bytes_ = 0;
+  ByteRingBuffer output_;
+  // |ERROR_HANDLE_EOF| at end of output, or error code of reading stdout.
+  DWORD output_error_ = 0;
   common::win::scoped_handle process_;
+  base::win::ObjectWatcher process_watcher_;
+  // |Read()| waiting for output.
+  void* read_buffer_ = nullptr;
+  base::MessagePumpForIO::IOContext read_context_;
+  domapi::IoIntPromise read_promise_;
+  size_t read_size_ = 0;
+  base::TimeTicks start_time_;
   common::win::scoped_handle stdin_write_;
   common::win::scoped_handle stdout_read_;
 
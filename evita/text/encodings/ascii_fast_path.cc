@@ -0,0 +1,57 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+
+#include "evita/text/encodings/ascii_fast_path.h"
+
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+namespace encodings {
+
+namespace {
+
+const uint64_t kNonAsciiMask = 0x8080808080808080ull;
+
+}  // namespace
+
+size_t DecodeAscii(const uint8_t* bytes,
+                   size_t num_bytes,
+                   base::char16* output) {
+  size_t index = 0;
+#if defined(ARCH_CPU_X86_FAMILY)
+  // Widen 16 bytes at once until we see non-ASCII byte.
+  const auto zero = _mm_setzero_si128();
+  for (; index + 16 <= num_bytes; index += 16) {
+    const auto block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + index));
+    if (_mm_movemask_epi8(block))
+      break;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + index),
+                     _mm_unpacklo_epi8(block, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + index + 8),
+                     _mm_unpackhi_epi8(block, zero));
+  }
+#endif
+  for (; index + 8 <= num_bytes; index += 8) {
+    uint64_t block;
+    ::memcpy(&block, bytes + index, sizeof(block));
+    if (block & kNonAsciiMask)
+      break;
+    for (size_t offset = 0; offset < 8; ++offset)
+      output[index + offset] = bytes[index + offset];
+  }
+  for (; index < num_bytes; ++index) {
+    if (bytes[index] >= 0x80)
+      break;
+    output[index] = bytes[index];
+  }
+  return index;
+}
+
+}  // namespace encodings
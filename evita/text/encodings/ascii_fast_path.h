@@ -0,0 +1,25 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_TEXT_ENCODINGS_ASCII_FAST_PATH_H_
+#define EVITA_TEXT_ENCODINGS_ASCII_FAST_PATH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/strings/string16.h"
+
+namespace encodings {
+
+// Converts leading ASCII bytes, 0x00 to 0x7F, of |bytes| to |output| and
+// returns number of converted bytes. |output| should have at least
+// |num_bytes| characters. Decoders use this function for runs of ASCII
+// bytes, which are most of bytes in source files.
+size_t DecodeAscii(const uint8_t* bytes,
+                   size_t num_bytes,
+                   base::char16* output);
+
+}  // namespace encodings
+
+#endif  // EVITA_TEXT_ENCODINGS_ASCII_FAST_PATH_H_
@@ -10,4 +10,13 @@ Decoder::Decoder() {}
 
 Decoder::~Decoder() {}
 
+base::Either<bool, base::string16> Decoder::Decode(const uint8_t* bytes,
+                                                   size_t num_bytes,
+                                                   bool is_stream) {
+  base::string16 output(MaxCharsOf(num_bytes), 0);
+  const auto& result = DecodeTo(bytes, num_bytes, is_stream, &output[0]);
+  output.resize(result.right);
+  return base::make_either(result.left, output);
+}
+
 }  // namespace encodings
@@ -19,9 +19,22 @@ class Decoder {
 
   virtual const base::string16& name() const = 0;
 
-  virtual base::Either<bool, base::string16> Decode(const uint8_t* bytes,
-                                                    size_t num_bytes,
-                                                    bool is_stream) = 0;
+  base::Either<bool, base::string16> Decode(const uint8_t* bytes,
+                                            size_t num_bytes,
+                                            bool is_stream);
+
+  // Decodes |bytes| into |output|, which should have at least
+  // |MaxCharsOf(num_bytes)| characters, and returns number of characters
+  // written into |output|. When |bytes| contains invalid byte sequence, this
+  // function returns false with number of characters decoded so far.
+  virtual base::Either<bool, size_t> DecodeTo(const uint8_t* bytes,
+                                              size_t num_bytes,
+                                              bool is_stream,
+                                              base::char16* output) = 0;
+
+  // Returns maximum number of characters decoded from |num_bytes| bytes,
+  // including a character made of bytes kept from previous call.
+  static size_t MaxCharsOf(size_t num_bytes) { return num_bytes + 1; }
 
  protected:
   Decoder();
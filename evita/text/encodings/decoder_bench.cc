@@ -0,0 +1,97 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures throughput of decoders for mostly ASCII text, e.g. source files
+// with a few Japanese comments, decoded in 64KB chunks as |TextDocument|
+// loader does.
+//
+// Usage: decoder_bench [--iterations=N]
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#include "evita/text/encodings/decoder.h"
+#include "evita/text/encodings/encoder.h"
+#include "evita/text/encodings/encodings.h"
+
+namespace encodings {
+
+namespace {
+
+const auto kChunkSize = 64 * 1024;
+const auto kDefaultIterations = 20;
+const auto kNumberOfLines = 100000;
+
+// Returns text of |kNumberOfLines| lines. Every tenth line has Japanese
+// comment.
+base::string16 MakeText() {
+  base::string16 text;
+  for (auto line = 0; line < kNumberOfLines; ++line) {
+    text += L"  const auto& result = decoder->Decode(bytes, size, true);";
+    if (line % 10 == 0)
+      text += L"  // \u6587\u5B57\u30B3\u30FC\u30C9";
+    text += L"\r\n";
+  }
+  return text;
+}
+
+void BenchDecoder(const base::string16& name,
+                  const base::string16& text,
+                  int iterations) {
+  std::unique_ptr<Encoder> encoder(Encodings::instance()->GetEncoder(name));
+  const auto& encoded = encoder->Encode(text, false);
+  CHECK_EQ(0, encoded.left) << name;
+  const auto& bytes = encoded.right;
+
+  std::vector<base::char16> output(Decoder::MaxCharsOf(kChunkSize));
+  size_t num_chars = 0;
+  const auto& start = base::TimeTicks::Now();
+  for (auto count = 0; count < iterations; ++count) {
+    std::unique_ptr<Decoder> decoder(Encodings::instance()->GetDecoder(name));
+    for (size_t offset = 0; offset < bytes.size(); offset += kChunkSize) {
+      const auto size = std::min(bytes.size() - offset,
+                                 static_cast<size_t>(kChunkSize));
+      const auto& result =
+          decoder->DecodeTo(bytes.data() + offset, size, true, output.data());
+      CHECK(result.left) << name;
+      num_chars += result.right;
+    }
+  }
+  const auto& elapsed = base::TimeTicks::Now() - start;
+  CHECK_EQ(text.size() * iterations, num_chars) << name;
+  const auto megabytes =
+      static_cast<double>(bytes.size()) * iterations / (1024 * 1024);
+  std::cout << std::left << std::setw(12) << base::UTF16ToASCII(name)
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << megabytes / elapsed.InSecondsF() << " MB/s"
+            << std::endl;
+}
+
+}  // namespace
+
+}  // namespace encodings
+
+int main(int argc, char** argv) {
+  base::AtExitManager at_exit;
+  base::CommandLine::Init(argc, argv);
+  const auto& command_line = *base::CommandLine::ForCurrentProcess();
+  auto iterations = encodings::kDefaultIterations;
+  if (command_line.HasSwitch("iterations")) {
+    base::StringToInt(command_line.GetSwitchValueASCII("iterations"),
+                      &iterations);
+  }
+  const auto& text = encodings::MakeText();
+  for (const auto& name : {L"utf-8", L"shift_jis", L"euc-jp"})
+    encodings::BenchDecoder(name, text, iterations);
+  return 0;
+}
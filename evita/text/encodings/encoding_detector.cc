@@ -0,0 +1,255 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+
+#include "evita/text/encodings/encoding_detector.h"
+
+#include "base/logging.h"
+
+namespace encodings {
+
+namespace {
+
+const uint8_t kUtf8Bom[] = {0xEF, 0xBB, 0xBF};
+
+// Confidence of |EncodingDetector::is_decided()|.
+const int kDecidedConfidence = 90;
+
+// Score margin between the best candidate and the second one for 100%
+// confidence.
+const int kDecidedMargin = 64;
+
+// Score of a double-byte character of Shift_JIS and EUC-JP.
+const int kDoubleByteScore = 1;
+
+// Additional score of hiragana and katakana, which are the most frequent
+// characters in Japanese text.
+const int kKanaScore = 2;
+
+// Score of UTF-8 BOM. It is large enough to make UTF-8 decided.
+const int kBomScore = kDecidedMargin * 16;
+
+// Score of a multi-byte UTF-8 sequence. Random bytes rarely form valid
+// UTF-8 sequences, so valid sequences are stronger evidence than Shift_JIS
+// and EUC-JP double-byte characters.
+const int kUtf8Score = 8;
+
+bool InRange(uint8_t byte, uint8_t min, uint8_t max) {
+  return byte >= min && byte <= max;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// EncodingDetector
+//
+EncodingDetector::EncodingDetector() {
+  candidates_[kUtf8].name = L"utf-8";
+  candidates_[kShiftJis].name = L"shift_jis";
+  candidates_[kEucJp].name = L"euc-jp";
+}
+
+EncodingDetector::~EncodingDetector() {}
+
+int EncodingDetector::confidence() const {
+  if (is_ascii())
+    return 0;
+  const auto& candidates = SortedCandidates();
+  if (candidates.empty())
+    return 0;
+  if (candidates.size() == 1)
+    return 100;
+  const auto margin = candidates[0]->score - candidates[1]->score;
+  return std::min(100, margin * 100 / kDecidedMargin);
+}
+
+base::string16 EncodingDetector::encoding() const {
+  const auto& candidates = SortedCandidates();
+  return candidates.empty() ? base::string16() : candidates[0]->name;
+}
+
+bool EncodingDetector::is_decided() const {
+  return confidence() >= kDecidedConfidence;
+}
+
+bool EncodingDetector::is_idle() const {
+  for (const auto& candidate : candidates_) {
+    if (candidate.num_bytes_needed)
+      return false;
+  }
+  return true;
+}
+
+std::vector<base::string16> EncodingDetector::Candidates() const {
+  std::vector<base::string16> names;
+  for (const auto* candidate : SortedCandidates())
+    names.push_back(candidate->name);
+  return names;
+}
+
+void EncodingDetector::Feed(const uint8_t* bytes, size_t num_bytes) {
+  auto const bytes_end = bytes + num_bytes;
+  auto can_skip_ascii = is_idle();
+  for (auto runner = bytes; runner < bytes_end; ++runner) {
+    auto const byte = *runner;
+    if (num_bytes_ < arraysize(kUtf8Bom)) {
+      if (num_bom_bytes_ == num_bytes_ && byte == kUtf8Bom[num_bytes_]) {
+        ++num_bom_bytes_;
+        if (num_bom_bytes_ == arraysize(kUtf8Bom))
+          candidates_[kUtf8].score += kBomScore;
+      }
+      ++num_bytes_;
+    }
+    // All candidates accept ASCII bytes between characters as is.
+    if (byte < 0x80 && can_skip_ascii)
+      continue;
+    if (byte >= 0x80)
+      ++num_non_ascii_bytes_;
+    ScanUtf8(byte);
+    ScanShiftJis(byte);
+    ScanEucJp(byte);
+    can_skip_ascii = is_idle();
+  }
+}
+
+// EUC-JP
+//  0x8E 0xA1-0xDF              half-width katakana
+//  0x8F 0xA1-0xFE 0xA1-0xFE    JIS X 0212
+//  0xA1-0xFE 0xA1-0xFE         JIS X 0208, hiragana are 0xA4 and katakana
+//                              are 0xA5.
+void EncodingDetector::ScanEucJp(uint8_t byte) {
+  auto& candidate = candidates_[kEucJp];
+  if (!candidate.is_valid)
+    return;
+  if (candidate.num_bytes_needed) {
+    auto const max_byte = candidate.lead_byte == 0x8E ? 0xDF : 0xFE;
+    if (!InRange(byte, 0xA1, max_byte)) {
+      candidate.Invalidate();
+      return;
+    }
+    --candidate.num_bytes_needed;
+    if (candidate.num_bytes_needed || candidate.lead_byte == 0x8E)
+      return;
+    candidate.score += kDoubleByteScore;
+    if (candidate.lead_byte == 0xA4 || candidate.lead_byte == 0xA5)
+      candidate.score += kKanaScore;
+    return;
+  }
+  if (byte < 0x80)
+    return;
+  candidate.lead_byte = byte;
+  if (byte == 0x8E || InRange(byte, 0xA1, 0xFE)) {
+    candidate.num_bytes_needed = 1;
+    return;
+  }
+  if (byte == 0x8F) {
+    candidate.num_bytes_needed = 2;
+    return;
+  }
+  candidate.Invalidate();
+}
+
+// Shift_JIS
+//  0xA1-0xDF                                   half-width katakana
+//  0x81-0x9F, 0xE0-0xFC 0x40-0x7E, 0x80-0xFC   JIS X 0208, hiragana are
+//                                              0x82 0x9F-0xF1 and katakana
+//                                              are 0x83 0x40-0x96.
+void EncodingDetector::ScanShiftJis(uint8_t byte) {
+  auto& candidate = candidates_[kShiftJis];
+  if (!candidate.is_valid)
+    return;
+  if (candidate.num_bytes_needed) {
+    if (!InRange(byte, 0x40, 0x7E) && !InRange(byte, 0x80, 0xFC)) {
+      candidate.Invalidate();
+      return;
+    }
+    candidate.num_bytes_needed = 0;
+    candidate.score += kDoubleByteScore;
+    if ((candidate.lead_byte == 0x82 && InRange(byte, 0x9F, 0xF1)) ||
+        (candidate.lead_byte == 0x83 && InRange(byte, 0x40, 0x96))) {
+      candidate.score += kKanaScore;
+    }
+    return;
+  }
+  if (byte < 0x80 || InRange(byte, 0xA1, 0xDF))
+    return;
+  if (InRange(byte, 0x81, 0x9F) || InRange(byte, 0xE0, 0xFC)) {
+    candidate.lead_byte = byte;
+    candidate.num_bytes_needed = 1;
+    return;
+  }
+  candidate.Invalidate();
+}
+
+// UTF-8, see "utf8_decoder.cc". We reject overlong sequences, surrogates
+// and code points larger than U+10FFFF by checking the second byte.
+void EncodingDetector::ScanUtf8(uint8_t byte) {
+  auto& candidate = candidates_[kUtf8];
+  if (!candidate.is_valid)
+    return;
+  if (candidate.num_bytes_needed) {
+    auto min_byte = 0x80;
+    auto max_byte = 0xBF;
+    switch (candidate.lead_byte) {
+      case 0xE0:
+        min_byte = 0xA0;
+        break;
+      case 0xED:
+        max_byte = 0x9F;
+        break;
+      case 0xF0:
+        min_byte = 0x90;
+        break;
+      case 0xF4:
+        max_byte = 0x8F;
+        break;
+    }
+    if (!InRange(byte, min_byte, max_byte)) {
+      candidate.Invalidate();
+      return;
+    }
+    // Only the second byte has special range.
+    candidate.lead_byte = 0;
+    --candidate.num_bytes_needed;
+    if (!candidate.num_bytes_needed)
+      candidate.score += kUtf8Score;
+    return;
+  }
+  if (byte < 0x80)
+    return;
+  candidate.lead_byte = byte;
+  if (InRange(byte, 0xC2, 0xDF)) {
+    candidate.num_bytes_needed = 1;
+    return;
+  }
+  if (InRange(byte, 0xE0, 0xEF)) {
+    candidate.num_bytes_needed = 2;
+    return;
+  }
+  if (InRange(byte, 0xF0, 0xF4)) {
+    candidate.num_bytes_needed = 3;
+    return;
+  }
+  candidate.Invalidate();
+}
+
+std::vector<const EncodingDetector::Candidate*>
+EncodingDetector::SortedCandidates() const {
+  std::vector<const Candidate*> candidates;
+  for (const auto& candidate : candidates_) {
+    if (candidate.is_valid)
+      candidates.push_back(&candidate);
+  }
+  // Candidates of same score are in order of preference, e.g. UTF-8 is
+  // preferred to Shift_JIS.
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const Candidate* a, const Candidate* b) {
+                     return a->score > b->score;
+                   });
+  return candidates;
+}
+
+}  // namespace encodings
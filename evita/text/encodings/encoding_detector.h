@@ -0,0 +1,100 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_TEXT_ENCODINGS_ENCODING_DETECTOR_H_
+#define EVITA_TEXT_ENCODINGS_ENCODING_DETECTOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string16.h"
+
+namespace encodings {
+
+//////////////////////////////////////////////////////////////////////
+//
+// EncodingDetector
+// Detects encoding of byte stream among UTF-8, Shift_JIS and EUC-JP by
+// scanning bytes once without decoding. Each candidate has a validator,
+// which eliminates the candidate on invalid byte sequence, and a score
+// computed from byte class statistics, e.g. number of multi-byte characters
+// and number of kana characters. UTF-8 BOM makes UTF-8 decided unless
+// following bytes are invalid UTF-8.
+//
+// Callers feed bytes chunk by chunk until |is_decided()| or end of stream,
+// then decode bytes with |encoding()|.
+//
+class EncodingDetector final {
+ public:
+  EncodingDetector();
+  ~EncodingDetector();
+
+  // Returns confidence of |encoding()| in 0 to 100.
+  int confidence() const;
+
+  // Returns the most likely encoding name, or empty string if no candidate
+  // can decode bytes.
+  base::string16 encoding() const;
+
+  // Returns true if all bytes fed so far are ASCII, which all candidates
+  // decode into same characters.
+  bool is_ascii() const { return !num_non_ascii_bytes_; }
+
+  bool is_decided() const;
+
+  // Returns true if no valid candidate is in the middle of a multi-byte
+  // character, so |Feed()| skips ASCII bytes without scanning.
+  bool is_idle() const;
+
+  // Returns names of candidates which can decode bytes fed so far, in order
+  // of likelihood.
+  std::vector<base::string16> Candidates() const;
+
+  void Feed(const uint8_t* bytes, size_t num_bytes);
+
+ private:
+  enum CandidateIndex {
+    kUtf8,
+    kShiftJis,
+    kEucJp,
+    kNumberOfCandidates,
+  };
+
+  struct Candidate {
+    const base::char16* name;
+    bool is_valid = true;
+    // Number of bytes needed to complete current multi-byte character.
+    int num_bytes_needed = 0;
+    uint8_t lead_byte = 0;
+    int score = 0;
+
+    // Invalid candidate needs no more bytes, so it doesn't stop |Feed()|
+    // from skipping ASCII bytes.
+    void Invalidate() {
+      is_valid = false;
+      num_bytes_needed = 0;
+    }
+  };
+
+  // Returns candidates which can decode bytes in order of likelihood.
+  std::vector<const Candidate*> SortedCandidates() const;
+
+  void ScanEucJp(uint8_t byte);
+  void ScanShiftJis(uint8_t byte);
+  void ScanUtf8(uint8_t byte);
+
+  Candidate candidates_[kNumberOfCandidates];
+  size_t num_bom_bytes_ = 0;
+  size_t num_bytes_ = 0;
+  size_t num_non_ascii_bytes_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(EncodingDetector);
+};
+
+}  // namespace encodings
+
+#endif  // EVITA_TEXT_ENCODINGS_ENCODING_DETECTOR_H_
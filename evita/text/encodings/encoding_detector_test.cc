@@ -0,0 +1,122 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#pragma warning(push)
+#pragma warning(disable : 4365 4625 4626 4826)
+#include "testing/gtest/include/gtest/gtest.h"
+#pragma warning(pop)
+
+#include "evita/text/encodings/encoding_detector.h"
+
+namespace encodings {
+
+namespace {
+
+void Feed(EncodingDetector* detector, const std::vector<uint8_t>& bytes) {
+  detector->Feed(bytes.data(), bytes.size());
+}
+
+// Returns |bytes| repeated |count| times.
+std::vector<uint8_t> Repeat(const std::vector<uint8_t>& bytes, int count) {
+  std::vector<uint8_t> result;
+  for (auto i = 0; i < count; ++i)
+    result.insert(result.end(), bytes.begin(), bytes.end());
+  return result;
+}
+
+}  // namespace
+
+TEST(EncodingDetectorTest, Ascii) {
+  EncodingDetector detector;
+  Feed(&detector, std::vector<uint8_t>{'a', 'b', '\r', '\n'});
+  EXPECT_TRUE(detector.is_ascii());
+  EXPECT_FALSE(detector.is_decided());
+  EXPECT_EQ(0, detector.confidence());
+  EXPECT_EQ(base::string16(L"utf-8"), detector.encoding());
+  EXPECT_EQ(3u, detector.Candidates().size());
+}
+
+TEST(EncodingDetectorTest, Bom) {
+  EncodingDetector detector;
+  Feed(&detector, std::vector<uint8_t>{0xEF, 0xBB});
+  EXPECT_FALSE(detector.is_decided());
+  Feed(&detector, std::vector<uint8_t>{0xBF, 'a'});
+  EXPECT_TRUE(detector.is_decided());
+  EXPECT_EQ(100, detector.confidence());
+  EXPECT_EQ(base::string16(L"utf-8"), detector.encoding());
+}
+
+TEST(EncodingDetectorTest, EucJp) {
+  EncodingDetector detector;
+  // U+3042 HIRAGANA LETTER A, U+611B
+  Feed(&detector, Repeat(std::vector<uint8_t>{0xA4, 0xA2, 0xB0, 0xA6}, 20));
+  EXPECT_TRUE(detector.is_decided());
+  EXPECT_EQ(base::string16(L"euc-jp"), detector.encoding());
+  // Shift_JIS can decode EUC-JP bytes as half-width katakana.
+  EXPECT_EQ((std::vector<base::string16>{L"euc-jp", L"shift_jis"}),
+            detector.Candidates());
+}
+
+TEST(EncodingDetectorTest, Invalid) {
+  EncodingDetector detector;
+  Feed(&detector, std::vector<uint8_t>{0x80, 0xFF});
+  EXPECT_EQ(0, detector.confidence());
+  EXPECT_EQ(base::string16(), detector.encoding());
+  EXPECT_TRUE(detector.Candidates().empty());
+}
+
+// Candidates invalidated in the middle of a multi-byte character don't stop
+// skipping following ASCII bytes.
+TEST(EncodingDetectorTest, InvalidThenAscii) {
+  EncodingDetector detector;
+  // 0xE3 0x41 is valid in Shift_JIS, but invalid in UTF-8 and EUC-JP.
+  Feed(&detector, std::vector<uint8_t>{0xE3, 0x41});
+  EXPECT_TRUE(detector.is_idle());
+  Feed(&detector, Repeat(std::vector<uint8_t>{'a', 'b', 'c', '\n'}, 1000));
+  EXPECT_TRUE(detector.is_idle());
+  EXPECT_EQ((std::vector<base::string16>{L"shift_jis"}),
+            detector.Candidates());
+  EXPECT_EQ(100, detector.confidence());
+}
+
+TEST(EncodingDetectorTest, ShiftJis) {
+  EncodingDetector detector;
+  // U+3042 HIRAGANA LETTER A, U+611B
+  Feed(&detector, std::vector<uint8_t>{'a', 0x82, 0xA0, 0x88, 0xA4});
+  EXPECT_TRUE(detector.is_decided());
+  EXPECT_EQ(100, detector.confidence());
+  EXPECT_EQ(base::string16(L"shift_jis"), detector.encoding());
+}
+
+TEST(EncodingDetectorTest, SplitCharacter) {
+  EncodingDetector detector;
+  // U+3042 HIRAGANA LETTER A in UTF-8 split across chunks.
+  Feed(&detector, std::vector<uint8_t>{'a', 0xE3, 0x81});
+  Feed(&detector, std::vector<uint8_t>{0x82, 'b'});
+  EXPECT_FALSE(detector.is_ascii());
+  EXPECT_EQ(base::string16(L"utf-8"), detector.encoding());
+  EXPECT_EQ((std::vector<base::string16>{L"utf-8", L"shift_jis"}),
+            detector.Candidates())
+      << "EUC-JP can't decode 0xE3 0x81.";
+}
+
+TEST(EncodingDetectorTest, Utf8) {
+  EncodingDetector detector;
+  // U+3042 HIRAGANA LETTER A, U+611B
+  Feed(&detector,
+       Repeat(std::vector<uint8_t>{0xE3, 0x81, 0x82, 0xE6, 0x84, 0x9B}, 8));
+  EXPECT_TRUE(detector.is_decided());
+  EXPECT_EQ(base::string16(L"utf-8"), detector.encoding());
+}
+
+TEST(EncodingDetectorTest, Utf8Overlong) {
+  EncodingDetector detector;
+  Feed(&detector, std::vector<uint8_t>{0xE0, 0x80, 0xAF});
+  EXPECT_NE(base::string16(L"utf-8"), detector.encoding());
+}
+
+}  // namespace encodings
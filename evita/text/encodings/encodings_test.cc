@@ -99,6 +99,16 @@ TEST_F(EncodingsTest, ShiftJisDecoder) {
             Decode(decoder, std::vector<uint8_t>{0x88, 0xA4}));
 }
 
+TEST_F(EncodingsTest, ShiftJisDecoderAsciiRun) {
+  auto const decoder = Encodings::instance()->GetDecoder(L"shift_jis");
+  std::vector<uint8_t> bytes(40, 'a');
+  bytes[33] = 0x88;
+  bytes[34] = 0xA4;
+  base::string16 expected(39, 'a');
+  expected[33] = 0x611B;
+  EXPECT_EQ(expected, Decode(decoder, bytes));
+}
+
 TEST_F(EncodingsTest, ShiftJisEncoder) {
   auto const encoder = Encodings::instance()->GetEncoder(L"shift_jis");
   EXPECT_EQ((std::vector<uint8_t>{0x61, 0x78}), Encode(encoder, L"ax"));
@@ -125,6 +135,48 @@ TEST_F(EncodingsTest, Utf8Decoder) {
       << "Bad UTF-8 byte stream, it contains 0xA9.";
 }
 
+TEST_F(EncodingsTest, Utf8DecoderAsciiRun) {
+  auto const decoder = Encodings::instance()->GetDecoder(L"utf-8");
+  std::vector<uint8_t> bytes(40, 'a');
+  bytes[17] = 0xE6;
+  bytes[18] = 0x84;
+  bytes[19] = 0x9B;
+  bytes[30] = 0xC2;
+  bytes[31] = 0xA9;
+  base::string16 expected(37, 'a');
+  expected[17] = 0x611B;
+  expected[28] = 0xA9;
+  EXPECT_EQ(expected, Decode(decoder, bytes));
+
+  bytes[35] = 0xA9;
+  EXPECT_EQ(L"EncodingError", DecodeStream(decoder, bytes))
+      << "Bad byte after ASCII run";
+}
+
+TEST_F(EncodingsTest, Utf8DecoderDecodeTo) {
+  auto const decoder = Encodings::instance()->GetDecoder(L"utf-8");
+  // "a\u611Bb" split in middle of three bytes sequence.
+  const uint8_t bytes[] = {0x61, 0xE6, 0x84, 0x9B, 0x62};
+  base::char16 output[8];
+
+  auto const result1 = decoder->DecodeTo(bytes, 2, true, output);
+  EXPECT_TRUE(result1.left);
+  ASSERT_EQ(1u, result1.right);
+  EXPECT_EQ('a', output[0]);
+
+  auto const result2 = decoder->DecodeTo(bytes + 2, 3, true, output);
+  EXPECT_TRUE(result2.left);
+  ASSERT_EQ(2u, result2.right);
+  EXPECT_EQ(0x611B, output[0]);
+  EXPECT_EQ('b', output[1]);
+
+  // Bad input returns characters decoded so far.
+  const uint8_t bad_bytes[] = {0x61, 0x62, 0xA9};
+  auto const result3 = decoder->DecodeTo(bad_bytes, 3, false, output);
+  EXPECT_FALSE(result3.left);
+  EXPECT_EQ(2u, result3.right);
+}
+
 TEST_F(EncodingsTest, Utf8Encoder) {
   auto const encoder = Encodings::instance()->GetEncoder(L"utf-8");
   EXPECT_EQ((std::vector<uint8_t>{0x61, 0x78}), Encode(encoder, L"ax"));
@@ -3,11 +3,11 @@
 // found in the LICENSE file.
 
 #include <windows.h>
-#include <sstream>
 
 #include "evita/text/encodings/euc_jp_decoder.h"
 
 #include "base/logging.h"
+#include "evita/text/encodings/ascii_fast_path.h"
 
 namespace encodings {
 
@@ -20,9 +20,10 @@ class EucJpDecoder::Private final {
   Private();
   ~Private();
 
-  base::Either<bool, base::string16> Decode(const uint8_t* bytes,
-                                            size_t num_bytes,
-                                            bool is_stream);
+  base::Either<bool, size_t> Decode(const uint8_t* bytes,
+                                    size_t num_bytes,
+                                    bool is_stream,
+                                    base::char16* output);
 
  private:
   enum class State {
@@ -33,7 +34,7 @@ class EucJpDecoder::Private final {
     CS32,
   };
 
-  base::Either<bool, base::string16> Error();
+  base::Either<bool, size_t> Error();
 
   uint8_t bytes_[2];
   State state_;
@@ -52,22 +53,31 @@ static void ConvertJisToShiftJis(uint8_t* bytes) {
   bytes[1] = static_cast<uint8_t>(bytes[1] + cell);
 }
 
-base::Either<bool, base::string16> EucJpDecoder::Private::Decode(
+base::Either<bool, size_t> EucJpDecoder::Private::Decode(
     const uint8_t* bytes,
     size_t num_bytes,
-    bool is_stream) {
+    bool is_stream,
+    base::char16* output) {
   auto const kShiftJisCodePage = 932;
   if (!is_stream) {
     state_ = State::CS0;
   }
-  std::basic_stringbuf<base::char16> output;
+  auto const output_start = output;
   auto const bytes_end = bytes + num_bytes;
   for (auto runner = bytes; runner < bytes_end; ++runner) {
+    if (state_ == State::CS0) {
+      auto const num_ascii_bytes =
+          DecodeAscii(runner, static_cast<size_t>(bytes_end - runner), output);
+      runner += num_ascii_bytes;
+      output += num_ascii_bytes;
+      if (runner == bytes_end)
+        break;
+    }
     auto const byte = *runner;
     switch (state_) {
       case State::CS0:
         if (byte <= 0x7F) {
-          output.sputc(static_cast<base::char16>(byte));
+          *output++ = static_cast<base::char16>(byte);
           break;
         }
         if (byte == 0x8E) {
@@ -97,14 +107,14 @@ base::Either<bool, base::string16> EucJpDecoder::Private::Decode(
               reinterpret_cast<char*>(bytes_), 2, &code_point, 1);
           if (num_chars != 1)
             return Error();
-          output.sputc(code_point);
+          *output++ = code_point;
           state_ = State::CS0;
           break;
         }
         return Error();
       case State::CS2:
         if (byte >= 0xA1 && byte <= 0xDEF) {
-          output.sputc(static_cast<base::char16>(0xFF61 + byte - 0xA1));
+          *output++ = static_cast<base::char16>(0xFF61 + byte - 0xA1);
           state_ = State::CS0;
           break;
         }
@@ -128,20 +138,21 @@ base::Either<bool, base::string16> EucJpDecoder::Private::Decode(
               reinterpret_cast<char*>(bytes_ + 1), 2, &code_point, 1);
           if (num_chars != 1)
             return Error();
-          output.sputc(code_point);
+          *output++ = code_point;
           state_ = State::CS0;
           break;
         }
         return Error();
     }
   }
+  auto const num_chars = static_cast<size_t>(output - output_start);
   if (is_stream)
-    return base::make_either(true, output.str());
-  return base::make_either(state_ == State::CS0, output.str());
+    return base::make_either(true, num_chars);
+  return base::make_either(state_ == State::CS0, num_chars);
 }
 
-base::Either<bool, base::string16> EucJpDecoder::Private::Error() {
-  return base::make_either(false, base::string16());
+base::Either<bool, size_t> EucJpDecoder::Private::Error() {
+  return base::make_either(false, static_cast<size_t>(0));
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -158,10 +169,11 @@ const base::string16& EucJpDecoder::name() const {
   return name_;
 }
 
-base::Either<bool, base::string16> EucJpDecoder::Decode(const uint8_t* bytes,
-                                                        size_t num_bytes,
-                                                        bool is_stream) {
-  return private_->Decode(bytes, num_bytes, is_stream);
+base::Either<bool, size_t> EucJpDecoder::DecodeTo(const uint8_t* bytes,
+                                                   size_t num_bytes,
+                                                   bool is_stream,
+                                                   base::char16* output) {
+  return private_->Decode(bytes, num_bytes, is_stream, output);
 }
 
 }  // namespace encodings
@@ -25,9 +25,10 @@ class EucJpDecoder final : public Decoder {
 
   // encoding::Decoder
   const base::string16& name() const final;
-  base::Either<bool, base::string16> Decode(const uint8_t* bytes,
-                                            size_t num_bytes,
-                                            bool is_stream) final;
+  base::Either<bool, size_t> DecodeTo(const uint8_t* bytes,
+                                      size_t num_bytes,
+                                      bool is_stream,
+                                      base::char16* output) final;
 
   std::unique_ptr<Private> private_;
 
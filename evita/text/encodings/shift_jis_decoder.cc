@@ -5,9 +5,9 @@
 #include "evita/text/encodings/shift_jis_decoder.h"
 
 #include <windows.h>
-#include <sstream>
 
 #include "base/logging.h"
+#include "evita/text/encodings/ascii_fast_path.h"
 
 namespace encodings {
 
@@ -20,9 +20,10 @@ class ShiftJisDecoder::Private final {
   Private();
   ~Private();
 
-  base::Either<bool, base::string16> Decode(const uint8_t* bytes,
-                                            size_t num_bytes,
-                                            bool is_stream);
+  base::Either<bool, size_t> Decode(const uint8_t* bytes,
+                                    size_t num_bytes,
+                                    bool is_stream,
+                                    base::char16* output);
 
  private:
   uint8_t bytes_[2];
@@ -37,17 +38,26 @@ ShiftJisDecoder::Private::Private() {
 
 ShiftJisDecoder::Private::~Private() {}
 
-base::Either<bool, base::string16> ShiftJisDecoder::Private::Decode(
+base::Either<bool, size_t> ShiftJisDecoder::Private::Decode(
     const uint8_t* bytes,
     size_t num_bytes,
-    bool is_stream) {
+    bool is_stream,
+    base::char16* output) {
   if (!is_stream) {
     bytes_[0] = 0;
     bytes_[1] = 0;
   }
-  std::basic_stringbuf<base::char16> output;
+  auto const output_start = output;
   auto const bytes_end = bytes + num_bytes;
   for (auto runner = bytes; runner < bytes_end; ++runner) {
+    if (!bytes_[0]) {
+      auto const num_ascii_bytes =
+          DecodeAscii(runner, static_cast<size_t>(bytes_end - runner), output);
+      runner += num_ascii_bytes;
+      output += num_ascii_bytes;
+      if (runner == bytes_end)
+        break;
+    }
     auto const byte = *runner;
     if (bytes_[0]) {
       bytes_[1] = byte;
@@ -56,26 +66,30 @@ base::Either<bool, base::string16> ShiftJisDecoder::Private::Decode(
       auto const num_chars = ::MultiByteToWideChar(
           kShiftJisCodePage, MB_ERR_INVALID_CHARS,
           reinterpret_cast<char*>(bytes_), 2, &code_point, 1);
-      if (num_chars != 1)
-        return base::make_either(false, output.str());
-      output.sputc(code_point);
+      if (num_chars != 1) {
+        return base::make_either(false,
+                                 static_cast<size_t>(output - output_start));
+      }
+      *output++ = code_point;
       bytes_[0] = 0;
     } else {
       if (byte <= 0x80) {
-        output.sputc(static_cast<base::char16>(byte));
+        *output++ = static_cast<base::char16>(byte);
       } else if (byte >= 0xA1 && byte <= 0xDF) {
-        output.sputc(static_cast<base::char16>(0xFF61 + byte - 0xA1));
+        *output++ = static_cast<base::char16>(0xFF61 + byte - 0xA1);
       } else if ((byte >= 0x81 && byte <= 0x9F) ||
                  (byte >= 0xE0 && byte <= 0xFC)) {
         bytes_[0] = byte;
       } else {
-        return base::make_either(false, output.str());
+        return base::make_either(false,
+                                 static_cast<size_t>(output - output_start));
       }
     }
   }
+  auto const num_chars = static_cast<size_t>(output - output_start);
   if (is_stream)
-    return base::make_either(true, output.str());
-  return base::make_either(!bytes_[0], output.str());
+    return base::make_either(true, num_chars);
+  return base::make_either(!bytes_[0], num_chars);
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -92,10 +106,11 @@ const base::string16& ShiftJisDecoder::name() const {
   return name_;
 }
 
-base::Either<bool, base::string16> ShiftJisDecoder::Decode(const uint8_t* bytes,
-                                                           size_t num_bytes,
-                                                           bool is_stream) {
-  return private_->Decode(bytes, num_bytes, is_stream);
+base::Either<bool, size_t> ShiftJisDecoder::DecodeTo(const uint8_t* bytes,
+                                                      size_t num_bytes,
+                                                      bool is_stream,
+                                                      base::char16* output) {
+  return private_->Decode(bytes, num_bytes, is_stream, output);
 }
 
 }  // namespace encodings
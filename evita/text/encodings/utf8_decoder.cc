@@ -2,15 +2,21 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-#include <sstream>
-#include <string>
-
 #include "evita/text/encodings/utf8_decoder.h"
 
 #include "base/logging.h"
+#include "evita/text/encodings/ascii_fast_path.h"
 
 namespace encodings {
 
+namespace {
+
+bool IsTrailByte(uint8_t byte) {
+  return byte >= 0x80 && byte <= 0xBF;
+}
+
+}  // namespace
+
 //////////////////////////////////////////////////////////////////////
 //
 // Utf8Decoder::Private
@@ -20,13 +26,10 @@ class Utf8Decoder::Private final {
   Private();
   ~Private();
 
-  // |string| contains characters decoded so far. Caller may use it what's
-  // wrong in input data.
-  base::Either<bool, base::string16> BadInput(const base::string16& string);
-
-  base::Either<bool, base::string16> Decode(const uint8_t* bytes,
-                                            size_t num_bytes,
-                                            bool is_stream);
+  base::Either<bool, size_t> Decode(const uint8_t* bytes,
+                                    size_t num_bytes,
+                                    bool is_stream,
+                                    base::char16* output);
 
  private:
   enum class State {
@@ -35,6 +38,13 @@ class Utf8Decoder::Private final {
     NeedByte,
   };
 
+  // Returns number of bytes of valid multi-byte sequence at |bytes| with
+  // decoded character in |output|, or zero if |bytes| doesn't start with
+  // two or three bytes sequence contained in |bytes_end|.
+  static size_t DecodeSequence(const uint8_t* bytes,
+                               const uint8_t* bytes_end,
+                               base::char16* output);
+
   int char32_;
   int num_bytes_needed_;
   State state_;
@@ -47,37 +57,52 @@ Utf8Decoder::Private::Private()
 
 Utf8Decoder::Private::~Private() {}
 
-base::Either<bool, base::string16> Utf8Decoder::Private::BadInput(
-    const base::string16& string) {
-  state_ = State::BadInput;
-  return base::make_either(false, string);
-}
-
 // 1 U+0000   U+007F   0xxxxxxx
 // 2 U+0080   U+07FF   110xxxxx 10xxxxxx
 // 3 U+0800   U+FFFF   1110xxxx 10xxxxxx 10xxxxxx
 // 4 U+10000  U+1FFFFF 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
 // Note: We don't support 5 byte and 6 byte UTF-8 sequence yet.
-base::Either<bool, base::string16> Utf8Decoder::Private::Decode(
+//
+// We decode runs of ASCII bytes and two or three bytes sequences without
+// state machine. State machine handles four bytes sequences, sequences
+// split across calls and bad inputs.
+base::Either<bool, size_t> Utf8Decoder::Private::Decode(
     const uint8_t* bytes,
     size_t num_bytes,
-    bool is_stream) {
+    bool is_stream,
+    base::char16* output) {
   if (!is_stream) {
     // Reset decode stream when we start decoding.
     state_ = State::FirstByte;
     num_bytes_needed_ = 0;
   }
 
-  std::basic_stringbuf<base::char16> output;
   auto const bytes_end = bytes + num_bytes;
-  for (auto runner = bytes; runner < bytes_end; ++runner) {
+  auto const output_start = output;
+  auto runner = bytes;
+  while (runner < bytes_end) {
+    if (state_ == State::FirstByte) {
+      auto const num_ascii_bytes =
+          DecodeAscii(runner, static_cast<size_t>(bytes_end - runner), output);
+      runner += num_ascii_bytes;
+      output += num_ascii_bytes;
+      if (runner == bytes_end)
+        break;
+      if (auto const sequence_size =
+              DecodeSequence(runner, bytes_end, output)) {
+        runner += sequence_size;
+        ++output;
+        continue;
+      }
+    }
     auto const byte = *runner;
+    ++runner;
     switch (state_) {
       case State::BadInput:
-        return BadInput(base::string16());
+        return base::make_either(false, static_cast<size_t>(0));
       case State::FirstByte:
         if (byte <= 0x7F) {
-          output.sputc(static_cast<base::char16>(byte));
+          *output++ = static_cast<base::char16>(byte);
           break;
         }
         if (byte >= 0xC0 && byte <= 0xDF) {
@@ -98,24 +123,31 @@ base::Either<bool, base::string16> Utf8Decoder::Private::Decode(
           state_ = State::NeedByte;
           break;
         }
-        return BadInput(output.str());
+        state_ = State::BadInput;
+        return base::make_either(false,
+                                 static_cast<size_t>(output - output_start));
       case State::NeedByte:
-        if (byte < 0x80 || byte > 0xBF)
-          return BadInput(output.str());
+        if (!IsTrailByte(byte)) {
+          state_ = State::BadInput;
+          return base::make_either(false,
+                                   static_cast<size_t>(output - output_start));
+        }
         char32_ <<= 6;
         char32_ |= byte & 0x3F;
         --num_bytes_needed_;
         if (num_bytes_needed_)
           break;
         if (char32_ <= 0xFFFF) {
-          output.sputc(static_cast<base::char16>(char32_));
+          *output++ = static_cast<base::char16>(char32_);
         } else if (char32_ <= 0x10FFFF) {
           char32_ -= 0x10000;
-          output.sputc(
-              static_cast<base::char16>(0xD800 | ((char32_ >> 10) & 0x3FF)));
-          output.sputc(static_cast<base::char16>(0xDC00 | (char32_ & 0x3FF)));
+          *output++ =
+              static_cast<base::char16>(0xD800 | ((char32_ >> 10) & 0x3FF));
+          *output++ = static_cast<base::char16>(0xDC00 | (char32_ & 0x3FF));
         } else {
-          return BadInput(output.str());
+          state_ = State::BadInput;
+          return base::make_either(false,
+                                   static_cast<size_t>(output - output_start));
         }
         state_ = State::FirstByte;
         break;
@@ -124,13 +156,38 @@ base::Either<bool, base::string16> Utf8Decoder::Private::Decode(
         break;
     }
   }
+  auto const num_chars = static_cast<size_t>(output - output_start);
   if (is_stream)
-    return base::make_either(true, output.str());
+    return base::make_either(true, num_chars);
 
   // We should not expect more bytes.
   auto const error = state_ == State::FirstByte;
   state_ = State::FirstByte;
-  return base::make_either(error, output.str());
+  return base::make_either(error, num_chars);
+}
+
+// static
+size_t Utf8Decoder::Private::DecodeSequence(const uint8_t* bytes,
+                                            const uint8_t* bytes_end,
+                                            base::char16* output) {
+  auto const byte = bytes[0];
+  if (byte >= 0xC0 && byte <= 0xDF) {
+    if (bytes_end - bytes < 2 || !IsTrailByte(bytes[1]))
+      return 0;
+    *output = static_cast<base::char16>(((byte & 0x1F) << 6) |
+                                        (bytes[1] & 0x3F));
+    return 2;
+  }
+  if (byte >= 0xE0 && byte <= 0xEF) {
+    if (bytes_end - bytes < 3 || !IsTrailByte(bytes[1]) ||
+        !IsTrailByte(bytes[2])) {
+      return 0;
+    }
+    *output = static_cast<base::char16>(
+        ((byte & 0x0F) << 12) | ((bytes[1] & 0x3F) << 6) | (bytes[2] & 0x3F));
+    return 3;
+  }
+  return 0;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -147,10 +204,11 @@ const base::string16& Utf8Decoder::name() const {
   return name_;
 }
 
-base::Either<bool, base::string16> Utf8Decoder::Decode(const uint8_t* bytes,
-                                                       size_t num_bytes,
-                                                       bool is_stream) {
-  return private_->Decode(bytes, num_bytes, is_stream);
+base::Either<bool, size_t> Utf8Decoder::DecodeTo(const uint8_t* bytes,
+                                                  size_t num_bytes,
+                                                  bool is_stream,
+                                                  base::char16* output) {
+  return private_->Decode(bytes, num_bytes, is_stream, output);
 }
 
 }  // namespace encodings
@@ -235,9 +235,11 @@ RootInlineBox* BlockFlow::FormatLine(TextFormatter* formatter) {
   const auto& cached_line =
       text_line_cache_->FindLine(formatter->text_offset());
   if (cached_line) {
+    ++cached_line_count_;
     formatter->DidFormat(cached_line);
     return cached_line;
   }
+  ++formatted_line_count_;
   return text_line_cache_->Register(std::move(formatter->FormatLine()));
 }
 
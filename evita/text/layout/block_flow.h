@@ -42,6 +42,10 @@ class BlockFlow final : public text::BufferMutationObserver,
   ~BlockFlow();
 
   const gfx::RectF& bounds() const { return bounds_; }
+  // Number of lines taken from line cache, for measuring performance.
+  size_t cached_line_count() const { return cached_line_count_; }
+  // Number of lines formatted by |TextFormatter|, for measuring performance.
+  size_t formatted_line_count() const { return formatted_line_count_; }
   int version() const { return version_; }
   const std::list<RootInlineBox*>& lines() const { return lines_; }
   gfx::PointF origin() const { return bounds_.origin(); }
@@ -102,7 +106,9 @@ class BlockFlow final : public text::BufferMutationObserver,
   void DidChangeMarker(const text::StaticRange& range) final;
 
   gfx::RectF bounds_;
+  size_t cached_line_count_ = 0;
   bool dirty_line_point_ = true;
+  size_t formatted_line_count_ = 0;
   std::list<RootInlineBox*> lines_;
   float lines_height_ = 0.0f;
   const text::MarkerSet& markers_;
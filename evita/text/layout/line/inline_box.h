@@ -6,6 +6,7 @@
 #define EVITA_TEXT_LAYOUT_LINE_INLINE_BOX_H_
 
 #include "base/macros.h"
+#include "base/strings/string_piece.h"
 #include "evita/base/castable.h"
 #include "evita/gfx/rect.h"
 #include "evita/text/layout/line/inline_box_forward.h"
@@ -42,6 +43,10 @@ class ComputedStyle;
 //
 // InlineBox
 //
+// All |InlineBox|es of a line are allocated in |evita::Zone| owned by
+// |RootInlineBox|. Destructors of |InlineBox| are never called, so members
+// of |InlineBox| must not own any resource.
+//
 class InlineBox : public base::DeprecatedCastable<InlineBox> {
   DECLARE_INLINE_BOX_ABSTRACT_CLASS(InlineBox, DeprecatedCastable);
 
@@ -170,7 +175,7 @@ class InlineTextBoxBase : public InlineBox, public WithFont {
   DECLARE_INLINE_BOX_ABSTRACT_CLASS(InlineTextBoxBase, InlineBox);
 
  public:
-  const base::string16 characters() const { return characters_; }
+  base::StringPiece16 characters() const { return characters_; }
 
  protected:
   InlineTextBoxBase(const ComputedStyle& style,
@@ -180,14 +185,15 @@ class InlineTextBoxBase : public InlineBox, public WithFont {
                     float height,
                     text::OffsetDelta start,
                     text::OffsetDelta end,
-                    const base::string16& characters);
+                    base::StringPiece16 characters);
   ~InlineTextBoxBase() override;
 
  private:
   // InlineBox
   text::OffsetDelta HitTestPoint(float x) const override;
 
-  const base::string16 characters_;
+  // |characters_| points to memory in the same zone as this box.
+  const base::StringPiece16 characters_;
 
   DISALLOW_COPY_AND_ASSIGN(InlineTextBoxBase);
 };
@@ -206,7 +212,7 @@ class InlineTextBox final : public InlineTextBoxBase {
                 float width,
                 float height,
                 text::OffsetDelta start,
-                const base::string16& characters);
+                base::StringPiece16 characters);
   ~InlineTextBox() final;
 
  private:
@@ -231,7 +237,7 @@ class InlineUnicodeBox final : public InlineTextBoxBase {
                    float width,
                    float height,
                    text::OffsetDelta start,
-                   const base::string16& characters);
+                   base::StringPiece16 characters);
   ~InlineUnicodeBox() final;
 
  private:
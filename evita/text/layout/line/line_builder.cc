@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
 #include "evita/text/layout/line/line_builder.h"
 
@@ -16,6 +17,10 @@ namespace layout {
 
 namespace {
 
+// Most of lines have less than ten inline boxes.
+const size_t kNumInitialBoxes = 16;
+const size_t kZoneSegmentSize = 1024;
+
 // TODO(eval1749): We should move |AlignHeightToPixel()| to another place
 // to share code.
 #if 0
@@ -35,9 +40,13 @@ float AlignHeightToPixel(float height) {
 LineBuilder::LineBuilder(text::Offset line_start,
                          text::Offset text_start,
                          float line_width)
-    : line_start_(line_start),
+    : zone_("LineBuilder", kZoneSegmentSize),
+      boxes_(&zone_),
+      line_start_(line_start),
       line_width_(line_width),
-      text_start_(text_start) {}
+      text_start_(text_start) {
+  boxes_.reserve(kNumInitialBoxes);
+}
 
 LineBuilder::~LineBuilder() {}
 
@@ -55,8 +64,9 @@ void LineBuilder::AddCodeUnitBox(const ComputedStyle& style,
                                  text::Offset offset,
                                  const base::string16& text) {
   AddTextBoxIfNeeded();
-  AddBoxInternal(new InlineUnicodeBox(style, font, current_x_, width, height,
-                                      offset - text_start_, text));
+  AddBoxInternal(NewBox<InlineUnicodeBox>(
+      style, font, current_x_, width, height, offset - text_start_,
+      NewCharacters(text.data(), text.size())));
 }
 
 void LineBuilder::AddFillerBox(const ComputedStyle& style,
@@ -64,8 +74,8 @@ void LineBuilder::AddFillerBox(const ComputedStyle& style,
                                float height,
                                text::Offset offset) {
   AddTextBoxIfNeeded();
-  AddBoxInternal(new InlineFillerBox(style, current_x_, width, height,
-                                     offset - text_start_));
+  AddBoxInternal(NewBox<InlineFillerBox>(style, current_x_, width, height,
+                                         offset - text_start_));
   font_ = style.fonts()[0];
 }
 
@@ -77,19 +87,19 @@ void LineBuilder::AddMarkerBox(const ComputedStyle& style,
                                text::Offset end,
                                TextMarker marker_name) {
   AddTextBoxIfNeeded();
-  AddBoxInternal(new InlineMarkerBox(style, font, current_x_, width, height,
-                                     start - text_start_, end - text_start_,
-                                     marker_name));
+  AddBoxInternal(NewBox<InlineMarkerBox>(style, font, current_x_, width,
+                                         height, start - text_start_,
+                                         end - text_start_, marker_name));
 }
 
 void LineBuilder::AddTextBoxIfNeeded() {
   if (pending_text_.empty())
     return;
   DCHECK_GT(pending_text_width_, 0.0f);
-  AddBoxInternal(new InlineTextBox(
+  AddBoxInternal(NewBox<InlineTextBox>(
       *style_, *font_, current_x_, pending_text_width_, ::ceil(font_->height()),
       current_offset_ - text_start_,
-      base::string16(pending_text_.data(), pending_text_.size())));
+      NewCharacters(pending_text_.data(), pending_text_.size())));
   pending_text_.clear();
   pending_text_width_ = 0.0f;
 }
@@ -102,7 +112,7 @@ std::unique_ptr<RootInlineBox> LineBuilder::Build() {
   DCHECK(!boxes_.empty());
   const auto end = boxes_.back()->end();
   return std::make_unique<RootInlineBox>(
-      boxes_, line_start_, text_start_, text_start_ + end,
+      std::move(zone_), boxes_, line_start_, text_start_, text_start_ + end,
       AlignHeightToPixel(ascent_), AlignHeightToPixel(descent_));
 }
 
@@ -114,6 +124,14 @@ bool LineBuilder::HasRoomFor(float width) const {
   return current_x_ + pending_text_width_ + width + marker_width < line_width_;
 }
 
+base::StringPiece16 LineBuilder::NewCharacters(
+    const base::char16* characters,
+    size_t length) {
+  auto* const copy = zone_.AllocateObjects<base::char16>(length);
+  std::copy(characters, characters + length, copy);
+  return base::StringPiece16(copy, length);
+}
+
 bool LineBuilder::TryAddChar(const ComputedStyle& style,
                              const gfx::Font& font,
                              text::Offset offset,
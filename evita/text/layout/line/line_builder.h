@@ -6,10 +6,14 @@
 #define EVITA_TEXT_LAYOUT_LINE_LINE_BUILDER_H_
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "base/macros.h"
 #include "base/strings/string16.h"
+#include "base/strings/string_piece.h"
+#include "evita/base/memory/zone.h"
+#include "evita/base/memory/zone_vector.h"
 #include "evita/text/models/offset.h"
 #include "evita/text/style/computed_style.h"
 
@@ -28,6 +32,9 @@ enum class TextMarker;
 //
 // LineBuilder
 //
+// |LineBuilder| allocates inline boxes and their characters in one |Zone|
+// and passes it to |RootInlineBox|.
+//
 class LineBuilder final {
  public:
   LineBuilder(text::Offset line_start,
@@ -64,9 +71,19 @@ class LineBuilder final {
 
  private:
   void AddBoxInternal(InlineBox* inline_box);
+  base::StringPiece16 NewCharacters(const base::char16* characters,
+                                    size_t length);
+
+  template <typename T, typename... Args>
+  T* NewBox(Args&&... args) {
+    return new (zone_.Allocate(sizeof(T))) T(std::forward<Args>(args)...);
+  }
 
+  // |zone_| holds inline boxes and |boxes_|, and should be constructed
+  // before |boxes_|.
+  evita::Zone zone_;
   float ascent_ = 0.0f;
-  std::vector<InlineBox*> boxes_;
+  evita::ZoneVector<InlineBox*> boxes_;
   float descent_ = 0.0f;
   text::Offset current_offset_;
   float current_x_ = 0.0f;
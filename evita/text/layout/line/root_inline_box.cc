@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cmath>
 #include <iterator>
+#include <utility>
 
 #include "evita/text/layout/line/root_inline_box.h"
 
@@ -20,13 +21,15 @@ namespace layout {
 //
 // RootInlineBox
 //
-RootInlineBox::RootInlineBox(const std::vector<InlineBox*>& boxes,
+RootInlineBox::RootInlineBox(evita::Zone&& zone,
+                             const evita::ZoneVector<InlineBox*>& boxes,
                              text::Offset line_start,
                              text::Offset text_start,
                              text::Offset text_end,
                              float ascent,
                              float descent)
-    : boxes_(boxes),
+    : zone_(std::move(zone)),
+      boxes_(&zone_, boxes.begin(), boxes.end()),
       descent_(descent),
       line_start_(line_start),
       text_start_(text_start),
@@ -41,10 +44,8 @@ RootInlineBox::RootInlineBox(const std::vector<InlineBox*>& boxes,
   DCHECK_EQ(bounds_.bottom, ::floor(bounds_.bottom));
 }
 
-RootInlineBox::~RootInlineBox() {
-  for (const auto& box : boxes_)
-    delete box;
-}
+// Inline boxes are released by |zone_|.
+RootInlineBox::~RootInlineBox() {}
 
 void RootInlineBox::set_origin(const gfx::PointF& origin) {
   bounds_.right = bounds_.width() + origin.x;
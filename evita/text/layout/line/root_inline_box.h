@@ -7,9 +7,9 @@
 
 #include <stdint.h>
 
-#include <vector>
-
 #include "base/macros.h"
+#include "evita/base/memory/zone.h"
+#include "evita/base/memory/zone_vector.h"
 #include "evita/gfx/rect_f.h"
 #include "evita/text/models/offset.h"
 
@@ -20,9 +20,18 @@ class Formatter;
 class TextBlock;
 class TextSelection;
 
+//////////////////////////////////////////////////////////////////////
+//
+// RootInlineBox
+//
+// |RootInlineBox| owns |zone| which holds all |InlineBox|es in |boxes|. We
+// release all inline boxes at once by destructing |zone|. |boxes| is copied
+// into |zone|, so a line doesn't allocate memory outside of |zone|.
+//
 class RootInlineBox final {
  public:
-  RootInlineBox(const std::vector<InlineBox*>& boxes,
+  RootInlineBox(evita::Zone&& zone,
+                const evita::ZoneVector<InlineBox*>& boxes,
                 text::Offset line_start,
                 text::Offset text_start,
                 text::Offset text_end,
@@ -33,7 +42,7 @@ class RootInlineBox final {
   float bottom() const { return bounds_.bottom; }
   const gfx::PointF bottom_right() const { return bounds_.bottom_right(); }
   const gfx::RectF& bounds() const { return bounds_; }
-  const std::vector<InlineBox*>& boxes() const { return boxes_; }
+  const evita::ZoneVector<InlineBox*>& boxes() const { return boxes_; }
   float descent() const { return descent_; }
   float height() const { return bounds_.height(); }
   InlineBox* last_box() const { return boxes_.back(); }
@@ -58,7 +67,8 @@ class RootInlineBox final {
 
  private:
   gfx::RectF bounds_;
-  const std::vector<InlineBox*> boxes_;
+  evita::Zone zone_;
+  const evita::ZoneVector<InlineBox*> boxes_;
   const float descent_;
   text::Offset line_start_;
   text::Offset text_start_;
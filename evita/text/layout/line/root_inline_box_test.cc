@@ -4,8 +4,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <utility>
 #include <vector>
 
+#include "evita/base/memory/zone.h"
+#include "evita/base/memory/zone_vector.h"
 #include "evita/gfx/font.h"
 #include "evita/gfx/font_face.h"
 #include "evita/text/layout/line/inline_box.h"
@@ -31,12 +34,18 @@ class LineBuilder final {
   void AddCodeUnit(const base::char16 code_unit);
   void AddMarker(TextMarker marker);
   void AddText(const base::string16& text);
-  std::unique_ptr<RootInlineBox> Build() const;
+  std::unique_ptr<RootInlineBox> Build();
   float WidthOf(const base::string16& text) const;
 
  private:
   void AddBoxInternal(InlineBox* box);
   static ComputedStyle CreateStyle();
+  base::StringPiece16 NewCharacters(const base::string16& text);
+
+  template <typename T, typename... Args>
+  T* NewBox(Args&&... args) {
+    return new (zone_.Allocate(sizeof(T))) T(std::forward<Args>(args)...);
+  }
 
   float ascent_ = 0;
   std::vector<InlineBox*> boxes_;
@@ -46,14 +55,18 @@ class LineBuilder final {
   text::OffsetDelta offset_;
   text::Offset start_;
   const ComputedStyle& style_;
+  evita::Zone zone_;
 
   DISALLOW_COPY_AND_ASSIGN(LineBuilder);
 };
 
 LineBuilder::LineBuilder(text::Offset start, const ComputedStyle& style)
-    : font_(*style.fonts()[0]), style_(style), start_(start) {
-  AddBoxInternal(
-      new InlineFillerBox(style_, 0, kLeadingWidth, 10, text::OffsetDelta(0)));
+    : font_(*style.fonts()[0]),
+      style_(style),
+      start_(start),
+      zone_("LineBuilderForTest") {
+  AddBoxInternal(NewBox<InlineFillerBox>(style_, 0, kLeadingWidth, 10,
+                                         text::OffsetDelta(0)));
 }
 
 void LineBuilder::AddBoxInternal(InlineBox* box) {
@@ -67,26 +80,30 @@ void LineBuilder::AddBoxInternal(InlineBox* box) {
 void LineBuilder::AddCodeUnit(const base::char16 code_unit) {
   const auto next_offset = offset_ + text::OffsetDelta(1);
   base::string16 text = L"uFFFF";
-  AddBoxInternal(new InlineUnicodeBox(style_, font_, left_, WidthOf(text),
-                                      font_.height() + 4, offset_, text));
+  AddBoxInternal(NewBox<InlineUnicodeBox>(style_, font_, left_, WidthOf(text),
+                                          font_.height() + 4, offset_,
+                                          NewCharacters(text)));
 }
 
 void LineBuilder::AddMarker(TextMarker marker) {
   const auto next_offset =
       marker == TextMarker::LineWrap ? offset_ : offset_ + text::OffsetDelta(1);
-  AddBoxInternal(new InlineMarkerBox(style_, font_, left_, WidthOf(L"x"),
-                                     font_.height(), offset_, next_offset,
-                                     marker));
+  AddBoxInternal(NewBox<InlineMarkerBox>(style_, font_, left_, WidthOf(L"x"),
+                                         font_.height(), offset_, next_offset,
+                                         marker));
 }
 
 void LineBuilder::AddText(const base::string16& text) {
-  AddBoxInternal(new InlineTextBox(style_, font_, left_, WidthOf(text),
-                                   font_.height(), offset_, text));
+  AddBoxInternal(NewBox<InlineTextBox>(style_, font_, left_, WidthOf(text),
+                                       font_.height(), offset_,
+                                       NewCharacters(text)));
 }
 
-std::unique_ptr<RootInlineBox> LineBuilder::Build() const {
-  return std::make_unique<RootInlineBox>(boxes_, start_, start_,
-                                         start_ + offset_, ascent_, descent_);
+std::unique_ptr<RootInlineBox> LineBuilder::Build() {
+  const evita::ZoneVector<InlineBox*> boxes(&zone_, boxes_);
+  return std::make_unique<RootInlineBox>(std::move(zone_), boxes, start_,
+                                         start_, start_ + offset_, ascent_,
+                                         descent_);
 }
 
 gfx::RectF CaretBoundsOf(int origin_x, int origin_y, int height) {
@@ -107,6 +124,12 @@ std::unique_ptr<ComputedStyle> CreateStyle() {
       .Build();
 }
 
+base::StringPiece16 LineBuilder::NewCharacters(const base::string16& text) {
+  auto* const characters = zone_.AllocateObjects<base::char16>(text.size());
+  std::copy(text.begin(), text.end(), characters);
+  return base::StringPiece16(characters, text.size());
+}
+
 float LineBuilder::WidthOf(const base::string16& text) const {
   return ::ceil(font_.GetTextWidth(text));
 }
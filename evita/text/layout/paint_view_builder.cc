@@ -78,16 +78,16 @@ void PaintInlineBoxBuilder::VisitInlineMarkerBox(InlineMarkerBox* box) {
 
 void PaintInlineBoxBuilder::VisitInlineTextBox(InlineTextBox* box) {
   DCHECK(!paint_box_);
-  paint_box_ = new paint::InlineTextBox(box->style(), box->font(), box->width(),
-                                        box->height(), box->characters(),
-                                        line_height_, line_descent_);
+  paint_box_ = new paint::InlineTextBox(
+      box->style(), box->font(), box->width(), box->height(),
+      box->characters().as_string(), line_height_, line_descent_);
 }
 
 void PaintInlineBoxBuilder::VisitInlineUnicodeBox(InlineUnicodeBox* box) {
   DCHECK(!paint_box_);
   paint_box_ = new paint::InlineUnicodeBox(
-      box->style(), box->font(), box->width(), box->height(), box->characters(),
-      line_height_, line_descent_);
+      box->style(), box->font(), box->width(), box->height(),
+      box->characters().as_string(), line_height_, line_descent_);
 }
 
 gfx::RectF RoundBounds(const gfx::RectF& bounds) {
@@ -203,22 +203,33 @@ scoped_refptr<paint::View> PaintViewBuilder::Build(
     const TextSelectionModel& selection_model,
     const CaretDisplayItem& caret) {
   TRACE_EVENT0("view", "PaintViewBuilder::Build");
-  // TODO(eval1749): We should recompute default style when style is changed,
-  // rather than every |Format| call.
-  const auto& bgcolor = ComputeBackgroundColor(block.style_tree());
-  const auto& ruler = ComputeRuler(block.style_tree(), block);
   const auto& selection = FormatSelection(block.style_tree(), selection_model);
   const auto& selection_bounds_set =
       CalculateSelectionBoundsSet(block.lines(), selection, block.bounds());
+  const auto& paint_selection = base::WrapRefCounted(
+      new paint::Selection(selection.color(), selection_bounds_set));
 
   std::vector<paint::RootInlineBox*> lines;
-  lines.reserve(block.lines().size());
-  for (const auto& line : block.lines())
-    lines.push_back(CreatePaintRootInlineBox(*line));
+  if (IsTextChanged(block)) {
+    bgcolor_ = ComputeBackgroundColor(block.style_tree());
+    bounds_ = block.bounds();
+    layout_version_ = block.version();
+    ruler_.reset(new paint::Ruler(ComputeRuler(block.style_tree(), block)));
+    style_version_ = block.style_tree().version();
+    lines.reserve(block.lines().size());
+    for (const auto& line : block.lines())
+      lines.push_back(CreatePaintRootInlineBox(*line));
+  } else {
+    TRACE_EVENT0("view", "PaintViewBuilder::Build.CaretAndSelection");
+  }
   return new paint::View(block.version(), block.bounds(), lines,
-                         base::WrapRefCounted(new paint::Selection(
-                             selection.color(), selection_bounds_set)),
-                         bgcolor, ruler, caret);
+                         paint_selection, bgcolor_, *ruler_, caret);
+}
+
+bool PaintViewBuilder::IsTextChanged(const BlockFlow& block) const {
+  return layout_version_ != block.version() ||
+         style_version_ != block.style_tree().version() ||
+         bounds_ != block.bounds();
 }
 
 }  // namespace layout
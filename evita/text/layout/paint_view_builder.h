@@ -10,10 +10,12 @@
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/time/time.h"
+#include "evita/gfx/color_f.h"
 #include "evita/gfx/rect_f.h"
 
 namespace paint {
 class Caret;
+class Ruler;
 class View;
 }
 
@@ -31,6 +33,11 @@ class TextSelectionModel;
 //
 // PaintViewBuilder
 //
+// PaintViewBuilder remembers text contents of the last built view. When text
+// contents aren't changed, e.g. caret blinking, selection dragging, |Build()|
+// returns a view without lines, and consumer paints only caret and selection
+// with lines of previous view.
+//
 class PaintViewBuilder final {
   using CaretDisplayItem = paint::Caret;
 
@@ -43,6 +50,14 @@ class PaintViewBuilder final {
                                    const CaretDisplayItem& caret);
 
  private:
+  bool IsTextChanged(const BlockFlow& block) const;
+
+  gfx::ColorF bgcolor_;
+  gfx::RectF bounds_;
+  int layout_version_ = -1;
+  std::unique_ptr<paint::Ruler> ruler_;
+  int style_version_ = -1;
+
   DISALLOW_COPY_AND_ASSIGN(PaintViewBuilder);
 };
 
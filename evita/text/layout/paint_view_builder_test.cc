@@ -0,0 +1,113 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <utility>
+
+#include "evita/text/layout/text_layout_test_base.h"
+
+#include "evita/css/selector_parser.h"
+#include "evita/css/style.h"
+#include "evita/css/style_builder.h"
+#include "evita/css/style_sheet.h"
+#include "evita/editor/dom_lock.h"
+#include "evita/text/layout/block_flow.h"
+#include "evita/text/layout/paint_view_builder.h"
+#include "evita/text/layout/render_selection.h"
+#include "evita/text/models/buffer.h"
+#include "evita/text/paint/public/caret.h"
+#include "evita/text/paint/public/selection.h"
+#include "evita/text/paint/public/view.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace layout {
+
+//////////////////////////////////////////////////////////////////////
+//
+// PaintViewBuilderTest
+//
+class PaintViewBuilderTest : public TextLayoutTestBase {
+ protected:
+  PaintViewBuilderTest();
+  ~PaintViewBuilderTest() override;
+
+  BlockFlow* block() const { return block_.get(); }
+
+  scoped_refptr<paint::View> Build(const TextSelectionModel& selection);
+  scoped_refptr<paint::View> Build();
+
+ private:
+  const std::unique_ptr<BlockFlow> block_;
+  PaintViewBuilder builder_;
+
+  DISALLOW_COPY_AND_ASSIGN(PaintViewBuilderTest);
+};
+
+PaintViewBuilderTest::PaintViewBuilderTest()
+    : block_(new BlockFlow(*buffer(), *markers(), style_tree())) {
+  block()->SetBounds(bounds());
+  editor::DomLock::GetInstance()->Acquire(FROM_HERE);
+  buffer()->InsertBefore(text::Offset(0), L"foo\nbar\n");
+  block()->Format(text::Offset(0));
+}
+
+PaintViewBuilderTest::~PaintViewBuilderTest() {
+  editor::DomLock::GetInstance()->Release(FROM_HERE);
+}
+
+scoped_refptr<paint::View> PaintViewBuilderTest::Build(
+    const TextSelectionModel& selection) {
+  return builder_.Build(*block(), selection,
+                        paint::Caret(paint::CaretState::None, gfx::RectF()));
+}
+
+scoped_refptr<paint::View> PaintViewBuilderTest::Build() {
+  return Build(TextSelectionModel());
+}
+
+TEST_F(PaintViewBuilderTest, BoundsChange) {
+  EXPECT_TRUE(Build()->has_lines());
+
+  block()->SetBounds(gfx::RectF(bounds().origin(), gfx::SizeF(200, 50)));
+  block()->Format(text::Offset(0));
+  EXPECT_TRUE(Build()->has_lines());
+  EXPECT_FALSE(Build()->has_lines());
+}
+
+TEST_F(PaintViewBuilderTest, LayoutChange) {
+  EXPECT_TRUE(Build()->has_lines());
+
+  buffer()->InsertBefore(text::Offset(0), L"baz");
+  block()->Format(text::Offset(0));
+  EXPECT_TRUE(Build()->has_lines());
+  EXPECT_FALSE(Build()->has_lines());
+}
+
+// Views without lines are built for caret and selection changes, and they
+// still have new selection.
+TEST_F(PaintViewBuilderTest, ReuseLines) {
+  const auto& view1 = Build();
+  EXPECT_TRUE(view1->has_lines());
+  EXPECT_TRUE(view1->selection()->bounds_set().empty());
+
+  const auto& view2 = Build(TextSelectionModel(
+      TextSelectionModel::State::HasFocus, text::Offset(0), text::Offset(2)));
+  EXPECT_FALSE(view2->has_lines());
+  EXPECT_EQ(1u, view2->selection()->bounds_set().size());
+  EXPECT_EQ(view1->bounds(), view2->bounds());
+}
+
+TEST_F(PaintViewBuilderTest, StyleChange) {
+  EXPECT_TRUE(Build()->has_lines());
+
+  style_sheet()->AppendRule(
+      css::Selector::Parser().Parse(L"*"),
+      std::move(css::StyleBuilder()
+                    .SetColor(css::ColorValue::Rgba(255, 0, 0))
+                    .Build()));
+  EXPECT_TRUE(Build()->has_lines());
+  EXPECT_FALSE(Build()->has_lines());
+}
+
+}  // namespace layout
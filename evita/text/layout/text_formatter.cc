@@ -13,8 +13,8 @@
 #include "base/trace_event/trace_event.h"
 #include "evita/css/selector.h"
 #include "evita/css/selector_builder.h"
-#include "evita/gfx/direct2d_factory_win.h"
 #include "evita/gfx/font.h"
+#include "evita/gfx/font_backend.h"
 #include "evita/gfx/font_face.h"
 #include "evita/text/layout/known_names.h"
 #include "evita/text/layout/text_format_context.h"
@@ -44,9 +44,7 @@ const int kTabWidth = 4;
 // TODO(eval1749): We should move |AlignHeightToPixel()| to another place
 // to share code.
 float AlignHeightToPixel(float height) {
-  return gfx::Direct2DFactory::GetInstance()
-      ->AlignToPixel(gfx::SizeF(0.0f, height))
-      .height;
+  return gfx::FontBackend::GetInstance()->AlignHeightToPixel(height);
 }
 
 // TODO(eval1749): We should move |AlignWidthToPixel()| to another place
@@ -0,0 +1,64 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "evita/text/layout/text_layout_test_base.h"
+
+#include "evita/gfx/fake_font_backend.h"
+#include "evita/gfx/font_backend.h"
+#include "evita/text/layout/line/inline_box.h"
+#include "evita/text/layout/line/root_inline_box.h"
+#include "evita/text/layout/text_format_context.h"
+#include "evita/text/layout/text_formatter.h"
+#include "evita/text/models/buffer.h"
+
+namespace layout {
+
+//////////////////////////////////////////////////////////////////////
+//
+// TextFormatterFakeFontTest
+// Formats lines with |gfx::FakeFontBackend|, which gives same metrics on
+// every machine: 10pt font is 16px high and ASCII characters are 7px wide.
+//
+class TextFormatterFakeFontTest : public TextLayoutTestBase {
+ protected:
+  TextFormatterFakeFontTest() = default;
+  ~TextFormatterFakeFontTest() override = default;
+
+  // Fonts are cached forever, so we install fake backend before any test
+  // creates fonts.
+  static void SetUpTestCase() {
+    gfx::FontBackend::SetInstance(std::make_unique<gfx::FakeFontBackend>());
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(TextFormatterFakeFontTest);
+};
+
+TEST_F(TextFormatterFakeFontTest, MeasureLine) {
+  buffer()->InsertBefore(text::Offset(0), L"foo\x6771\x4EAC");
+  TextFormatter formatter(FormatContextFor(text::Offset(0)));
+  const auto line = formatter.FormatLine();
+
+  ASSERT_EQ(3, line->boxes().size());
+  const auto text_box = line->boxes()[1];
+  ASSERT_TRUE(text_box->is<InlineTextBox>());
+  // Three ASCII characters and two East Asian wide characters.
+  EXPECT_EQ(7.0f * 3 + 14.0f * 2, text_box->width());
+  EXPECT_EQ(16.0f, text_box->height());
+  EXPECT_EQ(16.0f, line->height());
+}
+
+TEST_F(TextFormatterFakeFontTest, WrapLine) {
+  // Text area is 100px wide, which doesn't have room for 20 characters.
+  buffer()->InsertBefore(text::Offset(0), L"01234567890123456789");
+  TextFormatter formatter(FormatContextFor(text::Offset(0)));
+  const auto line = formatter.FormatLine();
+
+  EXPECT_TRUE(line->IsContinuingLine());
+  EXPECT_LE(line->width(), bounds().width());
+}
+
+}  // namespace layout
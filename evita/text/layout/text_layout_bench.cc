@@ -0,0 +1,264 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Text layout benchmark with deterministic font metrics.
+//
+// Usage: text_layout_bench [--lines=N] [file]
+//
+// Replays typing, scrolling, zooming and resizing on |file| in UTF-8, or on
+// generated corpus of |N| lines, and reports format time per line, number of
+// allocations and hit rate of line cache for each scenario.
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#include "evita/css/selector_parser.h"
+#include "evita/css/style.h"
+#include "evita/css/style_builder.h"
+#include "evita/css/style_sheet.h"
+#include "evita/gfx/fake_font_backend.h"
+#include "evita/gfx/font_backend.h"
+#include "evita/gfx/rect_f.h"
+#include "evita/text/layout/block_flow.h"
+#include "evita/text/layout/text_view.h"
+#include "evita/text/models/buffer.h"
+#include "evita/text/models/marker_set.h"
+
+namespace {
+
+size_t s_allocation_count;
+
+}  // namespace
+
+// Counts allocations during scenarios.
+void* operator new(size_t size) {
+  ++s_allocation_count;
+  const auto pointer = ::malloc(size);
+  CHECK(pointer);
+  return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+  ::free(pointer);
+}
+
+namespace layout {
+
+namespace {
+
+const auto kDefaultNumberOfLines = 10000;
+const auto kBlockHeight = 800.0f;
+const auto kBlockWidth = 1200.0f;
+const auto kNumberOfResizes = 50;
+const auto kNumberOfScrolls = 2000;
+const auto kNumberOfTypedChars = 500;
+const auto kNumberOfZooms = 20;
+
+css::Selector AsSelector(base::StringPiece text) {
+  return css::Selector::Parser().Parse(base::UTF8ToUTF16(text));
+}
+
+css::StyleSheet* CreateStyleSheet() {
+  auto style_sheet = new css::StyleSheet();
+  style_sheet->AppendRule(
+      AsSelector("*"),
+      std::move(css::StyleBuilder()
+                    .SetColor(css::ColorValue::Rgba(0, 0, 0))
+                    .SetBackgroundColor(css::ColorValue::Rgba(255, 255, 255))
+                    .SetFontSize(10)
+                    .SetFontFamily(
+                        css::FontFamily(css::String(L"Consolas, Meiryo")))
+                    .Build()));
+  return style_sheet;
+}
+
+// Generates |num_lines| lines of source code, prose and Japanese text with
+// fixed seed for reproducible results.
+base::string16 GenerateCorpus(int num_lines) {
+  static const base::char16* const kWords[] = {
+      L"auto",  L"const", L"return", L"if",      L"for",
+      L"(",     L")",     L"{",      L"}",       L"=",
+      L"text",  L"line",  L"offset", L"layout",  L"width",
+      L"\t",    L"//",    L"0x7E",   L"3.14159", L"\x65E5\x672C\x8A9E",
+      L"\x6587\x5B57\x5217",
+  };
+  base::string16 corpus;
+  uint32_t seed = 1;
+  for (auto line = 0; line < num_lines; ++line) {
+    // Linear congruential generator of Numerical Recipes.
+    seed = seed * 1664525u + 1013904223u;
+    // Every 16th line is long enough to wrap.
+    const auto num_words = line % 16 == 15 ? 200 : (seed >> 24) % 16;
+    for (auto index = 0u; index < num_words; ++index) {
+      seed = seed * 1664525u + 1013904223u;
+      corpus += kWords[(seed >> 16) % arraysize(kWords)];
+      corpus += L' ';
+    }
+    corpus += L'\n';
+  }
+  return corpus;
+}
+
+base::string16 LoadCorpus(const base::CommandLine& command_line) {
+  const auto& args = command_line.GetArgs();
+  if (args.empty()) {
+    auto num_lines = kDefaultNumberOfLines;
+    if (command_line.HasSwitch("lines")) {
+      base::StringToInt(command_line.GetSwitchValueASCII("lines"),
+                        &num_lines);
+    }
+    return GenerateCorpus(num_lines);
+  }
+  std::string contents;
+  const auto& file_path = base::FilePath(args[0]);
+  if (!base::ReadFileToString(file_path, &contents)) {
+    LOG(ERROR) << "Failed to read " << file_path.value();
+    return base::string16();
+  }
+  return base::UTF8ToUTF16(contents);
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// TextLayoutBench
+//
+class TextLayoutBench final {
+ public:
+  explicit TextLayoutBench(const base::string16& corpus);
+  ~TextLayoutBench();
+
+  void Run();
+
+ private:
+  void Measure(const char* name, const std::function<void()>& scenario);
+  void Resize();
+  void Scroll();
+  void Type();
+  void Zoom();
+
+  const std::unique_ptr<text::Buffer> buffer_;
+  const std::unique_ptr<text::MarkerSet> markers_;
+  const std::unique_ptr<css::StyleSheet> style_sheet_;
+  const std::unique_ptr<TextView> text_view_;
+
+  DISALLOW_COPY_AND_ASSIGN(TextLayoutBench);
+};
+
+TextLayoutBench::TextLayoutBench(const base::string16& corpus)
+    : buffer_(new text::Buffer()),
+      markers_(new text::MarkerSet(text::MarkerSet::Kind::Sticky, *buffer_)),
+      style_sheet_(CreateStyleSheet()),
+      text_view_(new TextView(*buffer_, *markers_, style_sheet_.get())) {
+  buffer_->InsertBefore(text::Offset(0), corpus);
+  text_view_->SetBounds(gfx::RectF(gfx::SizeF(kBlockWidth, kBlockHeight)));
+}
+
+TextLayoutBench::~TextLayoutBench() {}
+
+void TextLayoutBench::Measure(const char* name,
+                              const std::function<void()>& scenario) {
+  const auto& block = text_view_->block();
+  const auto cached_start = block.cached_line_count();
+  const auto formatted_start = block.formatted_line_count();
+  const auto allocation_start = s_allocation_count;
+  const auto& time_start = base::TimeTicks::Now();
+  scenario();
+  const auto& elapsed = base::TimeTicks::Now() - time_start;
+  const auto allocations = s_allocation_count - allocation_start;
+  const auto cached = block.cached_line_count() - cached_start;
+  const auto formatted = block.formatted_line_count() - formatted_start;
+  const auto lines = std::max(formatted, static_cast<size_t>(1));
+  std::cout << std::left << std::setw(10) << name << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10)
+            << elapsed.InMillisecondsF() << " ms " << std::setw(8) << formatted
+            << " lines " << std::setw(8)
+            << elapsed.InMicrosecondsF() / lines << " us/line "
+            << std::setw(10) << allocations << " allocs " << std::setw(8)
+            << static_cast<double>(allocations) / lines << " allocs/line "
+            << std::setw(7)
+            << (cached + formatted ? 100.0 * cached / (cached + formatted)
+                                   : 0.0)
+            << "% cache hit" << std::endl;
+}
+
+void TextLayoutBench::Resize() {
+  for (auto count = 0; count < kNumberOfResizes; ++count) {
+    const auto width = kBlockWidth / 2 + (count % 10) * kBlockWidth / 10;
+    text_view_->SetBounds(gfx::RectF(gfx::SizeF(width, kBlockHeight)));
+    text_view_->FormatIfNeeded();
+  }
+  text_view_->SetBounds(gfx::RectF(gfx::SizeF(kBlockWidth, kBlockHeight)));
+  text_view_->FormatIfNeeded();
+}
+
+void TextLayoutBench::Run() {
+  Measure("format", [this]() { text_view_->Format(text::Offset(0)); });
+  Measure("scroll", [this]() { Scroll(); });
+  Measure("type", [this]() { Type(); });
+  Measure("zoom", [this]() { Zoom(); });
+  Measure("resize", [this]() { Resize(); });
+}
+
+void TextLayoutBench::Scroll() {
+  for (auto count = 0; count < kNumberOfScrolls; ++count) {
+    if (!text_view_->ScrollDown())
+      break;
+    text_view_->FormatIfNeeded();
+  }
+  for (auto count = 0; count < kNumberOfScrolls; ++count) {
+    if (!text_view_->ScrollUp())
+      break;
+    text_view_->FormatIfNeeded();
+  }
+}
+
+void TextLayoutBench::Type() {
+  text_view_->FormatIfNeeded();
+  // Type into the first visible line as caret is always visible.
+  auto offset = text_view_->text_start();
+  for (auto count = 0; count < kNumberOfTypedChars; ++count) {
+    const auto char_code = count % 40 == 39 ? L'\n' : L'a' + count % 26;
+    buffer_->InsertBefore(offset, base::string16(1, char_code));
+    offset = offset + text::OffsetDelta(1);
+    text_view_->FormatIfNeeded();
+  }
+}
+
+void TextLayoutBench::Zoom() {
+  static const float kZooms[] = {1.5f, 2.0f, 0.75f, 1.0f};
+  for (auto count = 0; count < kNumberOfZooms; ++count) {
+    text_view_->SetZoom(kZooms[count % arraysize(kZooms)]);
+    text_view_->FormatIfNeeded();
+  }
+}
+
+}  // namespace
+
+}  // namespace layout
+
+int main(int argc, char** argv) {
+  base::AtExitManager at_exit;
+  base::CommandLine::Init(argc, argv);
+  gfx::FontBackend::SetInstance(std::make_unique<gfx::FakeFontBackend>());
+  const auto& corpus =
+      layout::LoadCorpus(*base::CommandLine::ForCurrentProcess());
+  layout::TextLayoutBench(corpus).Run();
+  return 0;
+}
@@ -0,0 +1,251 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/text/models/text_diff.h"
+
+#include <algorithm>
+#include <ostream>
+
+#include "base/logging.h"
+#include "base/macros.h"
+#include "evita/text/models/buffer.h"
+#include "evita/text/models/offset.h"
+
+namespace text {
+
+namespace {
+
+// Number of inserted and deleted lines we compute minimal edits for. Myers'
+// algorithm keeps O(D^2) trace, so larger differences are replaced at once.
+const size_t kMaxEditDistance = 1000;
+
+size_t HashLine(base::StringPiece16 line) {
+  // FNV-1a
+  size_t hash = 2166136261u;
+  for (const auto char_code : line) {
+    hash ^= char_code;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// LineSequence
+// Lines in [start, end) of |lines| with their hash values for fast
+// comparison.
+//
+class LineSequence final {
+ public:
+  LineSequence(const std::vector<base::StringPiece16>& lines,
+               size_t start,
+               size_t end);
+  ~LineSequence() = default;
+
+  int size() const { return static_cast<int>(hashes_.size()); }
+
+  bool Equals(int index, const LineSequence& other, int other_index) const;
+
+ private:
+  std::vector<size_t> hashes_;
+  const std::vector<base::StringPiece16>& lines_;
+  const size_t start_;
+
+  DISALLOW_COPY_AND_ASSIGN(LineSequence);
+};
+
+LineSequence::LineSequence(const std::vector<base::StringPiece16>& lines,
+                           size_t start,
+                           size_t end)
+    : lines_(lines), start_(start) {
+  hashes_.reserve(end - start);
+  for (auto index = start; index < end; ++index)
+    hashes_.push_back(HashLine(lines[index]));
+}
+
+bool LineSequence::Equals(int index,
+                          const LineSequence& other,
+                          int other_index) const {
+  return hashes_[index] == other.hashes_[other_index] &&
+         lines_[start_ + index] == other.lines_[other.start_ + other_index];
+}
+
+size_t OffsetOfLine(const std::vector<base::StringPiece16>& lines,
+                    const base::string16& text,
+                    size_t index) {
+  if (index == lines.size())
+    return text.size();
+  return static_cast<size_t>(lines[index].data() - text.data());
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// LineEdit
+//
+bool LineEdit::operator==(const LineEdit& other) const {
+  return old_start == other.old_start && old_end == other.old_end &&
+         new_start == other.new_start && new_end == other.new_end;
+}
+
+bool LineEdit::operator!=(const LineEdit& other) const {
+  return !operator==(other);
+}
+
+std::vector<LineEdit> ComputeLineEdits(
+    const std::vector<base::StringPiece16>& old_lines,
+    const std::vector<base::StringPiece16>& new_lines,
+    size_t max_distance) {
+  const auto old_size = old_lines.size();
+  const auto new_size = new_lines.size();
+  size_t prefix = 0;
+  while (prefix < old_size && prefix < new_size &&
+         old_lines[prefix] == new_lines[prefix]) {
+    ++prefix;
+  }
+  size_t suffix = 0;
+  while (suffix < old_size - prefix && suffix < new_size - prefix &&
+         old_lines[old_size - suffix - 1] == new_lines[new_size - suffix - 1]) {
+    ++suffix;
+  }
+  const LineEdit whole = {prefix, old_size - suffix, prefix,
+                          new_size - suffix};
+  if (whole.old_start == whole.old_end && whole.new_start == whole.new_end)
+    return std::vector<LineEdit>();
+  if (whole.old_start == whole.old_end || whole.new_start == whole.new_end)
+    return std::vector<LineEdit>{whole};
+
+  const LineSequence old_sequence(old_lines, whole.old_start, whole.old_end);
+  const LineSequence new_sequence(new_lines, whole.new_start, whole.new_end);
+  const auto old_length = old_sequence.size();
+  const auto new_length = new_sequence.size();
+  const auto max_d = static_cast<int>(std::min(
+      static_cast<size_t>(old_length + new_length), max_distance));
+
+  // |furthest[center + k]| holds the furthest x on diagonal k = x - y, and
+  // |traces[d]| holds |furthest| for diagonals [-d - 1, d + 1] before
+  // step d, for backtracking.
+  const auto center = max_d + 1;
+  std::vector<int> furthest(2 * max_d + 3);
+  std::vector<std::vector<int>> traces;
+  auto found = false;
+  for (auto d = 0; d <= max_d && !found; ++d) {
+    traces.emplace_back(furthest.begin() + center - d - 1,
+                        furthest.begin() + center + d + 2);
+    for (auto k = -d; k <= d; k += 2) {
+      auto x = k == -d || (k != d && furthest[center + k - 1] <
+                                         furthest[center + k + 1])
+                   ? furthest[center + k + 1]
+                   : furthest[center + k - 1] + 1;
+      auto y = x - k;
+      while (x < old_length && y < new_length &&
+             old_sequence.Equals(x, new_sequence, y)) {
+        ++x;
+        ++y;
+      }
+      furthest[center + k] = x;
+      if (x >= old_length && y >= new_length) {
+        found = true;
+        break;
+      }
+    }
+  }
+  if (!found)
+    return std::vector<LineEdit>{whole};
+
+  // Walk back from the end, merging adjacent one line edits.
+  std::vector<LineEdit> edits;
+  auto x = old_length;
+  auto y = new_length;
+  for (auto d = static_cast<int>(traces.size()) - 1; d > 0; --d) {
+    const auto& trace = traces[d];
+    const auto k = x - y;
+    const auto prev_k =
+        k == -d || (k != d && trace[k - 1 + d + 1] < trace[k + 1 + d + 1])
+            ? k + 1
+            : k - 1;
+    const auto prev_x = trace[prev_k + d + 1];
+    const auto prev_y = prev_x - prev_k;
+    while (x > prev_x && y > prev_y) {
+      --x;
+      --y;
+    }
+    if (!edits.empty() && edits.back().old_start == static_cast<size_t>(x) &&
+        edits.back().new_start == static_cast<size_t>(y)) {
+      edits.back().old_start = static_cast<size_t>(prev_x);
+      edits.back().new_start = static_cast<size_t>(prev_y);
+    } else {
+      edits.push_back(LineEdit{static_cast<size_t>(prev_x),
+                               static_cast<size_t>(x),
+                               static_cast<size_t>(prev_y),
+                               static_cast<size_t>(y)});
+    }
+    x = prev_x;
+    y = prev_y;
+  }
+  std::reverse(edits.begin(), edits.end());
+  for (auto& edit : edits) {
+    edit.old_start += whole.old_start;
+    edit.old_end += whole.old_start;
+    edit.new_start += whole.new_start;
+    edit.new_end += whole.new_start;
+  }
+  return edits;
+}
+
+void ReplaceTextByLineEdits(Buffer* buffer, const base::string16& new_text) {
+  DCHECK(!buffer->IsReadOnly());
+  const auto& old_text = buffer->GetText(Offset(0), buffer->GetEnd());
+  if (new_text.size() >= old_text.size() &&
+      new_text.compare(0, old_text.size(), old_text) == 0) {
+    if (new_text.size() == old_text.size())
+      return;
+    buffer->InsertBefore(buffer->GetEnd(), new_text.substr(old_text.size()));
+    return;
+  }
+
+  const auto& old_lines = SplitLines(old_text);
+  const auto& new_lines = SplitLines(new_text);
+  const auto& edits = ComputeLineEdits(old_lines, new_lines, kMaxEditDistance);
+  // Apply edits from the end, so offsets of earlier edits stay valid.
+  for (auto it = edits.rbegin(); it != edits.rend(); ++it) {
+    const auto& edit = *it;
+    const auto start = Offset(
+        static_cast<int>(OffsetOfLine(old_lines, old_text, edit.old_start)));
+    const auto end = Offset(
+        static_cast<int>(OffsetOfLine(old_lines, old_text, edit.old_end)));
+    const auto new_start = OffsetOfLine(new_lines, new_text, edit.new_start);
+    const auto& replacement = new_text.substr(
+        new_start, OffsetOfLine(new_lines, new_text, edit.new_end) - new_start);
+    if (start == end)
+      buffer->InsertBefore(start, replacement);
+    else if (replacement.empty())
+      buffer->Delete(start, end);
+    else
+      buffer->Replace(start, end, replacement);
+  }
+}
+
+std::vector<base::StringPiece16> SplitLines(const base::string16& text) {
+  std::vector<base::StringPiece16> lines;
+  size_t start = 0;
+  while (start < text.size()) {
+    const auto newline = text.find('\n', start);
+    const auto end =
+        newline == base::string16::npos ? text.size() : newline + 1;
+    lines.push_back(base::StringPiece16(text.data() + start, end - start));
+    start = end;
+  }
+  return lines;
+}
+
+}  // namespace text
+
+namespace std {
+ostream& operator<<(ostream& ostream, const text::LineEdit& edit) {
+  return ostream << "LineEdit(" << edit.old_start << ", " << edit.old_end
+                 << ", " << edit.new_start << ", " << edit.new_end << ')';
+}
+}  // namespace std
@@ -0,0 +1,60 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_TEXT_MODELS_TEXT_DIFF_H_
+#define EVITA_TEXT_MODELS_TEXT_DIFF_H_
+
+#include <stddef.h>
+
+#include <iosfwd>
+#include <vector>
+
+#include "base/strings/string16.h"
+#include "base/strings/string_piece.h"
+
+namespace text {
+
+class Buffer;
+
+//////////////////////////////////////////////////////////////////////
+//
+// LineEdit
+// Replaces lines [old_start, old_end) of old text with lines
+// [new_start, new_end) of new text.
+//
+struct LineEdit final {
+  size_t old_start;
+  size_t old_end;
+  size_t new_start;
+  size_t new_end;
+
+  bool operator==(const LineEdit& other) const;
+  bool operator!=(const LineEdit& other) const;
+};
+
+// Returns minimal line edits in increasing order which transform
+// |old_lines| to |new_lines|, by Myers' O(ND) difference algorithm. When
+// number of inserted and deleted lines exceeds |max_distance|, returns one
+// edit covering all lines between common leading and trailing lines.
+std::vector<LineEdit> ComputeLineEdits(
+    const std::vector<base::StringPiece16>& old_lines,
+    const std::vector<base::StringPiece16>& new_lines,
+    size_t max_distance);
+
+// Replaces contents of |buffer| with |new_text| by minimal line edits, so
+// markers, ranges and undo history of unchanged lines are kept. When
+// |new_text| starts with contents of |buffer|, e.g. a growing log file, we
+// just append the rest of |new_text|.
+void ReplaceTextByLineEdits(Buffer* buffer, const base::string16& new_text);
+
+// Returns lines of |text|, each of which includes its trailing newline.
+std::vector<base::StringPiece16> SplitLines(const base::string16& text);
+
+}  // namespace text
+
+namespace std {
+ostream& operator<<(ostream& ostream, const text::LineEdit& edit);
+}  // namespace std
+
+#endif  // EVITA_TEXT_MODELS_TEXT_DIFF_H_
@@ -0,0 +1,94 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#pragma warning(push)
+#pragma warning(disable : 4365 4625 4626 4826)
+#include "testing/gtest/include/gtest/gtest.h"
+#pragma warning(pop)
+
+#include "evita/text/models/text_diff.h"
+
+#include "evita/text/models/buffer.h"
+#include "evita/text/models/range.h"
+
+namespace text {
+
+class TextDiffTest : public ::testing::Test {
+ public:
+  Buffer* buffer() const { return buffer_.get(); }
+
+ protected:
+  TextDiffTest() : buffer_(new Buffer()) {}
+
+  std::vector<LineEdit> Diff(const base::string16& old_text,
+                             const base::string16& new_text,
+                             size_t max_distance = 100);
+  base::string16 GetText() const;
+
+ private:
+  std::unique_ptr<Buffer> buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(TextDiffTest);
+};
+
+std::vector<LineEdit> TextDiffTest::Diff(const base::string16& old_text,
+                                         const base::string16& new_text,
+                                         size_t max_distance) {
+  return ComputeLineEdits(SplitLines(old_text), SplitLines(new_text),
+                          max_distance);
+}
+
+base::string16 TextDiffTest::GetText() const {
+  return buffer_->GetText(Offset(0), buffer_->GetEnd());
+}
+
+TEST_F(TextDiffTest, ComputeLineEdits) {
+  EXPECT_EQ(std::vector<LineEdit>(), Diff(L"a\nb\n", L"a\nb\n"));
+  EXPECT_EQ(std::vector<LineEdit>{(LineEdit{1, 1, 1, 2})},
+            Diff(L"a\nc\n", L"a\nb\nc\n"));
+  EXPECT_EQ(std::vector<LineEdit>{(LineEdit{1, 2, 1, 1})},
+            Diff(L"a\nb\nc\n", L"a\nc\n"));
+  EXPECT_EQ(std::vector<LineEdit>{(LineEdit{1, 2, 1, 2})},
+            Diff(L"a\nb\nc\n", L"a\nx\nc\n"));
+  EXPECT_EQ((std::vector<LineEdit>{LineEdit{0, 1, 0, 0},
+                                   LineEdit{3, 3, 2, 3}}),
+            Diff(L"a\nb\nc\n", L"b\nc\nd\n"));
+  EXPECT_EQ((std::vector<LineEdit>{LineEdit{1, 2, 1, 1},
+                                   LineEdit{3, 3, 2, 3}}),
+            Diff(L"a\nb\nc\nd\n", L"a\nc\nb\nd\n"));
+}
+
+TEST_F(TextDiffTest, ComputeLineEditsMaxDistance) {
+  EXPECT_EQ(std::vector<LineEdit>{(LineEdit{1, 4, 1, 4})},
+            Diff(L"a\nb\nc\nd\ne\n", L"a\nx\nc\ny\ne\n", 2));
+}
+
+TEST_F(TextDiffTest, ReplaceTextByLineEdits) {
+  buffer()->InsertBefore(Offset(0), L"foo\nbar\nbaz\n");
+  const auto range = std::make_unique<Range>(buffer(), Offset(8), Offset(11));
+  ReplaceTextByLineEdits(buffer(), L"quux\nbaz\n");
+  EXPECT_EQ(L"quux\nbaz\n", GetText());
+  EXPECT_EQ(Offset(5), range->start());
+  EXPECT_EQ(Offset(8), range->end());
+}
+
+TEST_F(TextDiffTest, ReplaceTextByLineEditsAppend) {
+  buffer()->InsertBefore(Offset(0), L"foo\nba");
+  const auto range = std::make_unique<Range>(buffer(), Offset(0), Offset(3));
+  ReplaceTextByLineEdits(buffer(), L"foo\nbar\nbaz\n");
+  EXPECT_EQ(L"foo\nbar\nbaz\n", GetText());
+  EXPECT_EQ(Offset(0), range->start());
+  EXPECT_EQ(Offset(3), range->end());
+}
+
+TEST_F(TextDiffTest, SplitLines) {
+  EXPECT_EQ(std::vector<base::StringPiece16>(), SplitLines(L""));
+  EXPECT_EQ((std::vector<base::StringPiece16>{L"a\n", L"\n", L"b"}),
+            SplitLines(L"a\n\nb"));
+}
+
+}  // namespace text
@@ -0,0 +1,81 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <utility>
+
+#include "evita/text/paint/canvas_line_rasterizer.h"
+
+#include "base/logging.h"
+#include "evita/gfx/bitmap.h"
+#include "evita/gfx/canvas.h"
+#include "evita/text/paint/public/line/root_inline_box.h"
+#include "evita/text/paint/root_inline_box_painter.h"
+
+namespace paint {
+
+namespace {
+
+//////////////////////////////////////////////////////////////////////
+//
+// BitmapLineTile
+//
+class BitmapLineTile final : public LineTile {
+ public:
+  BitmapLineTile(std::unique_ptr<gfx::Bitmap> bitmap, const gfx::SizeF& size);
+  ~BitmapLineTile() final;
+
+  const gfx::Bitmap& bitmap() const { return *bitmap_; }
+  const gfx::SizeF& size() const { return size_; }
+
+ private:
+  // LineTile
+  size_t size_in_bytes() const final;
+
+  const std::unique_ptr<gfx::Bitmap> bitmap_;
+  const gfx::SizeF size_;
+
+  DISALLOW_COPY_AND_ASSIGN(BitmapLineTile);
+};
+
+BitmapLineTile::BitmapLineTile(std::unique_ptr<gfx::Bitmap> bitmap,
+                               const gfx::SizeF& size)
+    : bitmap_(std::move(bitmap)), size_(size) {}
+
+BitmapLineTile::~BitmapLineTile() {}
+
+// We assume 32 bits per pixel.
+size_t BitmapLineTile::size_in_bytes() const {
+  const auto pixel_size = (*bitmap_)->GetPixelSize();
+  return static_cast<size_t>(pixel_size.width) * pixel_size.height * 4;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// CanvasLineRasterizer
+//
+CanvasLineRasterizer::CanvasLineRasterizer(gfx::Canvas* canvas)
+    : canvas_(canvas) {}
+
+CanvasLineRasterizer::~CanvasLineRasterizer() {}
+
+void CanvasLineRasterizer::DrawTile(const LineTile& line_tile,
+                                    const gfx::RectF& bounds) {
+  const auto& tile = static_cast<const BitmapLineTile&>(line_tile);
+  canvas_->DrawBitmap(tile.bitmap(), bounds, gfx::RectF(tile.size()));
+}
+
+std::unique_ptr<LineTile> CanvasLineRasterizer::Rasterize(
+    const RootInlineBox& line) {
+  RootInlineBoxPainter(line).Paint(canvas_);
+  canvas_->Flush();
+  auto bitmap = canvas_->CopyToBitmap(line.bounds());
+  if (!bitmap)
+    return std::unique_ptr<LineTile>();
+  return std::make_unique<BitmapLineTile>(std::move(bitmap),
+                                          line.bounds().size());
+}
+
+}  // namespace paint
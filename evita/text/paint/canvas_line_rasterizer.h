@@ -0,0 +1,41 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_TEXT_PAINT_CANVAS_LINE_RASTERIZER_H_
+#define EVITA_TEXT_PAINT_CANVAS_LINE_RASTERIZER_H_
+
+#include <memory>
+
+#include "base/macros.h"
+#include "evita/text/paint/line_tile_cache.h"
+
+namespace gfx {
+class Canvas;
+}
+
+namespace paint {
+
+//////////////////////////////////////////////////////////////////////
+//
+// CanvasLineRasterizer
+// Paints lines on |gfx::Canvas| and keeps painted pixels in device bitmap.
+//
+class CanvasLineRasterizer final : public LineRasterizer {
+ public:
+  explicit CanvasLineRasterizer(gfx::Canvas* canvas);
+  ~CanvasLineRasterizer() final;
+
+ private:
+  // LineRasterizer
+  void DrawTile(const LineTile& tile, const gfx::RectF& bounds) final;
+  std::unique_ptr<LineTile> Rasterize(const RootInlineBox& line) final;
+
+  gfx::Canvas* const canvas_;
+
+  DISALLOW_COPY_AND_ASSIGN(CanvasLineRasterizer);
+};
+
+}  // namespace paint
+
+#endif  // EVITA_TEXT_PAINT_CANVAS_LINE_RASTERIZER_H_
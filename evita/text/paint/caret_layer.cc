@@ -0,0 +1,82 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/text/paint/caret_layer.h"
+
+#include "base/logging.h"
+#include "evita/gfx/canvas.h"
+#include "evita/gfx/color_f.h"
+#include "evita/gfx/rect_conversions.h"
+#include "evita/text/paint/public/caret.h"
+#include "evita/ui/compositor/layer.h"
+
+namespace paint {
+
+//////////////////////////////////////////////////////////////////////
+//
+// CaretLayer
+//
+CaretLayer::CaretLayer() {}
+
+CaretLayer::~CaretLayer() {}
+
+// static
+gfx::RectF CaretLayer::ComputeBounds(const Caret& caret) {
+  if (!caret.is_show())
+    return gfx::RectF();
+  return gfx::RectF(gfx::ToEnclosingRect(caret.bounds()));
+}
+
+void CaretLayer::DidRealize(ui::Layer* parent_layer) {
+  SetLayer(new ui::Layer());
+  parent_layer->AppendLayer(layer());
+  // Caret layer is hidden until we have caret bounds.
+  layer()->SetClip(gfx::RectF());
+}
+
+void CaretLayer::Hide() {
+  if (!is_shown_)
+    return;
+  is_shown_ = false;
+  layer()->SetClip(gfx::RectF());
+}
+
+void CaretLayer::Show() {
+  if (is_shown_)
+    return;
+  is_shown_ = true;
+  layer()->RemoveClip();
+}
+
+void CaretLayer::Update(const Caret& caret) {
+  // Note: Layer tree can be taken by window replacement animation.
+  if (!OwnsLayer())
+    return;
+  const auto& bounds = ComputeBounds(caret);
+  if (bounds.empty())
+    return Hide();
+  layer()->SetBounds(bounds);
+  if (!canvas_)
+    canvas_.reset(layer()->CreateCanvas());
+  else
+    canvas_->SetBounds(gfx::RectF(bounds.size()));
+  if (!canvas_->UpdateReadyState())
+    return Hide();
+  if (bitmap_id_ != canvas_->bitmap_id()) {
+    // Caret layer is painted only when layer is resized or render target is
+    // recreated.
+    gfx::Canvas::DrawingScope drawing_scope(canvas_.get());
+    canvas_->AddDirtyRect(canvas_->GetLocalBounds());
+    canvas_->Clear(gfx::ColorF::Black);
+    bitmap_id_ = canvas_->bitmap_id();
+  }
+  Show();
+}
+
+void CaretLayer::WillDestroyWidget() {
+  canvas_.reset();
+  DestroyLayer();
+}
+
+}  // namespace paint
@@ -0,0 +1,55 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_TEXT_PAINT_CARET_LAYER_H_
+#define EVITA_TEXT_PAINT_CARET_LAYER_H_
+
+#include <memory>
+
+#include "base/macros.h"
+#include "evita/gfx/rect_f.h"
+#include "evita/ui/compositor/layer_owner.h"
+
+namespace gfx {
+class Canvas;
+}
+
+namespace paint {
+
+class Caret;
+
+//////////////////////////////////////////////////////////////////////
+//
+// CaretLayer
+// Displays caret in its own layer above text. Moving caret changes origin of
+// layer and blinking caret changes clip of layer, so neither of them paints
+// text area.
+//
+class CaretLayer final : public ui::LayerOwner {
+ public:
+  CaretLayer();
+  ~CaretLayer() final;
+
+  void DidRealize(ui::Layer* parent_layer);
+  void Update(const Caret& caret);
+  void WillDestroyWidget();
+
+  // Returns bounds of caret layer for |caret| in pixels, or empty rectangle
+  // if caret layer should be hidden.
+  static gfx::RectF ComputeBounds(const Caret& caret);
+
+ private:
+  void Hide();
+  void Show();
+
+  int bitmap_id_ = -1;
+  std::unique_ptr<gfx::Canvas> canvas_;
+  bool is_shown_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(CaretLayer);
+};
+
+}  // namespace paint
+
+#endif  // EVITA_TEXT_PAINT_CARET_LAYER_H_
@@ -0,0 +1,26 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/text/paint/caret_layer.h"
+
+#include "evita/text/paint/public/caret.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace paint {
+
+TEST(CaretLayerTest, ComputeBounds) {
+  const auto& bounds =
+      gfx::RectF(gfx::PointF(10.5f, 20.0f), gfx::SizeF(1.0f, 15.5f));
+  EXPECT_EQ(gfx::RectF(gfx::PointF(10, 20), gfx::SizeF(2, 16)),
+            CaretLayer::ComputeBounds(Caret(CaretState::Show, bounds)));
+  EXPECT_TRUE(
+      CaretLayer::ComputeBounds(Caret(CaretState::Hide, bounds)).empty());
+  EXPECT_TRUE(
+      CaretLayer::ComputeBounds(Caret(CaretState::None, bounds)).empty());
+  EXPECT_TRUE(
+      CaretLayer::ComputeBounds(Caret(CaretState::Show, gfx::RectF()))
+          .empty());
+}
+
+}  // namespace paint
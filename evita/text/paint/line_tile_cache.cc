@@ -0,0 +1,228 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <functional>
+#include <utility>
+
+#include "evita/text/paint/line_tile_cache.h"
+
+#include "base/logging.h"
+#include "base/trace_event/trace_event.h"
+#include "evita/text/paint/public/line/inline_box.h"
+#include "evita/text/paint/public/line/root_inline_box.h"
+
+namespace paint {
+
+//////////////////////////////////////////////////////////////////////
+//
+// LineTile
+//
+LineTile::LineTile() {}
+LineTile::~LineTile() {}
+
+//////////////////////////////////////////////////////////////////////
+//
+// LineRasterizer
+//
+LineRasterizer::LineRasterizer() {}
+LineRasterizer::~LineRasterizer() {}
+
+//////////////////////////////////////////////////////////////////////
+//
+// LineTileCache::BoxKey
+// Holds values of |InlineBox| which affect image of line. Cache entries
+// must not refer |ComputedStyle| of inline boxes, since style recalc
+// destroys them and can allocate new style at same address. Fonts live
+// until process exit, so we compare them by address.
+//
+struct LineTileCache::BoxKey final {
+  explicit BoxKey(const InlineBox& box);
+
+  bool operator==(const BoxKey& other) const;
+  bool operator!=(const BoxKey& other) const { return !operator==(other); }
+
+  size_t Hash() const;
+
+  gfx::ColorF bgcolor;
+  base::string16 characters;
+  const char* class_name;
+  gfx::ColorF color;
+  const gfx::Font* font = nullptr;
+  float height;
+  float line_height;
+  int marker_name = -1;
+  gfx::ColorF text_decoration_color;
+  layout::TextDecorationLine text_decoration_line;
+  layout::TextDecorationStyle text_decoration_style;
+  float top;
+  float width;
+};
+
+LineTileCache::BoxKey::BoxKey(const InlineBox& box)
+    : bgcolor(box.style().bgcolor()),
+      class_name(box.class_name()),
+      color(box.style().color()),
+      height(box.height()),
+      line_height(box.line_height()),
+      text_decoration_color(box.style().text_decoration_color()),
+      text_decoration_line(box.style().text_decoration_line()),
+      text_decoration_style(box.style().text_decoration_style()),
+      top(box.top()),
+      width(box.width()) {
+  if (auto* const marker_box = box.as<InlineMarkerBox>()) {
+    font = &marker_box->font();
+    marker_name = static_cast<int>(marker_box->marker_name());
+    return;
+  }
+  if (auto* const text_box = box.as<InlineTextBoxBase>()) {
+    characters = text_box->characters();
+    font = &text_box->font();
+  }
+}
+
+bool LineTileCache::BoxKey::operator==(const BoxKey& other) const {
+  return class_name == other.class_name && width == other.width &&
+         height == other.height && top == other.top &&
+         line_height == other.line_height &&
+         marker_name == other.marker_name && font == other.font &&
+         characters == other.characters && bgcolor == other.bgcolor &&
+         color == other.color &&
+         text_decoration_color == other.text_decoration_color &&
+         text_decoration_line == other.text_decoration_line &&
+         text_decoration_style == other.text_decoration_style;
+}
+
+size_t LineTileCache::BoxKey::Hash() const {
+  auto hash_code = std::hash<base::string16>()(characters);
+  hash_code ^= std::hash<const char*>()(class_name);
+  hash_code ^= static_cast<size_t>(width) << 8;
+  hash_code ^= static_cast<size_t>(line_height);
+  hash_code ^= static_cast<size_t>(marker_name + 1) << 4;
+  return hash_code;
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// LineTileCache::Entry
+//
+class LineTileCache::Entry final {
+ public:
+  Entry(LineKey&& key,
+        size_t hash_code,
+        const gfx::SizeF& size,
+        std::unique_ptr<LineTile> tile);
+  ~Entry();
+
+  size_t hash_code() const { return hash_code_; }
+  const LineKey& key() const { return key_; }
+  const gfx::SizeF& size() const { return size_; }
+  const LineTile& tile() const { return *tile_; }
+
+ private:
+  const size_t hash_code_;
+  const LineKey key_;
+  const gfx::SizeF size_;
+  const std::unique_ptr<LineTile> tile_;
+
+  DISALLOW_COPY_AND_ASSIGN(Entry);
+};
+
+LineTileCache::Entry::Entry(LineKey&& key,
+                            size_t hash_code,
+                            const gfx::SizeF& size,
+                            std::unique_ptr<LineTile> tile)
+    : hash_code_(hash_code),
+      key_(std::move(key)),
+      size_(size),
+      tile_(std::move(tile)) {}
+
+LineTileCache::Entry::~Entry() {}
+
+//////////////////////////////////////////////////////////////////////
+//
+// LineTileCache
+//
+LineTileCache::LineTileCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+LineTileCache::~LineTileCache() {}
+
+void LineTileCache::Clear() {
+  map_.clear();
+  entries_.clear();
+  size_in_bytes_ = 0;
+}
+
+void LineTileCache::EvictIfNeeded() {
+  while (size_in_bytes_ > max_bytes_ && !entries_.empty()) {
+    const auto& entry = entries_.back();
+    const auto& range = map_.equal_range(entry->hash_code());
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second->get() != entry.get())
+        continue;
+      map_.erase(it);
+      break;
+    }
+    size_in_bytes_ -= entry->tile().size_in_bytes();
+    entries_.pop_back();
+  }
+}
+
+LineTileCache::EntryList::iterator LineTileCache::Find(
+    const LineKey& key,
+    size_t hash_code,
+    const gfx::SizeF& size) {
+  const auto& range = map_.equal_range(hash_code);
+  for (auto it = range.first; it != range.second; ++it) {
+    const auto& entry = *it->second;
+    if (entry->size() == size && entry->key() == key)
+      return it->second;
+  }
+  return entries_.end();
+}
+
+// static
+LineTileCache::LineKey LineTileCache::KeyOf(const RootInlineBox& line) {
+  LineKey key;
+  key.reserve(line.boxes().size());
+  for (const auto& box : line.boxes())
+    key.emplace_back(*box);
+  return key;
+}
+
+// static
+size_t LineTileCache::HashOf(const LineKey& key) {
+  auto hash_code = key.size();
+  for (const auto& box_key : key)
+    hash_code = hash_code * 31 + box_key.Hash();
+  return hash_code;
+}
+
+void LineTileCache::Paint(LineRasterizer* rasterizer,
+                          const RootInlineBox& line) {
+  auto key = KeyOf(line);
+  const auto hash_code = HashOf(key);
+  const auto& it = Find(key, hash_code, line.bounds().size());
+  if (it != entries_.end()) {
+    ++hit_count_;
+    // Move |entry| to most recently used position.
+    entries_.splice(entries_.begin(), entries_, it);
+    rasterizer->DrawTile((*it)->tile(), line.bounds());
+    return;
+  }
+  TRACE_EVENT0("view", "LineTileCache::Rasterize");
+  ++miss_count_;
+  auto tile = rasterizer->Rasterize(line);
+  if (!tile)
+    return;
+  const auto tile_size = tile->size_in_bytes();
+  if (tile_size > max_bytes_)
+    return;
+  entries_.emplace_front(new Entry(std::move(key), hash_code,
+                                   line.bounds().size(), std::move(tile)));
+  map_.emplace(entries_.front()->hash_code(), entries_.begin());
+  size_in_bytes_ += tile_size;
+  EvictIfNeeded();
+}
+
+}  // namespace paint
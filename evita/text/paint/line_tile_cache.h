@@ -0,0 +1,117 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_TEXT_PAINT_LINE_TILE_CACHE_H_
+#define EVITA_TEXT_PAINT_LINE_TILE_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "base/macros.h"
+#include "evita/gfx/rect_f.h"
+
+namespace paint {
+
+class RootInlineBox;
+
+//////////////////////////////////////////////////////////////////////
+//
+// LineTile
+// Represents rasterized image of a |RootInlineBox|.
+//
+class LineTile {
+ public:
+  virtual ~LineTile();
+
+  // Returns number of bytes used by this tile.
+  virtual size_t size_in_bytes() const = 0;
+
+ protected:
+  LineTile();
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(LineTile);
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// LineRasterizer
+// Rasterizes |RootInlineBox| into |LineTile| and draws |LineTile| to canvas.
+//
+class LineRasterizer {
+ public:
+  virtual ~LineRasterizer();
+
+  // Draws |tile| at |bounds|.
+  virtual void DrawTile(const LineTile& tile, const gfx::RectF& bounds) = 0;
+
+  // Paints |line| at its bounds and returns rasterized image of |line|, or
+  // null if rasterizer can't make tile.
+  virtual std::unique_ptr<LineTile> Rasterize(const RootInlineBox& line) = 0;
+
+ protected:
+  LineRasterizer();
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(LineRasterizer);
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// LineTileCache
+// Keeps rasterized images of lines for painting lines without rasterizing
+// them again, e.g. scrolling back to lines just shown. Tiles are evicted in
+// least recently used order when total size of tiles exceeds |max_bytes|.
+//
+class LineTileCache final {
+ public:
+  explicit LineTileCache(size_t max_bytes);
+  ~LineTileCache();
+
+  size_t hit_count() const { return hit_count_; }
+  size_t max_bytes() const { return max_bytes_; }
+  size_t miss_count() const { return miss_count_; }
+  size_t size() const { return entries_.size(); }
+  size_t size_in_bytes() const { return size_in_bytes_; }
+
+  // Discards all tiles, e.g. render target is recreated.
+  void Clear();
+
+  // Paints |line| with cached tile if available, otherwise paints |line| by
+  // |rasterizer| and caches result.
+  void Paint(LineRasterizer* rasterizer, const RootInlineBox& line);
+
+ private:
+  struct BoxKey;
+  class Entry;
+  using EntryList = std::list<std::unique_ptr<Entry>>;
+  // Cache entries are keyed by values of inline boxes rather than line
+  // itself, since inline boxes refer computed styles.
+  using LineKey = std::vector<BoxKey>;
+
+  void EvictIfNeeded();
+  EntryList::iterator Find(const LineKey& key,
+                           size_t hash_code,
+                           const gfx::SizeF& size);
+
+  static size_t HashOf(const LineKey& key);
+  static LineKey KeyOf(const RootInlineBox& line);
+
+  // |entries_| holds cache entries in most recently used order.
+  EntryList entries_;
+  size_t hit_count_ = 0;
+  // |map_| maps hash code of line to entry in |entries_|.
+  std::unordered_multimap<size_t, EntryList::iterator> map_;
+  const size_t max_bytes_;
+  size_t miss_count_ = 0;
+  size_t size_in_bytes_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(LineTileCache);
+};
+
+}  // namespace paint
+
+#endif  // EVITA_TEXT_PAINT_LINE_TILE_CACHE_H_
@@ -0,0 +1,222 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "evita/text/paint/line_tile_cache.h"
+
+#include "base/memory/ref_counted.h"
+#include "evita/gfx/color_f.h"
+#include "evita/text/paint/public/line/inline_box.h"
+#include "evita/text/paint/public/line/root_inline_box.h"
+#include "evita/text/style/computed_style.h"
+#include "evita/text/style/computed_style_builder.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace paint {
+
+namespace {
+
+const auto kLineHeight = 10.0f;
+
+//////////////////////////////////////////////////////////////////////
+//
+// FakeLineTile
+//
+class FakeLineTile final : public LineTile {
+ public:
+  FakeLineTile(int id, size_t size) : id_(id), size_(size) {}
+  ~FakeLineTile() final = default;
+
+  int id() const { return id_; }
+
+ private:
+  // LineTile
+  size_t size_in_bytes() const final { return size_; }
+
+  const int id_;
+  const size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeLineTile);
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// FakeLineRasterizer
+// A software canvas which records painting operations as text.
+//
+class FakeLineRasterizer final : public LineRasterizer {
+ public:
+  FakeLineRasterizer() = default;
+  ~FakeLineRasterizer() final = default;
+
+  std::string TakeLog();
+
+ private:
+  // LineRasterizer
+  void DrawTile(const LineTile& tile, const gfx::RectF& bounds) final;
+  std::unique_ptr<LineTile> Rasterize(const RootInlineBox& line) final;
+
+  int last_tile_id_ = 0;
+  std::ostringstream log_;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeLineRasterizer);
+};
+
+void FakeLineRasterizer::DrawTile(const LineTile& tile,
+                                  const gfx::RectF& bounds) {
+  log_ << "draw " << static_cast<const FakeLineTile&>(tile).id() << " at "
+       << bounds.top << ' ';
+}
+
+std::unique_ptr<LineTile> FakeLineRasterizer::Rasterize(
+    const RootInlineBox& line) {
+  ++last_tile_id_;
+  log_ << "raster " << last_tile_id_ << " at " << line.top() << ' ';
+  return std::make_unique<FakeLineTile>(
+      last_tile_id_, static_cast<size_t>(line.width() * line.height()));
+}
+
+std::string FakeLineRasterizer::TakeLog() {
+  const auto& result = log_.str();
+  log_.str("");
+  return result;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// LineTileCacheTest
+//
+class LineTileCacheTest : public ::testing::Test {
+ protected:
+  LineTileCacheTest();
+  ~LineTileCacheTest() override = default;
+
+  FakeLineRasterizer* rasterizer() { return &rasterizer_; }
+
+  // Returns a line which has a filler box of |width|. Lines with same width
+  // have same contents.
+  scoped_refptr<RootInlineBox> NewLine(float width, float top);
+  scoped_refptr<RootInlineBox> NewLine(const layout::ComputedStyle& style,
+                                       float width,
+                                       float top);
+
+  static std::unique_ptr<layout::ComputedStyle> NewStyle(
+      const gfx::ColorF& bgcolor);
+
+ private:
+  FakeLineRasterizer rasterizer_;
+  const std::unique_ptr<layout::ComputedStyle> style_;
+
+  DISALLOW_COPY_AND_ASSIGN(LineTileCacheTest);
+};
+
+LineTileCacheTest::LineTileCacheTest()
+    : style_(NewStyle(gfx::ColorF(1, 1, 1))) {}
+
+scoped_refptr<RootInlineBox> LineTileCacheTest::NewLine(float width,
+                                                        float top) {
+  return NewLine(*style_, width, top);
+}
+
+scoped_refptr<RootInlineBox> LineTileCacheTest::NewLine(
+    const layout::ComputedStyle& style,
+    float width,
+    float top) {
+  std::vector<InlineBox*> boxes;
+  boxes.push_back(
+      new InlineFillerBox(style, width, kLineHeight, kLineHeight, 0.0f));
+  const auto& bounds =
+      gfx::RectF(gfx::PointF(0.0f, top), gfx::SizeF(width, kLineHeight));
+  return base::WrapRefCounted(new RootInlineBox(boxes, bounds));
+}
+
+// static
+std::unique_ptr<layout::ComputedStyle> LineTileCacheTest::NewStyle(
+    const gfx::ColorF& bgcolor) {
+  return layout::ComputedStyle::Builder()
+      .SetBackgroundColor(bgcolor)
+      .SetColor(gfx::ColorF(0, 0, 0))
+      .Build();
+}
+
+TEST_F(LineTileCacheTest, Clear) {
+  LineTileCache cache(1000);
+  cache.Paint(rasterizer(), *NewLine(10, 0));
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(100u, cache.size_in_bytes());
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(0u, cache.size_in_bytes());
+  cache.Paint(rasterizer(), *NewLine(10, 0));
+  EXPECT_EQ("raster 1 at 0 raster 2 at 0 ", rasterizer()->TakeLog());
+}
+
+TEST_F(LineTileCacheTest, Evict) {
+  LineTileCache cache(250);
+  cache.Paint(rasterizer(), *NewLine(10, 0));
+  cache.Paint(rasterizer(), *NewLine(11, 10));
+  cache.Paint(rasterizer(), *NewLine(10, 20));
+  EXPECT_EQ("raster 1 at 0 raster 2 at 10 draw 1 at 20 ",
+            rasterizer()->TakeLog());
+  EXPECT_EQ(210u, cache.size_in_bytes());
+
+  // Line of width 11 is least recently used.
+  cache.Paint(rasterizer(), *NewLine(12, 30));
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_EQ(220u, cache.size_in_bytes());
+  cache.Paint(rasterizer(), *NewLine(10, 40));
+  cache.Paint(rasterizer(), *NewLine(11, 50));
+  EXPECT_EQ("raster 3 at 30 draw 1 at 40 raster 4 at 50 ",
+            rasterizer()->TakeLog());
+}
+
+TEST_F(LineTileCacheTest, Paint) {
+  LineTileCache cache(1000);
+  cache.Paint(rasterizer(), *NewLine(10, 0));
+  cache.Paint(rasterizer(), *NewLine(20, 10));
+  EXPECT_EQ("raster 1 at 0 raster 2 at 10 ", rasterizer()->TakeLog());
+  EXPECT_EQ(0u, cache.hit_count());
+  EXPECT_EQ(2u, cache.miss_count());
+
+  // Scroll up
+  cache.Paint(rasterizer(), *NewLine(10, 10));
+  cache.Paint(rasterizer(), *NewLine(20, 20));
+  EXPECT_EQ("draw 1 at 10 draw 2 at 20 ", rasterizer()->TakeLog());
+  EXPECT_EQ(2u, cache.hit_count());
+  EXPECT_EQ(2u, cache.miss_count());
+}
+
+// Cache entries should not refer styles, since style recalc destroys them.
+TEST_F(LineTileCacheTest, StyleValues) {
+  LineTileCache cache(1000);
+  auto style1 = NewStyle(gfx::ColorF(1, 1, 1));
+  cache.Paint(rasterizer(), *NewLine(*style1, 10, 0));
+  style1.reset();
+
+  // Same values in another style object.
+  const auto& style2 = NewStyle(gfx::ColorF(1, 1, 1));
+  cache.Paint(rasterizer(), *NewLine(*style2, 10, 10));
+  // Different values
+  const auto& style3 = NewStyle(gfx::ColorF(1, 0, 0));
+  cache.Paint(rasterizer(), *NewLine(*style3, 10, 20));
+  EXPECT_EQ("raster 1 at 0 draw 1 at 10 raster 2 at 20 ",
+            rasterizer()->TakeLog());
+}
+
+TEST_F(LineTileCacheTest, TooLargeTile) {
+  LineTileCache cache(50);
+  cache.Paint(rasterizer(), *NewLine(10, 0));
+  cache.Paint(rasterizer(), *NewLine(10, 10));
+  EXPECT_EQ("raster 1 at 0 raster 2 at 10 ", rasterizer()->TakeLog());
+  EXPECT_EQ(0u, cache.size());
+}
+
+}  // namespace paint
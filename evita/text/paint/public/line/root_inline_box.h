@@ -37,6 +37,9 @@ class RootInlineBox final : public base::RefCounted<RootInlineBox> {
   const gfx::PointF origin() const { return bounds_.origin(); }
   float width() const { return bounds_.width(); }
 
+  // Returns hash code computed from inline boxes. Hash code doesn't depend
+  // on |bounds()|, so we can find same line at another position.
+  size_t ComputeHashCode() const;
   RootInlineBox* Copy() const;
   bool Equal(const RootInlineBox*) const;
 
@@ -45,8 +48,6 @@ class RootInlineBox final : public base::RefCounted<RootInlineBox> {
 
   ~RootInlineBox();
 
-  size_t ComputeHashCode() const;
-
   const gfx::RectF bounds_;
   const std::vector<InlineBox*> boxes_;
   mutable size_t hash_code_ = 0;
@@ -44,6 +44,9 @@ class View final : public base::RefCounted<View> {
   const Caret& caret() const { return *caret_; }
   const std::vector<RootInlineBox*>& lines() const { return lines_; }
   const Ruler& ruler() const { return *ruler_; }
+  // Returns true if this view has lines. Views built for caret and selection
+  // changes don't have lines, see |layout::PaintViewBuilder|.
+  bool has_lines() const { return !lines_.empty(); }
   scoped_refptr<Selection> selection() const { return selection_; }
   int layout_version() const { return layout_version_; }
 
@@ -3,12 +3,14 @@
 // found in the LICENSE file.
 
 #include <algorithm>
+#include <cmath>
 
 #include "evita/text/paint/root_inline_box_list_painter.h"
 
 #include "base/logging.h"
 #include "evita/gfx/brush.h"
 #include "evita/gfx/canvas.h"
+#include "evita/text/paint/line_tile_cache.h"
 #include "evita/text/paint/public/line/inline_box.h"
 #include "evita/text/paint/public/line/root_inline_box.h"
 #include "evita/text/paint/root_inline_box_painter.h"
@@ -59,12 +61,21 @@ RootInlineBoxListPainter::RootInlineBoxListPainter(
     const gfx::RectF& bounds,
     const gfx::ColorF& bgcolor,
     const std::vector<RootInlineBox*>& format_lines,
-    const std::vector<RootInlineBox*>& screen_lines)
+    const std::vector<RootInlineBox*>& screen_lines,
+    LineTileCache* line_tile_cache)
     : bgcolor_(bgcolor),
       bounds_(bounds),
       canvas_(canvas),
       format_lines_(format_lines),
-      screen_lines_(screen_lines) {}
+      line_tile_cache_(line_tile_cache),
+      rasterizer_(canvas),
+      screen_lines_(screen_lines) {
+  screen_line_map_.reserve(screen_lines_.size());
+  for (auto runner = screen_lines_.begin(); runner != screen_lines_.end();
+       ++runner) {
+    screen_line_map_.emplace((*runner)->ComputeHashCode(), runner);
+  }
+}
 
 RootInlineBoxListPainter::~RootInlineBoxListPainter() {}
 
@@ -106,8 +117,8 @@ void RootInlineBoxListPainter::DrawDirtyRect(const gfx::RectF& rect,
   }
 }
 
-void RootInlineBoxListPainter::FillBottom(const RootInlineBox* line) const {
-  auto const rect = gfx::RectF(gfx::PointF(bounds_.left, line->bottom()),
+void RootInlineBoxListPainter::FillBottom(float top) const {
+  auto const rect = gfx::RectF(gfx::PointF(bounds_.left, top),
                                bounds_.bottom_right())
                         .Intersect(bounds_);
   if (rect.empty())
@@ -174,18 +185,31 @@ RootInlineBoxListPainter::FindLastMatch() const {
                          *format_last_match);
 }
 
+// Returns screen line which has same contents as |format_line| in
+// |screen_lines_|. We prefer a screen line at same position for skipping
+// copy, then nearest screen line fully visible on screen.
 RootInlineBoxListPainter::FormatLineIterator
 RootInlineBoxListPainter::FindCopyable(RootInlineBox* format_line) const {
-  for (auto runner = screen_lines_.begin(); runner != screen_lines_.end();
-       ++runner) {
-    auto const screen_line = *runner;
-    if (screen_line->Equal(format_line) &&
-        (format_line->bounds().top == screen_line->bounds().top ||
-         screen_line->bounds().bottom <= bounds_.bottom)) {
+  const auto& range =
+      screen_line_map_.equal_range(format_line->ComputeHashCode());
+  auto candidate = screen_lines_.end();
+  auto candidate_distance = 0.0f;
+  for (auto it = range.first; it != range.second; ++it) {
+    const auto runner = it->second;
+    const auto screen_line = *runner;
+    if (!screen_line->Equal(format_line))
+      continue;
+    if (format_line->top() == screen_line->top())
       return runner;
-    }
+    if (screen_line->bottom() > bounds_.bottom)
+      continue;
+    const auto distance = std::abs(format_line->top() - screen_line->top());
+    if (candidate != screen_lines_.end() && distance >= candidate_distance)
+      continue;
+    candidate = runner;
+    candidate_distance = distance;
   }
-  return screen_lines_.end();
+  return candidate;
 }
 
 void RootInlineBoxListPainter::Finish() {
@@ -212,15 +236,16 @@ bool RootInlineBoxListPainter::Paint() {
   DVLOG(0) << "Start painting";
 #endif
 
-  if (VLOG_IS_ON(0)) {
+  if (VLOG_IS_ON(0) && !format_lines_.empty()) {
     // TextBlock must cover whole screen area.
     auto const last_format_line = format_lines_.back();
     if (!last_format_line->last_box()->is<InlineMarkerBox>())
       DCHECK_GE(last_format_line->bounds().bottom, bounds_.bottom);
   }
 
-  gfx::Canvas::AxisAlignedClipScope clip_scope(canvas_, bounds_);
-
+  // We don't push clip here, since |LineTileCache| copies pixels of lines
+  // from render target, which doesn't allow clip. Painting operations other
+  // than |PaintLine()| are bounded by |bounds_|.
   auto const dirty_line_start = FindFirstMismatch();
   if (dirty_line_start != format_lines_.end()) {
     auto const clean_line_start = FindLastMatch();
@@ -236,7 +261,7 @@ bool RootInlineBoxListPainter::Paint() {
       if (dirty_line_runner == clean_line_start)
         break;
       auto const format_line = *dirty_line_runner;
-      RootInlineBoxPainter(*format_line).Paint(canvas_);
+      PaintLine(*format_line);
       FillRight(format_line);
       AddRect(&dirty_rects_, format_line->bounds());
       canvas_->Flush();
@@ -244,13 +269,20 @@ bool RootInlineBoxListPainter::Paint() {
   }
 
   // Erase dirty rectangle markers.
+  gfx::Canvas::AxisAlignedClipScope clip_scope(canvas_, bounds_);
   for (auto rect : skip_rects_) {
 #if DEBUG_DRAW
     DVLOG(0) << "skip " << rect;
 #endif
     RestoreSkipRect(rect);
   }
-  FillBottom(format_lines_.back());
+  if (format_lines_.empty()) {
+    // Nothing is formatted yet.
+    FillBottom(bounds_.top);
+    AddRect(&dirty_rects_, bounds_);
+  } else {
+    FillBottom(format_lines_.back()->bottom());
+  }
 
   auto const dirty = !copy_rects_.empty() || !dirty_rects_.empty();
 #if DEBUG_DRAW
@@ -259,6 +291,18 @@ bool RootInlineBoxListPainter::Paint() {
   return dirty;
 }
 
+// Paints |line| with |line_tile_cache_| if |line| is fully visible, since
+// line tile must have whole image of line. Fully visible line doesn't need
+// clip.
+void RootInlineBoxListPainter::PaintLine(const RootInlineBox& line) {
+  if (line_tile_cache_ && bounds_.Contains(line.bounds())) {
+    line_tile_cache_->Paint(&rasterizer_, line);
+    return;
+  }
+  gfx::Canvas::AxisAlignedClipScope clip_scope(canvas_, bounds_);
+  RootInlineBoxPainter(line).Paint(canvas_);
+}
+
 void RootInlineBoxListPainter::RestoreSkipRect(const gfx::RectF& rect) const {
   auto marker_rect = rect;
   marker_rect.left += kMarkerLeftMargin;
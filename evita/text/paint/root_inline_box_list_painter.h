@@ -5,14 +5,17 @@
 #ifndef EVITA_TEXT_PAINT_ROOT_INLINE_BOX_LIST_PAINTER_H_
 #define EVITA_TEXT_PAINT_ROOT_INLINE_BOX_LIST_PAINTER_H_
 
+#include <unordered_map>
 #include <vector>
 
 #include "base/macros.h"
 #include "evita/gfx/color_f.h"
 #include "evita/gfx/rect_f.h"
+#include "evita/text/paint/canvas_line_rasterizer.h"
 
 namespace paint {
 
+class LineTileCache;
 class RootInlineBox;
 
 //////////////////////////////////////////////////////////////////////
@@ -27,9 +30,13 @@ class RootInlineBoxListPainter final {
                            const gfx::RectF& bounds,
                            const gfx::ColorF& bgcolor,
                            const std::vector<RootInlineBox*>& format_lines,
-                           const std::vector<RootInlineBox*>& screen_lines);
+                           const std::vector<RootInlineBox*>& screen_lines,
+                           LineTileCache* line_tile_cache);
   ~RootInlineBoxListPainter();
 
+  // Returns screen line which can be copied to |format_line|, or end of
+  // screen lines if |format_line| should be painted.
+  FormatLineIterator FindCopyable(RootInlineBox* format_line) const;
   void Finish();
   bool Paint();
   FormatLineIterator TryCopy(const FormatLineIterator& format_line_start,
@@ -41,12 +48,12 @@ class RootInlineBoxListPainter final {
                      float red,
                      float green,
                      float blue) const;
-  void FillBottom(const RootInlineBox* line) const;
+  // Fills area below |top| with background color.
+  void FillBottom(float top) const;
   void FillRight(const RootInlineBox* line) const;
   FormatLineIterator FindFirstMismatch() const;
   FormatLineIterator FindLastMatch() const;
-  std::vector<RootInlineBox*>::const_iterator FindCopyable(
-      RootInlineBox* line) const;
+  void PaintLine(const RootInlineBox& line);
   void RestoreSkipRect(const gfx::RectF& rect) const;
 
   const gfx::ColorF bgcolor_;
@@ -55,7 +62,13 @@ class RootInlineBoxListPainter final {
   mutable std::vector<gfx::RectF> copy_rects_;
   mutable std::vector<gfx::RectF> dirty_rects_;
   const std::vector<RootInlineBox*>& format_lines_;
+  LineTileCache* const line_tile_cache_;
+  CanvasLineRasterizer rasterizer_;
   const std::vector<RootInlineBox*>& screen_lines_;
+  // |screen_line_map_| maps hash code of screen line to position in
+  // |screen_lines_| for finding screen line which can be copied to format
+  // line.
+  std::unordered_multimap<size_t, FormatLineIterator> screen_line_map_;
   mutable std::vector<gfx::RectF> skip_rects_;
 
   DISALLOW_COPY_AND_ASSIGN(RootInlineBoxListPainter);
@@ -0,0 +1,126 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include "evita/text/paint/root_inline_box_list_painter.h"
+
+#include "base/memory/ref_counted.h"
+#include "evita/gfx/color_f.h"
+#include "evita/text/paint/public/line/inline_box.h"
+#include "evita/text/paint/public/line/root_inline_box.h"
+#include "evita/text/style/computed_style.h"
+#include "evita/text/style/computed_style_builder.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace paint {
+
+namespace {
+
+const auto kLineHeight = 10.0f;
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// RootInlineBoxListPainterTest
+//
+class RootInlineBoxListPainterTest : public ::testing::Test {
+ protected:
+  RootInlineBoxListPainterTest();
+  ~RootInlineBoxListPainterTest() override = default;
+
+  // Adds a screen line, which is painted on screen before.
+  void AddScreenLine(float width, float top);
+
+  // Returns top of screen line copied to format line of |width| at |top|,
+  // or -1 if format line should be painted.
+  float FindCopyable(float width, float top);
+
+  // Returns a line which has a filler box of |width|. Lines with same width
+  // have same contents.
+  RootInlineBox* NewLine(float width, float top);
+
+ private:
+  const gfx::RectF bounds_;
+  std::vector<scoped_refptr<RootInlineBox>> lines_;
+  std::vector<RootInlineBox*> screen_lines_;
+  const std::unique_ptr<layout::ComputedStyle> style_;
+
+  DISALLOW_COPY_AND_ASSIGN(RootInlineBoxListPainterTest);
+};
+
+RootInlineBoxListPainterTest::RootInlineBoxListPainterTest()
+    : bounds_(gfx::PointF(0.0f, 0.0f), gfx::SizeF(100.0f, 40.0f)),
+      style_(layout::ComputedStyle::Builder()
+                 .SetBackgroundColor(gfx::ColorF(1, 1, 1))
+                 .SetColor(gfx::ColorF(0, 0, 0))
+                 .Build()) {}
+
+void RootInlineBoxListPainterTest::AddScreenLine(float width, float top) {
+  screen_lines_.push_back(NewLine(width, top));
+}
+
+float RootInlineBoxListPainterTest::FindCopyable(float width, float top) {
+  const std::vector<RootInlineBox*> format_lines{NewLine(width, top)};
+  // |FindCopyable()| doesn't paint, so we don't need canvas.
+  RootInlineBoxListPainter painter(nullptr, bounds_, gfx::ColorF(),
+                                   format_lines, screen_lines_, nullptr);
+  const auto& it = painter.FindCopyable(format_lines.front());
+  return it == screen_lines_.end() ? -1.0f : (*it)->top();
+}
+
+RootInlineBox* RootInlineBoxListPainterTest::NewLine(float width, float top) {
+  std::vector<InlineBox*> boxes;
+  boxes.push_back(
+      new InlineFillerBox(*style_, width, kLineHeight, kLineHeight, 0.0f));
+  const auto& bounds =
+      gfx::RectF(gfx::PointF(0.0f, top), gfx::SizeF(width, kLineHeight));
+  lines_.push_back(base::WrapRefCounted(new RootInlineBox(boxes, bounds)));
+  return lines_.back().get();
+}
+
+// A line whose size is changed at same position should be painted.
+TEST_F(RootInlineBoxListPainterTest, FindCopyableBoundsChanged) {
+  AddScreenLine(10, 0);
+  AddScreenLine(20, 10);
+
+  EXPECT_EQ(-1, FindCopyable(30, 0));
+  EXPECT_EQ(-1, FindCopyable(15, 10));
+}
+
+// Lines having same hash code but different contents should be painted.
+TEST_F(RootInlineBoxListPainterTest, FindCopyableHashCollision) {
+  // Hash code of filler box ignores fraction of width.
+  ASSERT_EQ(NewLine(10.5f, 0)->ComputeHashCode(),
+            NewLine(10, 0)->ComputeHashCode());
+  AddScreenLine(10.5f, 0);
+
+  EXPECT_EQ(-1, FindCopyable(10, 10));
+  EXPECT_EQ(0, FindCopyable(10.5f, 10));
+}
+
+// Partially visible screen line can't be copied, since it doesn't have
+// whole image of line.
+TEST_F(RootInlineBoxListPainterTest, FindCopyablePartiallyVisible) {
+  AddScreenLine(10, 35);
+
+  EXPECT_EQ(-1, FindCopyable(10, 0));
+  EXPECT_EQ(35, FindCopyable(10, 35)) << "Line at same position is skipped.";
+}
+
+TEST_F(RootInlineBoxListPainterTest, FindCopyableScroll) {
+  AddScreenLine(10, 0);
+  AddScreenLine(20, 10);
+  AddScreenLine(10, 20);
+
+  // Scroll up
+  EXPECT_EQ(10, FindCopyable(20, 0));
+  // Prefer line at same position, then nearest line.
+  EXPECT_EQ(20, FindCopyable(10, 20));
+  EXPECT_EQ(20, FindCopyable(10, 30));
+}
+
+}  // namespace paint
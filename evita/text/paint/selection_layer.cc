@@ -0,0 +1,126 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/text/paint/selection_layer.h"
+
+#include "base/logging.h"
+#include "base/trace_event/trace_event.h"
+#include "evita/gfx/brush.h"
+#include "evita/gfx/canvas.h"
+#include "evita/gfx/color_f.h"
+#include "evita/gfx/rect_conversions.h"
+#include "evita/text/paint/public/selection.h"
+#include "evita/ui/compositor/layer.h"
+
+namespace paint {
+
+namespace {
+
+// Selection bounds are in text window coordinate and selection layer is
+// placed at top left of text area.
+gfx::RectF ToLayerBounds(const ui::Layer& layer, const gfx::RectF& bounds) {
+  return bounds.Offset(-layer.origin().x, -layer.origin().y);
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// SelectionLayer
+//
+SelectionLayer::SelectionLayer() {}
+
+SelectionLayer::~SelectionLayer() {}
+
+// static
+void SelectionLayer::ComputeDifference(const Selection& old_selection,
+                                       const Selection& new_selection,
+                                       std::vector<gfx::RectF>* old_rects,
+                                       std::vector<gfx::RectF>* new_rects) {
+  for (const auto& old_bounds : old_selection.bounds_set()) {
+    if (old_bounds.empty() || new_selection.HasBounds(old_bounds))
+      continue;
+    old_rects->push_back(old_bounds);
+  }
+  for (const auto& new_bounds : new_selection.bounds_set()) {
+    if (new_bounds.empty() || old_selection.HasBounds(new_bounds))
+      continue;
+    new_rects->push_back(new_bounds);
+  }
+}
+
+void SelectionLayer::DidRealize(ui::Layer* parent_layer) {
+  SetLayer(new ui::Layer());
+  parent_layer->AppendLayer(layer());
+}
+
+void SelectionLayer::PaintAll(const Selection& selection) {
+  TRACE_EVENT0("view", "SelectionLayer::PaintAll");
+  canvas_->AddDirtyRect(canvas_->GetLocalBounds());
+  canvas_->Clear(gfx::ColorF());
+  if (selection.bounds_set().empty())
+    return;
+  gfx::Brush fill_brush(canvas_.get(), selection.color());
+  for (const auto& bounds : selection.bounds_set())
+    canvas_->FillRectangle(fill_brush, ToLayerBounds(*layer(), bounds));
+}
+
+void SelectionLayer::PaintDifference(const Selection& old_selection,
+                                     const Selection& new_selection) {
+  DCHECK(old_selection.color() == new_selection.color());
+  TRACE_EVENT0("view", "SelectionLayer::PaintDifference");
+  std::vector<gfx::RectF> old_rects;
+  std::vector<gfx::RectF> new_rects;
+  ComputeDifference(old_selection, new_selection, &old_rects, &new_rects);
+  for (const auto& old_bounds : old_rects) {
+    const auto& dirty_bounds = ToLayerBounds(*layer(), old_bounds);
+    gfx::Canvas::AxisAlignedClipScope clip_scope(canvas_.get(), dirty_bounds);
+    canvas_->AddDirtyRect(dirty_bounds);
+    canvas_->Clear(gfx::ColorF());
+  }
+  if (new_rects.empty())
+    return;
+  gfx::Brush fill_brush(canvas_.get(), new_selection.color());
+  for (const auto& new_bounds : new_rects) {
+    const auto& dirty_bounds = ToLayerBounds(*layer(), new_bounds);
+    canvas_->AddDirtyRect(dirty_bounds);
+    canvas_->FillRectangle(fill_brush, dirty_bounds);
+  }
+}
+
+void SelectionLayer::Update(const gfx::RectF& bounds,
+                            scoped_refptr<Selection> selection) {
+  // Note: Layer tree can be taken by window replacement animation.
+  if (!OwnsLayer())
+    return;
+  const auto& layer_bounds = gfx::RectF(gfx::ToEnclosingRect(bounds));
+  if (layer_bounds.empty())
+    return;
+  layer()->SetBounds(layer_bounds);
+  if (!canvas_)
+    canvas_.reset(layer()->CreateCanvas());
+  else
+    canvas_->SetBounds(gfx::RectF(layer_bounds.size()));
+  if (!canvas_->UpdateReadyState())
+    return;
+  if (selection_ == selection && bitmap_id_ == canvas_->bitmap_id())
+    return;
+  gfx::Canvas::DrawingScope drawing_scope(canvas_.get());
+  if (selection_ && bitmap_id_ == canvas_->bitmap_id() &&
+      selection_->color() == selection->color()) {
+    PaintDifference(*selection_, *selection);
+  } else {
+    PaintAll(*selection);
+  }
+  bitmap_id_ = canvas_->bitmap_id();
+  selection_ = selection;
+}
+
+void SelectionLayer::WillDestroyWidget() {
+  canvas_.reset();
+  selection_ = nullptr;
+  DestroyLayer();
+}
+
+}  // namespace paint
@@ -0,0 +1,65 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_TEXT_PAINT_SELECTION_LAYER_H_
+#define EVITA_TEXT_PAINT_SELECTION_LAYER_H_
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "evita/gfx/rect_f.h"
+#include "evita/ui/compositor/layer_owner.h"
+
+namespace gfx {
+class Canvas;
+}
+
+namespace paint {
+
+class Selection;
+
+//////////////////////////////////////////////////////////////////////
+//
+// SelectionLayer
+// Displays selection in its own transparent layer above text. Changing
+// selection paints only rectangles in symmetric difference of old and new
+// selection as damage rectangles, and never paints text area.
+//
+class SelectionLayer final : public ui::LayerOwner {
+ public:
+  SelectionLayer();
+  ~SelectionLayer() final;
+
+  void DidRealize(ui::Layer* parent_layer);
+
+  // Updates selection layer to cover |bounds| of text area and displays
+  // |selection|.
+  void Update(const gfx::RectF& bounds, scoped_refptr<Selection> selection);
+  void WillDestroyWidget();
+
+  // Sets rectangles to clear into |old_rects| and rectangles to fill into
+  // |new_rects| for changing |old_selection| to |new_selection|.
+  static void ComputeDifference(const Selection& old_selection,
+                                const Selection& new_selection,
+                                std::vector<gfx::RectF>* old_rects,
+                                std::vector<gfx::RectF>* new_rects);
+
+ private:
+  void PaintAll(const Selection& selection);
+  void PaintDifference(const Selection& old_selection,
+                       const Selection& new_selection);
+
+  int bitmap_id_ = -1;
+  std::unique_ptr<gfx::Canvas> canvas_;
+  // |selection_| holds selection displayed in this layer.
+  scoped_refptr<Selection> selection_;
+
+  DISALLOW_COPY_AND_ASSIGN(SelectionLayer);
+};
+
+}  // namespace paint
+
+#endif  // EVITA_TEXT_PAINT_SELECTION_LAYER_H_
@@ -0,0 +1,51 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <unordered_set>
+#include <vector>
+
+#include "evita/text/paint/selection_layer.h"
+
+#include "evita/gfx/color_f.h"
+#include "evita/text/paint/public/selection.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace paint {
+
+namespace {
+
+gfx::RectF LineRect(float top) {
+  return gfx::RectF(gfx::PointF(0, top), gfx::SizeF(100, 10));
+}
+
+scoped_refptr<Selection> NewSelection(
+    const std::unordered_set<gfx::RectF>& bounds_set) {
+  return base::WrapRefCounted(
+      new Selection(gfx::ColorF(0, 0, 1), bounds_set));
+}
+
+}  // namespace
+
+TEST(SelectionLayerTest, ComputeDifference) {
+  const auto& old_selection = NewSelection({LineRect(0), LineRect(10)});
+  const auto& new_selection = NewSelection({LineRect(10), LineRect(20)});
+  std::vector<gfx::RectF> old_rects;
+  std::vector<gfx::RectF> new_rects;
+  SelectionLayer::ComputeDifference(*old_selection, *new_selection,
+                                    &old_rects, &new_rects);
+  EXPECT_EQ(std::vector<gfx::RectF>({LineRect(0)}), old_rects);
+  EXPECT_EQ(std::vector<gfx::RectF>({LineRect(20)}), new_rects);
+}
+
+TEST(SelectionLayerTest, ComputeDifferenceSame) {
+  const auto& selection = NewSelection({LineRect(0), LineRect(10)});
+  std::vector<gfx::RectF> old_rects;
+  std::vector<gfx::RectF> new_rects;
+  SelectionLayer::ComputeDifference(*selection, *selection, &old_rects,
+                                    &new_rects);
+  EXPECT_TRUE(old_rects.empty());
+  EXPECT_TRUE(new_rects.empty());
+}
+
+}  // namespace paint
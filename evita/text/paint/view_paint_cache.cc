@@ -5,9 +5,7 @@
 #include "evita/text/paint/view_paint_cache.h"
 
 #include "evita/gfx/canvas.h"
-#include "evita/text/paint/public/caret.h"
 #include "evita/text/paint/public/line/root_inline_box.h"
-#include "evita/text/paint/public/selection.h"
 #include "evita/text/paint/public/view.h"
 
 namespace paint {
@@ -16,14 +14,10 @@ namespace paint {
 //
 // ViewPaintCache
 //
-ViewPaintCache::ViewPaintCache(gfx::Canvas* canvas,
-                               const View& view,
-                               const gfx::RectF& caret_bounds)
+ViewPaintCache::ViewPaintCache(gfx::Canvas* canvas, const View& view)
     : bitmap_id_(canvas->bitmap_id()),
-      caret_bounds_(caret_bounds),
       canvas_(canvas),
-      layout_version_(view.layout_version()),
-      selection_(view.selection()) {
+      layout_version_(view.layout_version()) {
   for (const auto& line : view.lines())
     lines_.push_back(line->Copy());
 }
@@ -39,13 +33,7 @@ bool ViewPaintCache::CanUseTextImage(gfx::Canvas* canvas) const {
 
 bool ViewPaintCache::NeedsTextPaint(gfx::Canvas* canvas,
                                     const View& view) const {
-  return CanUseTextImage(canvas) && layout_version_ != view.layout_version();
-}
-
-void ViewPaintCache::UpdateSelection(scoped_refptr<Selection> selection,
-                                     const gfx::RectF& caret_bounds) {
-  caret_bounds_ = caret_bounds;
-  selection_ = selection;
+  return !CanUseTextImage(canvas) || layout_version_ != view.layout_version();
 }
 
 }  // namespace paint
@@ -8,7 +8,6 @@
 #include <memory>
 
 #include "base/macros.h"
-#include "evita/gfx/rect_f.h"
 
 namespace gfx {
 class Canvas;
@@ -16,6 +15,7 @@ class Canvas;
 
 namespace paint {
 
+class LineTileCache;
 class View;
 class ViewPaintCache;
 
@@ -25,7 +25,8 @@ class ViewPaintCache;
 //
 class ViewPainter final {
  public:
-  explicit ViewPainter(const View& layout_view);
+  // |line_tile_cache| can be null.
+  ViewPainter(const View& layout_view, LineTileCache* line_tile_cache);
   ~ViewPainter();
 
   std::unique_ptr<ViewPaintCache> Paint(
@@ -33,16 +34,10 @@ class ViewPainter final {
       std::unique_ptr<ViewPaintCache> view_cache);
 
  private:
-  void PaintCaretIfNeeded(gfx::Canvas* canvas);
   void PaintRuler(gfx::Canvas* canvas);
-  void PaintSelection(gfx::Canvas* canvas);
-  void PaintSelectionWithCache(gfx::Canvas* canvas,
-                               const ViewPaintCache& view_cache);
-  void RestoreCaretBackgroundIfNeeded(gfx::Canvas* canvas,
-                                      const ViewPaintCache& view_cache);
 
   const View& layout_view_;
-  gfx::RectF caret_bounds_;
+  LineTileCache* const line_tile_cache_;
 
   DISALLOW_COPY_AND_ASSIGN(ViewPainter);
 };
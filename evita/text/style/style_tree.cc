@@ -169,6 +169,7 @@ StyleTree::~StyleTree() = default;
 
 void StyleTree::ResetCache() {
   style_cache_.clear();
+  ++version_;
 }
 
 const ComputedStyle& StyleTree::ComputedStyleOf(
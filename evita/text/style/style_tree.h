@@ -39,6 +39,9 @@ class StyleTree final : public css::StyleSheetObserver {
 
   StyleTree& operator=(const StyleTree& other) = delete;
 
+  // |version()| is incremented when cached computed styles are discarded.
+  int version() const { return version_; }
+
   const ComputedStyle& ComputedStyleOf(const css::Selector& selector) const;
 
   void AddStyleSheet(const css::StyleSheet& style_sheet);
@@ -54,6 +57,7 @@ class StyleTree final : public css::StyleSheetObserver {
 
   mutable std::map<css::Selector, std::unique_ptr<ComputedStyle>> style_cache_;
   std::unique_ptr<CompiledStyleSheetSet> style_sheet_set_;
+  int version_ = 0;
   float zoom_ = 1.0f;
 };
 
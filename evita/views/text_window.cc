@@ -20,9 +20,12 @@
 #include "evita/metrics/time_scope.h"
 #include "evita/text/models/buffer.h"
 #include "evita/text/models/selection.h"
+#include "evita/text/paint/caret_layer.h"
+#include "evita/text/paint/line_tile_cache.h"
 #include "evita/text/paint/public/caret.h"
 #include "evita/text/paint/public/selection.h"
 #include "evita/text/paint/public/view.h"
+#include "evita/text/paint/selection_layer.h"
 #include "evita/text/paint/view_paint_cache.h"
 #include "evita/text/paint/view_painter.h"
 #include "evita/ui/base/ime/text_composition.h"
@@ -38,6 +41,10 @@ namespace views {
 
 namespace {
 
+// Number of bytes for keeping rasterized lines. 8MB holds about 200 lines of
+// 1600x24 pixels.
+const size_t kLineTileCacheSize = 8 * 1024 * 1024;
+
 gfx::PointF ToPointF(const gfx::FloatPoint& point) {
   return gfx::PointF(point.x(), point.y());
 }
@@ -119,33 +126,48 @@ bool TextWindow::DragController::OnMouseReleased(const ui::MouseEvent& event) {
 //
 TextWindow::TextWindow(WindowId window_id)
     : CanvasContentWindow(window_id),
+      caret_layer_(new paint::CaretLayer()),
       drag_controller_(new DragController(this)),
-      metrics_view_(new MetricsView()) {
+      line_tile_cache_(new paint::LineTileCache(kLineTileCacheSize)),
+      metrics_view_(new MetricsView()),
+      selection_layer_(new paint::SelectionLayer()) {
   AppendChild(metrics_view_);
 }
 
 TextWindow::~TextWindow() {}
 
 void TextWindow::Paint(std::unique_ptr<TextAreaDisplayItem> display_item) {
+  const auto& paint_view = display_item->paint_view();
+  // Note: We should keep text view even if window is hidden, since next views
+  // don't have lines until text is changed.
+  if (paint_view->has_lines())
+    text_view_ = paint_view;
   if (!visible() || !canvas()->UpdateReadyState())
     return;
   TRACE_EVENT_WITH_FLOW0("view", "TextWindow::Paint", window_id(),
                          TRACE_EVENT_FLAG_FLOW_IN);
+  DCHECK(text_view_);
   metrics_view_->RecordTime();
   MetricsView::TimingScope timing_scope(metrics_view_);
-  if (!display_item->paint_view()->caret().is_none()) {
-    ui::TextInputClient::Get()->set_caret_bounds(
-        display_item->paint_view()->caret().bounds());
+  if (!paint_view->caret().is_none())
+    ui::TextInputClient::Get()->set_caret_bounds(paint_view->caret().bounds());
+  {
+    gfx::Canvas::DrawingScope drawing_scope(canvas());
+    // Paint text area
+    view_paint_cache_ =
+        paint::ViewPainter(*text_view_, line_tile_cache_.get())
+            .Paint(canvas(), std::move(view_paint_cache_));
+
+    auto display_item_list = std::move(display_item->display_item_list());
+    // Paint scroll bar
+    visuals::DisplayItemListProcessor processor;
+    processor.Paint(canvas(), std::move(display_item_list));
   }
-  gfx::Canvas::DrawingScope drawing_scope(canvas());
-  // Paint text area
-  view_paint_cache_ = paint::ViewPainter(*display_item->paint_view())
-                          .Paint(canvas(), std::move(view_paint_cache_));
 
-  auto display_item_list = std::move(display_item->display_item_list());
-  // Paint scroll bar
-  visuals::DisplayItemListProcessor processor;
-  processor.Paint(canvas(), std::move(display_item_list));
+  // Selection and caret are in their own layers. Changing them doesn't paint
+  // text area.
+  selection_layer_->Update(text_view_->bounds(), paint_view->selection());
+  caret_layer_->Update(paint_view->caret());
 
   NotifyUpdateContent();
 }
@@ -177,6 +199,7 @@ void TextWindow::UpdateBounds() {
 
 // gfx::CanvasObserver
 void TextWindow::DidRecreateCanvas() {
+  line_tile_cache_->Clear();
   view_paint_cache_.reset();
 }
 
@@ -235,6 +258,8 @@ void TextWindow::DidKillFocus(ui::Widget* will_focus_widget) {
 void TextWindow::DidRealize() {
   UpdateBounds();
   CanvasContentWindow::DidRealize();
+  selection_layer_->DidRealize(layer());
+  caret_layer_->DidRealize(layer());
   layer()->AppendLayer(metrics_view_->layer());
 }
 
@@ -267,4 +292,10 @@ void TextWindow::OnMouseReleased(const ui::MouseEvent& event) {
   CanvasContentWindow::OnMouseReleased(event);
 }
 
+void TextWindow::WillDestroyWidget() {
+  CanvasContentWindow::WillDestroyWidget();
+  caret_layer_->WillDestroyWidget();
+  selection_layer_->WillDestroyWidget();
+}
+
 }  // namespace views
@@ -7,6 +7,7 @@
 
 #include <memory>
 
+#include "base/memory/ref_counted.h"
 #include "evita/dom/public/float_rect.h"
 #include "evita/gfx/canvas_observer.h"
 #include "evita/gfx/rect_f.h"
@@ -18,6 +19,10 @@ class TextAreaDisplayItem;
 }
 
 namespace paint {
+class CaretLayer;
+class LineTileCache;
+class SelectionLayer;
+class View;
 class ViewPaintCache;
 }
 
@@ -73,10 +78,20 @@ class TextWindow final : public CanvasContentWindow,
   void OnMouseMoved(const ui::MouseEvent& event) final;
   void OnMousePressed(const ui::MouseEvent& event) final;
   void OnMouseReleased(const ui::MouseEvent& event) final;
+  void WillDestroyWidget() final;
 
+  // |caret_layer_| displays caret above text.
+  const std::unique_ptr<paint::CaretLayer> caret_layer_;
   std::unique_ptr<DragController> drag_controller_;
+  // |line_tile_cache_| keeps rasterized lines across |view_paint_cache_|.
+  const std::unique_ptr<paint::LineTileCache> line_tile_cache_;
   MetricsView* const metrics_view_;
   gfx::RectF scroll_bar_bounds_;
+  // |selection_layer_| displays selection above text.
+  const std::unique_ptr<paint::SelectionLayer> selection_layer_;
+  // |text_view_| holds the last view which has lines for painting text for
+  // views without lines, e.g. caret blinking.
+  scoped_refptr<paint::View> text_view_;
   std::unique_ptr<paint::ViewPaintCache> view_paint_cache_;
 
   DISALLOW_COPY_AND_ASSIGN(TextWindow);
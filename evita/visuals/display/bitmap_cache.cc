@@ -0,0 +1,69 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <utility>
+
+#include "evita/visuals/display/bitmap_cache.h"
+
+#include "base/logging.h"
+
+namespace visuals {
+
+//////////////////////////////////////////////////////////////////////
+//
+// BitmapCache::Entry
+//
+BitmapCache::Entry::Entry(size_t size_in_bytes)
+    : size_in_bytes_(size_in_bytes) {}
+
+BitmapCache::Entry::~Entry() {}
+
+//////////////////////////////////////////////////////////////////////
+//
+// BitmapCache
+//
+BitmapCache::BitmapCache(size_t budget) : budget_(budget) {}
+
+BitmapCache::~BitmapCache() {}
+
+BitmapCache::Entry* BitmapCache::Add(int image_id,
+                                     std::unique_ptr<Entry> entry) {
+  DCHECK(entry);
+  const auto& it = entries_.find(image_id);
+  if (it != entries_.end())
+    Remove(it->second);
+  size_in_bytes_ += entry->size_in_bytes();
+  nodes_.push_front(Node{image_id, std::move(entry)});
+  entries_.emplace(image_id, nodes_.begin());
+  EvictIfNeeded();
+  return nodes_.front().entry.get();
+}
+
+void BitmapCache::Clear() {
+  entries_.clear();
+  nodes_.clear();
+  size_in_bytes_ = 0;
+}
+
+void BitmapCache::EvictIfNeeded() {
+  while (size_in_bytes_ > budget_ && nodes_.size() > 1)
+    Remove(std::prev(nodes_.end()));
+}
+
+BitmapCache::Entry* BitmapCache::Find(int image_id) {
+  const auto& it = entries_.find(image_id);
+  if (it == entries_.end())
+    return nullptr;
+  nodes_.splice(nodes_.begin(), nodes_, it->second);
+  return it->second->entry.get();
+}
+
+void BitmapCache::Remove(NodeList::iterator it) {
+  DCHECK_GE(size_in_bytes_, it->entry->size_in_bytes());
+  size_in_bytes_ -= it->entry->size_in_bytes();
+  entries_.erase(it->image_id);
+  nodes_.erase(it);
+}
+
+}  // namespace visuals
@@ -0,0 +1,87 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_VISUALS_DISPLAY_BITMAP_CACHE_H_
+#define EVITA_VISUALS_DISPLAY_BITMAP_CACHE_H_
+
+#include <iterator>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include "base/macros.h"
+
+namespace visuals {
+
+//////////////////////////////////////////////////////////////////////
+//
+// BitmapCache
+// A least recently used cache of device bitmaps created from |ImageBitmap|,
+// keyed by |ImageBitmap::id()|. |BitmapCache| evicts least recently used
+// bitmaps when total size of bitmaps exceeds |budget|.
+//
+// Device bitmaps depend on rendering device, so users of |BitmapCache| should
+// call |Clear()| when device is lost.
+//
+class BitmapCache final {
+ public:
+  // Holds device dependent bitmap, e.g. |ID2D1Bitmap|.
+  class Entry {
+   public:
+    virtual ~Entry();
+
+    size_t size_in_bytes() const { return size_in_bytes_; }
+
+   protected:
+    explicit Entry(size_t size_in_bytes);
+
+   private:
+    const size_t size_in_bytes_;
+
+    DISALLOW_COPY_AND_ASSIGN(Entry);
+  };
+
+  explicit BitmapCache(size_t budget);
+  ~BitmapCache();
+
+  size_t budget() const { return budget_; }
+  size_t num_entries() const { return entries_.size(); }
+  size_t size_in_bytes() const { return size_in_bytes_; }
+
+  // Adds |entry| for image |image_id| as most recently used entry, and
+  // returns it. Newly added entry is kept even if it exceeds |budget_|.
+  Entry* Add(int image_id, std::unique_ptr<Entry> entry);
+
+  void Clear();
+
+  // Returns entry for image |image_id| and marks it as most recently used,
+  // or null if there is no entry.
+  Entry* Find(int image_id);
+
+ private:
+  struct Node {
+    int image_id;
+    std::unique_ptr<Entry> entry;
+  };
+
+  using NodeList = std::list<Node>;
+
+  void EvictIfNeeded();
+  void Remove(NodeList::iterator it);
+
+  const size_t budget_;
+
+  // Maps |ImageBitmap::id()| to node in |nodes_|.
+  std::unordered_map<int, NodeList::iterator> entries_;
+
+  // Most recently used node comes first.
+  NodeList nodes_;
+  size_t size_in_bytes_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(BitmapCache);
+};
+
+}  // namespace visuals
+
+#endif  // EVITA_VISUALS_DISPLAY_BITMAP_CACHE_H_
@@ -0,0 +1,104 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "evita/visuals/display/bitmap_cache.h"
+
+#include "base/macros.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace visuals {
+
+namespace {
+
+const size_t kBudget = 100;
+
+//////////////////////////////////////////////////////////////////////
+//
+// FakeCanvas
+// Creates device bitmaps of |size_in_bytes| as |gfx::Canvas| does.
+//
+class FakeCanvas final {
+ public:
+  explicit FakeCanvas(BitmapCache* cache) : cache_(cache) {}
+  ~FakeCanvas() = default;
+
+  int num_created() const { return num_created_; }
+
+  BitmapCache::Entry* DrawBitmap(int image_id, size_t size_in_bytes);
+
+ private:
+  class FakeBitmap final : public BitmapCache::Entry {
+   public:
+    explicit FakeBitmap(size_t size_in_bytes) : Entry(size_in_bytes) {}
+    ~FakeBitmap() final = default;
+
+   private:
+    DISALLOW_COPY_AND_ASSIGN(FakeBitmap);
+  };
+
+  BitmapCache* const cache_;
+  int num_created_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeCanvas);
+};
+
+BitmapCache::Entry* FakeCanvas::DrawBitmap(int image_id,
+                                           size_t size_in_bytes) {
+  if (const auto entry = cache_->Find(image_id))
+    return entry;
+  ++num_created_;
+  return cache_->Add(image_id, std::make_unique<FakeBitmap>(size_in_bytes));
+}
+
+}  // namespace
+
+TEST(BitmapCacheTest, Clear) {
+  BitmapCache cache(kBudget);
+  FakeCanvas canvas(&cache);
+  canvas.DrawBitmap(1, 10);
+  canvas.DrawBitmap(2, 10);
+  cache.Clear();
+  EXPECT_EQ(0, cache.num_entries());
+  EXPECT_EQ(0, cache.size_in_bytes());
+
+  canvas.DrawBitmap(1, 10);
+  EXPECT_EQ(3, canvas.num_created()) << "Device lost discards bitmaps.";
+}
+
+TEST(BitmapCacheTest, Evict) {
+  BitmapCache cache(kBudget);
+  FakeCanvas canvas(&cache);
+  canvas.DrawBitmap(1, 40);
+  canvas.DrawBitmap(2, 40);
+  canvas.DrawBitmap(1, 40);
+  canvas.DrawBitmap(3, 40);
+  EXPECT_EQ(2, cache.num_entries());
+  EXPECT_EQ(80, cache.size_in_bytes());
+  EXPECT_TRUE(cache.Find(1)) << "Image 1 is used recently than image 2.";
+  EXPECT_FALSE(cache.Find(2));
+  EXPECT_TRUE(cache.Find(3));
+}
+
+TEST(BitmapCacheTest, Find) {
+  BitmapCache cache(kBudget);
+  FakeCanvas canvas(&cache);
+  const auto entry = canvas.DrawBitmap(1, 10);
+  EXPECT_EQ(entry, canvas.DrawBitmap(1, 10));
+  EXPECT_NE(entry, canvas.DrawBitmap(2, 10));
+  EXPECT_EQ(2, canvas.num_created());
+  EXPECT_EQ(20, cache.size_in_bytes());
+}
+
+TEST(BitmapCacheTest, LargeBitmap) {
+  BitmapCache cache(kBudget);
+  FakeCanvas canvas(&cache);
+  canvas.DrawBitmap(1, 10);
+  const auto entry = canvas.DrawBitmap(2, kBudget * 2);
+  EXPECT_EQ(1, cache.num_entries());
+  EXPECT_EQ(entry, cache.Find(2)) << "Keep bitmap being drawn.";
+}
+
+}  // namespace visuals
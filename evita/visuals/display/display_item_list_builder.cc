@@ -4,6 +4,8 @@
 
 #include "evita/visuals/display/display_item_list_builder.h"
 
+#include <utility>
+
 #include "base/logging.h"
 #include "evita/gfx/base/geometry/float_rect.h"
 #include "evita/visuals/display/public/display_item_list.h"
@@ -17,14 +19,26 @@ namespace visuals {
 //
 DisplayItemListBuilder::DisplayItemListBuilder(
     const gfx::FloatRect& viewport_bounds)
-    : list_(new DisplayItemList()), viewport_bounds_(viewport_bounds) {}
+    : list_(new DisplayItemList()),
+      chunk_bounds_(viewport_bounds),
+      viewport_bounds_(viewport_bounds) {}
 
 DisplayItemListBuilder::~DisplayItemListBuilder() {
   DCHECK(!list_);
+  DCHECK(chunk_items_.empty());
+}
+
+size_t DisplayItemListBuilder::num_chunks() const {
+  return list_->chunks_.size();
+}
+
+void DisplayItemListBuilder::AddChunk(scoped_refptr<DisplayItemChunk> chunk) {
+  FlushChunk();
+  list_->chunks_.push_back(std::move(chunk));
 }
 
 void DisplayItemListBuilder::AddItem(std::unique_ptr<DisplayItem> item) {
-  list_->items_.push_back(item.release());
+  chunk_items_.push_back(item.release());
 }
 
 void DisplayItemListBuilder::AddRect(const gfx::FloatRect& rect) {
@@ -36,9 +50,39 @@ void DisplayItemListBuilder::AddRect(const gfx::FloatRect& rect) {
   list_->rects_.push_back(clipped);
 }
 
+void DisplayItemListBuilder::BeginChunk(int id,
+                                        int index,
+                                        const gfx::FloatRect& bounds) {
+  FlushChunk();
+  chunk_bounds_ = bounds;
+  chunk_id_ = id;
+  chunk_index_ = index;
+}
+
 std::unique_ptr<DisplayItemList> DisplayItemListBuilder::Build() {
   DCHECK(list_);
+  FlushChunk();
+  for (const auto& chunk : list_->chunks_) {
+    list_->items_.insert(list_->items_.end(), chunk->items().begin(),
+                         chunk->items().end());
+  }
   return std::move(list_);
 }
 
+void DisplayItemListBuilder::EndChunk() {
+  BeginChunk(0, anonymous_chunk_index_, viewport_bounds_);
+}
+
+void DisplayItemListBuilder::FlushChunk() {
+  if (chunk_items_.empty())
+    return;
+  list_->chunks_.push_back(make_scoped_refptr(new DisplayItemChunk(
+      chunk_id_, chunk_index_, chunk_bounds_, std::move(chunk_items_))));
+  chunk_items_.clear();
+  if (chunk_id_ != 0)
+    return;
+  ++anonymous_chunk_index_;
+  chunk_index_ = anonymous_chunk_index_;
+}
+
 }  // namespace visuals
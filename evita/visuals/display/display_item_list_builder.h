@@ -9,16 +9,21 @@
 #include <vector>
 
 #include "base/macros.h"
+#include "base/memory/ref_counted.h"
 #include "evita/gfx/base/geometry/float_rect.h"
 
 namespace visuals {
 
 class DisplayItem;
+class DisplayItemChunk;
 class DisplayItemList;
 
 //////////////////////////////////////////////////////////////////////
 //
 // DisplayItemListBuilder
+// Items added between |BeginChunk()| and |EndChunk()| are grouped into a
+// |DisplayItemChunk|. Items outside of them are grouped into chunks with
+// id zero.
 //
 class DisplayItemListBuilder final {
  public:
@@ -31,14 +36,30 @@ class DisplayItemListBuilder final {
         std::unique_ptr<DisplayItem>(new T(std::forward<Args>(args)...))));
   }
 
+  // Adds |chunk| painted in previous frame.
+  void AddChunk(scoped_refptr<DisplayItemChunk> chunk);
   void AddRect(const gfx::FloatRect& rect);
+  void BeginChunk(int id, int index, const gfx::FloatRect& bounds);
   std::unique_ptr<DisplayItemList> Build();
+  void EndChunk();
+
+  // Returns number of chunks added so far, excluding pending chunk.
+  size_t num_chunks() const;
 
  private:
   void AddItem(std::unique_ptr<DisplayItem> item);
+  void FlushChunk();
 
   std::unique_ptr<DisplayItemList> list_;
-  std::vector<gfx::FloatRect> rects_;
+
+  // Index of next chunk having id zero.
+  int anonymous_chunk_index_ = 0;
+
+  // Items of chunk being built.
+  gfx::FloatRect chunk_bounds_;
+  int chunk_id_ = 0;
+  int chunk_index_ = 0;
+  std::vector<DisplayItem*> chunk_items_;
 
   // Display item list should contains items paint inside |viewport_bounds_|.
   const gfx::FloatRect viewport_bounds_;
@@ -0,0 +1,90 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "evita/visuals/display/display_item_list_differ.h"
+
+#include "evita/visuals/display/public/display_item_list.h"
+
+namespace visuals {
+
+//////////////////////////////////////////////////////////////////////
+//
+// DisplayItemListDiffer
+//
+DisplayItemListDiffer::DisplayItemListDiffer(const DisplayItemList* last_list,
+                                             const DisplayItemList& new_list) {
+  for (const auto& rect : new_list.rects())
+    AddDamagedRect(rect);
+  if (!last_list) {
+    for (const auto& chunk : new_list.chunks())
+      AddDamagedRect(chunk->bounds());
+    num_changed_chunks_ = new_list.chunks().size();
+    return;
+  }
+
+  std::map<std::pair<int, int>, const DisplayItemChunk*> last_chunks;
+  for (const auto& chunk : last_list->chunks()) {
+    last_chunks.emplace(std::make_pair(chunk->id(), chunk->index()),
+                        chunk.get());
+  }
+
+  for (const auto& chunk : new_list.chunks()) {
+    const auto& it =
+        last_chunks.find(std::make_pair(chunk->id(), chunk->index()));
+    if (it == last_chunks.end()) {
+      AddDamagedRect(chunk->bounds());
+      ++num_changed_chunks_;
+      continue;
+    }
+    const auto last_chunk = it->second;
+    last_chunks.erase(it);
+    if (last_chunk == chunk.get()) {
+      ++num_reused_chunks_;
+      continue;
+    }
+    if (last_chunk->EqualsTo(*chunk)) {
+      ++num_unchanged_chunks_;
+      continue;
+    }
+    AddDamagedRect(last_chunk->bounds());
+    AddDamagedRect(chunk->bounds());
+    ++num_changed_chunks_;
+  }
+
+  // Chunks of removed boxes or boxes moved outside of viewport.
+  for (const auto& pair : last_chunks)
+    AddDamagedRect(pair.second->bounds());
+  num_changed_chunks_ += last_chunks.size();
+}
+
+DisplayItemListDiffer::~DisplayItemListDiffer() {}
+
+void DisplayItemListDiffer::AddDamagedRect(const gfx::FloatRect& rect) {
+  if (rect.IsEmpty())
+    return;
+  for (const auto& damaged_rect : damaged_rects_) {
+    if (damaged_rect.Contains(rect))
+      return;
+  }
+  damaged_rects_.push_back(rect);
+  if (damaged_bounds_.IsEmpty()) {
+    damaged_bounds_ = rect;
+    return;
+  }
+  damaged_bounds_ = gfx::FloatRect(
+      gfx::FloatPoint(std::min(damaged_bounds_.x(), rect.x()),
+                      std::min(damaged_bounds_.y(), rect.y())),
+      gfx::FloatPoint(std::max(damaged_bounds_.right(), rect.right()),
+                      std::max(damaged_bounds_.bottom(), rect.bottom())));
+}
+
+bool DisplayItemListDiffer::IsDamaged(const DisplayItemChunk& chunk) const {
+  return damaged_bounds_.Intersects(chunk.bounds());
+}
+
+}  // namespace visuals
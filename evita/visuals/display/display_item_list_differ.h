@@ -0,0 +1,68 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_VISUALS_DISPLAY_DISPLAY_ITEM_LIST_DIFFER_H_
+#define EVITA_VISUALS_DISPLAY_DISPLAY_ITEM_LIST_DIFFER_H_
+
+#include <vector>
+
+#include "base/macros.h"
+#include "evita/gfx/base/geometry/float_rect.h"
+
+namespace visuals {
+
+class DisplayItemChunk;
+class DisplayItemList;
+
+//////////////////////////////////////////////////////////////////////
+//
+// DisplayItemListDiffer
+// Compares chunks of new display item list with chunks of last display item
+// list by chunk id, to compute damaged rectangles to be rasterized again.
+//
+class DisplayItemListDiffer final {
+ public:
+  // |last_list| is null for the first frame, then all chunks in |new_list|
+  // are damaged.
+  DisplayItemListDiffer(const DisplayItemList* last_list,
+                        const DisplayItemList& new_list);
+  ~DisplayItemListDiffer();
+
+  // Bounding rectangle of |damaged_rects()|.
+  const gfx::FloatRect& damaged_bounds() const { return damaged_bounds_; }
+
+  // Damaged rectangles including dirty rectangles of new list.
+  const std::vector<gfx::FloatRect>& damaged_rects() const {
+    return damaged_rects_;
+  }
+
+  // Number of chunks added, removed or having different items.
+  size_t num_changed_chunks() const { return num_changed_chunks_; }
+
+  // Number of chunks shared with last list.
+  size_t num_reused_chunks() const { return num_reused_chunks_; }
+
+  // Number of chunks painted again but having same items as last list.
+  size_t num_unchanged_chunks() const { return num_unchanged_chunks_; }
+
+  // Returns true if |chunk| intersects with |damaged_bounds()|. Since a
+  // damaged chunk repaints all pixels in |damaged_bounds()|, e.g. background
+  // of parent box, chunks painted over it in the bounds are also damaged.
+  bool IsDamaged(const DisplayItemChunk& chunk) const;
+
+ private:
+  void AddDamagedRect(const gfx::FloatRect& rect);
+
+  gfx::FloatRect damaged_bounds_;
+  std::vector<gfx::FloatRect> damaged_rects_;
+  size_t num_changed_chunks_ = 0;
+  size_t num_reused_chunks_ = 0;
+  size_t num_unchanged_chunks_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(DisplayItemListDiffer);
+};
+
+}  // namespace visuals
+
+#endif  // EVITA_VISUALS_DISPLAY_DISPLAY_ITEM_LIST_DIFFER_H_
@@ -0,0 +1,94 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include "evita/visuals/display/display_item_list_differ.h"
+
+#include "evita/visuals/display/display_item_list_builder.h"
+#include "evita/visuals/display/public/display_item_list.h"
+#include "evita/visuals/display/public/display_items.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace visuals {
+
+namespace {
+
+gfx::FloatRect MakeRect(float x, float y, float width, float height) {
+  return gfx::FloatRect(gfx::FloatPoint(x, y), gfx::FloatSize(width, height));
+}
+
+// Builds list having two chunks, id=1 at (0, 0) and id=2 at (0, 10). Chunks
+// of |last_list| are reused when |reuse_first| or |reuse_second| is true.
+std::unique_ptr<DisplayItemList> BuildList(const DisplayItemList* last_list,
+                                           const gfx::FloatColor& color,
+                                           bool reuse_first,
+                                           bool reuse_second) {
+  DisplayItemListBuilder builder(MakeRect(0, 0, 100, 100));
+  if (reuse_first) {
+    builder.AddChunk(last_list->chunks()[0]);
+  } else {
+    builder.BeginChunk(1, 0, MakeRect(0, 0, 100, 10));
+    builder.AddNew<FillRectDisplayItem>(MakeRect(0, 0, 100, 10), color);
+    builder.EndChunk();
+  }
+  if (reuse_second) {
+    builder.AddChunk(last_list->chunks()[1]);
+  } else {
+    builder.BeginChunk(2, 0, MakeRect(0, 10, 100, 10));
+    builder.AddNew<FillRectDisplayItem>(MakeRect(0, 0, 100, 10), color);
+    builder.EndChunk();
+  }
+  return builder.Build();
+}
+
+}  // namespace
+
+TEST(DisplayItemListDifferTest, Changed) {
+  const auto& list1 = BuildList(nullptr, gfx::FloatColor(1, 0, 0), false,
+                                false);
+  const auto& list2 = BuildList(list1.get(), gfx::FloatColor(0, 1, 0), true,
+                                false);
+  DisplayItemListDiffer differ(list1.get(), *list2);
+  EXPECT_EQ(1, differ.num_changed_chunks());
+  EXPECT_EQ(1, differ.num_reused_chunks());
+  EXPECT_EQ(std::vector<gfx::FloatRect>{MakeRect(0, 10, 100, 10)},
+            differ.damaged_rects());
+  EXPECT_FALSE(differ.IsDamaged(*list2->chunks()[0]));
+  EXPECT_TRUE(differ.IsDamaged(*list2->chunks()[1]));
+}
+
+TEST(DisplayItemListDifferTest, FirstFrame) {
+  const auto& list = BuildList(nullptr, gfx::FloatColor(1, 0, 0), false,
+                               false);
+  DisplayItemListDiffer differ(nullptr, *list);
+  EXPECT_EQ(2, differ.num_changed_chunks());
+  EXPECT_EQ(2, differ.damaged_rects().size());
+}
+
+TEST(DisplayItemListDifferTest, Removed) {
+  const auto& list1 = BuildList(nullptr, gfx::FloatColor(1, 0, 0), false,
+                                false);
+  DisplayItemListBuilder builder(MakeRect(0, 0, 100, 100));
+  builder.AddChunk(list1->chunks()[0]);
+  const auto& list2 = builder.Build();
+  DisplayItemListDiffer differ(list1.get(), *list2);
+  EXPECT_EQ(1, differ.num_changed_chunks());
+  EXPECT_EQ(1, differ.num_reused_chunks());
+  EXPECT_EQ(std::vector<gfx::FloatRect>{MakeRect(0, 10, 100, 10)},
+            differ.damaged_rects());
+}
+
+TEST(DisplayItemListDifferTest, Unchanged) {
+  const auto& color = gfx::FloatColor(1, 0, 0);
+  const auto& list1 = BuildList(nullptr, color, false, false);
+  const auto& list2 = BuildList(list1.get(), color, false, false);
+  DisplayItemListDiffer differ(list1.get(), *list2);
+  EXPECT_EQ(0, differ.num_changed_chunks());
+  EXPECT_EQ(2, differ.num_unchanged_chunks());
+  EXPECT_TRUE(differ.damaged_rects().empty());
+}
+
+}  // namespace visuals
@@ -12,9 +12,11 @@
 #include <iostream>
 #endif
 #include <stack>
+#include <utility>
 
 #include "evita/visuals/display/display_item_list_processor.h"
 
+#include "base/trace_event/trace_event.h"
 #include "build/build_config.h"
 #include "evita/gfx/base/geometry/float_rect.h"
 #include "evita/gfx/bitmap.h"
@@ -23,6 +25,8 @@
 #include "evita/gfx/color_f.h"
 #include "evita/gfx/stroke_style.h"
 #include "evita/gfx/text_format.h"
+#include "evita/visuals/display/bitmap_cache.h"
+#include "evita/visuals/display/display_item_list_differ.h"
 #include "evita/visuals/display/public/display_item_list.h"
 #include "evita/visuals/display/public/display_item_visitor.h"
 #include "evita/visuals/display/public/display_items.h"
@@ -40,6 +44,16 @@ namespace visuals {
 
 namespace {
 
+// Total size of device bitmaps kept in |BitmapCache|.
+const size_t kBitmapCacheBudget = 32 * 1024 * 1024;
+
+// Returns true if |item| changes clip or transform rather than pixels.
+bool IsStateItem(const DisplayItem& item) {
+  return item.is<BeginClipDisplayItem>() ||
+         item.is<BeginTransformDisplayItem>() ||
+         item.is<EndClipDisplayItem>() || item.is<EndTransformDisplayItem>();
+}
+
 gfx::ColorF ToColorF(const gfx::FloatColor& color) {
   return gfx::ColorF(color.red(), color.green(), color.blue(), color.alpha());
 }
@@ -78,13 +92,43 @@ std::unique_ptr<gfx::Bitmap> CreateBitmapFromImage(gfx::Canvas* canvas,
   return std::make_unique<gfx::Bitmap>(canvas, bitmap);
 }
 
+//////////////////////////////////////////////////////////////////////
+//
+// DeviceBitmap
+//
+class DeviceBitmap final : public BitmapCache::Entry {
+ public:
+  explicit DeviceBitmap(std::unique_ptr<gfx::Bitmap> bitmap);
+  ~DeviceBitmap() final = default;
+
+  const gfx::Bitmap& bitmap() const { return *bitmap_; }
+
+ private:
+  static size_t ComputeSizeInBytes(const gfx::Bitmap& bitmap);
+
+  const std::unique_ptr<gfx::Bitmap> bitmap_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeviceBitmap);
+};
+
+DeviceBitmap::DeviceBitmap(std::unique_ptr<gfx::Bitmap> bitmap)
+    : Entry(ComputeSizeInBytes(*bitmap)), bitmap_(std::move(bitmap)) {}
+
+// Note: Device bitmap has 32 bits per pixel, since we create it with
+// |GUID_WICPixelFormat32bppPBGRA|.
+size_t DeviceBitmap::ComputeSizeInBytes(const gfx::Bitmap& bitmap) {
+  const auto& size = bitmap->GetPixelSize();
+  return static_cast<size_t>(size.width) * size.height * 4;
+}
+
 //////////////////////////////////////////////////////////////////////
 //
 // PaintVisitor
 //
 class PaintVisitor final : public DisplayItemVisitor {
  public:
-  explicit PaintVisitor(gfx::Canvas* canvas) : canvas_(canvas) {}
+  PaintVisitor(gfx::Canvas* canvas, BitmapCache* bitmap_cache)
+      : bitmap_cache_(bitmap_cache), canvas_(canvas) {}
   ~PaintVisitor() final = default;
 
  private:
@@ -93,6 +137,7 @@ class PaintVisitor final : public DisplayItemVisitor {
   FOR_EACH_DISPLAY_ITEM(V)
 #undef V
 
+  BitmapCache* const bitmap_cache_;
   gfx::Canvas* const canvas_;
   std::stack<D2D1_MATRIX_3X2_F> transforms_;
 
@@ -116,8 +161,15 @@ void PaintVisitor::VisitClear(ClearDisplayItem* item) {
 }
 
 void PaintVisitor::VisitDrawBitmap(DrawBitmapDisplayItem* item) {
-  const auto& bitmap = CreateBitmapFromImage(canvas_, item->bitmap());
-  (*canvas_)->DrawBitmap(*bitmap, ToRectF(item->destination()), item->opacity(),
+  const auto& image = item->bitmap();
+  auto entry = bitmap_cache_->Find(image.id());
+  if (!entry) {
+    entry = bitmap_cache_->Add(
+        image.id(), std::make_unique<DeviceBitmap>(
+                        CreateBitmapFromImage(canvas_, image)));
+  }
+  const auto& bitmap = static_cast<DeviceBitmap*>(entry)->bitmap();
+  (*canvas_)->DrawBitmap(bitmap, ToRectF(item->destination()), item->opacity(),
                          D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
                          ToRectF(item->source()));
 }
@@ -160,33 +212,92 @@ void PaintVisitor::VisitFillRect(FillRectDisplayItem* item) {
 //
 // DisplayItemListProcessor
 //
-DisplayItemListProcessor::DisplayItemListProcessor() {}
-DisplayItemListProcessor::~DisplayItemListProcessor() {}
+DisplayItemListProcessor::DisplayItemListProcessor()
+    : bitmap_cache_(new BitmapCache(kBitmapCacheBudget)) {}
+
+DisplayItemListProcessor::~DisplayItemListProcessor() {
+  if (canvas_)
+    canvas_->RemoveObserver(this);
+}
 
 void DisplayItemListProcessor::Paint(gfx::Canvas* canvas,
                                      std::unique_ptr<DisplayItemList> list) {
+  TRACE_EVENT0("visuals", "DisplayItemListProcessor::Paint");
+  if (canvas_ != canvas) {
+    if (canvas_)
+      canvas_->RemoveObserver(this);
+    canvas_ = canvas;
+    canvas_->AddObserver(this);
+    bitmap_cache_->Clear();
+  }
+  if (last_bitmap_id_ != canvas->bitmap_id())
+    last_items_.reset();
+  const DisplayItemListDiffer differ(last_items_.get(), *list);
   gfx::Canvas::DrawingScope drawing_scope(canvas);
-  for (const auto& rect : list->rects())
+  for (const auto& rect : differ.damaged_rects())
     canvas->AddDirtyRect(ToRectF(rect));
-  PaintVisitor painter(canvas);
-  for (const auto& item : list->items())
-    painter.Visit(item);
+  std::vector<bool> chunks_to_paint;
+  const auto& clip_bounds =
+      ComputeChunksToPaint(differ, *list, &chunks_to_paint);
+  num_painted_chunks_ = 0;
+  num_skipped_chunks_ = 0;
+  gfx::Canvas::AxisAlignedClipScope clip_scope(canvas, ToRectF(clip_bounds));
+  PaintVisitor painter(canvas, bitmap_cache_.get());
+  auto chunk_index = 0u;
+  for (const auto& chunk : list->chunks()) {
+    if (chunks_to_paint[chunk_index++]) {
+      ++num_painted_chunks_;
+      for (const auto& item : chunk->items())
+        painter.Visit(item);
+      continue;
+    }
+    // Pixels of |chunk| are in canvas bitmap, but we still need to maintain
+    // clip and transform for following chunks.
+    ++num_skipped_chunks_;
+    for (const auto& item : chunk->items()) {
+      if (IsStateItem(*item))
+        painter.Visit(item);
+    }
+  }
+  num_reused_chunks_ = differ.num_reused_chunks();
+  TRACE_COUNTER_ID2("visuals", "DisplayItemChunks", this, "painted",
+                    num_painted_chunks_, "skipped", num_skipped_chunks_);
 
 #if PRINT_DIRTY
   std::cout << "DisplayItemListProcessor::Paint(): dirty rects" << std::endl;
   auto index = 0;
-  for (const auto& rect : list->rects())
+  for (const auto& rect : differ.damaged_rects())
     std::cout << ' ' << ++index << ' ' << rect;
   std::cout << std::endl;
 #endif
 #if PAINT_DIRTY
-  for (const auto& rect : list->rects()) {
+  for (const auto& rect : differ.damaged_rects()) {
     gfx::Brush brush(canvas, gfx::ColorF(1, 0, 0, 0.1f));
     const auto& rect_f = ToRectF(rect);
     canvas->FillRectangle(brush, rect_f);
     canvas->DrawRectangle(brush, rect_f);
   }
 #endif
+  last_bitmap_id_ = canvas->bitmap_id();
+  last_items_ = std::move(list);
+}
+
+// static
+gfx::FloatRect DisplayItemListProcessor::ComputeChunksToPaint(
+    const DisplayItemListDiffer& differ,
+    const DisplayItemList& list,
+    std::vector<bool>* chunks_to_paint) {
+  chunks_to_paint->clear();
+  chunks_to_paint->reserve(list.chunks().size());
+  for (const auto& chunk : list.chunks())
+    chunks_to_paint->push_back(differ.IsDamaged(*chunk));
+  return differ.damaged_bounds();
+}
+
+// gfx::CanvasObserver
+void DisplayItemListProcessor::DidRecreateCanvas() {
+  bitmap_cache_->Clear();
+  last_items_.reset();
 }
 
 }  // namespace visuals
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "base/macros.h"
+#include "evita/gfx/canvas_observer.h"
 
 namespace gfx {
 class Canvas;
@@ -17,21 +18,54 @@ class FloatRect;
 
 namespace visuals {
 
+class BitmapCache;
 class DisplayItemList;
+class DisplayItemListDiffer;
 
 //////////////////////////////////////////////////////////////////////
 //
 // DisplayItemListProcessor
+// Rasterizes only chunks intersecting with regions damaged since last
+// display item list. Other chunks keep their pixels in canvas bitmap.
+// Rasterizing is clipped to the damaged regions, so a damaged chunk, e.g.
+// background of parent box, doesn't paint over pixels of skipped chunks.
 //
-class DisplayItemListProcessor final {
+// Device bitmaps created for |DrawBitmapDisplayItem| are kept in
+// |BitmapCache| until canvas is recreated, e.g. device lost.
+//
+class DisplayItemListProcessor final : public gfx::CanvasObserver {
  public:
   DisplayItemListProcessor();
-  ~DisplayItemListProcessor();
+  ~DisplayItemListProcessor() final;
+
+  // Statistics of the last |Paint()|.
+  size_t num_painted_chunks() const { return num_painted_chunks_; }
+  size_t num_reused_chunks() const { return num_reused_chunks_; }
+  size_t num_skipped_chunks() const { return num_skipped_chunks_; }
 
   void Paint(gfx::Canvas* canvas, std::unique_ptr<DisplayItemList> list);
 
+  // Returns bounds to clip rasterizing to, and sets whether each chunk of
+  // |list| is rasterized into |chunks_to_paint|.
+  static gfx::FloatRect ComputeChunksToPaint(
+      const DisplayItemListDiffer& differ,
+      const DisplayItemList& list,
+      std::vector<bool>* chunks_to_paint);
+
  private:
+  // gfx::CanvasObserver
+  void DidRecreateCanvas() final;
+
+  const std::unique_ptr<BitmapCache> bitmap_cache_;
+  gfx::Canvas* canvas_ = nullptr;
+
+  // Bitmap id of canvas painted |last_items_|. We paint all chunks when
+  // canvas discards its bitmap.
+  int last_bitmap_id_ = -1;
   std::unique_ptr<DisplayItemList> last_items_;
+  size_t num_painted_chunks_ = 0;
+  size_t num_reused_chunks_ = 0;
+  size_t num_skipped_chunks_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(DisplayItemListProcessor);
 };
@@ -0,0 +1,90 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include "evita/visuals/display/display_item_list_processor.h"
+
+#include "evita/visuals/display/display_item_list_builder.h"
+#include "evita/visuals/display/display_item_list_differ.h"
+#include "evita/visuals/display/public/display_item_list.h"
+#include "evita/visuals/display/public/display_items.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace visuals {
+
+namespace {
+
+gfx::FloatRect MakeRect(float x, float y, float width, float height) {
+  return gfx::FloatRect(gfx::FloatPoint(x, y), gfx::FloatSize(width, height));
+}
+
+// Builds list having parent chunk id=1 filling (0, 0, 100, 100) and child
+// chunk id=2 at (50, 50). |dirty_rect| is added to list if not empty.
+std::unique_ptr<DisplayItemList> BuildList(const gfx::FloatColor& color,
+                                           const gfx::FloatRect& dirty_rect) {
+  DisplayItemListBuilder builder(MakeRect(0, 0, 100, 100));
+  builder.BeginChunk(1, 0, MakeRect(0, 0, 100, 100));
+  builder.AddNew<FillRectDisplayItem>(MakeRect(0, 0, 100, 100), color);
+  builder.EndChunk();
+  builder.BeginChunk(2, 0, MakeRect(50, 50, 10, 10));
+  builder.AddNew<FillRectDisplayItem>(MakeRect(50, 50, 10, 10),
+                                      gfx::FloatColor(0, 0, 1));
+  builder.EndChunk();
+  if (!dirty_rect.IsEmpty())
+    builder.AddRect(dirty_rect);
+  return builder.Build();
+}
+
+}  // namespace
+
+// Parent is damaged only in dirty rectangle, and child outside of it is
+// skipped. Rasterizing is clipped to dirty rectangle, so parent doesn't
+// paint over pixels of child.
+TEST(DisplayItemListProcessorTest, ParentDamagedChildNot) {
+  const auto& color = gfx::FloatColor(1, 0, 0);
+  const auto& list1 = BuildList(color, gfx::FloatRect());
+  const auto& list2 = BuildList(color, MakeRect(0, 0, 10, 10));
+  DisplayItemListDiffer differ(list1.get(), *list2);
+  std::vector<bool> chunks_to_paint;
+  EXPECT_EQ(MakeRect(0, 0, 10, 10),
+            DisplayItemListProcessor::ComputeChunksToPaint(differ, *list2,
+                                                           &chunks_to_paint));
+  EXPECT_EQ(std::vector<bool>({true, false}), chunks_to_paint);
+}
+
+// Child in bounding rectangle of damaged rectangles is rasterized again even
+// if it doesn't intersect with any damaged rectangle, since parent paints
+// over it.
+TEST(DisplayItemListProcessorTest, ParentDamagedChildInBounds) {
+  const auto& color = gfx::FloatColor(1, 0, 0);
+  const auto& list1 = BuildList(color, gfx::FloatRect());
+  DisplayItemListBuilder builder(MakeRect(0, 0, 100, 100));
+  builder.AddChunk(list1->chunks()[0]);
+  builder.AddChunk(list1->chunks()[1]);
+  builder.AddRect(MakeRect(0, 0, 10, 10));
+  builder.AddRect(MakeRect(90, 90, 10, 10));
+  const auto& list2 = builder.Build();
+  DisplayItemListDiffer differ(list1.get(), *list2);
+  std::vector<bool> chunks_to_paint;
+  EXPECT_EQ(MakeRect(0, 0, 100, 100),
+            DisplayItemListProcessor::ComputeChunksToPaint(differ, *list2,
+                                                           &chunks_to_paint));
+  EXPECT_EQ(std::vector<bool>({true, true}), chunks_to_paint);
+}
+
+// Changed parent damages its bounds containing child.
+TEST(DisplayItemListProcessorTest, ParentChanged) {
+  const auto& list1 = BuildList(gfx::FloatColor(1, 0, 0), gfx::FloatRect());
+  const auto& list2 = BuildList(gfx::FloatColor(0, 1, 0), gfx::FloatRect());
+  DisplayItemListDiffer differ(list1.get(), *list2);
+  std::vector<bool> chunks_to_paint;
+  EXPECT_EQ(MakeRect(0, 0, 100, 100),
+            DisplayItemListProcessor::ComputeChunksToPaint(differ, *list2,
+                                                           &chunks_to_paint));
+  EXPECT_EQ(std::vector<bool>({true, true}), chunks_to_paint);
+}
+
+}  // namespace visuals
@@ -4,19 +4,46 @@
 
 #include "evita/visuals/display/public/display_item_list.h"
 
+#include <utility>
+
 #include "evita/visuals/display/public/display_items.h"
 
 namespace visuals {
 
 //////////////////////////////////////////////////////////////////////
 //
-// DisplayItemList
+// DisplayItemChunk
 //
-DisplayItemList::DisplayItemList() {}
+DisplayItemChunk::DisplayItemChunk(int id,
+                                   int index,
+                                   const gfx::FloatRect& bounds,
+                                   std::vector<DisplayItem*>&& items)
+    : bounds_(bounds), id_(id), index_(index), items_(std::move(items)) {}
 
-DisplayItemList::~DisplayItemList() {
+DisplayItemChunk::~DisplayItemChunk() {
   for (const auto& item : items_)
     delete item;
 }
 
+bool DisplayItemChunk::EqualsTo(const DisplayItemChunk& other) const {
+  if (this == &other)
+    return true;
+  if (id_ != other.id_ || index_ != other.index_ || bounds_ != other.bounds_ ||
+      items_.size() != other.items_.size()) {
+    return false;
+  }
+  for (size_t index = 0; index < items_.size(); ++index) {
+    if (*items_[index] != *other.items_[index])
+      return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// DisplayItemList
+//
+DisplayItemList::DisplayItemList() {}
+DisplayItemList::~DisplayItemList() {}
+
 }  // namespace visuals
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "base/macros.h"
+#include "base/memory/ref_counted.h"
 #include "evita/gfx/base/geometry/float_rect.h"
 
 namespace visuals {
@@ -15,6 +16,46 @@ namespace visuals {
 class DisplayItem;
 class DisplayItemListBuilder;
 
+//////////////////////////////////////////////////////////////////////
+//
+// DisplayItemChunk
+// A sequence of display items painted for a box, identified by sequence id
+// of the box and |index|, since items of child boxes split items of their
+// parent into multiple chunks. |bounds| is the box bounds in root box
+// coordinate.
+//
+// |DisplayItemChunk| is immutable, and shared between display item lists of
+// successive frames when the box and its descendants are not changed.
+//
+class DisplayItemChunk final
+    : public base::RefCountedThreadSafe<DisplayItemChunk> {
+ public:
+  DisplayItemChunk(int id,
+                   int index,
+                   const gfx::FloatRect& bounds,
+                   std::vector<DisplayItem*>&& items);
+
+  const gfx::FloatRect& bounds() const { return bounds_; }
+  int id() const { return id_; }
+  int index() const { return index_; }
+  const std::vector<DisplayItem*>& items() const { return items_; }
+
+  // Returns true if |other| has same id and equivalent items.
+  bool EqualsTo(const DisplayItemChunk& other) const;
+
+ private:
+  friend class base::RefCountedThreadSafe<DisplayItemChunk>;
+
+  ~DisplayItemChunk();
+
+  const gfx::FloatRect bounds_;
+  const int id_;
+  const int index_;
+  const std::vector<DisplayItem*> items_;
+
+  DISALLOW_COPY_AND_ASSIGN(DisplayItemChunk);
+};
+
 //////////////////////////////////////////////////////////////////////
 //
 // DisplayItemList
@@ -24,12 +65,18 @@ class DisplayItemList final {
   DisplayItemList();
   ~DisplayItemList();
 
+  const std::vector<scoped_refptr<DisplayItemChunk>>& chunks() const {
+    return chunks_;
+  }
+
+  // Items of all chunks in paint order.
   const std::vector<DisplayItem*>& items() const { return items_; }
   const std::vector<gfx::FloatRect>& rects() const { return rects_; }
 
  private:
   friend class DisplayItemListBuilder;
 
+  std::vector<scoped_refptr<DisplayItemChunk>> chunks_;
   std::vector<DisplayItem*> items_;
   std::vector<gfx::FloatRect> rects_;
 
@@ -21,4 +21,23 @@ TEST(DisplayItemList, Basic) {
   EXPECT_EQ(3, list->items().size());
 }
 
+TEST(DisplayItemList, Chunks) {
+  gfx::FloatRect viewport_bounds(gfx::FloatSize(10, 10));
+  DisplayItemListBuilder builder(viewport_bounds);
+  builder.AddNew<BeginClipDisplayItem>(gfx::FloatRect(gfx::FloatSize(1, 2)));
+  builder.BeginChunk(1, 0, gfx::FloatRect(gfx::FloatSize(1, 2)));
+  builder.AddNew<FillRectDisplayItem>(gfx::FloatRect(gfx::FloatSize(1, 2)),
+                                      gfx::FloatColor(1, 1, 1));
+  builder.EndChunk();
+  builder.AddNew<EndClipDisplayItem>();
+  const auto& list = builder.Build();
+
+  ASSERT_EQ(3, list->chunks().size());
+  EXPECT_EQ(0, list->chunks()[0]->id());
+  EXPECT_EQ(1, list->chunks()[1]->id());
+  EXPECT_EQ(0, list->chunks()[2]->id());
+  EXPECT_EQ(1, list->chunks()[2]->index());
+  EXPECT_EQ(3, list->items().size());
+}
+
 }  // namespace visuals
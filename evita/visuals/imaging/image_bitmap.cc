@@ -16,6 +16,10 @@
 
 namespace visuals {
 
+namespace {
+int last_image_bitmap_id;
+}  // namespace
+
 //////////////////////////////////////////////////////////////////////
 //
 // ImageBitmap
@@ -23,36 +27,43 @@ namespace visuals {
 ImageBitmap::ImageBitmap(const void* data,
                          size_t data_size,
                          const gfx::FloatSize& size)
-    : impl_(new NativeImageBitmap(data, data_size, size)) {
+    : id_(++last_image_bitmap_id),
+      impl_(new NativeImageBitmap(data, data_size, size)) {
   if (impl_->get())
     return;
   impl_.reset();
 }
 
 ImageBitmap::ImageBitmap(std::unique_ptr<NativeImageBitmap> impl)
-    : impl_(std::move(impl)) {
+    : id_(++last_image_bitmap_id), impl_(std::move(impl)) {
   if (impl_->get())
     return;
   impl_.reset();
 }
 
 ImageBitmap::ImageBitmap(const gfx::FloatSize& size)
-    : impl_(new NativeImageBitmap(size)) {}
+    : id_(++last_image_bitmap_id), impl_(new NativeImageBitmap(size)) {}
 
 ImageBitmap::ImageBitmap(const ImageBitmap& other)
-    : impl_(new NativeImageBitmap(*other.impl_)) {}
+    : id_(other.id_), impl_(new NativeImageBitmap(*other.impl_)) {}
 
-ImageBitmap::ImageBitmap(ImageBitmap&& other) : impl_(std::move(other.impl_)) {}
+ImageBitmap::ImageBitmap(ImageBitmap&& other)
+    : id_(other.id_), impl_(std::move(other.impl_)) {
+  other.id_ = 0;
+}
 
 ImageBitmap::ImageBitmap() {}
 ImageBitmap::~ImageBitmap() {}
 
 ImageBitmap& ImageBitmap::operator=(const ImageBitmap& other) {
+  id_ = other.id_;
   impl_.reset(new NativeImageBitmap(*other.impl_));
   return *this;
 }
 
 ImageBitmap& ImageBitmap::operator=(ImageBitmap&& other) {
+  id_ = other.id_;
+  other.id_ = 0;
   impl_ = std::move(other.impl_);
   return *this;
 }
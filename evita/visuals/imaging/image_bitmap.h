@@ -23,6 +23,8 @@ class NativeImageBitmap;
 //////////////////////////////////////////////////////////////////////
 //
 // ImageBitmap
+// Copies of |ImageBitmap| share native image and |id()|. Since native image
+// is never modified, |id()| also identifies contents of image.
 //
 class ImageBitmap final {
  public:
@@ -42,6 +44,7 @@ class ImageBitmap final {
 
   std::vector<uint8_t> data() const;
   base::string16 format() const;
+  int id() const { return id_; }
   const NativeImageBitmap& impl() const { return *impl_; }
   bool is_valid() const { return static_cast<bool>(impl_); }
   gfx::FloatSize resolution() const;
@@ -54,6 +57,7 @@ class ImageBitmap final {
   std::vector<uint8_t> Encode(base::StringPiece16 format) const;
 
  private:
+  int id_ = 0;
   std::unique_ptr<NativeImageBitmap> impl_;
 };
 
@@ -60,6 +60,12 @@ bool Box::IsDescendantOf(const Box& other) const {
   return false;
 }
 
+bool Box::IsLayoutBoundary() const {
+  if (is<RootBox>())
+    return true;
+  return width_.is_length() && height_.is_length();
+}
+
 std::ostream& operator<<(std::ostream& ostream, const Box& box) {
   ostream << box.class_name() << '.' << box.sequence_id();
   if (box.node())
@@ -74,6 +74,7 @@ class Box : public base::DeprecatedCastable<Box> {
   const css::Display& display() const { return display_; }
 
   bool is_changed() const { return is_changed_; }
+  bool needs_layout() const { return needs_layout_; }
 
   // CSS background and background
   const gfx::FloatColor& background_color() const { return background_color_; }
@@ -100,6 +101,11 @@ class Box : public base::DeprecatedCastable<Box> {
   bool InDocument() const;
   bool IsDescendantOf(const Box& other) const;
 
+  // Returns true if size of this box doesn't depend on its descendants, e.g.
+  // "width" and "height" are fixed. Changes in descendants of layout boundary
+  // don't require layout of its ancestors and siblings.
+  bool IsLayoutBoundary() const;
+
   // Change tracking
   bool IsBackgroundChanged() const { return is_background_changed_; }
   bool IsBorderChanged() const { return is_border_changed_; }
@@ -132,6 +138,9 @@ class Box : public base::DeprecatedCastable<Box> {
   bool is_origin_changed_ = true;
   bool is_padding_changed_ = true;
   bool is_size_changed_ = true;
+  // |needs_layout_| is set by |BoxEditor| when size of this box or positions
+  // of its children may be changed, and reset by |Layouter|.
+  bool needs_layout_ = true;
   bool should_paint_ = true;
 
   gfx::FloatColor background_color_;
@@ -15,7 +15,7 @@
 #include "evita/visuals/fonts/text_layout.h"
 #include "evita/visuals/imaging/image_bitmap.h"
 #include "evita/visuals/layout/ancestors.h"
-#include "evita/visuals/layout/ancestors_or_self.h"
+#include "evita/visuals/layout/box_index.h"
 #include "evita/visuals/layout/box_selection.h"
 #include "evita/visuals/layout/descendants_or_self.h"
 #include "evita/visuals/layout/flow_box.h"
@@ -29,6 +29,17 @@ namespace visuals {
 
 namespace {
 
+// Minimum number of child boxes for building |BoxIndex|. Scanning a few
+// children is faster than building index.
+const auto kMinimumChildrenForIndex = 32;
+
+// Returns true if |border1| and |border2| have same widths. Changing border
+// color doesn't affect layout.
+bool IsSameBorderWidth(const Border& border1, const Border& border2) {
+  return border1.top_left() == border2.top_left() &&
+         border1.bottom_right() == border2.bottom_right();
+}
+
 gfx::FloatColor ResolveColor(const css::Style& style, const css::Value& value) {
   if (value.is_color())
     return value.as_color_value().value();
@@ -137,6 +148,17 @@ Padding ComputePadding(const css::Style& style) {
   return Padding(padding_top, padding_right, padding_bottom, padding_left);
 }
 
+bool HasManyChildren(const ContainerBox& container) {
+  auto count = 0;
+  for (const auto& child : container.child_boxes()) {
+    static_cast<void>(child);
+    ++count;
+    if (count >= kMinimumChildrenForIndex)
+      return true;
+  }
+  return false;
+}
+
 void MustBeInLayout(const Box& box) {
   const auto lifecycle = box.root_box()->lifecycle();
   DCHECK_EQ(ViewLifecycle::State::InLayout, lifecycle->state()) << lifecycle;
@@ -249,7 +271,9 @@ void BoxEditor::AppendChild(ContainerBox* container, Box* new_child) {
     container->first_child_ = new_child;
   }
   container->last_child_ = new_child;
+  container->child_index_.reset();
   MarkDirty(container);
+  SetNeedsLayout(container);
   new_child->version_ = container->version_;
 }
 
@@ -265,7 +289,15 @@ const FontDescription& BoxEditor::ComputeFontDescription(const TextBox& box) {
 }
 
 void BoxEditor::DidLayout(Box* box) {
-  // TODO(eval1749): What should we do here?
+  MustBeInLayout(*box);
+  box->needs_layout_ = false;
+  const auto container = box->as<ContainerBox>();
+  if (!container)
+    return;
+  container->child_needs_layout_ = false;
+  if (container->child_index_ || !HasManyChildren(*container))
+    return;
+  container->child_index_.reset(new BoxIndex(*container));
 }
 
 void BoxEditor::DidMove(Box* box) {
@@ -344,9 +376,11 @@ void BoxEditor::RemoveChild(ContainerBox* container, Box* old_child) {
   old_child->next_sibling_ = nullptr;
   old_child->previous_sibling_ = nullptr;
   old_child->parent_ = nullptr;
+  container->child_index_.reset();
   if (root_box->lifecycle()->InShutdown())
     return;
   MarkDirty(container);
+  SetNeedsLayout(container);
 }
 
 void BoxEditor::RemoveDescendants(ContainerBox* container_box) {
@@ -384,7 +418,11 @@ void BoxEditor::SetBounds(Box* box, const gfx::FloatRect& new_bounds) {
   }
   const auto old_bounds = box->bounds_;
   box->bounds_ = new_bounds;
+  if (const auto parent = box->parent_)
+    parent->child_index_.reset();
   box->DidChangeBounds(old_bounds);
+  // Painter can't reuse display items of this box and its ancestors.
+  SetShouldPaint(box);
 }
 
 void BoxEditor::SetContentChanged(ContentBox* box) {
@@ -394,7 +432,10 @@ void BoxEditor::SetContentChanged(ContentBox* box) {
 
 void BoxEditor::SetDisplay(Box* box, const css::Display& display) {
   MustBeInTreeRebuild(*box);
+  if (box->display_ == display)
+    return;
   box->display_ = display;
+  SetNeedsLayout(box);
 }
 
 #define FOR_EACH_PROPERTY_AFFECTS_ORIGIN(V) \
@@ -430,9 +471,11 @@ void BoxEditor::SetStyle(Box* box, const css::Style& new_style) {
     return SetTextStyle(text, new_style);
 
   auto is_changed = false;
+  auto is_layout_changed = false;
   if (new_style.has_display() && new_style.display() != box->display()) {
     box->display_ = new_style.display();
     is_changed = true;
+    is_layout_changed = true;
   }
 
   UPDATE_COLOR(background, background_color);
@@ -443,6 +486,8 @@ void BoxEditor::SetStyle(Box* box, const css::Style& new_style) {
 
   const auto& new_border = ComputeBorder(new_style);
   if (box->border_ != new_border) {
+    if (!IsSameBorderWidth(box->border_, new_border))
+      is_layout_changed = true;
     box->border_ = new_border;
     box->is_border_changed_ = true;
     is_changed = true;
@@ -453,6 +498,7 @@ void BoxEditor::SetStyle(Box* box, const css::Style& new_style) {
     box->margin_ = new_margin;
     box->is_origin_changed_ = true;
     is_changed = true;
+    is_layout_changed = true;
   }
 
   const auto& new_padding = ComputePadding(new_style);
@@ -460,6 +506,7 @@ void BoxEditor::SetStyle(Box* box, const css::Style& new_style) {
     box->padding_ = new_padding;
     box->is_padding_changed_ = true;
     is_changed = true;
+    is_layout_changed = true;
   }
 
 #define V(property)                               \
@@ -468,6 +515,7 @@ void BoxEditor::SetStyle(Box* box, const css::Style& new_style) {
     box->property##_ = new_style.property();      \
     box->is_origin_changed_ = true;               \
     is_changed = true;                            \
+    is_layout_changed = true;                     \
   }
   FOR_EACH_PROPERTY_AFFECTS_ORIGIN(V)
 #undef V
@@ -478,6 +526,7 @@ void BoxEditor::SetStyle(Box* box, const css::Style& new_style) {
     box->property##_ = new_style.property();      \
     box->is_size_changed_ = true;                 \
     is_changed = true;                            \
+    is_layout_changed = true;                     \
   }
   FOR_EACH_PROPERTY_AFFECTS_SIZE(V)
 #undef V
@@ -485,6 +534,13 @@ void BoxEditor::SetStyle(Box* box, const css::Style& new_style) {
   if (!is_changed)
     return;
   MarkDirty(box);
+  if (!is_layout_changed)
+    return;
+  // Since size and position of |box| may be changed, its parent should lay
+  // out children even if |box| is a layout boundary.
+  SetNeedsLayout(box);
+  if (const auto parent = box->parent_)
+    SetNeedsLayout(parent);
 }
 
 void BoxEditor::SetImageData(ImageBox* image_box, const ImageData& data) {
@@ -493,6 +549,7 @@ void BoxEditor::SetImageData(ImageBox* image_box, const ImageData& data) {
     return;
   image_box->data_ = data;
   SetContentChanged(image_box);
+  SetNeedsLayout(image_box);
 }
 
 void BoxEditor::SetImageStyle(ImageBox* box, const css::Style& new_style) {
@@ -505,6 +562,36 @@ void BoxEditor::SetImageStyle(ImageBox* box, const css::Style& new_style) {
   MarkDirty(box);
 }
 
+void BoxEditor::SetIntrinsicSize(FlowBox* box, const gfx::FloatSize& size) {
+  MustBeInLayout(*box);
+  box->has_intrinsic_size_ = true;
+  box->intrinsic_size_ = size;
+}
+
+void BoxEditor::SetNeedsLayout(Box* box) {
+  box->needs_layout_ = true;
+  if (const auto flow_box = box->as<FlowBox>())
+    flow_box->has_intrinsic_size_ = false;
+  // Size of |runner| may be changed by layout, so its parent needs layout
+  // too, until we reach a layout boundary.
+  auto runner = box;
+  while (!runner->IsLayoutBoundary()) {
+    const auto parent = runner->parent_;
+    if (!parent || parent->needs_layout_)
+      return;
+    parent->needs_layout_ = true;
+    if (const auto flow_box = parent->as<FlowBox>())
+      flow_box->has_intrinsic_size_ = false;
+    runner = parent;
+  }
+  // Ancestors of layout boundary only need to visit path to it.
+  for (const auto& ancestor : Box::Ancestors(*runner)) {
+    if (ancestor->needs_layout_ || ancestor->child_needs_layout_)
+      return;
+    ancestor->child_needs_layout_ = true;
+  }
+}
+
 void BoxEditor::SetPreferredSize(TextBox* box, const gfx::FloatSize& size) {
   box->preferred_size_ = size;
 }
@@ -515,6 +602,7 @@ void BoxEditor::SetShapeData(ShapeBox* shape_box, const ShapeData& data) {
     return;
   shape_box->data_ = data;
   SetContentChanged(shape_box);
+  SetNeedsLayout(shape_box);
 }
 
 void BoxEditor::SetShapeStyle(ShapeBox* box, const css::Style& new_style) {
@@ -532,6 +620,7 @@ void BoxEditor::SetShapeStyle(ShapeBox* box, const css::Style& new_style) {
   if (new_style.has_font_size() && new_style.font_size() != box->font_size_) {
     box->font_size_ = new_style.font_size();
     is_changed = true;
+    SetNeedsLayout(box);
   }
 
   if (!is_changed)
@@ -541,7 +630,10 @@ void BoxEditor::SetShapeStyle(ShapeBox* box, const css::Style& new_style) {
 }
 
 void BoxEditor::SetShouldPaint(Box* box) {
-  for (const auto& runner : Box::AncestorsOrSelf(*box)) {
+  // Note: |box| may not be painted yet, e.g. outside of viewport, but we
+  // should tell its ancestors.
+  box->should_paint_ = true;
+  for (const auto& runner : Box::Ancestors(*box)) {
     if (runner->should_paint_)
       return;
     runner->should_paint_ = true;
@@ -556,6 +648,7 @@ void BoxEditor::SetTextData(TextBox* text_box, base::StringPiece16 data) {
   text_box->text_layout_.reset();
   text_box->preferred_size_ = gfx::FloatSize();
   SetContentChanged(text_box);
+  SetNeedsLayout(text_box);
 }
 
 #define FOR_EACH_PROPERTY_AFFECTS_TEXT_FONT(V) \
@@ -586,6 +679,12 @@ void BoxEditor::SetTextStyle(TextBox* box, const css::Style& new_style) {
   FOR_EACH_PROPERTY_AFFECTS_TEXT_FONT(V)
 #undef V
 
+  if (!box->text_format_) {
+    box->text_layout_.reset();
+    box->preferred_size_ = gfx::FloatSize();
+    SetNeedsLayout(box);
+  }
+
   if (!is_changed)
     return;
   box->is_content_changed_ = true;
@@ -627,6 +726,7 @@ void BoxEditor::SetViewportSize(RootBox* root_box, const gfx::FloatSize& size) {
   // use |RootBox::bounds_.size()|.
   root_box->viewport_size_ = size;
   root_box->is_size_changed_ = true;
+  SetNeedsLayout(root_box);
 }
 
 void BoxEditor::WillDestroy(Box* box) {
@@ -43,6 +43,7 @@ class BoxEditor final {
   void DidPaint(Box* box);
   void SetBounds(Box* box, const gfx::FloatRect& new_bounds);
   void SetLayoutClean(Box* box);
+  void SetNeedsLayout(Box* box);
 
   // ContainerBox
   void AppendChild(ContainerBox* container, Box* new_child);
@@ -57,6 +58,9 @@ class BoxEditor final {
   void SetShouldPaint(Box* box);
   void WillDestroy(Box* box);
 
+  // FlowBox
+  void SetIntrinsicSize(FlowBox* box, const gfx::FloatSize& size);
+
   // ImageBox
   void SetImageData(ImageBox* box, const ImageData& data);
 
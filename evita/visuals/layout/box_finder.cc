@@ -6,6 +6,7 @@
 
 #include "base/logging.h"
 #include "evita/gfx/base/geometry/float_rect.h"
+#include "evita/visuals/layout/box_index.h"
 #include "evita/visuals/layout/layouter.h"
 #include "evita/visuals/layout/root_box.h"
 
@@ -13,20 +14,30 @@ namespace visuals {
 
 namespace {
 
+// Returns the first child box of |container| containing |point|.
+Box* FindChildByPoint(const ContainerBox& container,
+                      const gfx::FloatPoint& point) {
+  if (const auto index = container.child_index()) {
+    const auto& children = index->FindByPoint(point);
+    return children.empty() ? nullptr : children.front();
+  }
+  for (const auto child : container.child_boxes()) {
+    if (child->bounds().Contains(point))
+      return child;
+  }
+  return nullptr;
+}
+
 HitTestResult WalkInTree(const gfx::FloatPoint& point, const Box* box) {
   const auto& point_in_box =
       point - gfx::FloatSize(box->bounds().x(), box->bounds().y());
   if (!box->bounds().Contains(point))
     return HitTestResult();
-  const auto container = box->as<ContainerBox>();
-  if (container) {
-    for (const auto child : container->child_boxes()) {
+  if (const auto container = box->as<ContainerBox>()) {
+    if (const auto child = FindChildByPoint(*container, point_in_box)) {
       const auto& result = WalkInTree(point_in_box, child);
-      if (result.box()) {
-        if (result.node())
-          return result;
-        break;
-      }
+      if (result.node())
+        return result;
     }
   }
   return HitTestResult(const_cast<Box*>(box), point_in_box);
@@ -0,0 +1,127 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "evita/visuals/layout/box_index.h"
+
+#include "base/logging.h"
+#include "evita/visuals/layout/container_box.h"
+
+namespace visuals {
+
+namespace {
+
+// Number of entries in a node of R-tree.
+const size_t kFanOut = 16;
+
+float CenterX(const gfx::FloatRect& rect) {
+  return rect.x() + rect.width() / 2;
+}
+
+float CenterY(const gfx::FloatRect& rect) {
+  return rect.y() + rect.height() / 2;
+}
+
+gfx::FloatRect UnionRects(const gfx::FloatRect& rect1,
+                          const gfx::FloatRect& rect2) {
+  return gfx::FloatRect(gfx::FloatPoint(std::min(rect1.x(), rect2.x()),
+                                        std::min(rect1.y(), rect2.y())),
+                        gfx::FloatPoint(std::max(rect1.right(), rect2.right()),
+                                        std::max(rect1.bottom(),
+                                                 rect2.bottom())));
+}
+
+// Sorts |nodes| by "Sort-Tile-Recursive" algorithm, then packs each
+// |kFanOut| nodes into a parent node.
+template <typename Node>
+std::vector<Node> PackNodes(std::vector<Node>* nodes) {
+  const auto num_parents = (nodes->size() + kFanOut - 1) / kFanOut;
+  const auto num_slices = static_cast<size_t>(
+      std::ceil(std::sqrt(static_cast<double>(num_parents))));
+  const auto slice_size = num_slices * kFanOut;
+  std::sort(nodes->begin(), nodes->end(),
+            [](const Node& node1, const Node& node2) {
+              return CenterX(node1.bounds) < CenterX(node2.bounds);
+            });
+  for (size_t start = 0; start < nodes->size(); start += slice_size) {
+    const auto end = std::min(start + slice_size, nodes->size());
+    std::sort(nodes->begin() + start, nodes->begin() + end,
+              [](const Node& node1, const Node& node2) {
+                return CenterY(node1.bounds) < CenterY(node2.bounds);
+              });
+  }
+  std::vector<Node> parents;
+  parents.reserve(num_parents);
+  for (size_t start = 0; start < nodes->size(); start += kFanOut) {
+    const auto end = std::min(start + kFanOut, nodes->size());
+    auto bounds = (*nodes)[start].bounds;
+    for (auto index = start + 1; index < end; ++index)
+      bounds = UnionRects(bounds, (*nodes)[index].bounds);
+    parents.push_back({bounds, start, end});
+  }
+  return parents;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// BoxIndex
+//
+BoxIndex::BoxIndex(const ContainerBox& container) {
+  std::vector<Node> leaves;
+  for (const auto& child : container.child_boxes()) {
+    leaves.push_back({child->bounds(), boxes_.size(), boxes_.size() + 1});
+    boxes_.push_back(child);
+  }
+  DCHECK(!leaves.empty()) << container;
+  levels_.push_back(std::move(leaves));
+  while (levels_.back().size() > 1)
+    levels_.push_back(PackNodes(&levels_.back()));
+}
+
+BoxIndex::~BoxIndex() {}
+
+template <typename Predicate>
+std::vector<Box*> BoxIndex::Find(const Predicate& predicate) const {
+  std::vector<size_t> indexes;
+  FindInNode(predicate, levels_.size() - 1, 0, &indexes);
+  std::sort(indexes.begin(), indexes.end());
+  std::vector<Box*> boxes;
+  boxes.reserve(indexes.size());
+  for (const auto index : indexes)
+    boxes.push_back(boxes_[index]);
+  return boxes;
+}
+
+std::vector<Box*> BoxIndex::FindByPoint(const gfx::FloatPoint& point) const {
+  return Find(
+      [&](const gfx::FloatRect& bounds) { return bounds.Contains(point); });
+}
+
+std::vector<Box*> BoxIndex::FindByRect(const gfx::FloatRect& rect) const {
+  return Find(
+      [&](const gfx::FloatRect& bounds) { return bounds.Intersects(rect); });
+}
+
+template <typename Predicate>
+void BoxIndex::FindInNode(const Predicate& predicate,
+                          size_t level,
+                          size_t index,
+                          std::vector<size_t>* indexes) const {
+  const auto& node = levels_[level][index];
+  if (!predicate(node.bounds))
+    return;
+  if (level == 0) {
+    indexes->push_back(node.begin);
+    return;
+  }
+  for (auto child = node.begin; child < node.end; ++child)
+    FindInNode(predicate, level - 1, child, indexes);
+}
+
+}  // namespace visuals
@@ -0,0 +1,67 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_VISUALS_LAYOUT_BOX_INDEX_H_
+#define EVITA_VISUALS_LAYOUT_BOX_INDEX_H_
+
+#include <vector>
+
+#include "base/macros.h"
+#include "evita/gfx/base/geometry/float_rect.h"
+
+namespace visuals {
+
+class Box;
+class ContainerBox;
+
+//////////////////////////////////////////////////////////////////////
+//
+// BoxIndex
+// A packed R-tree of bounds of child boxes of a container box, for finding
+// child boxes by point or rectangle without scanning all children.
+//
+// |BoxEditor| builds |BoxIndex| in |DidLayout()| for container having many
+// children, and discards it when children or their bounds are changed.
+//
+class BoxIndex final {
+ public:
+  explicit BoxIndex(const ContainerBox& container);
+  ~BoxIndex();
+
+  // Returns child boxes containing |point| in child order.
+  std::vector<Box*> FindByPoint(const gfx::FloatPoint& point) const;
+
+  // Returns child boxes intersecting with |rect| in child order.
+  std::vector<Box*> FindByRect(const gfx::FloatRect& rect) const;
+
+ private:
+  struct Node {
+    gfx::FloatRect bounds;
+    // For leaf node, [begin, end) is index of child box in |boxes_|,
+    // otherwise range of nodes in lower level.
+    size_t begin;
+    size_t end;
+  };
+
+  template <typename Predicate>
+  std::vector<Box*> Find(const Predicate& predicate) const;
+  template <typename Predicate>
+  void FindInNode(const Predicate& predicate,
+                  size_t level,
+                  size_t index,
+                  std::vector<size_t>* indexes) const;
+
+  // Child boxes in child order.
+  std::vector<Box*> boxes_;
+
+  // |levels_.front()| holds one leaf node per child box, and
+  // |levels_.back()| holds the root node.
+  std::vector<std::vector<Node>> levels_;
+
+  DISALLOW_COPY_AND_ASSIGN(BoxIndex);
+};
+
+}  // namespace visuals
+
+#endif  // EVITA_VISUALS_LAYOUT_BOX_INDEX_H_
@@ -0,0 +1,128 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include "evita/visuals/layout/box_index.h"
+
+#include "base/macros.h"
+#include "evita/css/style.h"
+#include "evita/css/style_builder.h"
+#include "evita/css/values.h"
+#include "evita/gfx/base/geometry/float_rect.h"
+#include "evita/visuals/layout/box_editor.h"
+#include "evita/visuals/layout/flow_box.h"
+#include "evita/visuals/layout/layouter.h"
+#include "evita/visuals/layout/root_box.h"
+#include "evita/visuals/layout/simple_box_tree.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace visuals {
+
+namespace {
+
+const size_t kNumberOfChildren = 100;
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// BoxIndexTest
+// Builds a flow box having |kNumberOfChildren| child boxes of height 10px.
+//
+class BoxIndexTest : public ::testing::Test {
+ protected:
+  BoxIndexTest();
+  ~BoxIndexTest() override = default;
+
+  SimpleBoxTree* box_tree() { return &box_tree_; }
+  FlowBox* main() { return box_tree_.root_box()->first_child()->as<FlowBox>(); }
+
+  // Returns indexes of |boxes| in children of |main()|.
+  std::vector<int> IndexesOf(const std::vector<Box*>& boxes);
+  void Layout() { Layouter().Layout(box_tree_.root_box()); }
+
+ private:
+  SimpleBoxTree box_tree_;
+
+  DISALLOW_COPY_AND_ASSIGN(BoxIndexTest);
+};
+
+BoxIndexTest::BoxIndexTest() {
+  const auto& style = css::StyleBuilder()
+                          .SetDisplay(css::Display::Block())
+                          .SetHeight(10)
+                          .Build();
+  box_tree_.Begin<FlowBox>();
+  for (size_t count = 0; count < kNumberOfChildren; ++count)
+    box_tree_.Begin<FlowBox>().SetStyle(*style).End<FlowBox>();
+  box_tree_.End<FlowBox>().Finish();
+}
+
+std::vector<int> BoxIndexTest::IndexesOf(const std::vector<Box*>& boxes) {
+  std::vector<int> indexes;
+  for (const auto& box : boxes) {
+    auto index = 0;
+    for (const auto& child : main()->child_boxes()) {
+      if (child == box)
+        break;
+      ++index;
+    }
+    indexes.push_back(index);
+  }
+  return indexes;
+}
+
+TEST_F(BoxIndexTest, FewChildren) {
+  SimpleBoxTree box_tree;
+  box_tree.Begin<FlowBox>().Add<FlowBox>().End<FlowBox>().Finish();
+  Layouter().Layout(box_tree.root_box());
+  const auto main = box_tree.root_box()->first_child()->as<FlowBox>();
+  EXPECT_FALSE(main->child_index());
+}
+
+TEST_F(BoxIndexTest, FindByPoint) {
+  Layout();
+  const auto index = main()->child_index();
+  ASSERT_TRUE(index);
+  EXPECT_EQ(std::vector<int>{0}, IndexesOf(index->FindByPoint({5, 0})));
+  EXPECT_EQ(std::vector<int>{25}, IndexesOf(index->FindByPoint({5, 255})));
+  EXPECT_EQ(std::vector<int>{99}, IndexesOf(index->FindByPoint({799, 999})));
+  EXPECT_TRUE(index->FindByPoint({5, 1000}).empty());
+  EXPECT_TRUE(index->FindByPoint({800, 5}).empty());
+}
+
+TEST_F(BoxIndexTest, FindByRect) {
+  Layout();
+  const auto index = main()->child_index();
+  ASSERT_TRUE(index);
+  EXPECT_EQ((std::vector<int>{9, 10, 11, 12}),
+            IndexesOf(index->FindByRect(
+                gfx::FloatRect(gfx::FloatPoint(0, 95), gfx::FloatSize(1, 30)))))
+      << "Results should be in child order.";
+  EXPECT_EQ(kNumberOfChildren,
+            index->FindByRect(gfx::FloatRect(gfx::FloatSize(800, 1000)))
+                .size());
+}
+
+TEST_F(BoxIndexTest, Invalidate) {
+  EXPECT_FALSE(main()->child_index()) << "Index is built by layout.";
+  Layout();
+  EXPECT_TRUE(main()->child_index());
+
+  box_tree()->StartOver();
+  const auto first_child = main()->first_child();
+  BoxEditor().RemoveChild(main(), first_child);
+  delete first_child;
+  box_tree()->Finish();
+  EXPECT_FALSE(main()->child_index()) << "Removing child discards index.";
+
+  Layout();
+  const auto index = main()->child_index();
+  ASSERT_TRUE(index);
+  EXPECT_EQ(std::vector<int>{0}, IndexesOf(index->FindByPoint({5, 5})));
+}
+
+}  // namespace visuals
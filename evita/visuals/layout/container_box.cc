@@ -6,6 +6,7 @@
 
 #include "base/logging.h"
 #include "evita/visuals/layout/box_editor.h"
+#include "evita/visuals/layout/box_index.h"
 
 namespace visuals {
 
@@ -15,6 +15,7 @@
 namespace visuals {
 
 class BoxEditor;
+class BoxIndex;
 
 //////////////////////////////////////////////////////////////////////
 //
@@ -27,6 +28,10 @@ class ContainerBox : public Box {
   ~ContainerBox() override;
 
   Children child_boxes() const { return Children(*this); }
+  bool child_needs_layout() const { return child_needs_layout_; }
+  // Returns spatial index of child boxes, or null if this box doesn't have
+  // many children.
+  const BoxIndex* child_index() const { return child_index_.get(); }
   Box* first_child() const { return first_child_; }
   bool is_child_changed() const { return is_child_changed_; }
   Box* last_child() const { return last_child_; }
@@ -42,6 +47,11 @@ class ContainerBox : public Box {
   Box* first_child_ = nullptr;
   Box* last_child_ = nullptr;
 
+  std::unique_ptr<BoxIndex> child_index_;
+
+  // |child_needs_layout_| is true when one of descendants needs layout but
+  // layout of this box isn't affected, e.g. descendant is a layout boundary.
+  bool child_needs_layout_ = false;
   bool is_child_changed_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(ContainerBox);
@@ -5,6 +5,7 @@
 #ifndef EVITA_VISUALS_LAYOUT_FLOW_BOX_H_
 #define EVITA_VISUALS_LAYOUT_FLOW_BOX_H_
 
+#include "evita/gfx/base/geometry/float_size.h"
 #include "evita/visuals/layout/container_box.h"
 
 namespace visuals {
@@ -21,7 +22,15 @@ class FlowBox final : public ContainerBox {
   explicit FlowBox(RootBox* root_box);
   ~FlowBox() final;
 
+  // Intrinsic size cached by |SizeCalculator|, which is valid until
+  // |BoxEditor| marks this box as needs layout.
+  const gfx::FloatSize& intrinsic_size() const { return intrinsic_size_; }
+  bool has_intrinsic_size() const { return has_intrinsic_size_; }
+
  private:
+  bool has_intrinsic_size_ = false;
+  gfx::FloatSize intrinsic_size_;
+
   DISALLOW_COPY_AND_ASSIGN(FlowBox);
 };
 
@@ -32,12 +32,17 @@ bool IsDisplayOutsideInline(const css::Display& display) {
 //////////////////////////////////////////////////////////////////////
 //
 // LayoutVisitor
+// Lays out boxes marked as needs layout and visits boxes having child needs
+// layout to reach them. Other boxes are skipped unless their size is
+// changed by layout of their parent.
 //
 class LayoutVisitor final : public BoxVisitor {
  public:
   LayoutVisitor() = default;
   ~LayoutVisitor() final = default;
 
+  int num_visited_boxes() const { return num_visited_boxes_; }
+
   void LayoutIfNeeded(Box* box);
 
  private:
@@ -54,6 +59,8 @@ class LayoutVisitor final : public BoxVisitor {
   FOR_EACH_VISUAL_BOX(V)
 #undef V
 
+  int num_visited_boxes_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(LayoutVisitor);
 };
 
@@ -64,11 +71,17 @@ void LayoutVisitor::Layout(Box* box,
 }
 
 void LayoutVisitor::Layout(Box* box, const gfx::FloatRect& bounds) {
+  const auto is_size_changed = box->bounds().size() != bounds.size();
   BoxEditor().SetBounds(box, bounds);
-  Layout(box);
+  if (is_size_changed)
+    return Layout(box);
+  // Moving |box| doesn't change layout of its descendants, since they are
+  // positioned relative to |box|.
+  LayoutIfNeeded(box);
 }
 
 void LayoutVisitor::Layout(Box* box) {
+  ++num_visited_boxes_;
   Visit(box);
   BoxEditor().DidLayout(box);
 }
@@ -82,9 +95,8 @@ void LayoutVisitor::LayoutFlowBoxHorizontally(const FlowBox& flow_box) {
     const auto& child_padding = child->padding();
     const auto& child_size = SizeCalculator().ComputePreferredSize(*child) +
                              child_border.size() + child_padding.size();
-    LayoutVisitor().Layout(
-        child,
-        gfx::FloatRect(child_origin + child_margin.top_left(), child_size));
+    Layout(child,
+           gfx::FloatRect(child_origin + child_margin.top_left(), child_size));
     child_origin = gfx::FloatPoint(
         child->bounds().right() + child_margin.right(), child_origin.y());
   }
@@ -101,33 +113,30 @@ void LayoutVisitor::LayoutFlowBoxVertically(const FlowBox& flow_box) {
     const auto& child_size = SizeCalculator().ComputePreferredSize(*child) +
                              child_border.size() + child_padding.size();
     if (child->position().is_absolute()) {
-      LayoutVisitor().Layout(
-          child, gfx::FloatPoint(child->left().as_length().value(),
-                                 child->top().as_length().value()) +
-                     child_margin.top_left(),
-          gfx::FloatSize(content_width, child_size.height()));
+      Layout(child, gfx::FloatPoint(child->left().as_length().value(),
+                                    child->top().as_length().value()) +
+                        child_margin.top_left(),
+             gfx::FloatSize(content_width, child_size.height()));
       continue;
     }
-    LayoutVisitor().Layout(
-        child,
-        gfx::FloatRect(child_origin + child_margin.top_left(),
-                       gfx::FloatSize(content_width, child_size.height())));
+    Layout(child,
+           gfx::FloatRect(child_origin + child_margin.top_left(),
+                          gfx::FloatSize(content_width, child_size.height())));
     child_origin = gfx::FloatPoint(
         child_origin.x(), child->bounds().bottom() + child_margin.bottom());
   }
 }
 
 void LayoutVisitor::LayoutIfNeeded(Box* box) {
-  if (box->is_changed())
+  if (box->needs_layout())
     return Layout(box);
   const auto container = box->as<ContainerBox>();
-  if (!container)
-    return;
-  if (!container->is_child_changed())
+  if (!container || !container->child_needs_layout())
     return;
+  ++num_visited_boxes_;
   for (const auto& child : container->child_boxes())
     LayoutIfNeeded(child);
-  return Layout(container);
+  BoxEditor().DidLayout(container);
 }
 
 // BoxVisitor
@@ -145,7 +154,7 @@ void LayoutVisitor::VisitImageBox(ImageBox* box) {
 }
 
 void LayoutVisitor::VisitRootBox(RootBox* root) {
-  LayoutVisitor().Layout(root->first_child(), root->content_bounds());
+  Layout(root->first_child(), root->content_bounds());
 }
 
 void LayoutVisitor::VisitShapeBox(ShapeBox* box) {
@@ -162,9 +171,9 @@ void LayoutVisitor::VisitTextBox(TextBox* box) {
 //
 // Layouter
 //
-Layouter::Layouter() {}
+Layouter::Layouter() = default;
 
-Layouter::~Layouter() {}
+Layouter::~Layouter() = default;
 
 void Layouter::Layout(RootBox* root_box) {
   if (root_box->IsLayoutClean())
@@ -173,7 +182,10 @@ void Layouter::Layout(RootBox* root_box) {
   ViewLifecycle::Scope scope(root_box->lifecycle(),
                              ViewLifecycle::State::InLayout);
   DCHECK(!root_box->bounds().size().IsEmpty());
-  LayoutVisitor().LayoutIfNeeded(root_box);
+  LayoutVisitor visitor;
+  visitor.LayoutIfNeeded(root_box);
+  num_visited_boxes_ = visitor.num_visited_boxes();
+  TRACE_COUNTER1("visuals", "LayoutVisitedBoxes", num_visited_boxes_);
 }
 
 }  // namespace visuals
@@ -18,15 +18,23 @@ class RootBox;
 //////////////////////////////////////////////////////////////////////
 //
 // Layouter
+// Lays out only boxes on paths to boxes marked as needs layout by
+// |BoxEditor|.
 //
 class Layouter final {
  public:
   Layouter();
   ~Layouter();
 
+  // Number of boxes visited by the last |Layout()|, for measuring how
+  // incremental layout is.
+  int num_visited_boxes() const { return num_visited_boxes_; }
+
   void Layout(RootBox* root);
 
  private:
+  int num_visited_boxes_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(Layouter);
 };
 
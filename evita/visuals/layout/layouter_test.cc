@@ -0,0 +1,140 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "evita/visuals/layout/layouter.h"
+
+#include "base/macros.h"
+#include "evita/css/style.h"
+#include "evita/css/style_builder.h"
+#include "evita/css/values.h"
+#include "evita/gfx/base/geometry/float_rect.h"
+#include "evita/visuals/layout/box_editor.h"
+#include "evita/visuals/layout/flow_box.h"
+#include "evita/visuals/layout/root_box.h"
+#include "evita/visuals/layout/simple_box_tree.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace visuals {
+
+namespace {
+
+std::unique_ptr<css::Style> BlockStyle(float height) {
+  return css::StyleBuilder()
+      .SetDisplay(css::Display::Block())
+      .SetHeight(height)
+      .Build();
+}
+
+gfx::FloatRect MakeRect(float x, float y, float width, float height) {
+  return gfx::FloatRect(gfx::FloatPoint(x, y), gfx::FloatSize(width, height));
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// LayouterTest
+// Builds following box tree, where "boundary" is a layout boundary:
+//  root
+//    main
+//      boundary (width: 100px; height: 50px)
+//        first (height: 10px)
+//        second (height: 10px)
+//      last (height: 20px)
+//
+class LayouterTest : public ::testing::Test {
+ protected:
+  LayouterTest();
+  ~LayouterTest() override = default;
+
+  Box* boundary() const { return main()->first_child(); }
+  Box* first() const { return boundary()->as<FlowBox>()->first_child(); }
+  Box* last() const { return main()->last_child(); }
+  FlowBox* main() const { return root()->first_child()->as<FlowBox>(); }
+  RootBox* root() const { return box_tree_->root_box(); }
+  Box* second() const { return boundary()->as<FlowBox>()->last_child(); }
+  SimpleBoxTree* box_tree() const { return box_tree_.get(); }
+
+  // Returns number of visited boxes.
+  int Layout();
+
+ private:
+  const std::unique_ptr<SimpleBoxTree> box_tree_;
+
+  DISALLOW_COPY_AND_ASSIGN(LayouterTest);
+};
+
+LayouterTest::LayouterTest() : box_tree_(new SimpleBoxTree()) {
+  box_tree_->Begin<FlowBox>()
+      .SetStyle(*css::StyleBuilder().SetDisplay(css::Display::Block()).Build())
+      .Begin<FlowBox>()
+      .SetStyle(*css::StyleBuilder()
+                     .SetDisplay(css::Display::Block())
+                     .SetWidth(100)
+                     .SetHeight(50)
+                     .Build())
+      .Add<FlowBox>()
+      .Add<FlowBox>()
+      .End<FlowBox>()
+      .Add<FlowBox>()
+      .End<FlowBox>();
+  BoxEditor().SetStyle(first(), *BlockStyle(10));
+  BoxEditor().SetStyle(second(), *BlockStyle(10));
+  BoxEditor().SetStyle(last(), *BlockStyle(20));
+  box_tree_->Finish();
+}
+
+int LayouterTest::Layout() {
+  Layouter layouter;
+  layouter.Layout(root());
+  return layouter.num_visited_boxes();
+}
+
+TEST_F(LayouterTest, Basic) {
+  EXPECT_EQ(6, Layout());
+  EXPECT_EQ(MakeRect(0, 0, 800, 50), boundary()->bounds());
+  EXPECT_EQ(MakeRect(0, 0, 800, 10), first()->bounds());
+  EXPECT_EQ(MakeRect(0, 10, 800, 10), second()->bounds());
+  EXPECT_EQ(MakeRect(0, 50, 800, 20), last()->bounds());
+  EXPECT_FALSE(root()->needs_layout());
+  EXPECT_FALSE(main()->child_needs_layout());
+}
+
+TEST_F(LayouterTest, LayoutBoundary) {
+  Layout();
+
+  box_tree()->StartOver();
+  BoxEditor().SetStyle(first(), *BlockStyle(30));
+  box_tree()->Finish();
+  EXPECT_TRUE(first()->needs_layout());
+  EXPECT_TRUE(boundary()->needs_layout());
+  EXPECT_FALSE(main()->needs_layout());
+  EXPECT_TRUE(main()->child_needs_layout());
+
+  EXPECT_EQ(4, Layout()) << "root, main, boundary and first";
+  EXPECT_EQ(MakeRect(0, 0, 800, 30), first()->bounds());
+  EXPECT_EQ(MakeRect(0, 30, 800, 10), second()->bounds());
+  EXPECT_EQ(MakeRect(0, 50, 800, 20), last()->bounds());
+  EXPECT_FALSE(boundary()->needs_layout());
+  EXPECT_FALSE(main()->child_needs_layout());
+}
+
+TEST_F(LayouterTest, NeedsLayout) {
+  Layout();
+
+  box_tree()->StartOver();
+  BoxEditor().SetStyle(last(), *BlockStyle(40));
+  box_tree()->Finish();
+  EXPECT_TRUE(last()->needs_layout());
+  EXPECT_TRUE(main()->needs_layout());
+  EXPECT_FALSE(boundary()->needs_layout());
+
+  EXPECT_EQ(3, Layout()) << "root, main and last";
+  EXPECT_EQ(MakeRect(0, 0, 800, 50), boundary()->bounds());
+  EXPECT_EQ(MakeRect(0, 50, 800, 40), last()->bounds());
+}
+
+}  // namespace visuals
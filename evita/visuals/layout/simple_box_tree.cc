@@ -78,4 +78,14 @@ SimpleBoxTree& SimpleBoxTree::SetStyle(const css::Style& style) {
   return *this;
 }
 
+SimpleBoxTree& SimpleBoxTree::StartOver() {
+  DCHECK(boxes_.empty());
+  boxes_.push(root_box_.get());
+  lifecycle_->StartOver();
+  ViewLifecycle::Scope(lifecycle_.get(), ViewLifecycle::State::InStyleRecalc);
+  lifecycle_scope_.reset(new ViewLifecycle::Scope(
+      lifecycle_.get(), ViewLifecycle::State::InTreeRebuild));
+  return *this;
+}
+
 }  // namespace visuals
@@ -61,6 +61,10 @@ class SimpleBoxTree final {
 
   void Finish();
 
+  // Starts tree rebuild again for changing boxes after layout. Callers
+  // should call |Finish()| after changing boxes.
+  SimpleBoxTree& StartOver();
+
   // Box
   SimpleBoxTree& SetStyle(const css::Style& style);
 
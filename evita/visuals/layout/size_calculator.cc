@@ -186,9 +186,13 @@ void IntrinsicSizeVisitor::VisitFlowBox(FlowBox* flow_box) {
   const auto first_child = flow_box->first_child();
   if (!first_child)
     return ReturnSize(gfx::FloatSize());
-  if (IsDisplayOutsideInline(first_child->display()))
-    return ReturnSize(SizeOfHorizontalFlowBox(*flow_box));
-  return ReturnSize(SizeOfVerticalFlowBox(*flow_box));
+  if (flow_box->has_intrinsic_size())
+    return ReturnSize(flow_box->intrinsic_size());
+  const auto& size = IsDisplayOutsideInline(first_child->display())
+                         ? SizeOfHorizontalFlowBox(*flow_box)
+                         : SizeOfVerticalFlowBox(*flow_box);
+  BoxEditor().SetIntrinsicSize(flow_box, size);
+  ReturnSize(size);
 }
 
 void IntrinsicSizeVisitor::VisitImageBox(ImageBox* box) {
@@ -40,6 +40,8 @@ const TextLayout& TextBox::text_layout() const {
 
 void TextBox::DidChangeBounds(const gfx::FloatRect& old_bounds) {
   DCHECK(root_box()->InLayout()) << root_box()->lifecycle();
+  if (old_bounds.size() == bounds().size())
+    return;
   text_layout_.reset();
 }
 
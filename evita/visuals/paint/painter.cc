@@ -4,12 +4,16 @@
 
 #include <algorithm>
 #include <stack>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "evita/visuals/paint/painter.h"
 
 #include "base/logging.h"
 #include "base/trace_event/trace_event.h"
 #include "evita/gfx/base/geometry/affine_transformer.h"
+#include "evita/gfx/base/geometry/float_matrix3x2.h"
 #include "evita/gfx/base/geometry/float_rect.h"
 #include "evita/visuals/display/display_item_list_builder.h"
 #include "evita/visuals/display/public/display_item_list.h"
@@ -18,9 +22,11 @@
 #include "evita/visuals/fonts/text_format_factory.h"
 #include "evita/visuals/fonts/text_layout.h"
 #include "evita/visuals/layout/box_editor.h"
+#include "evita/visuals/layout/box_index.h"
 #include "evita/visuals/layout/box_selection.h"
 #include "evita/visuals/layout/box_traversal.h"
 #include "evita/visuals/layout/box_visitor.h"
+#include "evita/visuals/layout/descendants_or_self.h"
 #include "evita/visuals/layout/flow_box.h"
 #include "evita/visuals/layout/image_box.h"
 #include "evita/visuals/layout/root_box.h"
@@ -32,6 +38,59 @@
 
 namespace visuals {
 
+//////////////////////////////////////////////////////////////////////
+//
+// PaintCache
+// Holds chunks of the last frame and range of chunks painted for each box
+// and its descendants.
+//
+class PaintCache final {
+ public:
+  struct Entry {
+    // Transform of the parent content box when the box is painted.
+    gfx::FloatMatrix3x2 matrix;
+    size_t begin;
+    size_t end;
+  };
+
+  // Maps sequence id of box to |Entry|.
+  using EntryMap = std::unordered_map<int, Entry>;
+
+  PaintCache() = default;
+  ~PaintCache() = default;
+
+  const std::vector<scoped_refptr<DisplayItemChunk>>& chunks() const {
+    return chunks_;
+  }
+
+  const gfx::FloatRect& cull_rect() const { return cull_rect_; }
+
+  const Entry* Find(const Box& box) const;
+  void Update(const gfx::FloatRect& cull_rect,
+              const DisplayItemList& list,
+              EntryMap&& entries);
+
+ private:
+  std::vector<scoped_refptr<DisplayItemChunk>> chunks_;
+  gfx::FloatRect cull_rect_;
+  EntryMap entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(PaintCache);
+};
+
+const PaintCache::Entry* PaintCache::Find(const Box& box) const {
+  const auto& it = entries_.find(box.sequence_id());
+  return it == entries_.end() ? nullptr : &it->second;
+}
+
+void PaintCache::Update(const gfx::FloatRect& cull_rect,
+                        const DisplayItemList& list,
+                        EntryMap&& entries) {
+  chunks_ = list.chunks();
+  cull_rect_ = cull_rect;
+  entries_ = std::move(entries);
+}
+
 namespace {
 
 bool IsBackgroundChanged(const Box& box) {
@@ -45,17 +104,32 @@ bool IsBorderChanged(const Box& box) {
   return box.IsBorderChanged() || box.IsOriginChanged() || box.IsSizeChanged();
 }
 
+// Returns true if |box| or its descendants are changed since last paint.
+// Note: |BoxEditor| propagates |ShouldPaint()| and |is_child_changed()| to
+// ancestors.
+bool IsChangedSinceLastPaint(const Box& box) {
+  if (box.is_changed() || box.ShouldPaint() || IsBackgroundChanged(box) ||
+      IsBorderChanged(box) || box.IsContentChanged()) {
+    return true;
+  }
+  const auto container = box.as<ContainerBox>();
+  return container && container->is_child_changed();
+}
+
 //////////////////////////////////////////////////////////////////////
 //
 // PaintVisitor
 //
 class PaintVisitor final : public BoxVisitor {
  public:
-  explicit PaintVisitor(const PaintInfo& paint_info);
+  PaintVisitor(const PaintInfo& paint_info, const PaintCache& cache);
   ~PaintVisitor() final;
 
+  size_t num_reused_chunks() const { return num_reused_chunks_; }
+
   // The entry point of |PaintVisitor|.
   std::unique_ptr<DisplayItemList> Paint(const RootBox& root_box);
+  PaintCache::EntryMap TakeEntries() { return std::move(entries_); }
 
  private:
   class BoxPaintScope final {
@@ -70,11 +144,22 @@ class PaintVisitor final : public BoxVisitor {
     DISALLOW_COPY_AND_ASSIGN(BoxPaintScope);
   };
 
+  // Chunk of box being painted.
+  struct Chunk {
+    int id;
+    int index;
+    gfx::FloatRect bounds;
+    gfx::FloatMatrix3x2 matrix;
+    size_t begin;
+  };
+
 #define V(name) void Visit##name(name* box) final;
   FOR_EACH_VISUAL_BOX(V)
 #undef V
 
   void AddDirtyBounds(const gfx::FloatRect& bounds);
+  void BeginChunk(const Box& box);
+  void EndChunk();
   void FillRect(const gfx::FloatRect& rect, const gfx::FloatColor& color);
   void FillRectAndMark(const gfx::FloatRect& rect,
                        const gfx::FloatColor& color,
@@ -83,12 +168,18 @@ class PaintVisitor final : public BoxVisitor {
   bool NeedsPaintContentBox(const ContentBox& box) const;
   void PaintBackgroundINeeded(const Box& box);
   void PaintBorderINeeded(const Box& box);
+  void PaintChild(Box* child);
   void PaintContainerBox(const ContainerBox& box);
   void PaintSelectionIfNeeded(const Box& box);
   void PopTransform();
   void PushTransform();
+  bool ReuseChunksIfPossible(const Box& box);
 
   DisplayItemListBuilder builder_;
+  const PaintCache& cache_;
+  std::stack<Chunk> chunks_;
+  PaintCache::EntryMap entries_;
+  size_t num_reused_chunks_ = 0;
   const PaintInfo& paint_info_;
   gfx::AffineTransformer transformer_;
   std::stack<gfx::FloatMatrix3x2> transforms_;
@@ -96,20 +187,44 @@ class PaintVisitor final : public BoxVisitor {
   DISALLOW_COPY_AND_ASSIGN(PaintVisitor);
 };
 
-PaintVisitor::PaintVisitor(const PaintInfo& paint_info)
-    : builder_(paint_info.cull_rect()), paint_info_(paint_info) {
+PaintVisitor::PaintVisitor(const PaintInfo& paint_info,
+                           const PaintCache& cache)
+    : builder_(paint_info.cull_rect()), cache_(cache), paint_info_(paint_info) {
   transforms_.push(transformer_.matrix());
 }
 
 PaintVisitor::~PaintVisitor() {
   transforms_.pop();
   DCHECK(transforms_.empty());
+  DCHECK(chunks_.empty());
 }
 
 void PaintVisitor::AddDirtyBounds(const gfx::FloatRect& bounds) {
   builder_.AddRect(transformer_.MapRect(bounds));
 }
 
+// Called before translating to |box|.
+void PaintVisitor::BeginChunk(const Box& box) {
+  Chunk chunk = {box.sequence_id(), 0, transformer_.MapRect(box.bounds()),
+                 transformer_.matrix(), 0};
+  builder_.BeginChunk(chunk.id, chunk.index, chunk.bounds);
+  chunk.begin = builder_.num_chunks();
+  chunks_.push(chunk);
+}
+
+// Items of parent box after this box go into next chunk of parent box.
+void PaintVisitor::EndChunk() {
+  builder_.EndChunk();
+  const auto& chunk = chunks_.top();
+  entries_[chunk.id] = {chunk.matrix, chunk.begin, builder_.num_chunks()};
+  chunks_.pop();
+  if (chunks_.empty())
+    return;
+  auto& parent = chunks_.top();
+  ++parent.index;
+  builder_.BeginChunk(parent.id, parent.index, parent.bounds);
+}
+
 void PaintVisitor::FillRect(const gfx::FloatRect& rect,
                             const gfx::FloatColor& color) {
   DCHECK(!rect.IsEmpty());
@@ -155,9 +270,10 @@ bool PaintVisitor::NeedsPaintContentBox(const ContentBox& box) const {
 }
 
 // The entry point of |PaintVisitor|.
+// Note: We don't mark whole root box as dirty, since display item list
+// processor computes damaged regions from dirty rectangles and difference of
+// chunks.
 std::unique_ptr<DisplayItemList> PaintVisitor::Paint(const RootBox& root_box) {
-  // TODO(eval1749): Should we need to pass dirty rect list?
-  AddDirtyBounds(root_box.bounds());
   Visit(root_box);
   if (!paint_info_.debug_text().empty()) {
     const auto& font =
@@ -168,9 +284,11 @@ std::unique_ptr<DisplayItemList> PaintVisitor::Paint(const RootBox& root_box) {
                        gfx::FloatSize(200, 50));
     const auto& text_layout = TextLayout(text_format, paint_info_.debug_text(),
                                          debug_text_bounds.size());
+    builder_.BeginChunk(0, 0, debug_text_bounds);
     builder_.AddNew<DrawTextDisplayItem>(debug_text_bounds,
                                          gfx::FloatColor(1, 0, 0), 20,
                                          text_layout, paint_info_.debug_text());
+    builder_.EndChunk();
   }
   return builder_.Build();
 }
@@ -241,12 +359,29 @@ void PaintVisitor::PaintBorderINeeded(const Box& box) {
   }
 }
 
+void PaintVisitor::PaintChild(Box* child) {
+  if (ReuseChunksIfPossible(*child))
+    return;
+  Visit(child);
+}
+
 void PaintVisitor::PaintContainerBox(const ContainerBox& box) {
   if (!NeedsPaintContainerBox(box))
     return;
   BoxPaintScope paint_scope(this, box);
+  if (const auto index = box.child_index()) {
+    // Since each box clips its contents, we don't need to visit child boxes
+    // outside cull rect.
+    const auto& cull_rect =
+        transformer_.Inverse().MapRect(paint_info_.cull_rect());
+    for (const auto& child : index->FindByRect(cull_rect)) {
+      PaintChild(child);
+      PaintSelectionIfNeeded(*child);
+    }
+    return;
+  }
   for (const auto& child : box.child_boxes()) {
-    Visit(child);
+    PaintChild(child);
     PaintSelectionIfNeeded(*child);
   }
 }
@@ -300,6 +435,38 @@ void PaintVisitor::PushTransform() {
   transforms_.push(transform);
 }
 
+// Reuses chunks of |box| in the last frame if neither |box| nor its
+// descendants are changed and |box| is painted with same transform.
+bool PaintVisitor::ReuseChunksIfPossible(const Box& box) {
+  if (cache_.cull_rect() != paint_info_.cull_rect())
+    return false;
+  if (IsChangedSinceLastPaint(box))
+    return false;
+  const auto entry = cache_.Find(box);
+  if (!entry || entry->matrix != transformer_.matrix())
+    return false;
+  builder_.EndChunk();
+  const auto begin = builder_.num_chunks();
+  for (auto index = entry->begin; index < entry->end; ++index)
+    builder_.AddChunk(cache_.chunks()[index]);
+  num_reused_chunks_ += entry->end - entry->begin;
+  // Keep entries of descendants for reusing them when |box| is changed but
+  // some of its descendants aren't changed in later frame.
+  const auto offset = begin - entry->begin;
+  for (const auto& runner : Box::DescendantsOrSelf(box)) {
+    const auto runner_entry = cache_.Find(*runner);
+    if (!runner_entry)
+      continue;
+    entries_[runner->sequence_id()] = {runner_entry->matrix,
+                                       runner_entry->begin + offset,
+                                       runner_entry->end + offset};
+  }
+  auto& parent = chunks_.top();
+  ++parent.index;
+  builder_.BeginChunk(parent.id, parent.index, parent.bounds);
+  return true;
+}
+
 // BoxVisitor
 void PaintVisitor::VisitFlowBox(FlowBox* box) {
   PaintContainerBox(*box);
@@ -325,7 +492,7 @@ void PaintVisitor::VisitRootBox(RootBox* root) {
   // TODO(eval1749): We should not paint background if document element, which
   // size is viewport, has background.
   BoxPaintScope paint_scope(this, *root);
-  Visit(root->first_child());
+  PaintChild(root->first_child());
   BoxEditor().DidPaint(root);
 }
 
@@ -363,6 +530,7 @@ void PaintVisitor::VisitTextBox(TextBox* text) {
 PaintVisitor::BoxPaintScope::BoxPaintScope(PaintVisitor* painter,
                                            const Box& box)
     : box_(box), painter_(painter) {
+  painter_->BeginChunk(box);
   painter_->transformer_.Translate(box.bounds().origin());
   painter_->PushTransform();
   painter_->PaintBackgroundINeeded(box);
@@ -379,6 +547,7 @@ PaintVisitor::BoxPaintScope::~BoxPaintScope() {
   painter_->builder_.AddNew<EndClipDisplayItem>();
   painter_->PopTransform();
   painter_->PopTransform();
+  painter_->EndChunk();
 }
 
 }  // namespace
@@ -387,7 +556,7 @@ PaintVisitor::BoxPaintScope::~BoxPaintScope() {
 //
 // Painter
 //
-Painter::Painter() {}
+Painter::Painter() : cache_(new PaintCache()) {}
 Painter::~Painter() {}
 
 std::unique_ptr<DisplayItemList> Painter::Paint(const PaintInfo& paint_info,
@@ -395,7 +564,14 @@ std::unique_ptr<DisplayItemList> Painter::Paint(const PaintInfo& paint_info,
   TRACE_EVENT0("visuals", "Painter::Paint");
   ViewLifecycle::Scope scope(root_box.lifecycle(),
                              ViewLifecycle::State::InPaint);
-  return PaintVisitor(paint_info).Paint(root_box);
+  PaintVisitor painter(paint_info, *cache_);
+  auto list = painter.Paint(root_box);
+  num_reused_chunks_ = painter.num_reused_chunks();
+  num_painted_chunks_ = list->chunks().size() - num_reused_chunks_;
+  cache_->Update(paint_info.cull_rect(), *list, painter.TakeEntries());
+  TRACE_COUNTER_ID2("visuals", "PaintedChunks", this, "painted",
+                    num_painted_chunks_, "reused", num_reused_chunks_);
+  return std::move(list);
 }
 
 }  // namespace visuals
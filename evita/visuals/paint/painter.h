@@ -12,22 +12,33 @@
 namespace visuals {
 
 class DisplayItemList;
+class PaintCache;
 class PaintInfo;
 class RootBox;
 
 //////////////////////////////////////////////////////////////////////
 //
 // Painter
+// |Painter| retains display item chunks of the last frame, and reuses
+// chunks of a box when neither the box nor its descendants are changed.
 //
 class Painter final {
  public:
   Painter();
   ~Painter();
 
+  // Statistics of the last |Paint()|.
+  size_t num_painted_chunks() const { return num_painted_chunks_; }
+  size_t num_reused_chunks() const { return num_reused_chunks_; }
+
   std::unique_ptr<DisplayItemList> Paint(const PaintInfo& paint_info,
                                          const RootBox& root_box);
 
  private:
+  const std::unique_ptr<PaintCache> cache_;
+  size_t num_painted_chunks_ = 0;
+  size_t num_reused_chunks_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(Painter);
 };
 
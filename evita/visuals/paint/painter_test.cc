@@ -2,7 +2,10 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <memory>
+
 #include "evita/visuals/paint/painter.h"
+
 #include "evita/css/style.h"
 #include "evita/css/style_builder.h"
 #include "evita/gfx/base/colors/float_color.h"
@@ -20,6 +23,18 @@
 
 namespace visuals {
 
+namespace {
+
+std::unique_ptr<css::Style> BlockStyle(float red) {
+  return css::StyleBuilder()
+      .SetBackgroundColor(css::ColorValue(red, 0, 0))
+      .SetDisplay(css::Display::Block())
+      .SetHeight(10)
+      .Build();
+}
+
+}  // namespace
+
 TEST(PainterTest, Basic) {
   SimpleBoxTree box_tree;
   box_tree.Begin<FlowBox>()
@@ -35,4 +50,38 @@ TEST(PainterTest, Basic) {
   EXPECT_EQ(5, display_item_list->items().size());
 }
 
+TEST(PainterTest, ReuseChunks) {
+  SimpleBoxTree box_tree;
+  box_tree.Begin<FlowBox>()
+      .Begin<FlowBox>()
+      .SetStyle(*BlockStyle(1))
+      .End<FlowBox>()
+      .Begin<FlowBox>()
+      .SetStyle(*BlockStyle(1))
+      .End<FlowBox>()
+      .End<FlowBox>()
+      .Finish();
+  const auto root = box_tree.root_box();
+  const auto main = root->first_child()->as<FlowBox>();
+  Layouter().Layout(root);
+  PaintInfo paint_info(gfx::FloatRect(root->viewport_size()));
+  Painter painter;
+  const auto& list1 = painter.Paint(paint_info, *root);
+  EXPECT_EQ(0, painter.num_reused_chunks());
+
+  box_tree.StartOver();
+  BoxEditor().SetStyle(main->last_child(), *BlockStyle(0.5f));
+  box_tree.Finish();
+  Layouter().Layout(root);
+  const auto& list2 = painter.Paint(paint_info, *root);
+  EXPECT_EQ(1, painter.num_reused_chunks()) << "The first child is reused.";
+  EXPECT_EQ(list1->chunks().size(), list2->chunks().size());
+  auto num_shared_chunks = 0;
+  for (size_t index = 0; index < list1->chunks().size(); ++index) {
+    if (list1->chunks()[index] == list2->chunks()[index])
+      ++num_shared_chunks;
+  }
+  EXPECT_EQ(1, num_shared_chunks);
+}
+
 }  // namespace visuals
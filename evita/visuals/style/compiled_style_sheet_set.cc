@@ -8,7 +8,6 @@
 #include "base/trace_event/trace_event.h"
 #include "evita/base/strings/atomic_string.h"
 #include "evita/css/rule.h"
-#include "evita/css/selector_builder.h"
 #include "evita/css/style.h"
 #include "evita/css/style_editor.h"
 #include "evita/css/style_sheet.h"
@@ -16,18 +15,39 @@
 
 namespace visuals {
 
+namespace {
+
+// Returns a bloom filter of classes in |selector|. A rule can't match an
+// element if filter of rule has a bit which filter of element doesn't have.
+uint64_t ComputeClassFilter(const css::Selector& selector) {
+  uint64_t filter = 0;
+  for (const auto& class_name : selector.classes()) {
+    // Low bits of hash value are always zero, since atomic strings are
+    // pointers.
+    filter |= uint64_t{1} << ((class_name.hash_value() >> 4) % 64);
+  }
+  return filter;
+}
+
+}  // namespace
+
 //////////////////////////////////////////////////////////////////////
 //
 // CompiledStyleSheetSet::Entry
 //
 CompiledStyleSheetSet::Entry::Entry(size_t passedPosition,
+                                    uint64_t passedClassFilter,
                                     std::unique_ptr<css::Style> passedStyle)
-    : position(passedPosition), style(std::move(passedStyle)) {}
+    : class_filter(passedClassFilter),
+      position(passedPosition),
+      style(std::move(passedStyle)) {}
 
 CompiledStyleSheetSet::Entry::Entry(Entry&& other)
-    : position(other.position), style(std::move(other.style)) {}
+    : class_filter(other.class_filter),
+      position(other.position),
+      style(std::move(other.style)) {}
 
-CompiledStyleSheetSet::Entry::Entry() : position(0) {}
+CompiledStyleSheetSet::Entry::Entry() : class_filter(0), position(0) {}
 CompiledStyleSheetSet::Entry::~Entry() = default;
 
 //////////////////////////////////////////////////////////////////////
@@ -76,9 +96,16 @@ void CompiledStyleSheetSet::AddObserver(
   observers_.AddObserver(observer);
 }
 
-void CompiledStyleSheetSet::ClearCache() {
-  cached_matches_.clear();
+void CompiledStyleSheetSet::CompileIfNeeded() const {
+  const_cast<CompiledStyleSheetSet*>(this)->CompileStyleSheetsIfNeeded();
+}
+
+void CompiledStyleSheetSet::ClearRules() {
+  class_rules_.clear();
+  id_rules_.clear();
   rules_.clear();
+  tag_rules_.clear();
+  universal_rules_.clear();
 }
 
 void CompiledStyleSheetSet::CompileStyleSheetsIfNeeded() {
@@ -88,6 +115,8 @@ void CompiledStyleSheetSet::CompileStyleSheetsIfNeeded() {
     for (const auto& rule : style_sheet->rules())
       CompileRule(*rule);
   }
+  for (auto it = rules_.cbegin(); it != rules_.cend(); ++it)
+    IndexRule(it);
   if (DLOG_IS_ON(INFO) && VLOG_IS_ON(1)) {
     DVLOG(1) << "Compiled Rules";
     for (const auto& entry : rules_)
@@ -103,114 +132,95 @@ void CompiledStyleSheetSet::CompileRule(const css::Rule& rule) {
   }
   rules_.emplace(
       rule.selector(),
-      std::move(Entry(rules_.size(),
+      std::move(Entry(rules_.size(), ComputeClassFilter(rule.selector()),
                       std::move(std::make_unique<css::Style>(rule.style())))));
 }
 
-// Returns true if this function adds class to |builder|.
-static bool AddClass(css::Selector::Builder* builder,
-                     const css::Selector& selector,
-                     size_t start) {
-  const auto& classes = selector.classes();
-  DCHECK_LE(start, classes.size());
-  if (start == classes.size())
-    return false;
-  size_t index = 0;
-  for (const auto& class_name : classes) {
-    if (index >= start)
-      builder->AddClass(class_name);
-    ++index;
+// Puts |rule| into only one bucket of the most selective part of selector,
+// since an element having id has only one id but may have many classes.
+void CompiledStyleSheetSet::IndexRule(Rule rule) {
+  const auto& selector = rule->first;
+  if (selector.has_id()) {
+    id_rules_[selector.id()].push_back(rule);
+    return;
+  }
+  if (selector.has_classes()) {
+    class_rules_[*selector.classes().begin()].push_back(rule);
+    return;
+  }
+  if (!selector.is_universal()) {
+    tag_rules_[selector.tag_name()].push_back(rule);
+    return;
+  }
+  universal_rules_.push_back(rule);
+}
+
+// Removes cached matches of elements which |selector| can match. Other
+// cached matches are still valid since order of other rules isn't changed.
+void CompiledStyleSheetSet::InvalidateCache(const css::Selector& selector) {
+  // Positions of rules are changed by inserting or removing a rule.
+  ClearRules();
+  base::AutoLock lock_scope(cache_lock_);
+  auto runner = cached_matches_.begin();
+  while (runner != cached_matches_.end()) {
+    if (runner->first.IsSubsetOf(selector))
+      runner = cached_matches_.erase(runner);
+    else
+      ++runner;
   }
-  return true;
 }
 
 CompiledStyleSheetSet::MatchSet CompiledStyleSheetSet::Match(
     const css::Selector& selector) const {
   DVLOG(1) << "Match: " << selector;
+  const auto class_filter = ComputeClassFilter(selector);
   MatchSet matched;
-  MatchOne(&matched, css::Selector(), selector);
-  for (size_t index = 0; index <= selector.classes().size(); ++index) {
-    if (!selector.is_universal() && selector.has_id()) {
-      css::Selector::Builder builder;
-      builder.SetTagName(selector.tag_name()).SetId(selector.id());
-      if (index == 0)
-        MatchOne(&matched, builder.Build(), selector);
-      if (AddClass(&builder, selector, index))
-        MatchOne(&matched, builder.Build(), selector);
-    }
-
-    if (!selector.is_universal()) {
-      css::Selector::Builder builder;
-      builder.SetTagName(selector.tag_name());
-      if (index == 0)
-        MatchOne(&matched, builder.Build(), selector);
-      if (AddClass(&builder, selector, index))
-        MatchOne(&matched, builder.Build(), selector);
-    }
-
-    if (selector.has_id()) {
-      css::Selector::Builder builder;
-      builder.SetId(selector.id());
-      if (index == 0)
-        MatchOne(&matched, builder.Build(), selector);
-      if (AddClass(&builder, selector, index))
-        MatchOne(&matched, builder.Build(), selector);
-    }
-
-    css::Selector::Builder builder;
-    if (!AddClass(&builder, selector, index))
-      continue;
-    MatchOne(&matched, builder.Build(), selector);
+  MatchRules(&matched, universal_rules_, selector, class_filter);
+  if (selector.has_id()) {
+    const auto& it = id_rules_.find(selector.id());
+    if (it != id_rules_.end())
+      MatchRules(&matched, it->second, selector, class_filter);
+  }
+  for (const auto& class_name : selector.classes()) {
+    const auto& it = class_rules_.find(class_name);
+    if (it != class_rules_.end())
+      MatchRules(&matched, it->second, selector, class_filter);
+  }
+  if (!selector.is_universal()) {
+    const auto& it = tag_rules_.find(selector.tag_name());
+    if (it != tag_rules_.end())
+      MatchRules(&matched, it->second, selector, class_filter);
   }
   return std::move(matched);
 }
 
-static bool StartsWith(const css::Selector& selector1,
-                       const css::Selector& selector2) {
-  if (selector1.tag_name() != selector2.tag_name())
-    return false;
-  if (selector1.id() != selector2.id())
-    return false;
-  if (selector1.classes().empty() || selector2.classes().empty())
-    return selector1.classes().empty() == selector2.classes().empty();
-  if (selector1.classes().size() > selector2.classes().size())
-    return false;
-  return *selector1.classes().begin() == *selector2.classes().begin();
-}
-
-void CompiledStyleSheetSet::MatchOne(MatchSet* match_set,
-                                     const css::Selector& needle,
-                                     const css::Selector& selector) const {
-  DVLOG(1) << "  MatchOne: needle=" << needle;
-  auto runner = rules_.lower_bound(needle);
-  while (runner != rules_.end()) {
-    if (!StartsWith(runner->first, needle)) {
-      DVLOG(1) << "    exit " << runner->first << " doesn't start with "
-               << needle;
-      return;
+void CompiledStyleSheetSet::MatchRules(MatchSet* match_set,
+                                       const RuleList& rules,
+                                       const css::Selector& selector,
+                                       uint64_t class_filter) const {
+  for (const auto& rule : rules) {
+    if (rule->second.class_filter & ~class_filter) {
+      DVLOG(1) << "    filter " << rule->first;
+      continue;
     }
-    if (selector.IsSubsetOf(runner->first)) {
-      DVLOG(1) << "    " << runner->first;
-      const auto& result = match_set->emplace(runner);
-      if (!result.second) {
-        DVLOG(1) << "  Matched Rules:";
-        for (const auto& rule : *match_set)
-          DVLOG(1) << "    " << rule->first;
-        NOTREACHED();
-      }
-    } else {
-      DVLOG(1) << "    skip " << runner->first;
+    if (!selector.IsSubsetOf(rule->first)) {
+      DVLOG(1) << "    skip " << rule->first;
+      continue;
     }
-    ++runner;
+    DVLOG(1) << "    " << rule->first;
+    const auto& result = match_set->emplace(rule);
+    DCHECK(result.second) << "Rule " << rule->first
+                          << " should be in one bucket.";
   }
 }
 
 void CompiledStyleSheetSet::Merge(css::Style* passed_style,
                                   const css::Selector& selector) const {
   DCHECK(!selector.is_universal()) << selector;
-  const_cast<CompiledStyleSheetSet*>(this)->CompileStyleSheetsIfNeeded();
+  CompileIfNeeded();
 
   {
+    base::AutoLock lock_scope(cache_lock_);
     const auto& present = cached_matches_.find(selector);
     if (present != cached_matches_.end()) {
       css::StyleEditor().Merge(passed_style, *present->second);
@@ -221,15 +231,17 @@ void CompiledStyleSheetSet::Merge(css::Style* passed_style,
   TRACE_EVENT0("visuals", "CompileStyleSheetSet::Merge");
   DVLOG(1) << "CompiledStyleSheetSet::Merge: " << selector;
 
+  // Matching runs without |cache_lock_|, since rules aren't changed during
+  // style recalc.
   const auto& matched = Match(selector);
   auto style = std::make_unique<css::Style>();
   for (const auto& rule : matched)
     css::StyleEditor().Merge(style.get(), *rule->second.style);
 
   css::StyleEditor().Merge(passed_style, *style);
-  const auto& result = cached_matches_.emplace(selector, std::move(style));
-  DCHECK(result.second) << "Cached matches should not have entry of "
-                        << selector;
+  base::AutoLock lock_scope(cache_lock_);
+  // Other thread may cache matches of |selector| while we are matching.
+  cached_matches_.emplace(selector, std::move(style));
 }
 
 void CompiledStyleSheetSet::RemoveObserver(
@@ -240,14 +252,14 @@ void CompiledStyleSheetSet::RemoveObserver(
 // css::StyleSheetObserver
 void CompiledStyleSheetSet::DidInsertRule(const css::Rule& new_rule,
                                           size_t index) {
-  ClearCache();
+  InvalidateCache(new_rule.selector());
   for (auto& observer : observers_)
     observer.DidInsertRule(new_rule, index);
 }
 
 void CompiledStyleSheetSet::DidRemoveRule(const css::Rule& old_rule,
                                           size_t index) {
-  ClearCache();
+  InvalidateCache(old_rule.selector());
   for (auto& observer : observers_)
     observer.DidRemoveRule(old_rule, index);
 }
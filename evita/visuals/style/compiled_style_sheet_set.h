@@ -5,13 +5,17 @@
 #ifndef EVITA_VISUALS_STYLE_COMPILED_STYLE_SHEET_SET_H_
 #define EVITA_VISUALS_STYLE_COMPILED_STYLE_SHEET_SET_H_
 
+#include <stdint.h>
+
 #include <map>
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "base/macros.h"
 #include "base/observer_list.h"
+#include "base/synchronization/lock.h"
 #include "evita/css/selector.h"
 #include "evita/css/style_sheet_observer.h"
 
@@ -27,6 +31,10 @@ class ElementNode;
 //////////////////////////////////////////////////////////////////////
 //
 // CompiledStyleSheetSet
+// Rules are indexed by id, class or tag name of selector for selecting
+// candidate rules of an element without visiting all rules. Matched styles
+// are cached by selector of element. |Merge()| is thread safe once rules
+// are compiled, for parallel style recalc.
 //
 class CompiledStyleSheetSet final : public css::StyleSheetObserver {
  public:
@@ -35,6 +43,9 @@ class CompiledStyleSheetSet final : public css::StyleSheetObserver {
   ~CompiledStyleSheetSet();
 
   void AddObserver(css::StyleSheetObserver* observer) const;
+  // Compiles style sheets if needed. This function must be called before
+  // calling |Merge()| on worker threads.
+  void CompileIfNeeded() const;
   void Merge(css::Style* style, const css::Selector& selector) const;
   void RemoveObserver(css::StyleSheetObserver* observer) const;
 
@@ -42,7 +53,9 @@ class CompiledStyleSheetSet final : public css::StyleSheetObserver {
   friend class CompiledStyleSheetSetTest;
 
   struct Entry {
-    Entry(size_t passedPosition, std::unique_ptr<css::Style> passedStyle);
+    Entry(size_t passedPosition,
+          uint64_t passedClassFilter,
+          std::unique_ptr<css::Style> passedStyle);
     Entry(const Entry& other) = delete;
     Entry(Entry&& other);
     Entry();
@@ -50,35 +63,54 @@ class CompiledStyleSheetSet final : public css::StyleSheetObserver {
 
     bool operator<(const Entry& other) const;
 
+    // A bloom filter of classes in selector of rule.
+    uint64_t class_filter;
     size_t position;
     std::unique_ptr<css::Style> style;
   };
 
-  using CacheMap = std::map<css::Selector, std::unique_ptr<css::Style>>;
+  using CacheMap =
+      std::unordered_map<css::Selector, std::unique_ptr<css::Style>>;
   using RuleMap = std::map<css::Selector, Entry>;
   using Rule = RuleMap::const_iterator;
+  using RuleList = std::vector<Rule>;
+  using RuleIndex = std::unordered_map<base::AtomicString, RuleList>;
 
   struct RuleLess {
     bool operator()(const Rule& rule1, const Rule& rule2) const;
   };
   using MatchSet = std::set<Rule, RuleLess>;
 
-  void ClearCache();
+  void ClearRules();
   void CompileStyleSheetsIfNeeded();
   void CompileRule(const css::Rule& rule);
+  void IndexRule(Rule rule);
+  void InvalidateCache(const css::Selector& selector);
   MatchSet Match(const css::Selector& selector) const;
-  void MatchOne(MatchSet* match_set,
-                const css::Selector& needle,
-                const css::Selector& selector) const;
+  void MatchRules(MatchSet* match_set,
+                  const RuleList& rules,
+                  const css::Selector& selector,
+                  uint64_t class_filter) const;
 
   // css::StyleSheetObserver
   void DidInsertRule(const css::Rule& new_rule, size_t index);
   void DidRemoveRule(const css::Rule& old_rule, size_t index);
 
+  // |cache_lock_| protects |cached_matches_|.
+  mutable base::Lock cache_lock_;
   mutable CacheMap cached_matches_;
+  // |class_rules_| contains rules having classes without id.
+  RuleIndex class_rules_;
+  // |id_rules_| contains rules having id.
+  RuleIndex id_rules_;
   mutable base::ObserverList<css::StyleSheetObserver> observers_;
   mutable RuleMap rules_;
   const std::vector<css::StyleSheet*> style_sheets_;
+  // |tag_rules_| contains rules having only tag name.
+  RuleIndex tag_rules_;
+  // |universal_rules_| contains rules having neither tag name, id nor
+  // classes, e.g. "*".
+  RuleList universal_rules_;
 
   DISALLOW_COPY_AND_ASSIGN(CompiledStyleSheetSet);
 };
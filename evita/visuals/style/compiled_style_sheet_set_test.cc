@@ -46,6 +46,8 @@ class CompiledStyleSheetSetTest : public ::testing::Test {
   CompiledStyleSheetSetTest() = default;
   ~CompiledStyleSheetSetTest() override = default;
 
+  bool IsCached(const CompiledStyleSheetSet& style_sheet,
+                base::StringPiece16 text) const;
   std::vector<css::Selector> Match(const CompiledStyleSheetSet& style_sheet,
                                    const css::Selector& selector) const;
 
@@ -53,6 +55,12 @@ class CompiledStyleSheetSetTest : public ::testing::Test {
   DISALLOW_COPY_AND_ASSIGN(CompiledStyleSheetSetTest);
 };
 
+bool CompiledStyleSheetSetTest::IsCached(
+    const CompiledStyleSheetSet& style_sheet,
+    base::StringPiece16 text) const {
+  return style_sheet.cached_matches_.count(ParseSelector(text)) != 0;
+}
+
 std::vector<css::Selector> CompiledStyleSheetSetTest::Match(
     const CompiledStyleSheetSet& style_sheet,
     const css::Selector& selector) const {
@@ -120,6 +128,55 @@ TEST_F(CompiledStyleSheetSetTest, Basic) {
   EXPECT_EQ(css::Height(css::Length(20)), tag_id_style->height());
 }
 
+TEST_F(CompiledStyleSheetSetTest, InvalidateCache) {
+  const auto style_sheet = new css::StyleSheet();
+  style_sheet->AppendRule(ParseSelector(L"tag"),
+                          css::StyleBuilder().SetColor(1, 0, 0).Build());
+  style_sheet->AppendRule(ParseSelector(L".c1"),
+                          css::StyleBuilder().SetColor(0, 1, 0).Build());
+  CompiledStyleSheetSet compiled({style_sheet});
+
+  const auto document = NodeTreeBuilder()
+                            .Begin(L"tag", L"c1")
+                            .ClassList({L"c1"})
+                            .End(L"tag")
+                            .Begin(L"tag", L"c2")
+                            .ClassList({L"c2"})
+                            .End(L"tag")
+                            .Begin(L"other", L"id")
+                            .End(L"other")
+                            .Build();
+  const auto tag_c1 = document->GetElementById(L"c1");
+  const auto tag_c2 = document->GetElementById(L"c2");
+  const auto other_id = document->GetElementById(L"id");
+
+  ComputeStyle(compiled, *tag_c1);
+  ComputeStyle(compiled, *tag_c2);
+  ComputeStyle(compiled, *other_id);
+  EXPECT_TRUE(IsCached(compiled, L"tag.c1"));
+  EXPECT_TRUE(IsCached(compiled, L"tag.c2"));
+  EXPECT_TRUE(IsCached(compiled, L"other#id"));
+
+  style_sheet->InsertRule(ParseSelector(L".c2"),
+                          css::StyleBuilder().SetColor(0, 0, 1).Build(), 0);
+  EXPECT_TRUE(IsCached(compiled, L"tag.c1"));
+  EXPECT_FALSE(IsCached(compiled, L"tag.c2"));
+  EXPECT_TRUE(IsCached(compiled, L"other#id"));
+  EXPECT_EQ(css::Color(css::ColorValue(0, 1, 0)),
+            ComputeStyle(compiled, *tag_c1)->color());
+  EXPECT_EQ(css::Color(css::ColorValue(0, 0, 1)),
+            ComputeStyle(compiled, *tag_c2)->color());
+
+  style_sheet->RemoveRule(1);
+  EXPECT_FALSE(IsCached(compiled, L"tag.c1"));
+  EXPECT_FALSE(IsCached(compiled, L"tag.c2"));
+  EXPECT_TRUE(IsCached(compiled, L"other#id"));
+  EXPECT_EQ(css::Color(css::ColorValue(0, 0, 1)),
+            ComputeStyle(compiled, *tag_c2)->color());
+  EXPECT_EQ(css::Color(css::ColorValue(0, 1, 0)),
+            ComputeStyle(compiled, *tag_c1)->color());
+}
+
 TEST_F(CompiledStyleSheetSetTest, Match) {
   const auto style_sheet = new css::StyleSheet();
   style_sheet->AppendRule(
@@ -156,6 +213,32 @@ TEST_F(CompiledStyleSheetSetTest, Match) {
             Match(compiled, ParseSelector(L".c1:hover")));
 }
 
+TEST_F(CompiledStyleSheetSetTest, MatchId) {
+  const auto style_sheet = new css::StyleSheet();
+  style_sheet->AppendRule(ParseSelector(L"*"),
+                          css::StyleBuilder().SetColor(1, 0, 0).Build());
+  style_sheet->AppendRule(ParseSelector(L"#id"),
+                          css::StyleBuilder().SetColor(0, 0, 1).Build());
+  style_sheet->AppendRule(ParseSelector(L"tag#id.c1"),
+                          css::StyleBuilder().SetColor(0, 1, 0).Build());
+  style_sheet->AppendRule(ParseSelector(L".c2.c3"),
+                          css::StyleBuilder().SetColor(1, 1, 0).Build());
+  CompiledStyleSheetSet compiled({style_sheet});
+
+  EXPECT_EQ((std::vector<css::Selector>{ParseSelector(L"#id"),
+                                        ParseSelector(L"*")}),
+            Match(compiled, ParseSelector(L"tag#id")));
+  EXPECT_EQ((std::vector<css::Selector>{ParseSelector(L"tag#id.c1"),
+                                        ParseSelector(L"#id"),
+                                        ParseSelector(L"*")}),
+            Match(compiled, ParseSelector(L"tag#id.c1.c2")));
+  EXPECT_EQ((std::vector<css::Selector>{ParseSelector(L".c2.c3"),
+                                        ParseSelector(L"*")}),
+            Match(compiled, ParseSelector(L"tag.c1.c2.c3")));
+  EXPECT_EQ(std::vector<css::Selector>{ParseSelector(L"*")},
+            Match(compiled, ParseSelector(L"tag#other.c2")));
+}
+
 TEST_F(CompiledStyleSheetSetTest, Hover) {
   const auto style_sheet = new css::StyleSheet();
   style_sheet->AppendRule(
@@ -0,0 +1,96 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/visuals/style/shared_style.h"
+
+#include <utility>
+
+#include "base/logging.h"
+#include "evita/css/style.h"
+
+namespace visuals {
+
+//////////////////////////////////////////////////////////////////////
+//
+// SharedStyle
+//
+SharedStyle::SharedStyle(StyleInterner* interner,
+                         std::unique_ptr<css::Style> style,
+                         size_t hash_code)
+    : hash_code_(hash_code),
+      interner_(interner),
+      ref_count_(0),
+      style_(std::move(style)) {}
+
+SharedStyle::~SharedStyle() {}
+
+void SharedStyle::AddRef() const {
+  ref_count_.fetch_add(1);
+}
+
+// |StyleInterner::Intern()| takes a new reference of |this| with
+// |StyleInterner::lock_| held, so we drop the last reference and remove
+// |this| from the interner with the lock held. Other references are dropped
+// without the lock.
+void SharedStyle::Release() const {
+  auto count = ref_count_.load();
+  while (count > 1) {
+    if (ref_count_.compare_exchange_weak(count, count - 1))
+      return;
+  }
+  if (interner_) {
+    base::AutoLock lock_scope(interner_->lock_);
+    if (ref_count_.fetch_sub(1) > 1)
+      return;
+    interner_->Remove(this);
+  } else if (ref_count_.fetch_sub(1) > 1) {
+    return;
+  }
+  delete this;
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// StyleInterner
+//
+StyleInterner::StyleInterner() {}
+
+StyleInterner::~StyleInterner() {
+  // Detach living shared styles, e.g. held by observers, from |this|.
+  for (const auto& pair : map_)
+    pair.second->interner_ = nullptr;
+}
+
+size_t StyleInterner::size() const {
+  base::AutoLock lock_scope(lock_);
+  return map_.size();
+}
+
+scoped_refptr<SharedStyle> StyleInterner::Intern(
+    std::unique_ptr<css::Style> style) {
+  const auto hash_code = style->hash_value();
+  base::AutoLock lock_scope(lock_);
+  const auto& range = map_.equal_range(hash_code);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second->style() == *style)
+      return base::WrapRefCounted(it->second);
+  }
+  const auto shared_style = new SharedStyle(this, std::move(style), hash_code);
+  map_.emplace(hash_code, shared_style);
+  return base::WrapRefCounted(shared_style);
+}
+
+void StyleInterner::Remove(const SharedStyle* shared_style) {
+  lock_.AssertAcquired();
+  const auto& range = map_.equal_range(shared_style->hash_code());
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second != shared_style)
+      continue;
+    map_.erase(it);
+    return;
+  }
+  NOTREACHED() << "StyleInterner doesn't have " << shared_style->style();
+}
+
+}  // namespace visuals
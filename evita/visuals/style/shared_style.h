@@ -0,0 +1,93 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_VISUALS_STYLE_SHARED_STYLE_H_
+#define EVITA_VISUALS_STYLE_SHARED_STYLE_H_
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+
+namespace css {
+class Style;
+}
+
+namespace visuals {
+
+class StyleInterner;
+
+//////////////////////////////////////////////////////////////////////
+//
+// SharedStyle
+// An immutable computed style shared by nodes which have equal computed
+// style. Since |StyleInterner| has only one |SharedStyle| for equal styles,
+// we can compare |SharedStyle| by pointer.
+//
+// Unlike |base::RefCountedThreadSafe|, the last reference is released with
+// |StyleInterner::lock_| held, so |StyleInterner::Intern()| on another
+// thread doesn't take a reference of |SharedStyle| being destroyed.
+//
+class SharedStyle final {
+ public:
+  size_t hash_code() const { return hash_code_; }
+  const css::Style& style() const { return *style_; }
+
+  void AddRef() const;
+  void Release() const;
+
+ private:
+  friend class StyleInterner;
+
+  SharedStyle(StyleInterner* interner,
+              std::unique_ptr<css::Style> style,
+              size_t hash_code);
+  ~SharedStyle();
+
+  const size_t hash_code_;
+  StyleInterner* interner_;
+  mutable std::atomic<int> ref_count_;
+  const std::unique_ptr<css::Style> style_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedStyle);
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// StyleInterner
+// Maps equal |css::Style| objects to one |SharedStyle|. |SharedStyle| is
+// removed from |StyleInterner| when the last reference is released.
+// |Intern()| can be called on style recalc worker threads.
+//
+class StyleInterner final {
+ public:
+  StyleInterner();
+  ~StyleInterner();
+
+  // Returns number of living |SharedStyle|.
+  size_t size() const;
+
+  scoped_refptr<SharedStyle> Intern(std::unique_ptr<css::Style> style);
+
+ private:
+  friend class SharedStyle;
+
+  // Removes |shared_style| from |map_|. |lock_| should be held.
+  void Remove(const SharedStyle* shared_style);
+
+  // |lock_| protects |map_| for interning styles on style recalc worker
+  // threads, and serializes releasing the last reference of |SharedStyle|
+  // with |Intern()|.
+  mutable base::Lock lock_;
+  std::unordered_multimap<size_t, SharedStyle*> map_;
+
+  DISALLOW_COPY_AND_ASSIGN(StyleInterner);
+};
+
+}  // namespace visuals
+
+#endif  // EVITA_VISUALS_STYLE_SHARED_STYLE_H_
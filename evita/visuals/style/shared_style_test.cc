@@ -0,0 +1,95 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "evita/visuals/style/shared_style.h"
+
+#include "base/macros.h"
+#include "base/threading/simple_thread.h"
+#include "evita/css/style.h"
+#include "evita/css/style_builder.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace visuals {
+
+namespace {
+
+//////////////////////////////////////////////////////////////////////
+//
+// InternAndRelease
+// Interns and releases styles repeatedly, so the last reference of a style
+// is released while another thread interns an equal style.
+//
+class InternAndRelease final : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit InternAndRelease(StyleInterner* interner);
+  ~InternAndRelease() final;
+
+ private:
+  // base::DelegateSimpleThread::Delegate
+  void Run() final;
+
+  StyleInterner* const interner_;
+  std::unique_ptr<css::Style> styles_[2];
+
+  DISALLOW_COPY_AND_ASSIGN(InternAndRelease);
+};
+
+InternAndRelease::InternAndRelease(StyleInterner* interner)
+    : interner_(interner) {
+  styles_[0] = css::StyleBuilder().SetColor(1, 0, 0).Build();
+  styles_[1] = css::StyleBuilder().SetColor(0, 1, 0).Build();
+}
+
+InternAndRelease::~InternAndRelease() {}
+
+void InternAndRelease::Run() {
+  for (auto count = 0; count < 10000; ++count) {
+    const auto& expected = *styles_[count % 2];
+    const auto& shared_style =
+        interner_->Intern(std::make_unique<css::Style>(expected));
+    ASSERT_EQ(expected, shared_style->style());
+  }
+}
+
+}  // namespace
+
+TEST(StyleInternerTest, Intern) {
+  StyleInterner interner;
+  const auto& style1 =
+      interner.Intern(css::StyleBuilder().SetColor(1, 0, 0).Build());
+  const auto& style2 =
+      interner.Intern(css::StyleBuilder().SetColor(1, 0, 0).Build());
+  const auto& style3 =
+      interner.Intern(css::StyleBuilder().SetColor(0, 1, 0).Build());
+
+  EXPECT_EQ(style1, style2);
+  EXPECT_NE(style1, style3);
+  EXPECT_EQ(2u, interner.size());
+}
+
+TEST(StyleInternerTest, Release) {
+  StyleInterner interner;
+  auto style1 = interner.Intern(css::StyleBuilder().SetColor(1, 0, 0).Build());
+  auto style2 = interner.Intern(css::StyleBuilder().SetColor(1, 0, 0).Build());
+  EXPECT_EQ(1u, interner.size());
+
+  style1 = nullptr;
+  EXPECT_EQ(1u, interner.size());
+  style2 = nullptr;
+  EXPECT_EQ(0u, interner.size());
+}
+
+TEST(StyleInternerTest, ReleaseWhileInterning) {
+  StyleInterner interner;
+  InternAndRelease delegate(&interner);
+  base::DelegateSimpleThreadPool pool("StyleInternerTest", 4);
+  pool.AddWork(&delegate, 4);
+  pool.Start();
+  pool.JoinAll();
+  EXPECT_EQ(0u, interner.size());
+}
+
+}  // namespace visuals
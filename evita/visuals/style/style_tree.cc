@@ -4,12 +4,20 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iterator>
 #include <ostream>
+#include <unordered_map>
+#include <vector>
 
 #include "evita/visuals/style/style_tree.h"
 
+#include "base/memory/singleton.h"
 #include "base/observer_list.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/sys_info.h"
+#include "base/threading/simple_thread.h"
 #include "base/trace_event/trace_event.h"
 #include "evita/css/media.h"
 #include "evita/css/media_state.h"
@@ -27,6 +35,7 @@
 #include "evita/visuals/dom/shape.h"
 #include "evita/visuals/dom/text.h"
 #include "evita/visuals/style/compiled_style_sheet_set.h"
+#include "evita/visuals/style/shared_style.h"
 #include "evita/visuals/style/style_tree_observer.h"
 #include "evita/visuals/view/public/selection.h"
 #include "evita/visuals/view/public/view_lifecycle.h"
@@ -34,13 +43,28 @@
 namespace visuals {
 
 namespace {
+
+// Style recalc of whole document runs in parallel if document has at least
+// |kMinNodesForParallelUpdate| nodes.
+const size_t kMinNodesForParallelUpdate = 512;
+const int kMaxStyleRecalcThreads = 8;
+// Number of subtrees per thread for balancing work among threads.
+const size_t kTasksPerThread = 4;
+
 struct Item {
   bool is_child_dirty = true;
   bool is_dirty = true;
-  std::unique_ptr<css::Style> style;
+  scoped_refptr<SharedStyle> style;
   int version;
 };
 
+// Holds computed style of previous sibling element for sharing it with
+// next sibling element which has same selector and no inline style.
+struct SiblingStyle {
+  css::Selector selector;
+  scoped_refptr<SharedStyle> style;
+};
+
 #define FOR_EACH_INHERITABLE_PROPERTY(V) \
   V(Color, color)                        \
   V(FontFamily, font_family)             \
@@ -49,6 +73,58 @@ struct Item {
   V(FontStyle, font_style)               \
   V(FontWeight, font_weight)
 
+using StyleMap = std::unordered_map<const Node*, scoped_refptr<SharedStyle>>;
+
+int NumberOfStyleRecalcThreads() {
+  return std::min(base::SysInfo::NumberOfProcessors(), kMaxStyleRecalcThreads);
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// StyleRecalcThreadPool
+// Keeps style recalc threads until process exit, so parallel style recalc
+// doesn't create and join threads each time.
+//
+class StyleRecalcThreadPool final {
+ public:
+  // Runs |delegate| on |num_threads| threads of this pool.
+  void AddWork(base::DelegateSimpleThread::Delegate* delegate,
+               int num_threads);
+
+  static StyleRecalcThreadPool* GetInstance();
+
+ private:
+  friend struct base::DefaultSingletonTraits<StyleRecalcThreadPool>;
+
+  StyleRecalcThreadPool();
+  ~StyleRecalcThreadPool();
+
+  base::DelegateSimpleThreadPool pool_;
+
+  DISALLOW_COPY_AND_ASSIGN(StyleRecalcThreadPool);
+};
+
+StyleRecalcThreadPool::StyleRecalcThreadPool()
+    : pool_("StyleRecalc", NumberOfStyleRecalcThreads() - 1) {
+  pool_.Start();
+}
+
+StyleRecalcThreadPool::~StyleRecalcThreadPool() {
+  pool_.JoinAll();
+}
+
+void StyleRecalcThreadPool::AddWork(
+    base::DelegateSimpleThread::Delegate* delegate,
+    int num_threads) {
+  DCHECK_LT(num_threads, NumberOfStyleRecalcThreads());
+  pool_.AddWork(delegate, num_threads);
+}
+
+// static
+StyleRecalcThreadPool* StyleRecalcThreadPool::GetInstance() {
+  return base::Singleton<StyleRecalcThreadPool>::get();
+}
+
 void InheritStyle(css::Style* style, const css::Style& parent_style) {
 #define V(Name, name)                                    \
   if (!style->has_##name() && parent_style.has_##name()) \
@@ -93,7 +169,7 @@ class StyleTree::Impl final {
   Impl(const Document& document,
        const css::Media& media,
        const std::vector<css::StyleSheet*>& style_sheets);
-  ~Impl() = default;
+  ~Impl();
 
   const Document& document() const { return document_; }
   Node* focused_node() const { return focused_node_; }
@@ -114,21 +190,42 @@ class StyleTree::Impl final {
   void UpdateIfNeeded();
 
  private:
+  class ParallelUpdater;
+
   struct Context {
     bool is_updated = false;
   };
 
+  void CommitStyles(Context* context,
+                    const ContainerNode& container,
+                    const StyleMap& styles);
   std::unique_ptr<css::Style> ComputeInitialStyle() const;
+  std::unique_ptr<css::Style> ComputeStyleForAnonymousInlineBox(
+      const css::Style& parent_style) const;
   std::unique_ptr<css::Style> ComputeStyleForDocument() const;
   std::unique_ptr<css::Style> ComputeStyleForElement(
-      const ElementNode& element) const;
+      const ElementNode& element,
+      const css::Selector& selector,
+      const css::Style& parent_style) const;
+  scoped_refptr<SharedStyle> ComputeSharedStyleForElement(
+      const ElementNode& element,
+      const css::Style& parent_style,
+      SiblingStyle* sibling_style);
+  scoped_refptr<SharedStyle> ComputeSharedStyleForNode(
+      const Node& node,
+      const css::Style& parent_style,
+      SiblingStyle* sibling_style);
   Item* GetOrNewItem(const Node& element);
   void IncrementVersionIfNeeded(Context* context);
   css::Selector MakeSelectorForElement(const ElementNode& element) const;
+  bool ShouldUpdateInParallel() const;
   void UpdateAsAnonymousInlineBox(Context* context, const Node& node);
   void UpdateChildren(Context* context, const ContainerNode& element);
+  void UpdateChildrenInParallel(Context* context);
   void UpdateDocumentStyleIfNeeded(Context* context);
-  void UpdateElement(Context* context, const ElementNode& element);
+  void UpdateElement(Context* context,
+                     const ElementNode& element,
+                     SiblingStyle* sibling_style);
   void UpdateElementIfNeeded(Context* context, const ElementNode& element);
   void UpdateImage(Context* context, const Image& image);
   void UpdateNodeIfNeeded(Context* context, const Node& node);
@@ -137,28 +234,147 @@ class StyleTree::Impl final {
 
   std::unique_ptr<CompiledStyleSheetSet> compiled_style_sheet_set_;
   const Document& document_;
+  // Pseudo classes are atomized here, since |base::AtomicString| can't be
+  // made on worker threads.
+  const base::AtomicString focus_class_;
   Node* focused_node_ = nullptr;
+  const base::AtomicString hover_class_;
   Node* hovered_node_ = nullptr;
   // |initial_style_| is computed from media provided values.
   std::unique_ptr<css::Style> initial_style_;
-  // TODO(eval1749): We should share |css::Style| objects for elements which
-  // have same style, e.g. siblings.
   std::unordered_map<const Node*, std::unique_ptr<Item>> item_map_;
   const css::Media& media_;
   base::ObserverList<StyleTreeObserver> observers_;
   StyleTreeState state_ = StyleTreeState::Dirty;
+  // |style_interner_| shares computed styles among nodes.
+  StyleInterner style_interner_;
   int version_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(Impl);
 };
 
+//////////////////////////////////////////////////////////////////////
+//
+// StyleTree::Impl::ParallelUpdater
+// Computes styles of descendants of |containers| whose styles are already
+// computed. Each subtree is a task, and threads pick up next task when they
+// finish a task. Results are kept per task for being committed in document
+// order on the thread calling |StyleTree::UpdateIfNeeded()|. Worker threads
+// are borrowed from |StyleRecalcThreadPool|.
+//
+class StyleTree::Impl::ParallelUpdater final
+    : public base::DelegateSimpleThread::Delegate {
+ public:
+  ParallelUpdater(Impl* impl,
+                  const std::vector<const ContainerNode*>& containers,
+                  const StyleMap& styles);
+  ~ParallelUpdater() final;
+
+  // Runs tasks on |num_threads| threads including current thread and
+  // merges computed styles into |styles|.
+  void RunTasks(int num_threads, StyleMap* styles);
+
+ private:
+  void UpdateChildren(const ContainerNode& container,
+                      const css::Style& parent_style,
+                      StyleMap* results);
+
+  void RunTasksOnThisThread();
+
+  // base::DelegateSimpleThread::Delegate
+  void Run() final;
+
+  const std::vector<const ContainerNode*>& containers_;
+  // |done_event_| is signaled when all worker threads finish tasks.
+  base::WaitableEvent done_event_;
+  Impl* const impl_;
+  std::atomic<size_t> next_task_;
+  std::atomic<int> num_running_workers_;
+  // |results_[i]| holds computed styles of descendants of |containers_[i]|.
+  std::vector<StyleMap> results_;
+  // |styles_| is read-only during running tasks.
+  const StyleMap& styles_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelUpdater);
+};
+
+StyleTree::Impl::ParallelUpdater::ParallelUpdater(
+    Impl* impl,
+    const std::vector<const ContainerNode*>& containers,
+    const StyleMap& styles)
+    : containers_(containers),
+      done_event_(base::WaitableEvent::ResetPolicy::MANUAL,
+                  base::WaitableEvent::InitialState::NOT_SIGNALED),
+      impl_(impl),
+      next_task_(0),
+      num_running_workers_(0),
+      results_(containers.size()),
+      styles_(styles) {}
+
+StyleTree::Impl::ParallelUpdater::~ParallelUpdater() {}
+
+void StyleTree::Impl::ParallelUpdater::RunTasks(int num_threads,
+                                                StyleMap* styles) {
+  DCHECK_GT(num_threads, 1);
+  num_running_workers_ = num_threads - 1;
+  StyleRecalcThreadPool::GetInstance()->AddWork(this, num_threads - 1);
+  RunTasksOnThisThread();
+  done_event_.Wait();
+  for (const auto& results : results_)
+    styles->insert(results.begin(), results.end());
+}
+
+void StyleTree::Impl::ParallelUpdater::RunTasksOnThisThread() {
+  for (;;) {
+    const auto index = next_task_.fetch_add(1);
+    if (index >= containers_.size())
+      return;
+    const auto& container = *containers_[index];
+    const auto& it = styles_.find(&container);
+    DCHECK(it != styles_.end()) << container;
+    UpdateChildren(container, it->second->style(), &results_[index]);
+  }
+}
+
+// base::DelegateSimpleThread::Delegate
+void StyleTree::Impl::ParallelUpdater::Run() {
+  RunTasksOnThisThread();
+  if (num_running_workers_.fetch_sub(1) == 1)
+    done_event_.Signal();
+}
+
+void StyleTree::Impl::ParallelUpdater::UpdateChildren(
+    const ContainerNode& container,
+    const css::Style& parent_style,
+    StyleMap* results) {
+  SiblingStyle sibling_style;
+  for (const auto& child : container.child_nodes()) {
+    const auto& style =
+        impl_->ComputeSharedStyleForNode(*child, parent_style, &sibling_style);
+    results->emplace(child, style);
+    if (const auto element = child->as<Element>())
+      UpdateChildren(*element, style->style(), results);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// StyleTree::Impl
+//
 StyleTree::Impl::Impl(const Document& document,
                       const css::Media& media,
                       const std::vector<css::StyleSheet*>& style_sheets)
     : compiled_style_sheet_set_(new CompiledStyleSheetSet(style_sheets)),
       document_(document),
+      focus_class_(L":focus"),
+      hover_class_(L":hover"),
       media_(media) {}
 
+StyleTree::Impl::~Impl() {
+  // Release shared styles before destructing |style_interner_|.
+  item_map_.clear();
+}
+
 bool StyleTree::Impl::is_dirty() const {
   DCHECK_NE(StyleTreeState::Updating, state_);
   return state_ == StyleTreeState::Dirty;
@@ -172,6 +388,32 @@ void StyleTree::Impl::Clear() {
   state_ = StyleTreeState::Dirty;
 }
 
+// Stores computed styles in |styles| into descendants of |container| in
+// document order for notifying style changes to observers in document
+// order.
+void StyleTree::Impl::CommitStyles(Context* context,
+                                   const ContainerNode& container,
+                                   const StyleMap& styles) {
+  for (const auto& child : container.child_nodes()) {
+    const auto item = GetOrNewItem(*child);
+    item->is_child_dirty = false;
+    item->is_dirty = false;
+    const auto old_style = std::move(item->style);
+    const auto& it = styles.find(child);
+    DCHECK(it != styles.end()) << "No computed style for " << child;
+    item->style = it->second;
+    item->version = version_;
+    const auto element = child->as<Element>();
+    if (!element)
+      continue;
+    if (old_style && old_style != item->style) {
+      for (auto& observer : observers_)
+        observer.DidChangeComputedStyle(*element, old_style->style());
+    }
+    CommitStyles(context, *element, styles);
+  }
+}
+
 const css::Style& StyleTree::Impl::ComputedStyleOf(const Node& node) const {
   DCHECK_NE(StyleTreeState::Dirty, state_);
   const auto& it = item_map_.find(&node);
@@ -179,7 +421,7 @@ const css::Style& StyleTree::Impl::ComputedStyleOf(const Node& node) const {
     NOTREACHED() << "No computed style for " << node;
     return *initial_style_;
   }
-  return *it->second->style;
+  return it->second->style->style();
 }
 
 std::unique_ptr<css::Style> StyleTree::Impl::ComputeInitialStyle() const {
@@ -193,6 +435,15 @@ std::unique_ptr<css::Style> StyleTree::Impl::ComputeInitialStyle() const {
   return std::move(style);
 }
 
+std::unique_ptr<css::Style>
+StyleTree::Impl::ComputeStyleForAnonymousInlineBox(
+    const css::Style& parent_style) const {
+  auto style = std::make_unique<css::Style>();
+  InheritStyle(style.get(), parent_style);
+  css::StyleEditor().Merge(style.get(), initial_style());
+  return std::move(style);
+}
+
 std::unique_ptr<css::Style> StyleTree::Impl::ComputeStyleForDocument() const {
   DCHECK_NE(StyleTreeState::Dirty, state_);
   auto style = std::make_unique<css::Style>(initial_style());
@@ -204,20 +455,56 @@ std::unique_ptr<css::Style> StyleTree::Impl::ComputeStyleForDocument() const {
 }
 
 std::unique_ptr<css::Style> StyleTree::Impl::ComputeStyleForElement(
-    const ElementNode& element) const {
+    const ElementNode& element,
+    const css::Selector& selector,
+    const css::Style& parent_style) const {
   DCHECK_NE(StyleTreeState::Dirty, state_);
   const auto inline_style = element.inline_style();
   auto style = inline_style ? std::make_unique<css::Style>(*inline_style)
                             : std::make_unique<css::Style>();
-  const auto& selector = MakeSelectorForElement(element);
   compiled_style_sheet_set_->Merge(style.get(), selector);
-  InheritStyle(style.get(), ComputedStyleOf(*element.parent()));
+  InheritStyle(style.get(), parent_style);
   css::StyleEditor().Merge(style.get(), initial_style());
   DCHECK(style->has_display()) << "A style must have display property. "
                                << initial_style();
   return std::move(style);
 }
 
+// When |sibling_style| has style of previous sibling element of same
+// selector, we share it without matching style sheets, since inheritable
+// properties are also same as they have same parent.
+// Note: This function is called on style recalc worker threads.
+scoped_refptr<SharedStyle> StyleTree::Impl::ComputeSharedStyleForElement(
+    const ElementNode& element,
+    const css::Style& parent_style,
+    SiblingStyle* sibling_style) {
+  const auto& selector = MakeSelectorForElement(element);
+  if (sibling_style && sibling_style->style && !element.inline_style() &&
+      sibling_style->selector == selector) {
+    return sibling_style->style;
+  }
+  const auto& style = style_interner_.Intern(
+      ComputeStyleForElement(element, selector, parent_style));
+  if (sibling_style) {
+    sibling_style->selector = selector;
+    sibling_style->style = element.inline_style() ? nullptr : style;
+  }
+  return style;
+}
+
+// Note: This function is called on style recalc worker threads.
+scoped_refptr<SharedStyle> StyleTree::Impl::ComputeSharedStyleForNode(
+    const Node& node,
+    const css::Style& parent_style,
+    SiblingStyle* sibling_style) {
+  if (const auto element = node.as<Element>())
+    return ComputeSharedStyleForElement(*element, parent_style, sibling_style);
+  // |Image|, |Shape| and |Text| nodes are treated as anonymous inline box.
+  DCHECK(!node.is<ContainerNode>()) << "Unsupported node type " << node;
+  return style_interner_.Intern(
+      ComputeStyleForAnonymousInlineBox(parent_style));
+}
+
 // UserActionSource::Observer
 void StyleTree::Impl::DidChangeFocusedNode(Node* focused_node) {
   DCHECK_NE(focused_node_, focused_node);
@@ -256,9 +543,9 @@ css::Selector StyleTree::Impl::MakeSelectorForElement(
   for (auto class_name : element.class_list())
     builder.AddClass(class_name);
   if (focused_node_ && element.Contains(*focused_node_))
-    builder.AddClass(base::AtomicString(L":focus"));
+    builder.AddClass(focus_class_);
   if (hovered_node_ && element.Contains(*hovered_node_))
-    builder.AddClass(base::AtomicString(L":hover"));
+    builder.AddClass(hover_class_);
   return std::move(builder.Build());
 }
 
@@ -287,23 +574,34 @@ void StyleTree::Impl::RemoveObserver(StyleTreeObserver* observer) {
   observers_.RemoveObserver(observer);
 }
 
+bool StyleTree::Impl::ShouldUpdateInParallel() const {
+  if (NumberOfStyleRecalcThreads() <= 1)
+    return false;
+  size_t num_nodes = 0;
+  for (const auto& node : Node::DescendantsOrSelf(document_)) {
+    static_cast<void>(node);
+    if (++num_nodes >= kMinNodesForParallelUpdate)
+      return true;
+  }
+  return false;
+}
+
 void StyleTree::Impl::UpdateAsAnonymousInlineBox(Context* context,
                                                  const Node& node) {
   const auto item = GetOrNewItem(node);
   item->is_dirty = false;
   item->is_child_dirty = false;
-  auto style = std::make_unique<css::Style>();
-  InheritStyle(style.get(), ComputedStyleOf(*node.parent()));
-  css::StyleEditor().Merge(style.get(), initial_style());
-  item->style = std::move(style);
+  item->style = style_interner_.Intern(
+      ComputeStyleForAnonymousInlineBox(ComputedStyleOf(*node.parent())));
 }
 
 void StyleTree::Impl::UpdateChildren(Context* context,
                                      const ContainerNode& container) {
+  SiblingStyle sibling_style;
   for (const auto& child : container.child_nodes()) {
     // TODO(eval1749): We should use |NodeVisitor| to update style for node.
     if (const auto element = child->as<Element>()) {
-      UpdateElement(context, *element);
+      UpdateElement(context, *element, &sibling_style);
       continue;
     }
     if (const auto image = child->as<Image>()) {
@@ -322,6 +620,39 @@ void StyleTree::Impl::UpdateChildren(Context* context,
   }
 }
 
+// Computes styles of whole document in parallel. Styles of elements near
+// root are computed on this thread until we have enough subtrees, then
+// subtrees are computed on multiple threads.
+void StyleTree::Impl::UpdateChildrenInParallel(Context* context) {
+  TRACE_EVENT0("visuals", "StyleTree::UpdateChildrenInParallel");
+  const auto num_threads = NumberOfStyleRecalcThreads();
+  const auto min_tasks = num_threads * kTasksPerThread;
+  StyleMap styles;
+  styles.emplace(&document_, GetOrNewItem(document_)->style);
+  std::vector<const ContainerNode*> containers{&document_};
+  while (!containers.empty() && containers.size() < min_tasks) {
+    std::vector<const ContainerNode*> children;
+    for (const auto& container : containers) {
+      const auto& parent_style = styles.find(container)->second->style();
+      SiblingStyle sibling_style;
+      for (const auto& child : container->child_nodes()) {
+        const auto& style =
+            ComputeSharedStyleForNode(*child, parent_style, &sibling_style);
+        styles.emplace(child, style);
+        if (const auto element = child->as<Element>())
+          children.push_back(element);
+      }
+    }
+    containers = std::move(children);
+  }
+  if (!containers.empty()) {
+    // Rules must be compiled before matching on worker threads.
+    compiled_style_sheet_set_->CompileIfNeeded();
+    ParallelUpdater(this, containers, styles).RunTasks(num_threads, &styles);
+  }
+  CommitStyles(context, document_, styles);
+}
+
 void StyleTree::Impl::UpdateDocumentStyleIfNeeded(Context* context) {
   const auto item = GetOrNewItem(document_);
   if (!item->is_dirty) {
@@ -341,30 +672,35 @@ void StyleTree::Impl::UpdateDocumentStyleIfNeeded(Context* context) {
 
   item->is_child_dirty = false;
   item->is_dirty = false;
-  const auto old_style = std::move(item->style);
-  item->style = std::move(ComputeStyleForDocument());
+  item->style = style_interner_.Intern(ComputeStyleForDocument());
   item->version = version_;
-  DCHECK(item->style->has_background_color())
-      << "document style should not have background-color property. "
-      << *item->style;
+  DCHECK(item->style->style().has_background_color())
+      << "document style should have background-color property. "
+      << item->style->style();
+  if (ShouldUpdateInParallel())
+    return UpdateChildrenInParallel(context);
   UpdateChildren(context, document_);
 }
 
 void StyleTree::Impl::UpdateElement(Context* context,
-                                    const ElementNode& element) {
+                                    const ElementNode& element,
+                                    SiblingStyle* sibling_style) {
   IncrementVersionIfNeeded(context);
   const auto item = GetOrNewItem(element);
   item->is_child_dirty = false;
   item->is_dirty = false;
   const auto old_style = std::move(item->style);
-  item->style = std::move(ComputeStyleForElement(element));
+  item->style = ComputeSharedStyleForElement(
+      element, ComputedStyleOf(*element.parent()), sibling_style);
   item->version = version_;
   // Simple style merge check.
-  DCHECK(item->style->has_display())
-      << "Style merge failed. We should merge initial style. " << *item->style;
-  if (old_style) {
+  DCHECK(item->style->style().has_display())
+      << "Style merge failed. We should merge initial style. "
+      << item->style->style();
+  // Equal styles are interned into one |SharedStyle|.
+  if (old_style && old_style != item->style) {
     for (auto& observer : observers_)
-      observer.DidChangeComputedStyle(element, *old_style);
+      observer.DidChangeComputedStyle(element, old_style->style());
   }
   UpdateChildren(context, element);
 }
@@ -373,7 +709,7 @@ void StyleTree::Impl::UpdateElementIfNeeded(Context* context,
                                             const ElementNode& element) {
   const auto item = GetOrNewItem(element);
   if (item->is_dirty)
-    return UpdateElement(context, element);
+    return UpdateElement(context, element, nullptr);
   if (!item->is_child_dirty)
     return;
   item->is_child_dirty = false;
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <vector>
+
 #include "evita/visuals/style/style_tree.h"
 
 #include "base/observer_list.h"
@@ -14,6 +16,7 @@
 #include "evita/visuals/dom/document.h"
 #include "evita/visuals/dom/element.h"
 #include "evita/visuals/dom/node_tree_builder.h"
+#include "evita/visuals/style/style_tree_observer.h"
 #include "evita/visuals/view/public/user_action_source.h"
 #include "evita/visuals/view/public/view_lifecycle.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -21,9 +24,34 @@
 namespace visuals {
 
 namespace {
+
 css::Selector ParseSelector(base::StringPiece16 text) {
   return css::Selector::Parser().Parse(text);
 }
+
+//////////////////////////////////////////////////////////////////////
+//
+// StyleChangeRecorder
+//
+class StyleChangeRecorder final : public StyleTreeObserver {
+ public:
+  StyleChangeRecorder() = default;
+  ~StyleChangeRecorder() final = default;
+
+  const std::vector<const ElementNode*>& elements() const { return elements_; }
+
+ private:
+  // StyleTreeObserver
+  void DidChangeComputedStyle(const ElementNode& element,
+                              const css::Style& old_style) final {
+    elements_.push_back(&element);
+  }
+
+  std::vector<const ElementNode*> elements_;
+
+  DISALLOW_COPY_AND_ASSIGN(StyleChangeRecorder);
+};
+
 }  // namespace
 
 //////////////////////////////////////////////////////////////////////
@@ -165,4 +193,112 @@ TEST_F(StyleTreeTest, Inheritance) {
   lifecycle.FinishShutdown();
 }
 
+// Document has enough nodes for updating style in parallel.
+TEST_F(StyleTreeTest, ParallelUpdate) {
+  const auto& kColorGreen = css::Color(css::ColorValue(0, 1, 0));
+  const auto& kColorRed = css::Color(css::ColorValue(1, 0, 0));
+  auto* const style_sheet = new css::StyleSheet();
+  style_sheet->AppendRule(
+      ParseSelector(L".c1"),
+      std::move(css::StyleBuilder().SetColor(kColorRed).Build()));
+  NodeTreeBuilder builder;
+  builder.Begin(L"body");
+  for (auto section = 0; section < 20; ++section) {
+    builder.Begin(L"div");
+    for (auto index = 0; index < 20; ++index) {
+      builder.Begin(L"span")
+          .ClassList({index % 2 ? L"c1" : L"c2"})
+          .AddText(L"x")
+          .End(L"span");
+    }
+    builder.End(L"div");
+  }
+  const auto& document = builder.End(L"body").Build();
+  std::vector<const ElementNode*> c1_spans;
+  std::vector<const ElementNode*> c2_spans;
+  const auto body = document->first_child()->as<Element>();
+  for (const auto& div : body->child_nodes()) {
+    auto index = 0;
+    for (const auto& span : div->as<Element>()->child_nodes()) {
+      (index % 2 ? c1_spans : c2_spans).push_back(span->as<Element>());
+      ++index;
+    }
+  }
+  ViewLifecycle lifecycle(*document, mock_media());
+  ViewLifecycle::Scope(&lifecycle, ViewLifecycle::State::Started);
+  StyleTree style_tree(&lifecycle, *this, {style_sheet});
+  StyleChangeRecorder recorder;
+  style_tree.AddObserver(&recorder);
+  style_tree.UpdateIfNeeded();
+
+  for (const auto& span : c1_spans) {
+    EXPECT_EQ(&style_tree.ComputedStyleOf(*c1_spans.front()),
+              &style_tree.ComputedStyleOf(*span))
+        << "Styles computed on different threads are interned.";
+    EXPECT_EQ(kColorRed,
+              style_tree.ComputedStyleOf(*span->first_child()).color())
+        << "Text inherits color from span.";
+  }
+  EXPECT_TRUE(recorder.elements().empty());
+
+  style_sheet->AppendRule(
+      ParseSelector(L".c2"),
+      std::move(css::StyleBuilder().SetColor(kColorGreen).Build()));
+  style_tree.UpdateIfNeeded();
+  for (const auto& span : c2_spans)
+    EXPECT_EQ(kColorGreen, style_tree.ComputedStyleOf(*span).color());
+  EXPECT_EQ(c2_spans, recorder.elements())
+      << "Style changes are notified in document order.";
+
+  style_tree.RemoveObserver(&recorder);
+  lifecycle.StartShutdown();
+  lifecycle.FinishShutdown();
+}
+
+TEST_F(StyleTreeTest, SharedStyle) {
+  const auto& kColorRed = css::Color(css::ColorValue(1, 0, 0));
+  auto* const style_sheet = new css::StyleSheet();
+  style_sheet->AppendRule(
+      ParseSelector(L".c1"),
+      std::move(css::StyleBuilder().SetColor(kColorRed).Build()));
+  style_sheet->AppendRule(
+      ParseSelector(L".c2"),
+      std::move(css::StyleBuilder().SetColor(kColorRed).Build()));
+  const auto& document = NodeTreeBuilder()
+                             .Begin(L"body")
+                             .Begin(L"foo", L"a")
+                             .ClassList({L"c1"})
+                             .End(L"foo")
+                             .Begin(L"foo", L"b")
+                             .ClassList({L"c1"})
+                             .End(L"foo")
+                             .Begin(L"foo", L"c")
+                             .ClassList({L"c2"})
+                             .End(L"foo")
+                             .Begin(L"foo", L"d")
+                             .End(L"foo")
+                             .End(L"body")
+                             .Build();
+  ViewLifecycle lifecycle(*document, mock_media());
+  ViewLifecycle::Scope(&lifecycle, ViewLifecycle::State::Started);
+  StyleTree style_tree(&lifecycle, *this, {style_sheet});
+  style_tree.UpdateIfNeeded();
+
+  const auto& style_a =
+      style_tree.ComputedStyleOf(*document->GetElementById(L"a"));
+  const auto& style_b =
+      style_tree.ComputedStyleOf(*document->GetElementById(L"b"));
+  const auto& style_c =
+      style_tree.ComputedStyleOf(*document->GetElementById(L"c"));
+  const auto& style_d =
+      style_tree.ComputedStyleOf(*document->GetElementById(L"d"));
+  EXPECT_EQ(kColorRed, style_a.color());
+  EXPECT_EQ(&style_a, &style_b) << "Shared with previous sibling.";
+  EXPECT_EQ(&style_a, &style_c) << "Equal styles are interned.";
+  EXPECT_NE(&style_a, &style_d);
+
+  lifecycle.StartShutdown();
+  lifecycle.FinishShutdown();
+}
+
 }  // namespace visuals
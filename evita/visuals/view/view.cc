@@ -44,7 +44,8 @@ View::View(const Document& document,
       selection_(new Selection(lifecycle_.get())),
       style_tree_(
           new StyleTree(lifecycle_.get(), user_action_source, style_sheets)),
-      box_tree_(new BoxTree(lifecycle_.get(), *selection_, *style_tree_)) {
+      box_tree_(new BoxTree(lifecycle_.get(), *selection_, *style_tree_)),
+      painter_(new Painter()) {
   lifecycle_->AddObserver(this);
 }
 
@@ -94,7 +95,7 @@ std::unique_ptr<DisplayItemList> View::Paint() {
       base::StringPrintf(L"dom: %d, css: %d, box: %d", document().version(),
                          style_tree_->version(), box_tree_->version());
   PaintInfo paint_info(root_box->bounds(), debug_text);
-  auto display_item_list = Painter().Paint(paint_info, *root_box);
+  auto display_item_list = painter_->Paint(paint_info, *root_box);
   // TODO(eval1749): Do we have another place to call |Selection::DidPaint()|.
   // In here, we call |Selection::DidPaint()| even if painter doesn't paint
   // caret, e.g. selection is none, selection is out side of viewport.
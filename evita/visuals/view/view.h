@@ -25,6 +25,7 @@ class BoxTree;
 class DisplayItemList;
 class Document;
 class Node;
+class Painter;
 class Selection;
 class StyleTree;
 class UserActionSource;
@@ -77,6 +78,9 @@ class View final : public ViewLifecycleObserver {
   // |BoxTree| takes |ViewLifecycle|, |Selection| and |StyleTree|.
   std::unique_ptr<BoxTree> box_tree_;
 
+  // |Painter| retains display items of the last frame.
+  std::unique_ptr<Painter> painter_;
+
   DISALLOW_COPY_AND_ASSIGN(View);
 };
 